@@ -35,6 +35,7 @@
 #include "ConsoleCommands/QuitCommand.h"
 #include "ConsoleCommands/PingCommand.h"
 #include "ConsoleCommands/ScriptCommand.h"
+#include "ConsoleCommands/DataStorageCommand.h"
 #include "EngineLoop.h"
 
 class ConsoleCommandHandler
@@ -45,6 +46,7 @@ public:
         RegisterCommand("quit"_h, &QuitCommand);
         RegisterCommand("ping"_h, &PingCommand);
         RegisterCommand("reload"_h, &ReloadCommand);
+        RegisterCommand("benchmarkdatastorage"_h, &BenchmarkDataStorageCommand);
     }
 
     void HandleCommand(EngineLoop& engineLoop, std::string& command)
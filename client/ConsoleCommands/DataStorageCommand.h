@@ -0,0 +1,109 @@
+/*
+    MIT License
+
+    Copyright (c) 2020 NovusCore
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+#pragma once
+#include <Utils/Timer.h>
+#include <Utils/StringUtils.h>
+#include <Utils/DebugHandler.h>
+#include "../EngineLoop.h"
+#include "../ECS/Components/Singletons/DataStorageSingleton.h"
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+// Times script style DataStorage lookups, string keys through the generic storage versus precomputed keys into the typed slots
+// Runs on local storages so it never races the game thread, usage: benchmarkdatastorage [iterations]
+void BenchmarkDataStorageCommand(EngineLoop& engineLoop, std::vector<std::string> subCommands)
+{
+    constexpr u32 NUM_KEYS = 64;
+
+    u32 numIterations = 10000;
+    if (subCommands.size() > 0)
+    {
+        numIterations = static_cast<u32>(std::strtoul(subCommands[0].c_str(), nullptr, 10));
+        if (numIterations == 0)
+        {
+            DebugHandler::PrintWarning("Usage: benchmarkdatastorage [iterations]");
+            return;
+        }
+    }
+
+    DataStorageSingleton dataStorage;
+
+    std::vector<std::string> names(NUM_KEYS);
+    std::vector<u32> keys(NUM_KEYS);
+    for (u32 i = 0; i < NUM_KEYS; i++)
+    {
+        names[i] = "BenchmarkKey" + std::to_string(i);
+        keys[i] = StringUtils::fnv1a_32(names[i].c_str(), names[i].length());
+
+        dataStorage.storage.EmplaceU32(keys[i], i);
+        dataStorage.u32Slots.Emplace(keys[i], i);
+    }
+
+    // The sums are printed so none of the loops can be optimized away
+    u64 stringSum = 0;
+    Timer stringTimer;
+    for (u32 iteration = 0; iteration < numIterations; iteration++)
+    {
+        for (const std::string& name : names)
+        {
+            u32 val = 0;
+            dataStorage.storage.GetU32(StringUtils::fnv1a_32(name.c_str(), name.length()), val);
+            stringSum += val;
+        }
+    }
+    f32 stringMs = stringTimer.GetLifeTime() * 1000.0f;
+
+    u64 stringSlotSum = 0;
+    Timer stringSlotTimer;
+    for (u32 iteration = 0; iteration < numIterations; iteration++)
+    {
+        for (const std::string& name : names)
+        {
+            u32 val = 0;
+            dataStorage.u32Slots.Get(StringUtils::fnv1a_32(name.c_str(), name.length()), val);
+            stringSlotSum += val;
+        }
+    }
+    f32 stringSlotMs = stringSlotTimer.GetLifeTime() * 1000.0f;
+
+    u64 keySum = 0;
+    Timer keyTimer;
+    for (u32 iteration = 0; iteration < numIterations; iteration++)
+    {
+        for (u32 key : keys)
+        {
+            u32 val = 0;
+            dataStorage.u32Slots.Get(key, val);
+            keySum += val;
+        }
+    }
+    f32 keyMs = keyTimer.GetLifeTime() * 1000.0f;
+
+    f64 numLookups = static_cast<f64>(numIterations) * NUM_KEYS;
+    DebugHandler::Print("DataStorage benchmark, %u lookups (%llu, %llu, %llu)", static_cast<u32>(numLookups), static_cast<unsigned long long>(stringSum), static_cast<unsigned long long>(stringSlotSum), static_cast<unsigned long long>(keySum));
+    DebugHandler::Print("  String key, generic storage:  %.2fms (%.2fns per lookup)", stringMs, (stringMs * 1000000.0) / numLookups);
+    DebugHandler::Print("  String key, typed slots:      %.2fms (%.2fns per lookup)", stringSlotMs, (stringSlotMs * 1000000.0) / numLookups);
+    DebugHandler::Print("  Precomputed key, typed slots: %.2fms (%.2fns per lookup)", keyMs, (keyMs * 1000000.0) / numLookups);
+}
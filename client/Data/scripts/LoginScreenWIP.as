@@ -4,15 +4,20 @@
 *	Updated 22/10/2020	
 */
 
+// Hashed once when the module is built instead of on every lookup
+const uint LOGIN_BACKGROUND_KEY = DataStorage::HashKey("LOGIN-background");
+const uint LOGIN_USERNAME_FIELD_KEY = DataStorage::HashKey("LOGIN-usernameField");
+const uint LOGIN_PASSWORD_FIELD_KEY = DataStorage::HashKey("LOGIN-passwordField");
+
 void LogIn()
 {
 	// LOGIN
 	Entity backgroundId;
 	Entity usernameFieldId;
 	Entity passwordFieldId;
-	DataStorage::GetEntity("LOGIN-background", backgroundId);
-	DataStorage::GetEntity("LOGIN-usernameField", usernameFieldId);
-	DataStorage::GetEntity("LOGIN-passwordField", passwordFieldId);
+	DataStorage::GetEntity(LOGIN_BACKGROUND_KEY, backgroundId);
+	DataStorage::GetEntity(LOGIN_USERNAME_FIELD_KEY, usernameFieldId);
+	DataStorage::GetEntity(LOGIN_PASSWORD_FIELD_KEY, passwordFieldId);
 	
 	string username;
 	string password;
@@ -65,7 +70,7 @@ void OnLoginScreenLoaded(uint SceneLoaded)
 	background.SetLocalAnchor(vec2(0.5f, 0.5f));
 	background.SetTexture("Data/extracted/textures/Interface/Glues/LoadingScreens/loadscreennorthrendwide.dds");
 	background.SetDepthLayer(0);
-	DataStorage::EmplaceEntity("LOGIN-background", background.GetEntityId());
+	DataStorage::EmplaceEntity(LOGIN_BACKGROUND_KEY, background.GetEntityId());
 
 	userNameLabel.SetParent(background);
 	userNameLabel.SetAnchor(vec2(0.5,0.5));
@@ -93,7 +98,7 @@ void OnLoginScreenLoaded(uint SceneLoaded)
 	usernameField.SetFillParentSize(true);
 	usernameField.SetFont(FONT, INPUTFIELDFONTSIZE);
 	usernameField.OnSubmit(OnFieldSubmit);
-	DataStorage::EmplaceEntity("LOGIN-usernameField", usernameField.GetEntityId());
+	DataStorage::EmplaceEntity(LOGIN_USERNAME_FIELD_KEY, usernameField.GetEntityId());
 			
 	passwordLabel.SetParent(background);
 	passwordLabel.SetAnchor(vec2(0.5,0.5));
@@ -121,7 +126,7 @@ void OnLoginScreenLoaded(uint SceneLoaded)
 	passwordField.SetFillParentSize(true);
 	passwordField.SetFont(FONT, INPUTFIELDFONTSIZE);
 	passwordField.OnSubmit(OnFieldSubmit);
-	DataStorage::EmplaceEntity("LOGIN-passwordField", passwordField.GetEntityId());
+	DataStorage::EmplaceEntity(LOGIN_PASSWORD_FIELD_KEY, passwordField.GetEntityId());
 	
 	submitButton.SetParent(background);
 	submitButton.SetAnchor(vec2(0.5,0.5));
@@ -1,9 +1,11 @@
 #pragma once
 #include <NovusTypes.h>
+#include <vector>
 
 namespace NDBC
 {
     struct Light;
+    struct File;
 }
 
 constexpr f32 AreaUpdateTimeToUpdate = 1 / 30.0f;
@@ -14,6 +16,12 @@ struct AreaUpdateSingleton
     u16 lightId;
 
     f32 updateTimer = AreaUpdateTimeToUpdate;
+
+    // Light rows of the current map, only queried again when the map or the Light NDBC changes
+    std::vector<u32> mapLightRowIndices;
+    NDBC::File* mapLightFile = nullptr;
+    u32 mapLightMapId = 0;
+    u32 mapLightGeneration = 0;
 };
 
 struct AreaUpdateLightData
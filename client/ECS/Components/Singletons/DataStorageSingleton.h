@@ -1,8 +1,59 @@
 #pragma once
 #include <NovusTypes.h>
 #include <Containers/DataStorage.h>
+#include <entity/entity.hpp>
+#include <robin_hood.h>
+#include <string>
+
+// Values of a single type keyed by a name hash (StringUtils::fnv1a_32 or "name"_h), a lookup is one probe into a flat map
+template <typename T>
+class DataStorageSlots
+{
+public:
+    // Fails if the key is already in use
+    bool Put(u32 key, const T& val)
+    {
+        return _slots.emplace(key, val).second;
+    }
+
+    // Overwrites whatever the key held before
+    void Emplace(u32 key, const T& val)
+    {
+        _slots[key] = val;
+    }
+
+    bool Get(u32 key, T& val) const
+    {
+        auto itr = _slots.find(key);
+        if (itr == _slots.end())
+            return false;
+
+        val = itr->second;
+        return true;
+    }
+
+    bool Has(u32 key) const
+    {
+        return _slots.find(key) != _slots.end();
+    }
+
+    bool Clear(u32 key)
+    {
+        return _slots.erase(key) > 0;
+    }
+
+private:
+    robin_hood::unordered_flat_map<u32, T> _slots;
+};
 
 struct DataStorageSingleton
 {
     DataStorage storage;
-};
\ No newline at end of file
+
+    // The types scripts touch every frame get their own slots, everything else still goes through the generic storage
+    DataStorageSlots<i32> i32Slots;
+    DataStorageSlots<u32> u32Slots;
+    DataStorageSlots<f32> f32Slots;
+    DataStorageSlots<std::string> stringSlots;
+    DataStorageSlots<entt::entity> entitySlots;
+};
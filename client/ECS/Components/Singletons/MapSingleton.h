@@ -64,7 +64,7 @@ struct MapSingleton
 		if (itr == _mapNameHashToDBC.end())
 			return nullptr;
 
-		return itr->second;
+		return _mapsNDBC->GetRowById<NDBC::Map>(itr->second);
 	}
 	NDBC::Map* GetMapByInternalNameHash(u32 mapInternalNameHash)
 	{
@@ -72,7 +72,7 @@ struct MapSingleton
 		if (itr == _mapInternalNameHashToDBC.end())
 			return nullptr;
 
-		return itr->second;
+		return _mapsNDBC->GetRowById<NDBC::Map>(itr->second);
 	}
 	NDBC::AreaTable* GetAreaTableByNameHash(u32 areaTableNameHash)
 	{
@@ -80,15 +80,7 @@ struct MapSingleton
 		if (itr == _areaNameHashToDBC.end())
 			return nullptr;
 
-		return itr->second;
-	}
-	std::vector<NDBC::Light*>* GetLightsByMapId(u32 mapId)
-	{
-		auto& itr = _mapIdToLightDBC.find(mapId);
-		if (itr == _mapIdToLightDBC.end())
-			return nullptr;
-
-		return &itr->second;
+		return _areaTableNDBC->GetRowById<NDBC::AreaTable>(itr->second);
 	}
 
 // NDBC Helper Functions
@@ -103,8 +95,8 @@ public:
 		// AreaTable.ndbc
 		_areaNameHashToDBC.clear();
 
-		// Light.ndbc
-		_mapIdToLightDBC.clear();
+		_mapsNDBC = nullptr;
+		_areaTableNDBC = nullptr;
 	}
 
 	void AddMapNDBC(NDBC::File* mapsNDBC, NDBC::Map* map)
@@ -113,18 +105,17 @@ public:
 		u32 mapNameHash = mapsNDBC->GetStringTable()->GetStringHash(map->name);
 		u32 mapInternalNameHash = mapsNDBC->GetStringTable()->GetStringHash(map->internalName);
 
-		_mapNameHashToDBC[mapNameHash] = map;
-		_mapInternalNameHashToDBC[mapInternalNameHash] = map;
+		_mapsNDBC = mapsNDBC;
+		_mapNameHashToDBC[mapNameHash] = map->id;
+		_mapInternalNameHashToDBC[mapInternalNameHash] = map->id;
 		_mapNames.push_back(&mapName);
 	}
 	void AddAreaTableNDBC(NDBC::File* areaTableNDBC, NDBC::AreaTable* areaTable)
 	{
 		u32 areaNameHash = areaTableNDBC->GetStringTable()->GetStringHash(areaTable->name);
-		_areaNameHashToDBC[areaNameHash] = areaTable;
-	}
-	void AddLightNDBC(NDBC::Light* light)
-	{
-		_mapIdToLightDBC[light->mapId].push_back(light);
+
+		_areaTableNDBC = areaTableNDBC;
+		_areaNameHashToDBC[areaNameHash] = areaTable->id;
 	}
 
 private:
@@ -140,8 +131,10 @@ private:
 	vec3 _skybandHorizonColor = vec3(0.0f, 0.0f, 0.0f);
 
 	std::vector<const std::string*> _mapNames;
-	robin_hood::unordered_map<u32, NDBC::Map*> _mapNameHashToDBC;
-	robin_hood::unordered_map<u32, NDBC::Map*> _mapInternalNameHashToDBC;
-	robin_hood::unordered_map<u32, NDBC::AreaTable*> _areaNameHashToDBC;
-	robin_hood::unordered_map<u32, std::vector<NDBC::Light*>> _mapIdToLightDBC;
+	// Name hash -> row id, rows are looked up when asked for since the editor can move them (MakeWritable, saving) or unmap them
+	NDBC::File* _mapsNDBC = nullptr;
+	NDBC::File* _areaTableNDBC = nullptr;
+	robin_hood::unordered_map<u32, u32> _mapNameHashToDBC;
+	robin_hood::unordered_map<u32, u32> _mapInternalNameHashToDBC;
+	robin_hood::unordered_map<u32, u32> _areaNameHashToDBC;
 };
@@ -23,37 +23,57 @@
 */
 #pragma once
 #include <NovusTypes.h>
+#include <Utils/DebugHandler.h>
 #include <robin_hood.h>
+#include <shared_mutex>
 #include "../../../Loaders/NDBC/NDBC.h"
 
 struct NDBCSingleton
 {
 	NDBCSingleton() {}
 
+	NDBCSingleton& operator=(const NDBCSingleton& o)
+	{
+		return *this;
+	}
+
+	// Files are only mapped the first time GetNDBCFile asks for them
+	void RegisterNDBCFile(const std::string& name, const std::string& path)
+	{
+		std::unique_lock lock(_mutex);
+
+		NDBCEntry& entry = InsertEntry(name);
+		entry.path = path;
+	}
+
 	NDBC::File& AddNDBCFile(std::string name, size_t size)
 	{
-		StringUtils::StringHash stringHash = name;
-		_loadedNDBCFileNames.push_back(name);
+		std::unique_lock lock(_mutex);
 
-		NDBC::File& file = _nameHashToDBCFile[stringHash];
+		NDBCEntry& entry = InsertEntry(name);
+
+		NDBC::File& file = entry.file;
 		file.GetBuffer() = new DynamicBytebuffer(size);
 		file.GetStringTable() = new StringTable();
 
+		entry.isOpen = true;
 		return file;
 	}
 
 	bool RemoveNDBCFile(std::string name)
 	{
 		StringUtils::StringHash stringHash = name;
+		std::unique_lock lock(_mutex);
 
-		auto& dbcFileItr = _nameHashToDBCFile.find(stringHash);
-		if (dbcFileItr == _nameHashToDBCFile.end())
+		auto itr = _nameHashToEntry.find(stringHash);
+		if (itr == _nameHashToEntry.end() || itr->second.isRemoved)
 			return false;
 
-		NDBC::File& file = dbcFileItr->second;
-
-		delete file.GetBuffer();
-		delete file.GetStringTable();
+		// The entry itself stays, anything still holding on to the File just sees an empty file
+		NDBCEntry& entry = itr->second;
+		entry.isRemoved = true;
+		entry.isOpen = false;
+		entry.file.Close();
 
 		for (std::vector<std::string>::iterator fileNameItr = _loadedNDBCFileNames.begin(); fileNameItr != _loadedNDBCFileNames.end(); fileNameItr++)
 		{
@@ -69,16 +89,78 @@ struct NDBCSingleton
 
 	NDBC::File* GetNDBCFile(StringUtils::StringHash nameHash)
 	{
-		auto& itr = _nameHashToDBCFile.find(nameHash);
-		if (itr == _nameHashToDBCFile.end())
+		{
+			std::shared_lock lock(_mutex);
+
+			auto itr = _nameHashToEntry.find(nameHash);
+			if (itr == _nameHashToEntry.end() || itr->second.isRemoved)
+				return nullptr;
+
+			if (itr->second.isOpen)
+				return &itr->second.file;
+		}
+
+		std::unique_lock lock(_mutex);
+
+		// Another thread might have opened (or removed) it while we weren't holding the lock
+		auto itr = _nameHashToEntry.find(nameHash);
+		if (itr == _nameHashToEntry.end() || itr->second.isRemoved)
 			return nullptr;
 
-		return &itr->second;
+		NDBCEntry& entry = itr->second;
+		if (entry.isOpen)
+			return &entry.file;
+
+		// Only try once, a broken file would otherwise get reopened on every lookup
+		if (entry.failedToOpen)
+			return nullptr;
+
+		if (!entry.file.Open(entry.path))
+		{
+			DebugHandler::PrintError("Failed to open %s", entry.path.c_str());
+			entry.failedToOpen = true;
+			return nullptr;
+		}
+
+		entry.isOpen = true;
+		return &entry.file;
 	}
 
+	// Every registered file, opened or not
 	const std::vector<std::string>& GetLoadedNDBCFileNames() { return _loadedNDBCFileNames; }
 
 private:
-    robin_hood::unordered_map<u32, NDBC::File> _nameHashToDBCFile;
+	struct NDBCEntry
+	{
+		std::string path;
+		NDBC::File file;
+		bool isOpen = false;
+		bool isRemoved = false;
+		bool failedToOpen = false;
+	};
+
+	// Has to be called with the unique lock held
+	NDBCEntry& InsertEntry(const std::string& name)
+	{
+		StringUtils::StringHash stringHash = name;
+
+		auto itr = _nameHashToEntry.find(stringHash);
+		if (itr != _nameHashToEntry.end() && !itr->second.isRemoved)
+			return itr->second;
+
+		// Adding a removed name again reuses its entry, its file was closed on removal
+		NDBCEntry& entry = _nameHashToEntry[stringHash];
+		entry.path.clear();
+		entry.isRemoved = false;
+		entry.failedToOpen = false;
+
+		_loadedNDBCFileNames.push_back(name);
+		return entry;
+	}
+
+private:
+	std::shared_mutex _mutex;
+
+	robin_hood::unordered_node_map<u32, NDBCEntry> _nameHashToEntry; // Nodes are stable, so File pointers handed out stay valid
 	std::vector<std::string> _loadedNDBCFileNames;
-};
+};
\ No newline at end of file
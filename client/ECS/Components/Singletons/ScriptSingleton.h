@@ -1,18 +1,37 @@
 #pragma once
 #include <NovusTypes.h>
+#include <entity/entity.hpp>
+#include <robin_hood.h>
 #include <vector>
+#include <memory>
 #include <mutex>
 #include <atomic>
-#include <functional>
-#include <Utils/ConcurrentQueue.h>
+#include <cstring>
+#include <type_traits>
+#include <thread>
+#include <algorithm>
+
+enum ScriptTransactionFlags : u8
+{
+    SCRIPT_TRANSACTION_FLAG_NONE = 0,
+    SCRIPT_TRANSACTION_FLAG_COALESCE = 1 << 0 // Only the last transaction of this kind for the entity runs, for "set" style mutations
+};
+
+// A POD command, the payload is copied in by value so recording never allocates once the arenas have grown
+struct ScriptTransaction
+{
+    static constexpr size_t MAX_PAYLOAD_SIZE = 32;
+
+    void (*execute)(entt::entity entity, const u8* payload);
+    u64 sequence; // Global recording order, arenas are drained per thread so this restores the order across threads
+    entt::entity entity;
+    u8 flags;
+    alignas(16) u8 payload[MAX_PAYLOAD_SIZE];
+};
 
 struct ScriptSingleton
 {
-    ScriptSingleton() : _systemCompleteCount(0), _queueCreateLock(), _transactionQueues()
-    {
-        _transactionQueues.reserve(16);
-        _transactionQueues.push_back(moodycamel::ConcurrentQueue<std::function<void()>>());
-    }
+    ScriptSingleton() : _systemCompleteCount(0), _generation(_nextGeneration++) { }
 
     ScriptSingleton& operator=(const ScriptSingleton& o)
     {
@@ -22,11 +41,6 @@ struct ScriptSingleton
     void CompleteSystem()
     {
         _systemCompleteCount++;
-        if (_systemCompleteCount >= _transactionQueues.size())
-        {
-            std::lock_guard lock(_queueCreateLock);
-            _transactionQueues.push_back(moodycamel::ConcurrentQueue<std::function<void()>>());
-        }
     }
 
     void ResetCompletedSystems()
@@ -34,25 +48,127 @@ struct ScriptSingleton
         _systemCompleteCount = 0;
     }
 
-    void AddTransaction(std::function<void()> const& transaction)
+    // Records Function(entity, data) to run on the main thread in ExecuteTransactions
+    template <auto Function, typename T>
+    void AddTransaction(entt::entity entity, const T& data, u8 flags = SCRIPT_TRANSACTION_FLAG_NONE)
     {
-        _transactionQueues[_systemCompleteCount].enqueue(transaction);
+        static_assert(std::is_trivially_copyable_v<T>, "ScriptSingleton: Transaction data must be trivially copyable");
+        static_assert(sizeof(T) <= ScriptTransaction::MAX_PAYLOAD_SIZE, "ScriptSingleton: Transaction data is too big");
+
+        TransactionArena* arena = GetThreadArena();
+        std::lock_guard lock(arena->mutex);
+
+        ScriptTransaction& transaction = arena->transactions.emplace_back();
+        transaction.execute = &Execute<Function, T>;
+        transaction.sequence = _nextSequence.fetch_add(1, std::memory_order_relaxed);
+        transaction.entity = entity;
+        transaction.flags = flags;
+        std::memcpy(transaction.payload, &data, sizeof(T));
     }
 
     void ExecuteTransactions()
     {
-        for (moodycamel::ConcurrentQueue<std::function<void()>>& transactionQueue : _transactionQueues)
+        // Every arena is drained into one buffer so coalescing sees the whole frame
         {
-            std::function<void()> transaction;
-            while (transactionQueue.try_dequeue(transaction))
+            std::lock_guard lock(_arenasMutex);
+            for (auto& pair : _arenas)
             {
-                transaction();
+                std::unique_ptr<TransactionArena>& arena = pair.second;
+                std::lock_guard arenaLock(arena->mutex);
+                _executing.insert(_executing.end(), arena->transactions.begin(), arena->transactions.end());
+                arena->transactions.clear();
             }
         }
+
+        if (_executing.size() == 0)
+            return;
+
+        std::sort(_executing.begin(), _executing.end(), [](const ScriptTransaction& a, const ScriptTransaction& b) { return a.sequence < b.sequence; });
+
+        // Remember the last index of every coalescable transaction, anything earlier for the same entity and command is skipped
+        _lastCoalesced.clear();
+        for (u32 i = 0; i < _executing.size(); i++)
+        {
+            const ScriptTransaction& transaction = _executing[i];
+            if (transaction.flags & SCRIPT_TRANSACTION_FLAG_COALESCE)
+                _lastCoalesced[{ transaction.entity, transaction.execute }] = i;
+        }
+
+        for (u32 i = 0; i < _executing.size(); i++)
+        {
+            const ScriptTransaction& transaction = _executing[i];
+            if (transaction.flags & SCRIPT_TRANSACTION_FLAG_COALESCE && _lastCoalesced[{ transaction.entity, transaction.execute }] != i)
+                continue;
+
+            transaction.execute(transaction.entity, transaction.payload);
+        }
+
+        _executing.clear();
     }
 
 private:
+    struct TransactionArena
+    {
+        std::mutex mutex; // Only contended while ExecuteTransactions drains it
+        std::vector<ScriptTransaction> transactions;
+    };
+
+    struct CoalesceKey
+    {
+        entt::entity entity;
+        void (*execute)(entt::entity entity, const u8* payload);
+
+        bool operator==(const CoalesceKey& other) const { return entity == other.entity && execute == other.execute; }
+    };
+    struct CoalesceKeyHash
+    {
+        size_t operator()(const CoalesceKey& key) const
+        {
+            return robin_hood::hash_int(static_cast<u64>(entt::to_integral(key.entity)) ^ reinterpret_cast<u64>(key.execute));
+        }
+    };
+
+    template <auto Function, typename T>
+    static void Execute(entt::entity entity, const u8* payload)
+    {
+        T data;
+        std::memcpy(&data, payload, sizeof(T));
+        Function(entity, data);
+    }
+
+    // Each thread records into its own arena, they're kept for the lifetime of the singleton and only ever cleared
+    // The thread_local only caches the lookup, it's keyed on the singleton's generation so a new singleton at the same address never reuses a stale arena
+    TransactionArena* GetThreadArena()
+    {
+        thread_local u64 cachedGeneration = INVALID_GENERATION;
+        thread_local TransactionArena* cachedArena = nullptr;
+
+        if (cachedGeneration != _generation)
+        {
+            std::lock_guard lock(_arenasMutex);
+
+            std::unique_ptr<TransactionArena>& arena = _arenas[std::this_thread::get_id()];
+            if (!arena)
+                arena = std::make_unique<TransactionArena>();
+
+            cachedArena = arena.get();
+            cachedGeneration = _generation;
+        }
+
+        return cachedArena;
+    }
+
+private:
+    static constexpr u64 INVALID_GENERATION = 0;
+    static inline std::atomic<u64> _nextGeneration = 1;
+    static inline std::atomic<u64> _nextSequence = 0;
+
     std::atomic<u32> _systemCompleteCount;
-    std::mutex _queueCreateLock;
-    std::vector<moodycamel::ConcurrentQueue<std::function<void()>>> _transactionQueues;
-};
\ No newline at end of file
+    const u64 _generation;
+
+    std::mutex _arenasMutex;
+    robin_hood::unordered_map<std::thread::id, std::unique_ptr<TransactionArena>> _arenas;
+
+    std::vector<ScriptTransaction> _executing;
+    robin_hood::unordered_map<CoalesceKey, u32, CoalesceKeyHash> _lastCoalesced;
+};
@@ -1,6 +1,7 @@
 #include "AreaUpdateSystem.h"
 #include "../../Utils/ServiceLocator.h"
 #include "../../Utils/MapUtils.h"
+#include "../../Loaders/NDBC/NDBCQuery.h"
 #include "../../Rendering/CameraOrbital.h"
 #include "../../Rendering/CameraFreeLook.h"
 #include "../Components/Singletons/TimeSingleton.h"
@@ -82,8 +83,19 @@ void AreaUpdateSystem::Update(entt::registry& registry)
 
         // Get Lights
 
-        std::vector<NDBC::Light*>* lights = mapSingleton.GetLightsByMapId(currentMap.id);
-        if (lights)
+        u32 lightGeneration = lightNDBC->GetQueryGeneration();
+        if (areaUpdateSingleton.mapLightFile != lightNDBC || areaUpdateSingleton.mapLightMapId != currentMap.id || areaUpdateSingleton.mapLightGeneration != lightGeneration)
+        {
+            NDBC::Query lightQuery(lightNDBC);
+            lightQuery.WhereEquals(NDBC_COLUMN(NDBC::Light, mapId), currentMap.id);
+
+            areaUpdateSingleton.mapLightRowIndices = lightQuery.GetRowIndices();
+            areaUpdateSingleton.mapLightFile = lightNDBC;
+            areaUpdateSingleton.mapLightMapId = currentMap.id;
+            areaUpdateSingleton.mapLightGeneration = lightGeneration;
+        }
+
+        if (areaUpdateSingleton.mapLightRowIndices.size() > 0)
         {
             std::vector<AreaUpdateLightData> innerRadiusLights;
             innerRadiusLights.reserve(4);
@@ -91,8 +103,9 @@ void AreaUpdateSystem::Update(entt::registry& registry)
             std::vector<AreaUpdateLightData> outerRadiusLights;
             outerRadiusLights.reserve(4);
 
-            for (NDBC::Light* light : *lights)
+            for (u32 rowIndex : areaUpdateSingleton.mapLightRowIndices)
             {
+                NDBC::Light* light = lightNDBC->GetRowByIndex<NDBC::Light>(rowIndex);
                 const vec3& lightPosition = light->position;
 
                 // LightPosition of (0,0,0) means default, override!
@@ -1,80 +1,89 @@
 #include "ConnectionSystems.h"
 #include <entt.hpp>
 #include <tracy/Tracy.hpp>
+#include <iterator>
 #include <Networking/MessageHandler.h>
 #include <Networking/NetworkClient.h>
 #include "../../Components/Network/ConnectionSingleton.h"
 #include "../../Components/Network/AuthenticationSingleton.h"
 #include "../../../Utils/ServiceLocator.h"
 
-void ConnectionUpdateSystem::Update(entt::registry& registry)
+// Packets are moved between the IO thread and the update thread in batches of this size
+constexpr size_t PACKET_BATCH_SIZE = 64;
+
+// Dispatches every queued packet, returns false if a handler failed and the connection was closed
+static bool HandlePackets(std::shared_ptr<NetworkClient>& connection, moodycamel::ConcurrentQueue<std::shared_ptr<NetworkPacket>>& packetQueue, MessageHandler* messageHandler)
 {
-    ZoneScopedNC("ConnectionUpdateSystem::Update", tracy::Color::Blue)
-    ConnectionSingleton& connectionSingleton = registry.ctx<ConnectionSingleton>();
+    std::shared_ptr<NetworkPacket> packets[PACKET_BATCH_SIZE];
+    moodycamel::ConsumerToken consumerToken(packetQueue);
 
-    if (connectionSingleton.authConnection)
+    size_t numPackets = 0;
+    while ((numPackets = packetQueue.try_dequeue_bulk(consumerToken, packets, PACKET_BATCH_SIZE)) > 0)
     {
-        std::shared_ptr<NetworkPacket> packet = nullptr;
-
-        MessageHandler* authSocketMessageHandler = ServiceLocator::GetAuthSocketMessageHandler();
-        while (connectionSingleton.authPacketQueue.try_dequeue(packet))
+        for (size_t i = 0; i < numPackets; i++)
         {
+            std::shared_ptr<NetworkPacket>& packet = packets[i];
 #ifdef NC_Debug
             DebugHandler::PrintSuccess("[Network/Socket]: CMD: %u, Size: %u", packet->header.opcode, packet->header.size);
 #endif // NC_Debug
 
-            if (!authSocketMessageHandler->CallHandler(connectionSingleton.authConnection, packet))
+            if (!messageHandler->CallHandler(connection, packet))
             {
-                connectionSingleton.authConnection->Close(asio::error::shut_down);
-                connectionSingleton.authConnection = nullptr;
-                return;
+                connection->Close(asio::error::shut_down);
+                connection = nullptr;
+                return false;
             }
-        }
-    }
-
-    if (connectionSingleton.gameConnection)
-    {
-        std::shared_ptr<NetworkPacket> packet = nullptr;
 
-        MessageHandler* gameSocketMessageHandler = ServiceLocator::GetGameSocketMessageHandler();
-        while (connectionSingleton.gamePacketQueue.try_dequeue(packet))
-        {
-#ifdef NC_Debug
-            DebugHandler::PrintSuccess("[Network/Socket]: CMD: %u, Size: %u", packet->header.opcode, packet->header.size);
-#endif // NC_Debug
-
-            if (!gameSocketMessageHandler->CallHandler(connectionSingleton.gameConnection, packet))
-            {
-                connectionSingleton.gameConnection->Close(asio::error::shut_down);
-                connectionSingleton.gameConnection = nullptr;
-                return;
-            }
+            // Hand the payload back to its pool now rather than when the batch gets overwritten
+            packet = nullptr;
         }
     }
+
+    return true;
 }
 
-void ConnectionUpdateSystem::AuthSocket_HandleConnect(BaseSocket* socket, bool connected)
+void ConnectionUpdateSystem::Update(entt::registry& registry)
 {
-    // The client initially will connect to a region server, from there on the client receives
-    // an IP address / port from that region server to the proper authentication server.
+    ZoneScopedNC("ConnectionUpdateSystem::Update", tracy::Color::Blue)
+    ConnectionSingleton& connectionSingleton = registry.ctx<ConnectionSingleton>();
 
-    if (connected)
+    if (connectionSingleton.authConnection)
     {
-        /* Send Initial Packet */
-        std::shared_ptr<Bytebuffer> buffer = Bytebuffer::Borrow<512>();
-        buffer->Put(Opcode::MSG_REQUEST_ADDRESS);
-        buffer->PutU16(0);
-        socket->Send(buffer);
+        MessageHandler* authSocketMessageHandler = ServiceLocator::GetAuthSocketMessageHandler();
+        if (!HandlePackets(connectionSingleton.authConnection, connectionSingleton.authPacketQueue, authSocketMessageHandler))
+            return;
+    }
 
-        socket->AsyncRead();
+    if (connectionSingleton.gameConnection)
+    {
+        MessageHandler* gameSocketMessageHandler = ServiceLocator::GetGameSocketMessageHandler();
+        if (!HandlePackets(connectionSingleton.gameConnection, connectionSingleton.gamePacketQueue, gameSocketMessageHandler))
+            return;
     }
 }
-void ConnectionUpdateSystem::AuthSocket_HandleRead(BaseSocket* socket)
+
+// Bytebuffer pools are size classed, borrow from the smallest class the payload fits in instead of always taking a full network buffer
+static std::shared_ptr<Bytebuffer> BorrowPayload(u16 size)
+{
+    if (size <= 128)
+        return Bytebuffer::Borrow<128>();
+    if (size <= 512)
+        return Bytebuffer::Borrow<512>();
+    if (size <= 1024)
+        return Bytebuffer::Borrow<1024>();
+    if (size <= 4096)
+        return Bytebuffer::Borrow<4096>();
+
+    return Bytebuffer::Borrow<NETWORK_BUFFER_SIZE>();
+}
+
+// Splits the receive buffer into packets and queues them for the update thread, returns false if the stream was malformed
+static bool ReadPackets(BaseSocket* socket, moodycamel::ConcurrentQueue<std::shared_ptr<NetworkPacket>>& packetQueue)
 {
-    entt::registry* gameRegistry = ServiceLocator::GetGameRegistry();
     std::shared_ptr<Bytebuffer> buffer = socket->GetReceiveBuffer();
 
-    ConnectionSingleton* connectionSingleton = &gameRegistry->ctx<ConnectionSingleton>();
+    std::shared_ptr<NetworkPacket> packets[PACKET_BATCH_SIZE];
+    size_t numPackets = 0;
 
     while (buffer->GetActiveSize())
     {
@@ -86,11 +95,13 @@ void ConnectionUpdateSystem::AuthSocket_HandleRead(BaseSocket* socket)
 
         if (size > NETWORK_BUFFER_SIZE)
         {
+            packetQueue.enqueue_bulk(std::make_move_iterator(packets), numPackets);
             socket->Close(asio::error::shut_down);
-            return;
+            return false;
         }
 
-        std::shared_ptr<NetworkPacket> packet = NetworkPacket::Borrow();
+        std::shared_ptr<NetworkPacket>& packet = packets[numPackets++];
+        packet = NetworkPacket::Borrow();
         {
             // Header
             {
@@ -102,19 +113,53 @@ void ConnectionUpdateSystem::AuthSocket_HandleRead(BaseSocket* socket)
             {
                 if (size)
                 {
-                    packet->payload = Bytebuffer::Borrow<NETWORK_BUFFER_SIZE>();
+                    packet->payload = BorrowPayload(size);
                     packet->payload->size = size;
                     packet->payload->writtenData = size;
                     std::memcpy(packet->payload->GetDataPointer(), buffer->GetReadPointer(), size);
                 }
             }
+        }
 
-            connectionSingleton->authPacketQueue.enqueue(packet);
+        if (numPackets == PACKET_BATCH_SIZE)
+        {
+            packetQueue.enqueue_bulk(std::make_move_iterator(packets), numPackets);
+            numPackets = 0;
         }
 
         buffer->readData += size;
     }
 
+    if (numPackets > 0)
+        packetQueue.enqueue_bulk(std::make_move_iterator(packets), numPackets);
+
+    return true;
+}
+
+void ConnectionUpdateSystem::AuthSocket_HandleConnect(BaseSocket* socket, bool connected)
+{
+    // The client initially will connect to a region server, from there on the client receives
+    // an IP address / port from that region server to the proper authentication server.
+
+    if (connected)
+    {
+        /* Send Initial Packet */
+        std::shared_ptr<Bytebuffer> buffer = Bytebuffer::Borrow<512>();
+        buffer->Put(Opcode::MSG_REQUEST_ADDRESS);
+        buffer->PutU16(0);
+        socket->Send(buffer);
+
+        socket->AsyncRead();
+    }
+}
+void ConnectionUpdateSystem::AuthSocket_HandleRead(BaseSocket* socket)
+{
+    entt::registry* gameRegistry = ServiceLocator::GetGameRegistry();
+    ConnectionSingleton* connectionSingleton = &gameRegistry->ctx<ConnectionSingleton>();
+
+    if (!ReadPackets(socket, connectionSingleton->authPacketQueue))
+        return;
+
     socket->AsyncRead();
 }
 void ConnectionUpdateSystem::AuthSocket_HandleDisconnect(BaseSocket* socket)
@@ -157,48 +202,10 @@ void ConnectionUpdateSystem::GameSocket_HandleConnect(BaseSocket* socket, bool c
 void ConnectionUpdateSystem::GameSocket_HandleRead(BaseSocket* socket)
 {
     entt::registry* gameRegistry = ServiceLocator::GetGameRegistry();
-    std::shared_ptr<Bytebuffer> buffer = socket->GetReceiveBuffer();
-
     ConnectionSingleton* connectionSingleton = &gameRegistry->ctx<ConnectionSingleton>();
 
-    while (buffer->GetActiveSize())
-    {
-        Opcode opcode = Opcode::INVALID;
-        u16 size = 0;
-
-        buffer->Get(opcode);
-        buffer->GetU16(size);
-
-        if (size > NETWORK_BUFFER_SIZE)
-        {
-            socket->Close(asio::error::shut_down);
-            return;
-        }
-
-        std::shared_ptr<NetworkPacket> packet = NetworkPacket::Borrow();
-        {
-            // Header
-            {
-                packet->header.opcode = opcode;
-                packet->header.size = size;
-            }
-
-            // Payload
-            {
-                if (size)
-                {
-                    packet->payload = Bytebuffer::Borrow<NETWORK_BUFFER_SIZE>();
-                    packet->payload->size = size;
-                    packet->payload->writtenData = size;
-                    std::memcpy(packet->payload->GetDataPointer(), buffer->GetReadPointer(), size);
-                }
-            }
-
-            connectionSingleton->gamePacketQueue.enqueue(packet);
-        }
-
-        buffer->readData += size;
-    }
+    if (!ReadPackets(socket, connectionSingleton->gamePacketQueue))
+        return;
 
     socket->AsyncRead();
 }
@@ -39,7 +39,6 @@ namespace Editor
 
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         MapSingleton& mapSingleton = registry->ctx<MapSingleton>();
-        NDBCSingleton& ndbcSingleton = registry->ctx<NDBCSingleton>();
 
         ClientRenderer* clientRenderer = ServiceLocator::GetClientRenderer();
         DebugRenderer* debugRenderer = clientRenderer->GetDebugRenderer();
@@ -89,8 +88,6 @@ namespace Editor
                     {
                         if (hasNewSelection) 
                         {
-                            NDBC::File* areaTableFile = ndbcSingleton.GetNDBCFile("AreaTable"_h);
-
                             const u32 packedChunkCellID = pixelData.value;
                             u32 cellID = packedChunkCellID & 0xffff;
                             u32 chunkID = packedChunkCellID >> 16;
@@ -145,16 +142,6 @@ namespace Editor
 
                             _selectedTerrainData.chunk = chunk;
                             _selectedTerrainData.cell = &_selectedTerrainData.chunk->cells[_selectedTerrainData.cellId];
-
-                            
-                            _selectedTerrainData.zone = _selectedTerrainData.cell ? areaTableFile->GetRowById<NDBC::AreaTable>(_selectedTerrainData.cell->areaId) : nullptr;
-                            _selectedTerrainData.area = nullptr;
-
-                            if (_selectedTerrainData.zone && _selectedTerrainData.zone->parentId)
-                            {
-                                _selectedTerrainData.area = _selectedTerrainData.zone;
-                                _selectedTerrainData.zone = areaTableFile->GetRowById<NDBC::AreaTable>(_selectedTerrainData.area->parentId);
-                            }
                         }
 
                         TerrainSelectionDrawImGui();
@@ -309,8 +296,9 @@ namespace Editor
         if (!chunk || !cell)
             return;
 
-        const NDBC::AreaTable* zone = _selectedTerrainData.zone;
-        const NDBC::AreaTable* area = _selectedTerrainData.area;
+        // Looked up every draw, the NDBC editor can move or unmap the rows while the selection is kept
+        const NDBC::AreaTable* zone = areaTableFile->GetRowById<NDBC::AreaTable>(cell->areaId);
+        const NDBC::AreaTable* area = nullptr;
 
         if (zone && zone->parentId)
         {
@@ -361,6 +349,10 @@ namespace Editor
         const std::vector<MapObjectRenderer::InstanceLookupData>& instanceLookupDatas = mapObjectRenderer->GetInstanceLookupData();
         const std::vector<MapObjectRenderer::LoadedMapObject>& loadedMapObjects = mapObjectRenderer->GetLoadedMapObjects();
 
+        // The selected MapObject might have been streamed out since we picked it
+        if (_selectedMapObjectData.instanceLookupDataID >= instanceLookupDatas.size())
+            return;
+
         const MapObjectRenderer::InstanceLookupData& instanceLookupData = instanceLookupDatas[_selectedMapObjectData.instanceLookupDataID];
         const MapObjectRenderer::LoadedMapObject& loadedMapObject = loadedMapObjects[instanceLookupData.loadedObjectID];
         const mat4x4& instanceMatrix = mapObjectRenderer->GetInstances()[instanceLookupData.instanceID].instanceMatrix;
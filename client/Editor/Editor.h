@@ -66,9 +66,6 @@ namespace Editor
 
             Terrain::Chunk* chunk;
             Terrain::Cell* cell;
-
-            NDBC::AreaTable* zone;
-            NDBC::AreaTable* area;
         } _selectedTerrainData;
 
         struct SelectedMapObjectData
@@ -135,9 +135,17 @@ bool NDBCEditorHandler::DeleteSelectedNDBC()
     if (fs::is_directory(outputPath) || !fs::is_regular_file(outputPath))
         return false;
 
+    // Release the mapping first, mapped files can't be deleted everywhere
+    NDBC::File* file = ndbcSingleton.GetNDBCFile(ndbcNameHash);
+    if (file)
+        file->ReleaseMapping();
+
     if (!fs::remove(outputPath))
         return false;
 
+    std::error_code errorCode;
+    fs::remove(outputPath.string() + "idx", errorCode);
+
     const std::vector<std::string>& loadedNDBCFileNames = ndbcSingleton.GetLoadedNDBCFileNames();
     u32 numNDBCNames = static_cast<u32>(loadedNDBCFileNames.size());
 
@@ -163,10 +171,18 @@ bool NDBCEditorHandler::SaveSelectedNDBC()
     fs::path ndbcPath = fs::absolute("Data/extracted/Ndbc");
     fs::path outputPath = (ndbcPath / ndbcName).replace_extension("ndbc");
 
-    std::ofstream output(outputPath, std::ofstream::out | std::ofstream::binary);
-    {
-        NDBC::File* file = ndbcSingleton.GetNDBCFile(ndbcNameHash);
+    NDBC::File* file = ndbcSingleton.GetNDBCFile(ndbcNameHash);
+    if (!file)
+        return false;
 
+    file->MakeWritable();
+
+    // Mapped files can't be overwritten everywhere, so we write next to it and swap it in once the mapping is released
+    fs::path tempPath = outputPath;
+    tempPath += ".tmp";
+
+    std::ofstream output(tempPath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    {
         DynamicBytebuffer*& fileBuffer = file->GetBuffer();
         DynamicBytebuffer* buffer = new DynamicBytebuffer(fileBuffer->size);
         std::vector<NDBC::NDBCColumn>& columns = file->GetColumns();
@@ -211,6 +227,21 @@ bool NDBCEditorHandler::SaveSelectedNDBC()
         output.write(reinterpret_cast<char const*>(buffer->GetDataPointer()), buffer->writtenData);
         output.close();
 
+        file->ReleaseMapping();
+
+        std::error_code errorCode;
+        fs::rename(tempPath, outputPath, errorCode);
+        if (errorCode)
+        {
+            DebugHandler::PrintError("Failed to replace %s during NDBCEditorHandler::SaveSelectedNDBC() (%s)", outputPath.string().c_str(), errorCode.message().c_str());
+            fs::remove(tempPath, errorCode);
+            delete buffer;
+            return false;
+        }
+
+        // The id index sidecar describes the old file, it gets rebuilt the next time the file is opened
+        fs::remove(outputPath.string() + "idx", errorCode);
+
         delete fileBuffer;
         fileBuffer = buffer;
     }
@@ -441,6 +472,11 @@ void NDBCEditorHandler::DrawDefaultLayout()
 
     u32 dbcNameHash = StringUtils::fnv1a_32(_selectedNDBC, strlen(_selectedNDBC));
     NDBC::File* file = ndbcSingleton.GetNDBCFile(dbcNameHash);
+    if (!file)
+        return;
+
+    // Rows are edited in place below
+    file->MakeWritable();
     DynamicBytebuffer*& fileBuffer = file->GetBuffer();
     std::vector<NDBC::NDBCColumn>& columns = file->GetColumns();
 
@@ -480,12 +516,14 @@ void NDBCEditorHandler::DrawDefaultLayout()
             if (isFloat)
             {
                 f32* value = reinterpret_cast<f32*>(&fileBuffer->GetDataPointer()[file->GetBufferOffsetToRowData() + finalOffset]);
-                ImGui::InputFloat("", value);
+                if (ImGui::InputFloat("", value))
+                    file->InvalidateQueryCaches();
             }
             else
             {
                 i32* value = reinterpret_cast<i32*>(&fileBuffer->GetDataPointer()[file->GetBufferOffsetToRowData() + finalOffset]);
-                ImGui::InputInt("", value);
+                if (ImGui::InputInt("", value))
+                    file->InvalidateQueryCaches();
             }
 
             ImGui::NextColumn();
@@ -6,6 +6,7 @@
 
 #include <SceneManager.h>
 #include <Renderer/Renderer.h>
+#include <Renderer/Font.h>
 #include "Rendering/ClientRenderer.h"
 #include "Rendering/TerrainRenderer.h"
 #include "Rendering/MapObjectRenderer.h"
@@ -42,6 +43,7 @@
 
 #include "UI/ECS/Systems/DeleteElementsSystem.h"
 #include "UI/ECS/Systems/UpdateRenderingSystem.h"
+#include "UI/ECS/Systems/UpdateLayoutSystem.h"
 #include "UI/ECS/Systems/UpdateBoundsSystem.h"
 #include "UI/ECS/Systems/UpdateCullingSystem.h"
 #include "UI/ECS/Systems/BuildSortKeySystem.h"
@@ -302,6 +304,9 @@ void EngineLoop::Run()
     }
 
     // Clean up stuff here
+    Renderer::Font::Deinit();
+    ServiceLocator::GetRenderer()->SavePipelineCache();
+
     Message exitMessage;
     exitMessage.code = MSG_OUT_EXIT_CONFIRM;
     _outputQueue.enqueue(exitMessage);
@@ -434,13 +439,24 @@ void EngineLoop::SetupUpdateFramework()
 
     /* UI SYSTEMS */
     // DeleteElementsSystem
-    /*tf::Task uiDeleteElementSystem = framework.emplace([&uiRegistry, &gameRegistry]()
+    tf::Task uiDeleteElementSystem = framework.emplace([&uiRegistry, &gameRegistry]()
     {
         ZoneScopedNC("DeleteElementsSystem::Update", tracy::Color::Gainsboro);
         UISystem::DeleteElementsSystem::Update(uiRegistry);
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
 
+    // UpdateLayoutSystem
+    tf::Task uiUpdateLayoutSystemTask = framework.emplace([&uiRegistry, &gameRegistry]()
+    {
+        ZoneScopedNC("UpdateLayoutSystem::Update", tracy::Color::Gainsboro);
+        UISystem::UpdateLayoutSystem::Update(uiRegistry);
+        gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
+    });
+    uiUpdateLayoutSystemTask.gather(uiDeleteElementSystem);
+
+    // The systems below only read the layout and each write their own components, so they run side by side
+
     // UpdateRenderingSystem
     tf::Task uiUpdateRenderingSystem = framework.emplace([&uiRegistry, &gameRegistry]()
     {
@@ -448,7 +464,7 @@ void EngineLoop::SetupUpdateFramework()
         UISystem::UpdateRenderingSystem::Update(uiRegistry);
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
-    uiUpdateRenderingSystem.gather(uiDeleteElementSystem);
+    uiUpdateRenderingSystem.gather(uiUpdateLayoutSystemTask);
 
     // UpdateBoundsSystem
     tf::Task uiUpdateBoundsSystemTask = framework.emplace([&uiRegistry, &gameRegistry]()
@@ -457,7 +473,7 @@ void EngineLoop::SetupUpdateFramework()
         UISystem::UpdateBoundsSystem::Update(uiRegistry);
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
-    uiUpdateRenderingSystem.gather(uiDeleteElementSystem);
+    uiUpdateBoundsSystemTask.gather(uiUpdateLayoutSystemTask);
 
     // UpdateCullingSystem
     tf::Task uiUpdateCullingSystemTask = framework.emplace([&uiRegistry, &gameRegistry]()
@@ -466,7 +482,7 @@ void EngineLoop::SetupUpdateFramework()
         UISystem::UpdateCullingSystem::Update(uiRegistry);
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
-    uiUpdateRenderingSystem.gather(uiDeleteElementSystem);
+    uiUpdateCullingSystemTask.gather(uiUpdateLayoutSystemTask);
     
     // BuildSortKeySystem
     tf::Task uiBuildSortKeySystemTask = framework.emplace([&uiRegistry, &gameRegistry]()
@@ -475,18 +491,19 @@ void EngineLoop::SetupUpdateFramework()
         UISystem::BuildSortKeySystem::Update(uiRegistry);
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
-    uiUpdateRenderingSystem.gather(uiDeleteElementSystem);
+    uiBuildSortKeySystemTask.gather(uiUpdateLayoutSystemTask);
 
     // FinalCleanUpSystem
     tf::Task uiFinalCleanUpSystemTask = framework.emplace([&uiRegistry, &gameRegistry]()
     {
-        ZoneScopedNC("UpdateRenderingSystem::Update", tracy::Color::Gainsboro);
+        ZoneScopedNC("FinalCleanUpSystem::Update", tracy::Color::Gainsboro);
         UISystem::FinalCleanUpSystem::Update(uiRegistry);
         gameRegistry.ctx<ScriptSingleton>().CompleteSystem();
     });
     uiFinalCleanUpSystemTask.gather(uiUpdateRenderingSystem);
+    uiFinalCleanUpSystemTask.gather(uiUpdateBoundsSystemTask);
     uiFinalCleanUpSystemTask.gather(uiUpdateCullingSystemTask);
-    uiFinalCleanUpSystemTask.gather(uiBuildSortKeySystemTask);*/
+    uiFinalCleanUpSystemTask.gather(uiBuildSortKeySystemTask);
     /* END UI SYSTEMS */
 
     // MovementSystem
@@ -541,7 +558,7 @@ void EngineLoop::SetupUpdateFramework()
         gameRegistry.ctx<ScriptSingleton>().ExecuteTransactions();
         gameRegistry.ctx<ScriptSingleton>().ResetCompletedSystems();
     });
-    //scriptSingletonTask.gather(uiFinalCleanUpSystemTask);
+    scriptSingletonTask.gather(uiFinalCleanUpSystemTask);
     scriptSingletonTask.gather(renderModelSystemTask);
 }
 void EngineLoop::SetupMessageHandler()
@@ -768,6 +785,9 @@ void EngineLoop::DrawMapStats()
                 ImGui::Text("Instance Type:     %s", instanceType.c_str());
                 ImGui::Text("Max Players:       %u", map->maxPlayers);
                 ImGui::Text("Expansion:         %u", map->expansion);
+
+                ImGui::Spacing();
+                ImGui::Text("Load Time:         %.2f ms", _clientRenderer->GetTerrainRenderer()->GetLastMapLoadTime() * 1000.0f);
             }
 
             ImGui::EndTabItem();
@@ -781,16 +801,21 @@ void EngineLoop::DrawMapStats()
             }
             else
             {
+                TerrainRenderer* terrainRenderer = _clientRenderer->GetTerrainRenderer();
+
                 if (currentMap.header.flags.UseMapObjectInsteadOfTerrain)
                 {
                     ImGui::Text("Loaded World Object:           %s", currentMap.header.mapObjectName.c_str());
                 }
                 else
                 {
-                    ImGui::Text("Loaded Chunks:                 %u", currentMap.chunks.size());
+                    ImGui::Text("Chunks On Disk:                %u", static_cast<u32>(currentMap.GetNumChunks()));
+                    ImGui::Text("Decoded Chunks:                %u", static_cast<u32>(currentMap.GetNumDecodedChunks()));
+                    ImGui::Text("Resident Chunks:               %u / %u", terrainRenderer->GetNumResidentChunks(), terrainRenderer->GetNumChunkSlots());
+                    ImGui::Text("Chunks Pending Stream In:      %u", terrainRenderer->GetNumChunksPendingLoad());
+                    ImGui::Text("Resident Terrain Textures:     %u", terrainRenderer->GetNumResidentColorTextures());
                 }
 
-                TerrainRenderer* terrainRenderer = _clientRenderer->GetTerrainRenderer();
                 MapObjectRenderer* mapObjectRenderer = terrainRenderer->GetMapObjectRenderer();
                 CModelRenderer* cModelRenderer = _clientRenderer->GetCModelRenderer();
 
@@ -891,6 +916,10 @@ void EngineLoop::DrawMemoryStats()
     f32 vramMinPercent = (static_cast<f32>(vramUsage) / static_cast<f32>(vramMinBudget)) * 100;
 
     ImGui::Text("VRAM Usage (Min specs): %luMB / %luMB (%.2f%%)", vramUsage, vramMinBudget, vramMinPercent);
+
+    // Transient rendertargets with non overlapping lifetimes share memory
+    size_t vramTransientSaved = _clientRenderer->GetTransientVRAMSaved() / 1000000;
+    ImGui::Text("VRAM Saved (Transient aliasing): %luMB", vramTransientSaved);
 }
 
 void EngineLoop::DrawImguiMenuBar()
@@ -1109,6 +1138,24 @@ void EngineLoop::DrawPerformance(EngineStatsSingleton* stats)
         DrawCullingStatsEntry("Total", totalTriangles, totalTrianglesSurvived, !showTriangles);
     }
 
+    ImGui::Spacing();
+    ImGui::Spacing();
+    ImGui::Text("Descriptor Sets");
+    ImGui::Separator();
+
+    // Descriptor set cache
+    {
+        Renderer::Renderer* renderer = ServiceLocator::GetRenderer();
+
+        u32 cacheHits = renderer->GetNumDescriptorSetCacheHits();
+        u32 cacheMisses = renderer->GetNumDescriptorSetCacheMisses();
+        u32 totalBinds = cacheHits + cacheMisses;
+        f32 hitPercent = totalBinds > 0 ? static_cast<f32>(cacheHits) / static_cast<f32>(totalBinds) * 100.0f : 0.0f;
+
+        ImGui::Text("Cache Hits / Misses: %u / %u (%.0f%%)", cacheHits, cacheMisses, hitPercent);
+        ImGui::Text("Cached Sets: %u", renderer->GetNumCachedDescriptorSets());
+    }
+
     ImGui::Spacing();
     ImGui::Spacing();
     ImGui::Text("Frametimes");
@@ -8,6 +8,11 @@ bool Terrain::Chunk::Read(FileReader& reader, Terrain::Chunk& chunk, StringTable
     Bytebuffer buffer(nullptr, reader.Length());
     reader.Read(&buffer, buffer.size);
 
+    return Read(buffer, chunk, stringTable);
+}
+
+bool Terrain::Chunk::Read(Bytebuffer& buffer, Terrain::Chunk& chunk, StringTable& stringTable)
+{
     buffer.Get<Terrain::ChunkHeader>(chunk.chunkHeader);
 
     if (chunk.chunkHeader.token != Terrain::MAP_CHUNK_TOKEN)
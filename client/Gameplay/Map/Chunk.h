@@ -35,6 +35,7 @@
 // A Cell consists of two interlapping grids. There is the 9*9 OUTER grid and the 8*8 INNER grid.
 
 class FileReader;
+class Bytebuffer;
 namespace Terrain
 {
     constexpr i32 MAP_CHUNK_TOKEN = 1128812107; // UTF8 -> Binary -> Decimal for "chnk"
@@ -199,6 +200,10 @@ namespace Terrain
         std::vector<u8> liquidvertexData;
 
         static bool Read(FileReader& reader, Terrain::Chunk& chunk, StringTable& stringTable);
+        static bool Read(Bytebuffer& buffer, Terrain::Chunk& chunk, StringTable& stringTable);
+
+        // Offset of the cells within a chunk file, lets us peek at the heights of a chunk without decoding all of it
+        static constexpr size_t CellsFileOffset = sizeof(ChunkHeader) + sizeof(HeightHeader) + sizeof(HeightBox);
     };
 #pragma pack(pop)
 }
\ No newline at end of file
@@ -1,10 +1,184 @@
 #include "Map.h"
+#include "../../Utils/MapUtils.h"
+#include "../../Utils/MemoryMappedFile.h"
 
 #include <Utils/ByteBuffer.h>
 #include <Utils/FileReader.h>
+#include <tracy/Tracy.hpp>
 
 namespace Terrain
 {
+    size_t Map::GetNumDecodedChunks()
+    {
+        std::scoped_lock lock(_chunkMutex);
+        return chunks.size();
+    }
+
+    bool Map::IsChunkDecoded(u16 chunkID)
+    {
+        std::scoped_lock lock(_chunkMutex);
+        return chunks.find(chunkID) != chunks.end();
+    }
+
+    Terrain::Chunk* Map::GetChunkById(u16 chunkID)
+    {
+        {
+            std::scoped_lock lock(_chunkMutex);
+
+            auto itr = chunks.find(chunkID);
+            if (itr != chunks.end())
+                return &itr->second;
+        }
+
+        MemoryMappedFile chunkFile;
+        if (!MapChunkFile(chunkID, chunkFile))
+            return nullptr;
+
+        return DecodeChunk(chunkID, chunkFile);
+    }
+
+    bool Map::MapChunkFile(u16 chunkID, MemoryMappedFile& chunkFile)
+    {
+        auto pathItr = chunkPaths.find(chunkID);
+        if (pathItr == chunkPaths.end())
+            return false;
+
+        ZoneScopedN("Map::MapChunkFile");
+
+        if (!chunkFile.Open(pathItr->second))
+        {
+            DebugHandler::PrintError("Failed to load map chunk (%s)", pathItr->second.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    Terrain::Chunk* Map::DecodeChunk(u16 chunkID, const MemoryMappedFile& chunkFile)
+    {
+        ZoneScopedN("Map::DecodeChunk");
+
+        // Decode outside of the lock so multiple threads can fault in different chunks at the same time
+        Bytebuffer buffer(const_cast<u8*>(chunkFile.GetData()), chunkFile.GetSize());
+        buffer.writtenData = chunkFile.GetSize();
+
+        std::unique_ptr<Terrain::Chunk> chunk = std::make_unique<Terrain::Chunk>(); // Too big to comfortably live on a worker thread's stack
+        StringTable chunkStringTable;
+        if (!Terrain::Chunk::Read(buffer, *chunk, chunkStringTable))
+        {
+            DebugHandler::PrintError("Failed to decode map chunk (%u)", chunkID);
+            return nullptr;
+        }
+
+        // Chunk borders first, that way the cell pass picks up the corrected corners of its neighbours
+        AlignChunkBorders(chunkID, *chunk);
+        Terrain::MapUtils::AlignCellBorders(*chunk);
+
+        std::scoped_lock lock(_chunkMutex);
+
+        // Someone else might have decoded the same chunk while we were busy
+        auto itr = chunks.find(chunkID);
+        if (itr != chunks.end())
+            return &itr->second;
+
+        Terrain::Chunk& insertedChunk = chunks[chunkID];
+        insertedChunk = std::move(*chunk);
+        stringTables[chunkID].CopyFrom(chunkStringTable);
+
+        return &insertedChunk;
+    }
+
+    StringTable* Map::GetStringTableById(u16 chunkID)
+    {
+        if (GetChunkById(chunkID) == nullptr)
+            return nullptr;
+
+        std::scoped_lock lock(_chunkMutex);
+        return &stringTables[chunkID];
+    }
+
+    void Map::AlignChunkBorders(u16 chunkID, Chunk& chunk)
+    {
+        // Neighbours might not be decoded yet, so rather than faulting them in we peek at their heights directly in the mapped files.
+        // The bottom row and right column of a cell are never touched by alignment, except for the top right corner which comes from the cell above it
+        u16 chunkX = chunkID % Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
+        u16 chunkY = chunkID / Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
+
+        MemoryMappedFile aboveFile;
+        MemoryMappedFile leftFile;
+        MemoryMappedFile aboveLeftFile;
+
+        auto MapNeighbour = [&](bool hasNeighbour, u16 neighbourID, MemoryMappedFile& file) -> const Terrain::Cell*
+        {
+            if (!hasNeighbour)
+                return nullptr;
+
+            auto pathItr = chunkPaths.find(neighbourID);
+            if (pathItr == chunkPaths.end())
+                return nullptr;
+
+            if (!file.Open(pathItr->second) || file.GetSize() < Terrain::Chunk::CellsFileOffset + sizeof(Terrain::Cell) * Terrain::MAP_CELLS_PER_CHUNK)
+                return nullptr;
+
+            return reinterpret_cast<const Terrain::Cell*>(file.GetData() + Terrain::Chunk::CellsFileOffset);
+        };
+
+        const Terrain::Cell* aboveCells = MapNeighbour(chunkY > 0, chunkID - Terrain::MAP_CHUNKS_PER_MAP_STRIDE, aboveFile);
+        const Terrain::Cell* leftCells = MapNeighbour(chunkX > 0, chunkID - 1, leftFile);
+        const Terrain::Cell* aboveLeftCells = MapNeighbour(chunkX > 0 && chunkY > 0, chunkID - Terrain::MAP_CHUNKS_PER_MAP_STRIDE - 1, aboveLeftFile);
+
+        if (aboveCells != nullptr)
+        {
+            u32 aboveStartCellID = Terrain::MAP_CELLS_PER_CHUNK - Terrain::MAP_CELLS_PER_CHUNK_SIDE;
+
+            for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK_SIDE; i++)
+            {
+                Terrain::Cell& currentCell = chunk.cells[i];
+                const Terrain::Cell& aboveCell = aboveCells[aboveStartCellID + i];
+
+                // Avoid fixing the very first height value within the cell grid (This is handled by "hasChunkLeft"
+                for (u32 currentHeightID = 1; currentHeightID < Terrain::MAP_CELL_OUTER_GRID_STRIDE; currentHeightID++)
+                {
+                    u32 aboveHeightID = currentHeightID + (Terrain::MAP_CELL_TOTAL_GRID_SIZE - Terrain::MAP_CELL_OUTER_GRID_STRIDE);
+                    memcpy(&currentCell.heightData[currentHeightID], &aboveCell.heightData[aboveHeightID], sizeof(f32));
+                }
+            }
+        }
+
+        if (leftCells != nullptr)
+        {
+            u32 leftStartCellID = Terrain::MAP_CELLS_PER_CHUNK_SIDE - 1;
+            u32 bottomRightHeightID = Terrain::MAP_CELL_TOTAL_GRID_SIZE - 1;
+
+            for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i += Terrain::MAP_CELLS_PER_CHUNK_SIDE)
+            {
+                Terrain::Cell& currentCell = chunk.cells[i];
+                const Terrain::Cell& leftCell = leftCells[leftStartCellID + i];
+
+                for (u32 currentHeightID = 0; currentHeightID < Terrain::MAP_CELL_TOTAL_GRID_SIZE; currentHeightID += Terrain::MAP_CELL_TOTAL_GRID_STRIDE)
+                {
+                    u32 aboveHeightID = currentHeightID + (Terrain::MAP_CELL_OUTER_GRID_STRIDE - 1);
+                    const f32* sourceHeight = &leftCell.heightData[aboveHeightID];
+
+                    // The top right corner of the left cell gets aligned to the cell above it, use that value directly
+                    if (currentHeightID == 0)
+                    {
+                        if (i > 0)
+                        {
+                            sourceHeight = &leftCells[leftStartCellID + i - Terrain::MAP_CELLS_PER_CHUNK_SIDE].heightData[bottomRightHeightID];
+                        }
+                        else if (aboveLeftCells != nullptr)
+                        {
+                            sourceHeight = &aboveLeftCells[Terrain::MAP_CELLS_PER_CHUNK - 1].heightData[bottomRightHeightID];
+                        }
+                    }
+
+                    memcpy(&currentCell.heightData[currentHeightID], sourceHeight, sizeof(f32));
+                }
+            }
+        }
+    }
+
     void Map::GetChunkPositionFromChunkId(u16 chunkId, u16& x, u16& y) const
     {
         x = chunkId % MAP_CHUNKS_PER_MAP_STRIDE;
@@ -15,7 +189,7 @@ namespace Terrain
     {
         chunkId = Math::FloorToInt(x) + (Math::FloorToInt(y) * MAP_CHUNKS_PER_MAP_STRIDE);
 
-        return chunks.find(chunkId) != chunks.end();
+        return HasChunk(chunkId);
     }
 
     bool MapHeader::Read(FileReader& reader, Terrain::MapHeader& header)
@@ -25,6 +25,7 @@
 #include <NovusTypes.h>
 #include <robin_hood.h>
 #include <limits>
+#include <mutex>
 #include <Containers/StringTable.h>
 #include "Chunk.h"
 
@@ -34,6 +35,7 @@
 // A Cell consists of two interlapping grids. There is the 9*9 OUTER grid and the 8*8 INNER grid.
 
 class FileReader;
+class MemoryMappedFile;
 namespace Terrain
 {
     constexpr f32 MAP_SIZE = MAP_CHUNK_SIZE * MAP_CHUNKS_PER_MAP_STRIDE; // yards
@@ -71,20 +73,29 @@ namespace Terrain
 
         u16 id = std::numeric_limits<u16>().max(); // Default Map to Invalid ID
         std::string_view name;
-        robin_hood::unordered_map<u16, Chunk> chunks;
-        robin_hood::unordered_map<u16, StringTable> stringTables;
+
+        // Every chunk this map has on disk, filled in by MapUtils::LoadMap without reading the chunks themselves
+        robin_hood::unordered_map<u16, std::string> chunkPaths;
+
+        // Chunks get decoded the first time someone asks for them through GetChunkById, these are node maps so pointers stay valid while others fault in
+        robin_hood::unordered_node_map<u16, Chunk> chunks;
+        robin_hood::unordered_node_map<u16, StringTable> stringTables;
 
         bool IsLoadedMap() { return id != std::numeric_limits<u16>().max(); }
         bool IsMapLoaded(u16 newId) { return id == newId; }
 
-        Terrain::Chunk* GetChunkById(u16 chunkID)
-        {
-            auto& itr = chunks.find(chunkID);
-            if (itr == chunks.end())
-                return nullptr;
+        bool HasChunk(u16 chunkID) const { return chunkPaths.find(chunkID) != chunkPaths.end(); }
+        size_t GetNumChunks() const { return chunkPaths.size(); }
+        size_t GetNumDecodedChunks();
+
+        Terrain::Chunk* GetChunkById(u16 chunkID);
+
+        // GetChunkById runs these two back to back, loaders that fault in many chunks at once can run them as separate stages instead
+        bool MapChunkFile(u16 chunkID, MemoryMappedFile& chunkFile);
+        Terrain::Chunk* DecodeChunk(u16 chunkID, const MemoryMappedFile& chunkFile);
+        bool IsChunkDecoded(u16 chunkID);
+        StringTable* GetStringTableById(u16 chunkID);
 
-            return &itr->second;
-        }
         void GetChunkPositionFromChunkId(u16 chunkId, u16& x, u16& y) const;
         bool GetChunkIdFromChunkPosition(u16 x, u16 y, u16& chunkId) const;
 
@@ -99,6 +110,9 @@ namespace Terrain
             header.mapObjectPlacement.rotation = vec3(0, 0, 0);
             header.mapObjectPlacement.scale = 0;
 
+            std::scoped_lock lock(_chunkMutex);
+
+            chunkPaths.clear();
             chunks.clear();
 
             for (auto& itr : stringTables)
@@ -107,5 +121,11 @@ namespace Terrain
             }
             stringTables.clear();
         }
+
+    private:
+        void AlignChunkBorders(u16 chunkID, Chunk& chunk);
+
+    private:
+        std::mutex _chunkMutex;
     };
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "../LoaderSystem.h"
 
 #include "../NDBC/NDBC.h"
+#include "../NDBC/NDBCQuery.h"
 #include "../../Utils/ServiceLocator.h"
 #include "../../Utils/MapUtils.h"
 #include "../../ECS/Components/Singletons/MapSingleton.h"
@@ -83,14 +84,8 @@ public:
             }
         }
 
-        // Add Lookup Table(s) for Light.ndbc
-        {
-            for (u32 i = 0; i < lightNDBC->GetNumRows(); i++)
-            {
-                NDBC::Light* light = lightNDBC->GetRowByIndex<NDBC::Light>(i);
-                mapSingleton.AddLightNDBC(light);
-            }
-        }
+        // Lights are looked up per map every frame, index them once instead of scanning
+        NDBC::BuildSecondaryIndex(lightNDBC, NDBC_COLUMN(NDBC::Light, mapId));
 
         return true;
     }
@@ -0,0 +1,422 @@
+#include "NDBC.h"
+#include <Utils/DebugHandler.h>
+#include <tracy/Tracy.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+namespace fs = std::filesystem;
+
+namespace NDBC
+{
+    // Reads the same layout DynamicBytebuffer writes, straight out of the mapping
+    struct MappedReader
+    {
+        const u8* data = nullptr;
+        size_t size = 0;
+        size_t offset = 0;
+
+        bool GetU32(u32& val)
+        {
+            if (offset + sizeof(u32) > size)
+                return false;
+
+            std::memcpy(&val, &data[offset], sizeof(u32));
+            offset += sizeof(u32);
+            return true;
+        }
+
+        bool GetString(std::string& val)
+        {
+            const u8* start = &data[offset];
+            const u8* terminator = static_cast<const u8*>(std::memchr(start, '\0', size - offset));
+            if (terminator == nullptr)
+                return false;
+
+            size_t length = terminator - start;
+            val.assign(reinterpret_cast<const char*>(start), length);
+            offset += length + 1;
+            return true;
+        }
+    };
+
+    static u64 GetWriteTime(const std::string& path)
+    {
+        std::error_code errorCode;
+        fs::file_time_type writeTime = fs::last_write_time(path, errorCode);
+        if (errorCode)
+            return 0;
+
+        return static_cast<u64>(writeTime.time_since_epoch().count());
+    }
+
+    bool File::Open(const std::string& path)
+    {
+        ZoneScoped;
+        Close();
+
+        _mappedFile = new MemoryMappedFile();
+        if (!_mappedFile->Open(path))
+        {
+            DebugHandler::PrintError("Failed to map NDBC file (%s)", path.c_str());
+            Close();
+            return false;
+        }
+
+        if (!ReadHeader(path))
+        {
+            Close();
+            return false;
+        }
+
+        if (!LoadIdIndex(path))
+        {
+            BuildIdIndex(path);
+        }
+
+        return true;
+    }
+
+    void File::Close()
+    {
+        delete _buffer;
+        delete _stringTable;
+        delete _mappedFile;
+        delete _retiredMappedFile;
+        delete _mappedIdIndex;
+
+        _buffer = nullptr;
+        _stringTable = nullptr;
+        _mappedFile = nullptr;
+        _retiredMappedFile = nullptr;
+        _mappedIdIndex = nullptr;
+
+        _header = NDBCHeader();
+        _columns.clear();
+        _numRows = 0;
+        _rowSize = 0;
+        _bufferOffsetToRowData = 0;
+
+        _idIndexHeader = IdIndexHeader();
+        _idIndex = nullptr;
+        _builtIdIndex.clear();
+
+        InvalidateQueryCaches();
+    }
+
+    void File::MakeWritable()
+    {
+        if (_mappedFile == nullptr)
+            return;
+
+        size_t size = _mappedFile->GetSize();
+
+        _buffer = new DynamicBytebuffer(size);
+        _buffer->PutBytes(const_cast<u8*>(_mappedFile->GetData()), size);
+
+        _retiredMappedFile = _mappedFile;
+        _mappedFile = nullptr;
+    }
+
+    void File::ReleaseMapping()
+    {
+        MakeWritable();
+
+        delete _retiredMappedFile;
+        _retiredMappedFile = nullptr;
+
+        // Keep the index around by copying it out, the sidecar itself has to be unmapped too
+        if (_mappedIdIndex)
+        {
+            _builtIdIndex.assign(_idIndex, _idIndex + _idIndexHeader.numEntries);
+            _idIndex = _builtIdIndex.data();
+
+            delete _mappedIdIndex;
+            _mappedIdIndex = nullptr;
+        }
+    }
+
+    bool File::ReadHeader(const std::string& path)
+    {
+        MappedReader reader;
+        reader.data = _mappedFile->GetData();
+        reader.size = _mappedFile->GetSize();
+
+        u32 numColumns = 0;
+        bool readHeaderSuccessfully = reader.GetU32(_header.token) && reader.GetU32(_header.version) && reader.GetU32(numColumns);
+        if (!readHeaderSuccessfully)
+        {
+            DebugHandler::PrintFatal("Attempted to load NDBC file (%s) with no header, try reextracting your data", path.c_str());
+            return false;
+        }
+
+        if (_header.token != NDBC::NDBC_TOKEN)
+        {
+            DebugHandler::PrintFatal("Attempted to load NDBC file (%s) with the wrong token, try reextracting your data", path.c_str());
+            return false;
+        }
+
+        if (_header.version != NDBC::NDBC_VERSION)
+        {
+            if (_header.version < NDBC::NDBC_VERSION)
+            {
+                DebugHandler::PrintFatal("Attempted to load NDBC file (%s) with older version of %u instead of expected version of %u, try reextracting your data", path.c_str(), _header.version, NDBC::NDBC_VERSION);
+            }
+            else
+            {
+                DebugHandler::PrintFatal("Attempted to load NDBC file (%s) with newer version of %u instead of expected version of %u, try updating your client", path.c_str(), _header.version, NDBC::NDBC_VERSION);
+            }
+
+            return false;
+        }
+
+        // Load String Name Indexes
+        _columns.resize(numColumns);
+        for (u32 i = 0; i < numColumns; i++)
+        {
+            NDBCColumn& column = _columns[i];
+
+            if (!reader.GetString(column.name) || !reader.GetU32(column.dataType))
+            {
+                DebugHandler::PrintFatal("Attempted to load NDBC file (%s) with corrupt column header data, try reextracting your data", path.c_str());
+                return false;
+            }
+        }
+
+        // All Columns are 4 bytes
+        _rowSize = numColumns * sizeof(u32);
+
+        if (!reader.GetU32(_numRows))
+        {
+            DebugHandler::PrintFatal("Attempted to load NDBC file (%s) with corrupt row data, try reextracting your data", path.c_str());
+            return false;
+        }
+
+        _bufferOffsetToRowData = reader.offset;
+
+        size_t rowDataBytes = static_cast<size_t>(_numRows) * _rowSize;
+        if (_bufferOffsetToRowData + rowDataBytes >= reader.size)
+        {
+            DebugHandler::PrintFatal("Attempted to load NDBC file (%s) with corrupt row data, try reextracting your data", path.c_str());
+            return false;
+        }
+
+        // The string table is the one part that gets deserialized, it's copied out of the mapping first since StringTable reads from a buffer
+        size_t stringTableOffset = _bufferOffsetToRowData + rowDataBytes;
+        size_t stringTableSize = reader.size - stringTableOffset;
+
+        DynamicBytebuffer stringTableBuffer(stringTableSize);
+        stringTableBuffer.PutBytes(const_cast<u8*>(&reader.data[stringTableOffset]), stringTableSize);
+
+        _stringTable = new StringTable();
+        if (!_stringTable->Deserialize(&stringTableBuffer))
+        {
+            DebugHandler::PrintFatal("Attempted to load NDBC file (%s) with corrupt StringTable data, try reextracting your data", path.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool File::LoadIdIndex(const std::string& path)
+    {
+        std::string indexPath = path + "idx";
+        if (!fs::is_regular_file(indexPath))
+            return false;
+
+        MemoryMappedFile* mappedIdIndex = new MemoryMappedFile();
+        if (!mappedIdIndex->Open(indexPath) || mappedIdIndex->GetSize() < sizeof(IdIndexHeader))
+        {
+            delete mappedIdIndex;
+            return false;
+        }
+
+        IdIndexHeader header;
+        std::memcpy(&header, mappedIdIndex->GetData(), sizeof(IdIndexHeader));
+
+        bool isValid = header.token == NDBC::NDBC_INDEX_TOKEN && header.version == NDBC::NDBC_INDEX_VERSION;
+        isValid &= header.ndbcSize == _mappedFile->GetSize() && header.ndbcWriteTime == GetWriteTime(path);
+        isValid &= mappedIdIndex->GetSize() == sizeof(IdIndexHeader) + static_cast<size_t>(header.numEntries) * sizeof(IdIndexEntry);
+
+        if (!isValid)
+        {
+            delete mappedIdIndex;
+            return false;
+        }
+
+        _idIndexHeader = header;
+        _idIndex = reinterpret_cast<const IdIndexEntry*>(&mappedIdIndex->GetData()[sizeof(IdIndexHeader)]);
+        _mappedIdIndex = mappedIdIndex;
+
+        return true;
+    }
+
+    void File::BuildIdIndex(const std::string& path)
+    {
+        ZoneScoped;
+
+        _idIndexHeader = IdIndexHeader();
+        _idIndexHeader.ndbcSize = _mappedFile->GetSize();
+        _idIndexHeader.ndbcWriteTime = GetWriteTime(path);
+        _builtIdIndex.clear();
+
+        const u8* rowData = &_mappedFile->GetData()[_bufferOffsetToRowData];
+
+        // Most tables are written with contiguous ids, those don't need any entries at all
+        bool isDense = true;
+        u32 firstId = 0;
+        for (u32 i = 0; i < _numRows; i++)
+        {
+            u32 id;
+            std::memcpy(&id, &rowData[static_cast<size_t>(i) * _rowSize], sizeof(u32));
+
+            if (i == 0)
+                firstId = id;
+
+            isDense &= id == firstId + i;
+            _builtIdIndex.push_back({ id, i });
+        }
+
+        if (isDense)
+        {
+            _builtIdIndex.clear();
+            _idIndexHeader.firstId = firstId;
+            _idIndexHeader.isDense = 1;
+        }
+        else
+        {
+            std::sort(_builtIdIndex.begin(), _builtIdIndex.end(), [](const IdIndexEntry& a, const IdIndexEntry& b) { return a.id < b.id || (a.id == b.id && a.rowIndex < b.rowIndex); });
+
+            // Duplicate ids resolve to the last row with that id
+            size_t numUnique = 0;
+            for (size_t i = 0; i < _builtIdIndex.size(); i++)
+            {
+                if (numUnique > 0 && _builtIdIndex[numUnique - 1].id == _builtIdIndex[i].id)
+                {
+                    _builtIdIndex[numUnique - 1] = _builtIdIndex[i];
+                }
+                else
+                {
+                    _builtIdIndex[numUnique++] = _builtIdIndex[i];
+                }
+            }
+            _builtIdIndex.resize(numUnique);
+        }
+
+        _idIndexHeader.numEntries = static_cast<u32>(_builtIdIndex.size());
+        _idIndex = _builtIdIndex.data();
+
+        // Not being able to write the index only costs us this rebuild next time
+        std::string indexPath = path + "idx";
+        std::ofstream output(indexPath, std::ofstream::out | std::ofstream::binary);
+        if (!output)
+        {
+            DebugHandler::PrintWarning("Failed to write NDBC id index (%s)", indexPath.c_str());
+            return;
+        }
+
+        output.write(reinterpret_cast<const char*>(&_idIndexHeader), sizeof(IdIndexHeader));
+        output.write(reinterpret_cast<const char*>(_builtIdIndex.data()), _builtIdIndex.size() * sizeof(IdIndexEntry));
+    }
+
+    std::shared_ptr<const ColumnData> File::GetColumnData(u32 offset, u32 valueSize)
+    {
+        std::lock_guard lock(_queryCache->mutex);
+
+        u64 key = (static_cast<u64>(offset) << 32) | valueSize;
+        auto itr = _queryCache->columns.find(key);
+        if (itr != _queryCache->columns.end())
+            return itr->second;
+
+        ZoneScoped;
+
+        std::shared_ptr<ColumnData> columnData = std::make_shared<ColumnData>();
+        columnData->valueSize = valueSize;
+        columnData->values.resize(static_cast<size_t>(_numRows) * valueSize);
+
+        if (offset + valueSize <= _rowSize)
+        {
+            const u8* rowData = &GetData()[_bufferOffsetToRowData + offset];
+            for (u32 i = 0; i < _numRows; i++)
+            {
+                std::memcpy(&columnData->values[static_cast<size_t>(i) * valueSize], &rowData[static_cast<size_t>(i) * _rowSize], valueSize);
+            }
+        }
+        else
+        {
+            DebugHandler::PrintError("NDBC: Column at offset %u with size %u is outside of rows of %u bytes", offset, valueSize, _rowSize);
+            columnData->values.clear();
+        }
+
+        _queryCache->columns[key] = columnData;
+        return columnData;
+    }
+
+    std::shared_ptr<const SecondaryIndex> File::GetSecondaryIndex(u32 offset, bool buildIfMissing)
+    {
+        {
+            std::lock_guard lock(_queryCache->mutex);
+
+            auto itr = _queryCache->secondaryIndices.find(offset);
+            if (itr != _queryCache->secondaryIndices.end())
+                return itr->second;
+
+            // A registered index that's missing was dropped by InvalidateQueryCaches, so it gets rebuilt here
+            if (!buildIfMissing && std::find(_queryCache->registeredIndices.begin(), _queryCache->registeredIndices.end(), offset) == _queryCache->registeredIndices.end())
+                return nullptr;
+        }
+
+        ZoneScoped;
+
+        std::shared_ptr<const ColumnData> columnData = GetColumnData(offset, sizeof(u32));
+        const u32* values = reinterpret_cast<const u32*>(columnData->values.data());
+        u32 numValues = static_cast<u32>(columnData->values.size() / sizeof(u32));
+
+        std::shared_ptr<SecondaryIndex> index = std::make_shared<SecondaryIndex>();
+
+        // Count every value first so each group gets a contiguous range, then scatter the rows into place
+        for (u32 i = 0; i < numValues; i++)
+        {
+            index->valueToRange[values[i]].second++;
+        }
+
+        u32 first = 0;
+        for (auto& pair : index->valueToRange)
+        {
+            pair.second.first = first;
+            first += pair.second.second;
+            pair.second.second = 0;
+        }
+
+        index->rowIndices.resize(numValues);
+        for (u32 i = 0; i < numValues; i++)
+        {
+            std::pair<u32, u32>& range = index->valueToRange[values[i]];
+            index->rowIndices[range.first + range.second++] = i;
+        }
+
+        std::lock_guard lock(_queryCache->mutex);
+
+        // Another thread might have beaten us to it, keep whichever got there first
+        auto result = _queryCache->secondaryIndices.emplace(offset, index);
+        return result.first->second;
+    }
+
+    void File::RegisterSecondaryIndex(u32 offset)
+    {
+        std::lock_guard lock(_queryCache->mutex);
+
+        std::vector<u32>& registeredIndices = _queryCache->registeredIndices;
+        if (std::find(registeredIndices.begin(), registeredIndices.end(), offset) == registeredIndices.end())
+            registeredIndices.push_back(offset);
+    }
+
+    void File::InvalidateQueryCaches()
+    {
+        std::lock_guard lock(_queryCache->mutex);
+
+        _queryCache->columns.clear();
+        _queryCache->secondaryIndices.clear();
+        _queryCache->generation.fetch_add(1, std::memory_order_release);
+    }
+}
@@ -3,7 +3,12 @@
 #include <Utils/DynamicBytebuffer.h>
 #include <Containers/StringTable.h>
 #include <vector>
+#include <algorithm>
 #include <robin_hood.h>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include "../../Utils/MemoryMappedFile.h"
 
 namespace NDBC
 {
@@ -22,29 +27,97 @@ namespace NDBC
         u32 version = NDBC::NDBC_VERSION;
     };
 
+    // The row ids of a file sorted for binary search, persisted next to the .ndbc as a .ndbcidx so opening a file needs no indexing
+    constexpr u32 NDBC_INDEX_TOKEN = 1313096280;
+    constexpr u32 NDBC_INDEX_VERSION = 1;
+
+    struct IdIndexHeader
+    {
+        u32 token = NDBC::NDBC_INDEX_TOKEN;
+        u32 version = NDBC::NDBC_INDEX_VERSION;
+        u64 ndbcSize = 0; // The .ndbc this was built from, a mismatch on either means the index is stale
+        u64 ndbcWriteTime = 0;
+        u32 numEntries = 0;
+        u32 firstId = 0;
+        u32 isDense = 0; // Row i has id firstId + i, lookups are a subtraction and no entries are stored
+        u32 padding = 0;
+    };
+
+    struct IdIndexEntry
+    {
+        u32 id;
+        u32 rowIndex;
+    };
+
+    // One column copied out of the rows into a contiguous array, scans over it don't stride through whole rows
+    struct ColumnData
+    {
+        std::vector<u8> values;
+        u32 valueSize = 0;
+    };
+
+    // Rows grouped by the value of a 4 byte column, rowIndices holds each group back to back
+    struct SecondaryIndex
+    {
+        robin_hood::unordered_flat_map<u32, std::pair<u32, u32>> valueToRange; // Raw column bits -> (first, count) in rowIndices
+        std::vector<u32> rowIndices;
+    };
+
     struct File
     {
     public:
+        // Maps the file read-only and loads or builds its id index, only the string table gets copied
+        bool Open(const std::string& path);
+        void Close();
+
+        // Mapped rows are read-only, this copies the file into an owned buffer for the editor
+        // The old mapping is kept, so rows handed out before this stay readable (but won't see edits)
+        void MakeWritable();
+
+        // Unmaps the .ndbc and its .ndbcidx so they can be rewritten or deleted
+        // Rows handed out while the file was mapped dangle after this, so keep row ids around rather than row pointers (see MapSingleton)
+        void ReleaseMapping();
+
         template<typename NDBCStruct>
         NDBCStruct* GetFirstRow()
         {
-            return reinterpret_cast<NDBCStruct*>(&_buffer->GetDataPointer()[_bufferOffsetToRowData]);
+            return reinterpret_cast<NDBCStruct*>(&GetData()[_bufferOffsetToRowData]);
         }
 
         template<typename NDBCStruct>
         NDBCStruct* GetRowByIndex(u32 index)
         {
-            return &reinterpret_cast<NDBCStruct*>(&_buffer->GetDataPointer()[_bufferOffsetToRowData])[index];
+            return &reinterpret_cast<NDBCStruct*>(&GetData()[_bufferOffsetToRowData])[index];
         }
 
         template<typename NDBCStruct>
         NDBCStruct* GetRowById(u32 id)
         {
-            auto& itr = _rowIdToRow.find(id);
-            if (itr == _rowIdToRow.end())
+            u32 rowIndex = 0;
+            if (!FindRowIndex(id, rowIndex))
                 return nullptr;
 
-            return reinterpret_cast<NDBCStruct*>(itr->second);
+            return GetRowByIndex<NDBCStruct>(rowIndex);
+        }
+
+        bool FindRowIndex(u32 id, u32& rowIndex) const
+        {
+            if (_idIndexHeader.isDense)
+            {
+                if (id < _idIndexHeader.firstId || id - _idIndexHeader.firstId >= _numRows)
+                    return false;
+
+                rowIndex = id - _idIndexHeader.firstId;
+                return true;
+            }
+
+            const IdIndexEntry* end = _idIndex + _idIndexHeader.numEntries;
+            const IdIndexEntry* itr = std::lower_bound(_idIndex, end, id, [](const IdIndexEntry& entry, u32 id) { return entry.id < id; });
+            if (itr == end || itr->id != id)
+                return false;
+
+            rowIndex = itr->rowIndex;
+            return true;
         }
 
         NDBCHeader& GetHeader() { return _header; }
@@ -59,10 +132,31 @@ namespace NDBC
         size_t GetBufferOffsetToRowData() { return _bufferOffsetToRowData; }
         void SetBufferOffsetToRowData(size_t bufferOffsetToRowData) { _bufferOffsetToRowData = bufferOffsetToRowData; }
 
+        // Only set for files created in the editor or after MakeWritable, mapped files have no buffer
         DynamicBytebuffer*& GetBuffer() { return _buffer; }
         StringTable*& GetStringTable() { return _stringTable; }
 
-        robin_hood::unordered_map<u32, void*>& GetRowIdToRowMap() { return _rowIdToRow; }
+        bool IsMapped() { return _mappedFile != nullptr; }
+
+        // Built on first use and shared until InvalidateQueryCaches, see NDBCQuery.h for the typed wrappers
+        std::shared_ptr<const ColumnData> GetColumnData(u32 offset, u32 valueSize);
+        std::shared_ptr<const SecondaryIndex> GetSecondaryIndex(u32 offset, bool buildIfMissing);
+
+        // Registered indices survive InvalidateQueryCaches, they get rebuilt the next time they're asked for
+        void RegisterSecondaryIndex(u32 offset);
+
+        // Anything that changes row data has to call this, the editor does after every edit
+        void InvalidateQueryCaches();
+
+        // Bumped by every InvalidateQueryCaches, anything derived from query results can compare it to know when to redo them
+        u32 GetQueryGeneration() { return _queryCache->generation.load(std::memory_order_acquire); }
+
+    private:
+        u8* GetData() { return _mappedFile ? const_cast<u8*>(_mappedFile->GetData()) : _buffer->GetDataPointer(); }
+
+        bool ReadHeader(const std::string& path);
+        bool LoadIdIndex(const std::string& path);
+        void BuildIdIndex(const std::string& path);
 
     private:
         NDBCHeader _header;
@@ -74,8 +168,24 @@ namespace NDBC
 
         DynamicBytebuffer* _buffer = nullptr;
         StringTable* _stringTable = nullptr;
+        MemoryMappedFile* _mappedFile = nullptr;
+        MemoryMappedFile* _retiredMappedFile = nullptr;
+
+        // Points into either the mapped .ndbcidx or _builtIdIndex
+        IdIndexHeader _idIndexHeader;
+        const IdIndexEntry* _idIndex = nullptr;
+        MemoryMappedFile* _mappedIdIndex = nullptr;
+        std::vector<IdIndexEntry> _builtIdIndex;
 
-        robin_hood::unordered_map<u32, void*> _rowIdToRow;
+        struct QueryCache
+        {
+            std::mutex mutex;
+            robin_hood::unordered_map<u64, std::shared_ptr<const ColumnData>> columns; // (offset << 32) | valueSize
+            robin_hood::unordered_map<u32, std::shared_ptr<const SecondaryIndex>> secondaryIndices; // offset
+            std::vector<u32> registeredIndices; // offset
+            std::atomic<u32> generation = 0;
+        };
+        std::shared_ptr<QueryCache> _queryCache = std::make_shared<QueryCache>();
     };
 
     struct TeleportLocation
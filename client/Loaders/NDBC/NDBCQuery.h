@@ -0,0 +1,212 @@
+#pragma once
+#include <NovusTypes.h>
+#include <Utils/DebugHandler.h>
+#include "NDBC.h"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// Describes a column by the member of the row struct it's read into, e.g. NDBC_COLUMN(NDBC::Light, mapId)
+#define NDBC_COLUMN(Struct, Member) NDBC::Column<decltype(Struct::Member)>{ static_cast<u32>(offsetof(Struct, Member)) }
+
+namespace NDBC
+{
+    // A typed view of one column, offset is in bytes from the start of the row
+    // Types wider than 4 bytes (vec2, vec3) cover consecutive columns
+    template <typename T>
+    struct Column
+    {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % sizeof(u32) == 0, "NDBC::Column: Every NDBC column is 4 bytes");
+
+        u32 offset = 0;
+    };
+
+    // Looks a column up by the name stored in the file and checks that T matches its data type
+    template <typename T>
+    bool FindColumn(File* file, const std::string& name, Column<T>& column)
+    {
+        static_assert(sizeof(T) == sizeof(u32), "NDBC::FindColumn: Only single columns can be looked up by name");
+
+        constexpr u32 expectedDataType = std::is_same_v<T, f32> ? 2 : std::is_signed_v<T> ? 0 : 1;
+
+        std::vector<NDBCColumn>& columns = file->GetColumns();
+        for (u32 i = 0; i < columns.size(); i++)
+        {
+            if (columns[i].name != name)
+                continue;
+
+            if (columns[i].dataType != expectedDataType)
+            {
+                DebugHandler::PrintError("NDBC: Column (%s) has data type %u but was requested as %u", name.c_str(), columns[i].dataType, expectedDataType);
+                return false;
+            }
+
+            column.offset = i * sizeof(u32);
+            return true;
+        }
+
+        return false;
+    }
+
+    // Contiguous values of a column, indexed by row index
+    template <typename T>
+    struct ColumnView
+    {
+        std::shared_ptr<const ColumnData> data; // Keeps the values alive if the cache gets invalidated meanwhile
+        const T* values = nullptr;
+        u32 count = 0;
+
+        const T& operator[](u32 rowIndex) const { return values[rowIndex]; }
+
+        const T* begin() const { return values; }
+        const T* end() const { return values + count; }
+    };
+
+    template <typename T>
+    ColumnView<T> GetColumnView(File* file, Column<T> column)
+    {
+        ColumnView<T> view;
+        view.data = file->GetColumnData(column.offset, sizeof(T));
+        view.values = reinterpret_cast<const T*>(view.data->values.data());
+        view.count = static_cast<u32>(view.data->values.size() / sizeof(T));
+
+        return view;
+    }
+
+    // Groups rows by a column once so WhereEquals on it becomes a lookup instead of a scan
+    // The column stays registered, edits that invalidate the index get it rebuilt on the next query
+    template <typename T>
+    void BuildSecondaryIndex(File* file, Column<T> column)
+    {
+        static_assert(sizeof(T) == sizeof(u32) && !std::is_floating_point_v<T>, "NDBC::BuildSecondaryIndex: Only integer columns can be indexed");
+        file->RegisterSecondaryIndex(column.offset);
+        file->GetSecondaryIndex(column.offset, true);
+    }
+
+    // Filters the rows of a file down to a set of row indices, filters run over contiguous column data
+    // Query lights(lightNDBC);
+    // lights.WhereEquals(NDBC_COLUMN(NDBC::Light, mapId), mapId);
+    // lights.Each<NDBC::Light>([](NDBC::Light* light) { ... });
+    class Query
+    {
+    public:
+        Query(File* file) : _file(file) { }
+
+        template <typename T, typename Value>
+        Query& WhereEquals(Column<T> column, const Value& value)
+        {
+            T typedValue = static_cast<T>(value);
+
+            // The first filter can come straight from a secondary index, if one was built for this column
+            if constexpr (sizeof(T) == sizeof(u32) && !std::is_floating_point_v<T>)
+            {
+                if (!_isFiltered)
+                {
+                    std::shared_ptr<const SecondaryIndex> index = _file->GetSecondaryIndex(column.offset, false);
+                    if (index)
+                    {
+                        u32 key;
+                        std::memcpy(&key, &typedValue, sizeof(u32));
+
+                        _isFiltered = true;
+                        _rowIndices.clear();
+
+                        auto itr = index->valueToRange.find(key);
+                        if (itr != index->valueToRange.end())
+                        {
+                            const u32* first = &index->rowIndices[itr->second.first];
+                            _rowIndices.assign(first, first + itr->second.second);
+                        }
+
+                        return *this;
+                    }
+                }
+            }
+
+            return Where(column, [typedValue](const T& columnValue) { return columnValue == typedValue; });
+        }
+
+        template <typename T, typename Predicate>
+        Query& Where(Column<T> column, Predicate predicate)
+        {
+            ColumnView<T> view = GetColumnView(_file, column);
+
+            // Branchless compaction, every row gets written and the count only advances on a match
+            u32 numMatches = 0;
+            if (!_isFiltered)
+            {
+                _rowIndices.resize(view.count);
+                for (u32 i = 0; i < view.count; i++)
+                {
+                    _rowIndices[numMatches] = i;
+                    numMatches += predicate(view.values[i]) ? 1 : 0;
+                }
+            }
+            else
+            {
+                // Rows past the end of the column (an empty view for a column outside the row) never match
+                for (u32 i = 0; i < _rowIndices.size(); i++)
+                {
+                    u32 rowIndex = _rowIndices[i];
+                    _rowIndices[numMatches] = rowIndex;
+                    numMatches += (rowIndex < view.count && predicate(view.values[rowIndex])) ? 1 : 0;
+                }
+            }
+
+            _rowIndices.resize(numMatches);
+            _isFiltered = true;
+
+            return *this;
+        }
+
+        // Values of one column for the matched rows, in row order
+        template <typename T>
+        void Select(Column<T> column, std::vector<T>& values)
+        {
+            ColumnView<T> view = GetColumnView(_file, column);
+            if (!_isFiltered)
+            {
+                values.assign(view.begin(), view.end());
+                return;
+            }
+
+            values.resize(_rowIndices.size());
+            for (u32 i = 0; i < _rowIndices.size(); i++)
+            {
+                u32 rowIndex = _rowIndices[i];
+                values[i] = rowIndex < view.count ? view.values[rowIndex] : T();
+            }
+        }
+
+        template <typename RowStruct, typename Func>
+        void Each(Func func)
+        {
+            if (!_isFiltered)
+            {
+                for (u32 i = 0; i < _file->GetNumRows(); i++)
+                {
+                    func(_file->GetRowByIndex<RowStruct>(i));
+                }
+
+                return;
+            }
+
+            for (u32 rowIndex : _rowIndices)
+            {
+                func(_file->GetRowByIndex<RowStruct>(rowIndex));
+            }
+        }
+
+        u32 Count() { return _isFiltered ? static_cast<u32>(_rowIndices.size()) : _file->GetNumRows(); }
+
+        // Only meaningful after a filter, an unfiltered query matches every row
+        const std::vector<u32>& GetRowIndices() { return _rowIndices; }
+
+    private:
+        File* _file = nullptr;
+
+        bool _isFiltered = false;
+        std::vector<u32> _rowIndices;
+    };
+}
@@ -95,8 +95,8 @@ void CModelRenderer::Update(f32 deltaTime)
     }
 
     // Read back from the culling counters
-    u32 numOpaqueDrawCalls = static_cast<u32>(_opaqueDrawCalls.size());
-    u32 numTransparentDrawCalls = static_cast<u32>(_transparentDrawCalls.size());
+    u32 numOpaqueDrawCalls = static_cast<u32>(_opaqueDrawCalls.Size());
+    u32 numTransparentDrawCalls = static_cast<u32>(_transparentDrawCalls.Size());
 
     _numOpaqueSurvivingDrawCalls = numOpaqueDrawCalls;
     _numTransparentSurvivingDrawCalls = numTransparentDrawCalls;
@@ -162,7 +162,7 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
     renderGraph->AddPass<CModelDepthPrepassData>("CModel Depth Prepass",
         [=](CModelDepthPrepassData& data, Renderer::RenderGraphBuilder& builder)
         {
-            data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+            data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
 
             return true; // Return true from setup to enable this pass, return false to disable it
         },
@@ -263,9 +263,9 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
                 _cullConstants.cameraPos = camera->GetPosition();
             }
 
-            const u32 numInstances = static_cast<u32>(_instances.size());
-            const u32 numOpaqueDrawCalls = static_cast<u32>(_opaqueDrawCalls.size());
-            const u32 numTransparentDrawCalls = static_cast<u32>(_transparentDrawCalls.size());
+            const u32 numInstances = static_cast<u32>(_instances.Size());
+            const u32 numOpaqueDrawCalls = static_cast<u32>(_opaqueDrawCalls.Size());
+            const u32 numTransparentDrawCalls = static_cast<u32>(_transparentDrawCalls.Size());
 
             if (numInstances == 0)
             {
@@ -307,13 +307,13 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
                 cullConstants->occlusionCull = CVAR_ComplexModelOcclusionCullEnabled.Get();
                 commandList.PushConstant(cullConstants, 0, sizeof(CullConstants));
 
-                _cullingDescriptorSet.Bind("_packedDrawCallDatas", _opaqueDrawCallDataBuffer);
-                _cullingDescriptorSet.Bind("_drawCalls", _opaqueDrawCallBuffer);
+                _cullingDescriptorSet.Bind("_packedDrawCallDatas", _opaqueDrawCallDatas.GetBuffer());
+                _cullingDescriptorSet.Bind("_drawCalls", _opaqueDrawCalls.GetBuffer());
                 _cullingDescriptorSet.Bind("_culledDrawCalls", _opaqueCulledDrawCallBuffer);
                 _cullingDescriptorSet.Bind("_drawCount", _opaqueDrawCountBuffer);
                 _cullingDescriptorSet.Bind("_triangleCount", _opaqueTriangleCountBuffer);
-                _cullingDescriptorSet.Bind("_instances", _instanceBuffer);
-                _cullingDescriptorSet.Bind("_cullingDatas", _cullingDataBuffer);
+                _cullingDescriptorSet.Bind("_instances", _instances.GetBuffer());
+                _cullingDescriptorSet.Bind("_cullingDatas", _cullingDatas.GetBuffer());
                 _cullingDescriptorSet.Bind("_visibleInstanceMask", _visibleInstanceMaskBuffer);
 
                 Renderer::SamplerDesc samplerDesc;
@@ -356,7 +356,7 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
 
             // Copy _transparentDrawCallBuffer into _transparentCulledDrawCallBuffer
             //u32 copySize = numTransparentDrawCalls * sizeof(DrawCall);
-            //commandList.CopyBuffer(_transparentCulledDrawCallBuffer, 0, _transparentDrawCallBuffer, 0, copySize);
+            //commandList.CopyBuffer(_transparentCulledDrawCallBuffer, 0, _transparentDrawCalls.GetBuffer(), 0, copySize);
 
             // Cull transparent
             if (cullingEnabled && numTransparentDrawCalls > 0)
@@ -388,13 +388,13 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
                 cullConstants->occlusionCull = CVAR_ComplexModelOcclusionCullEnabled.Get();
                 commandList.PushConstant(cullConstants, 0, sizeof(CullConstants));
 
-                _cullingDescriptorSet.Bind("_packedDrawCallDatas", _transparentDrawCallDataBuffer);
-                _cullingDescriptorSet.Bind("_drawCalls", _transparentDrawCallBuffer);
+                _cullingDescriptorSet.Bind("_packedDrawCallDatas", _transparentDrawCallDatas.GetBuffer());
+                _cullingDescriptorSet.Bind("_drawCalls", _transparentDrawCalls.GetBuffer());
                 _cullingDescriptorSet.Bind("_culledDrawCalls", _transparentCulledDrawCallBuffer);
                 _cullingDescriptorSet.Bind("_drawCount", _transparentDrawCountBuffer);
                 _cullingDescriptorSet.Bind("_triangleCount", _transparentTriangleCountBuffer);
-                _cullingDescriptorSet.Bind("_instances", _instanceBuffer);
-                _cullingDescriptorSet.Bind("_cullingDatas", _cullingDataBuffer);
+                _cullingDescriptorSet.Bind("_instances", _instances.GetBuffer());
+                _cullingDescriptorSet.Bind("_cullingDatas", _cullingDatas.GetBuffer());
                 _cullingDescriptorSet.Bind("_visibleInstanceMask", _visibleInstanceMaskBuffer);
 
                 _cullingDescriptorSet.Bind("_sortKeys", _transparentSortKeys);
@@ -466,15 +466,17 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
                     u32 sourceByteOffset;
                     u32 targetByteOffset;
                     u32 threadGroupSize;
-                } constants;
+                };
 
-                constants.sourceByteOffset = 0;
-                constants.targetByteOffset = 0;
-                constants.threadGroupSize = 32;
+                // The CommandList only stores the pointer until it gets executed, so this can't live on the stack
+                PushConstants* constants = graphResources.FrameNew<PushConstants>();
+                constants->sourceByteOffset = 0;
+                constants->targetByteOffset = 0;
+                constants->threadGroupSize = 32;
 
                 commandList.BeginPipeline(pipeline);
                 commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_DRAW, &descriptorSet, frameIndex);
-                commandList.PushConstant(&constants, 0, sizeof(PushConstants));
+                commandList.PushConstant(constants, 0, sizeof(PushConstants));
                 commandList.Dispatch(1, 1, 1);
                 commandList.EndPipeline(pipeline);
 
@@ -521,15 +523,15 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
 
                 _animationPrepassDescriptorSet.Bind("_visibleInstanceCount", _visibleInstanceCountBuffer);
                 _animationPrepassDescriptorSet.Bind("_visibleInstanceIndices", _visibleInstanceIndexBuffer);
-                _animationPrepassDescriptorSet.Bind("_instances", _instanceBuffer);
-                _animationPrepassDescriptorSet.Bind("_animationSequence", _animationSequenceBuffer);
-                _animationPrepassDescriptorSet.Bind("_animationModelInfo", _animationModelInfoBuffer);
-                _animationPrepassDescriptorSet.Bind("_animationBoneInfo", _animationBoneInfoBuffer);
+                _animationPrepassDescriptorSet.Bind("_instances", _instances.GetBuffer());
+                _animationPrepassDescriptorSet.Bind("_animationSequence", _animationSequence.GetBuffer());
+                _animationPrepassDescriptorSet.Bind("_animationModelInfo", _animationModelInfo.GetBuffer());
+                _animationPrepassDescriptorSet.Bind("_animationBoneInfo", _animationBoneInfo.GetBuffer());
                 _animationPrepassDescriptorSet.Bind("_animationBoneDeformMatrix", _animationBoneDeformMatrixBuffer);
                 _animationPrepassDescriptorSet.Bind("_animationBoneInstances", _animationBoneInstancesBuffer);
-                _animationPrepassDescriptorSet.Bind("_animationTrackInfo", _animationTrackInfoBuffer);
-                _animationPrepassDescriptorSet.Bind("_animationTrackTimestamp", _animationTrackTimestampBuffer);
-                _animationPrepassDescriptorSet.Bind("_animationTrackValue", _animationTrackValueBuffer);
+                _animationPrepassDescriptorSet.Bind("_animationTrackInfo", _animationTrackInfo.GetBuffer());
+                _animationPrepassDescriptorSet.Bind("_animationTrackTimestamp", _animationTrackTimestamps.GetBuffer());
+                _animationPrepassDescriptorSet.Bind("_animationTrackValue", _animationTrackValues.GetBuffer());
 
                 commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::DEBUG, &resources.debugDescriptorSet, frameIndex);
                 commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_animationPrepassDescriptorSet, frameIndex);
@@ -538,7 +540,7 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
 
                 commandList.EndPipeline(pipeline);
 
-                commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _instanceBuffer);
+                commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToComputeShaderRead, _instances.GetBuffer());
                 commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToVertexShaderRead, _animationBoneDeformMatrixBuffer);
 
                 commandList.PopMarker();
@@ -555,11 +557,11 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
 
                 commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, &resources.globalDescriptorSet, frameIndex);
 
-                _passDescriptorSet.Bind("_packedDrawCallDatas", _opaqueDrawCallDataBuffer);
-                _passDescriptorSet.Bind("_packedVertices", _vertexBuffer);
+                _passDescriptorSet.Bind("_packedDrawCallDatas", _opaqueDrawCallDatas.GetBuffer());
+                _passDescriptorSet.Bind("_packedVertices", _vertices.GetBuffer());
                 _passDescriptorSet.Bind("_textures", _cModelTextures);
-                _passDescriptorSet.Bind("_textureUnits", _textureUnitBuffer);
-                _passDescriptorSet.Bind("_instances", _instanceBuffer);
+                _passDescriptorSet.Bind("_textureUnits", _textureUnits.GetBuffer());
+                _passDescriptorSet.Bind("_instances", _instances.GetBuffer());
                 _passDescriptorSet.Bind("_animationBoneDeformMatrix", _animationBoneDeformMatrixBuffer);
                 commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
 
@@ -567,9 +569,9 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
                 constants->isTransparent = false;
                 commandList.PushConstant(constants, 0, sizeof(Constants));
 
-                commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+                commandList.SetIndexBuffer(_indices.GetBuffer(), Renderer::IndexFormat::UInt16);
 
-                Renderer::BufferID argumentBuffer = (cullingEnabled) ? _opaqueCulledDrawCallBuffer : _opaqueDrawCallBuffer;
+                Renderer::BufferID argumentBuffer = (cullingEnabled) ? _opaqueCulledDrawCallBuffer : _opaqueDrawCalls.GetBuffer();
                 commandList.DrawIndexedIndirectCount(argumentBuffer, 0, _opaqueDrawCountBuffer, 0, numOpaqueDrawCalls);
 
                 commandList.EndPipeline(pipeline);
@@ -587,7 +589,7 @@ void CModelRenderer::AddComplexModelDepthPrepass(Renderer::RenderGraph* renderGr
             }
 
             // We skip transparencies since they don't write to depth
-        });
+        }, this);
 }
 
 void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, RenderResources& resources, u8 frameIndex)
@@ -597,6 +599,7 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, Ren
         Renderer::RenderPassMutableResource color;
         Renderer::RenderPassMutableResource objectIDs;
         Renderer::RenderPassMutableResource depth;
+        Renderer::RenderPassResource ambientObscurance;
     };
 
     const bool cullingEnabled = CVAR_ComplexModelCullingEnabled.Get();
@@ -607,9 +610,10 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, Ren
     renderGraph->AddPass<CModelPassData>("CModel Pass",
         [=](CModelPassData& data, Renderer::RenderGraphBuilder& builder)
     {
-        data.color = builder.Write(resources.color, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
-        data.objectIDs = builder.Write(resources.objectIDs, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
-        data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+        data.color = builder.Write(resources.color, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
+        data.objectIDs = builder.Write(resources.objectIDs, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
+        data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
+        data.ambientObscurance = builder.Read(resources.ambientObscurance, Renderer::RenderGraphBuilder::ShaderStage::PIXEL);
 
         return true; // Return true from setup to enable this pass, return false to disable it
     },
@@ -650,9 +654,9 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, Ren
             u32 isTransparent;
         };
 
-        const u32 numInstances = static_cast<u32>(_instances.size());
-        const u32 numOpaqueDrawCalls = static_cast<u32>(_opaqueDrawCalls.size());
-        const u32 numTransparentDrawCalls = static_cast<u32>(_transparentDrawCalls.size());
+        const u32 numInstances = static_cast<u32>(_instances.Size());
+        const u32 numOpaqueDrawCalls = static_cast<u32>(_opaqueDrawCalls.Size());
+        const u32 numTransparentDrawCalls = static_cast<u32>(_transparentDrawCalls.Size());
 
         // Set Opaque Pipeline
         if (numOpaqueDrawCalls > 0)
@@ -665,11 +669,11 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, Ren
 
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, &resources.globalDescriptorSet, frameIndex);
 
-            _passDescriptorSet.Bind("_packedDrawCallDatas", _opaqueDrawCallDataBuffer);
-            _passDescriptorSet.Bind("_packedVertices", _vertexBuffer);
+            _passDescriptorSet.Bind("_packedDrawCallDatas", _opaqueDrawCallDatas.GetBuffer());
+            _passDescriptorSet.Bind("_packedVertices", _vertices.GetBuffer());
             _passDescriptorSet.Bind("_textures", _cModelTextures);
-            _passDescriptorSet.Bind("_textureUnits", _textureUnitBuffer);
-            _passDescriptorSet.Bind("_instances", _instanceBuffer);
+            _passDescriptorSet.Bind("_textureUnits", _textureUnits.GetBuffer());
+            _passDescriptorSet.Bind("_instances", _instances.GetBuffer());
             _passDescriptorSet.Bind("_animationBoneDeformMatrix", _animationBoneDeformMatrixBuffer);
             _passDescriptorSet.Bind("_ambientOcclusion", resources.ambientObscurance);
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
@@ -678,9 +682,9 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, Ren
             constants->isTransparent = false;
             commandList.PushConstant(constants, 0, sizeof(Constants));
 
-            commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+            commandList.SetIndexBuffer(_indices.GetBuffer(), Renderer::IndexFormat::UInt16);
             
-            Renderer::BufferID argumentBuffer = (cullingEnabled) ? _opaqueCulledDrawCallBuffer : _opaqueDrawCallBuffer;
+            Renderer::BufferID argumentBuffer = (cullingEnabled) ? _opaqueCulledDrawCallBuffer : _opaqueDrawCalls.GetBuffer();
             commandList.DrawIndexedIndirectCount(argumentBuffer, 0, _opaqueDrawCountBuffer, 0, numOpaqueDrawCalls);
 
             commandList.EndPipeline(pipeline);
@@ -789,11 +793,11 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, Ren
 
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, &resources.globalDescriptorSet, frameIndex);
 
-            _passDescriptorSet.Bind("_packedDrawCallDatas", _transparentDrawCallDataBuffer);
-            _passDescriptorSet.Bind("_packedVertices", _vertexBuffer);
+            _passDescriptorSet.Bind("_packedDrawCallDatas", _transparentDrawCallDatas.GetBuffer());
+            _passDescriptorSet.Bind("_packedVertices", _vertices.GetBuffer());
             _passDescriptorSet.Bind("_textures", _cModelTextures);
-            _passDescriptorSet.Bind("_textureUnits", _textureUnitBuffer);
-            _passDescriptorSet.Bind("_instances", _instanceBuffer);
+            _passDescriptorSet.Bind("_textureUnits", _textureUnits.GetBuffer());
+            _passDescriptorSet.Bind("_instances", _instances.GetBuffer());
             _passDescriptorSet.Bind("_animationBoneDeformMatrix", _animationBoneDeformMatrixBuffer);
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
 
@@ -801,7 +805,7 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, Ren
             constants->isTransparent = true;
             commandList.PushConstant(constants, 0, sizeof(Constants));
 
-            commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+            commandList.SetIndexBuffer(_indices.GetBuffer(), Renderer::IndexFormat::UInt16);
 
             if (cullingEnabled)
             {
@@ -825,24 +829,57 @@ void CModelRenderer::AddComplexModelPass(Renderer::RenderGraph* renderGraph, Ren
 
             commandList.PopMarker();
         }
-    });
+    }, this);
 }
 
 void CModelRenderer::RegisterLoadFromChunk(u16 chunkID, const Terrain::Chunk& chunk, StringTable& stringTable)
 {
     _mapChunkToPlacementOffset[chunkID] = static_cast<u16>(_complexModelsToBeLoaded.Size());
 
+    std::vector<u32>& chunkUniqueIDs = _chunkUniqueIDs[chunkID];
+    chunkUniqueIDs.reserve(chunk.complexModelPlacements.size());
+
     for (const Terrain::Placement& placement : chunk.complexModelPlacements)
     {
         u32 uniqueID = placement.uniqueID;
+        chunkUniqueIDs.push_back(uniqueID);
+
         if (_uniqueIdCounter[uniqueID]++ == 0)
         {
             ComplexModelToBeLoaded& modelToBeLoaded = _complexModelsToBeLoaded.EmplaceBack();
             modelToBeLoaded.placement = &placement;
             modelToBeLoaded.name = &stringTable.GetString(placement.nameID);
             modelToBeLoaded.nameHash = stringTable.GetStringHash(placement.nameID);
+            modelToBeLoaded.chunkID = chunkID;
+        }
+    }
+}
+
+void CModelRenderer::UnloadChunk(u16 chunkID)
+{
+    auto chunkItr = _chunkUniqueIDs.find(chunkID);
+    if (chunkItr == _chunkUniqueIDs.end())
+        return;
+
+    // Placements can be shared between chunks, the instance stays until the last chunk referencing it is unloaded
+    for (u32 uniqueID : chunkItr->second)
+    {
+        auto counterItr = _uniqueIdCounter.find(uniqueID);
+        if (counterItr == _uniqueIdCounter.end() || --counterItr->second > 0)
+            continue;
+
+        _uniqueIdCounter.erase(counterItr);
+
+        auto instanceItr = _uniqueIdToInstance.find(uniqueID);
+        if (instanceItr != _uniqueIdToInstance.end())
+        {
+            _instancesToBeRemoved.push_back(instanceItr->second);
+            _uniqueIdToInstance.erase(instanceItr);
         }
     }
+
+    _chunkUniqueIDs.erase(chunkItr);
+    _mapChunkToPlacementOffset.erase(chunkID);
 }
 
 void CModelRenderer::ExecuteLoad()
@@ -850,11 +887,11 @@ void CModelRenderer::ExecuteLoad()
     ZoneScopedN("CModelRenderer::ExecuteLoad()");
 
     size_t numComplexModelsToLoad = _complexModelsToBeLoaded.Size();
-    if (numComplexModelsToLoad == 0)
+    if (numComplexModelsToLoad == 0 && _instancesToBeRemoved.size() == 0)
         return;
 
-    _animationBoneDeformRangeAllocator.Reset();
-    _animationBoneInstancesRangeAllocator.Reset();
+    // Removals go first so the loads below can reuse the freed instance slots and geometry ranges
+    RemoveInstances();
 
     _complexModelsToBeLoaded.WriteLock([&](std::vector<ComplexModelToBeLoaded>& complexModelsToBeLoaded)
         {
@@ -863,6 +900,17 @@ void CModelRenderer::ExecuteLoad()
                 ZoneScoped;
                 ZoneText(modelToBeLoaded.name->c_str(), modelToBeLoaded.name->length());
 
+                u32 uniqueID = modelToBeLoaded.placement->uniqueID;
+                bool isChunkPlacement = modelToBeLoaded.chunkID != Terrain::MAP_CHUNK_ID_INVALID;
+
+                // The chunk was unloaded again before we got to load it
+                if (isChunkPlacement && _uniqueIdCounter.find(uniqueID) == _uniqueIdCounter.end())
+                    continue;
+
+                // The chunk was unloaded and loaded again before we got to load it, so the placement is queued twice and an earlier entry already added it
+                if (isChunkPlacement && _uniqueIdToInstance.find(uniqueID) != _uniqueIdToInstance.end())
+                    continue;
+
                 // Placements reference a path to a ComplexModel, several placements can reference the same object
                 // Because of this we want only the first load to actually load the object, subsequent loads should reuse the loaded version
                 u32 modelID;
@@ -870,9 +918,22 @@ void CModelRenderer::ExecuteLoad()
                 auto it = _nameHashToIndexMap.find(modelToBeLoaded.nameHash);
                 if (it == _nameHashToIndexMap.end())
                 {
-                    modelID = static_cast<u32>(_loadedComplexModels.size());
-                    LoadedComplexModel& complexModel = _loadedComplexModels.emplace_back();
+                    if (_freeModelIDs.size() > 0)
+                    {
+                        modelID = _freeModelIDs.back();
+                        _freeModelIDs.pop_back();
+
+                        _loadedComplexModels[modelID] = LoadedComplexModel();
+                    }
+                    else
+                    {
+                        modelID = static_cast<u32>(_loadedComplexModels.size());
+                        _loadedComplexModels.emplace_back();
+                    }
+
+                    LoadedComplexModel& complexModel = _loadedComplexModels[modelID];
                     complexModel.objectID = modelID;
+                    complexModel.nameHash = modelToBeLoaded.nameHash;
                     LoadComplexModel(modelToBeLoaded, complexModel);
 
                     _nameHashToIndexMap[modelToBeLoaded.nameHash] = modelID;
@@ -885,30 +946,21 @@ void CModelRenderer::ExecuteLoad()
                 // Add Placement Details (This is used to go from a placement to LoadedMapObject or InstanceData
                 Terrain::PlacementDetails& placementDetails = _complexModelPlacementDetails.emplace_back();
                 placementDetails.loadedIndex = modelID;
-                placementDetails.instanceIndex = static_cast<u32>(_instances.size());
 
                 // Add placement as an instance
-                AddInstance(_loadedComplexModels[modelID], *modelToBeLoaded.placement);
+                placementDetails.instanceIndex = AddInstance(_loadedComplexModels[modelID], *modelToBeLoaded.placement);
+
+                if (isChunkPlacement)
+                {
+                    _uniqueIdToInstance[uniqueID] = placementDetails.instanceIndex;
+                }
             }
         });
 
     {
-        ZoneScopedN("CModelRenderer::ExecuteLoad()::CreateBuffers()");
-        CreateBuffers();
+        ZoneScopedN("CModelRenderer::ExecuteLoad()::SyncToGPU()");
+        SyncToGPU();
         _complexModelsToBeLoaded.Clear();
-
-        // Calculate triangles
-        _numOpaqueTriangles = 0;
-        _numTransparentTriangles = 0;
-
-        for (const DrawCall& drawCall : _opaqueDrawCalls)
-        {
-            _numOpaqueTriangles += drawCall.indexCount / 3;
-        }
-        for (const DrawCall& drawCall : _transparentDrawCalls)
-        {
-            _numTransparentTriangles += drawCall.indexCount / 3;
-        }
     }
 }
 
@@ -917,38 +969,72 @@ void CModelRenderer::Clear()
     _uniqueIdCounter.clear();
     _mapChunkToPlacementOffset.clear();
     _complexModelPlacementDetails.clear();
+    _chunkUniqueIDs.clear();
+    _uniqueIdToInstance.clear();
+    _instancesToBeRemoved.clear();
     _loadedComplexModels.clear();
     _nameHashToIndexMap.clear();
+    _freeModelIDs.clear();
+    std::fill(_textureRefCounts.begin(), _textureRefCounts.end(), static_cast<u16>(0));
+    _texturesToUnload.clear();
     _opaqueDrawCallDataIndexToLoadedModelIndex.clear();
     _transparentDrawCallDataIndexToLoadedModelIndex.clear();
 
-    _vertices.clear();
-    _indices.clear();
-    _textureUnits.clear();
-    _instances.clear();
-    _cullingDatas.clear();
+    _vertices.Clear();
+    _indices.Clear();
+    _textureUnits.Clear();
+    _instances.Clear();
+    _instanceBoneDeformRangeFrames.clear();
+    _instanceBoneInstanceRangeFrames.clear();
+    _cullingDatas.Clear();
+
+    _animationSequence.Clear();
+    _animationModelInfo.Clear();
+    _animationBoneInfo.Clear();
+    _animationBoneInstances.clear();
+    _animationTrackInfo.Clear();
+    _animationTrackTimestamps.Clear();
+    _animationTrackValues.Clear();
+    _animationBoneDeformRangeAllocator.Reset();
+    _animationBoneInstancesRangeAllocator.Reset();
 
-    _animationModelInfo.clear();
-    _animationBoneInfo.clear();
-    _animationTrackInfo.clear();
-    _animationTrackTimestamps.clear();
-    _animationTrackValues.clear();
+    _opaqueDrawCalls.Clear();
+    _opaqueDrawCallDatas.Clear();
 
-    _opaqueDrawCalls.clear();
-    _opaqueDrawCallDatas.clear();
+    _transparentDrawCalls.Clear();
+    _transparentDrawCallDatas.Clear();
 
-    _transparentDrawCalls.clear();
-    _transparentDrawCallDatas.clear();
+    _numOpaqueTriangles = 0;
+    _numTransparentTriangles = 0;
 
     _renderer->UnloadTexturesInArray(_cModelTextures, 0);
 }
 
 void CModelRenderer::CreatePermanentResources()
 {
+    _vertices.Init("CModelVertexBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 256 * 1024);
+    _indices.Init("CModelIndexBuffer", Renderer::BufferUsage::INDEX_BUFFER, 512 * 1024);
+    _textureUnits.Init("CModelTextureUnitBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 8192);
+    _instances.Init("CModelInstanceBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 4096);
+    _cullingDatas.Init("CModelCullDataBuffer", Renderer::BufferUsage::STORAGE_BUFFER);
+
+    _animationSequence.Init("AnimationSequenceBuffer", Renderer::BufferUsage::STORAGE_BUFFER);
+    _animationModelInfo.Init("AnimationModelInfoBuffer", Renderer::BufferUsage::STORAGE_BUFFER);
+    _animationBoneInfo.Init("AnimationBoneInfoBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 8192);
+    _animationTrackInfo.Init("AnimationTrackInfoBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 8192);
+    _animationTrackTimestamps.Init("AnimationTrackTimestampBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 65536);
+    _animationTrackValues.Init("AnimationTrackValueBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 65536);
+
+    _opaqueDrawCalls.Init("CModelOpaqueDrawCallBuffer", Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER, 8192);
+    _opaqueDrawCallDatas.Init("CModelOpaqueDrawCallDataBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 8192);
+    _transparentDrawCalls.Init("CModelAlphaDrawCalls", Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER, 8192);
+    _transparentDrawCallDatas.Init("CModelAlphaDrawCallDataBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 8192);
+
     Renderer::TextureArrayDesc textureArrayDesc;
     textureArrayDesc.size = 4096;
 
     _cModelTextures = _renderer->CreateTextureArray(textureArrayDesc);
+    _textureRefCounts.resize(textureArrayDesc.size);
 
     Renderer::SamplerDesc samplerDesc;
     samplerDesc.enabled = true;
@@ -1079,18 +1165,24 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
     entt::registry* registry = ServiceLocator::GetGameRegistry();
     TextureSingleton& textureSingleton = registry->ctx<TextureSingleton>();
 
-    AnimationModelInfo& animationModelInfo = _animationModelInfo.emplace_back();
+    // The model info is indexed by objectID, unloaded models hand their slot over to the next model that gets loaded
+    if (complexModel.objectID >= _animationModelInfo.Size())
+    {
+        _animationModelInfo.AddCount(complexModel.objectID + 1 - _animationModelInfo.Size());
+    }
+
+    AnimationModelInfo& animationModelInfo = _animationModelInfo[complexModel.objectID];
+    animationModelInfo = AnimationModelInfo();
+    _animationModelInfo.SetDirtyElement(complexModel.objectID);
 
     // Add Sequences
     {
-        size_t numSequenceInfoBefore = _animationSequence.size();
         size_t numSequencesToAdd = cModel.sequences.size();
+        size_t numSequenceInfoBefore = (numSequencesToAdd > 0) ? _animationSequence.AddCount(numSequencesToAdd) : 0;
 
         animationModelInfo.numSequences = static_cast<u16>(numSequencesToAdd);
         animationModelInfo.sequenceOffset = static_cast<u32>(numSequenceInfoBefore);
 
-        _animationSequence.resize(numSequenceInfoBefore + numSequencesToAdd);
-
         for (u32 i = 0; i < numSequencesToAdd; i++)
         {
             AnimationSequence& sequence = _animationSequence[numSequenceInfoBefore + i];
@@ -1111,8 +1203,8 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
 
     // Add Bones
     {
-        size_t numBoneInfoBefore = _animationBoneInfo.size();
         size_t numBonesToAdd = cModel.bones.size();
+        size_t numBoneInfoBefore = (numBonesToAdd > 0) ? _animationBoneInfo.AddCount(numBonesToAdd) : 0;
 
         complexModel.numBones = static_cast<u32>(numBonesToAdd);
 
@@ -1122,7 +1214,6 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
         u32 numSequences = 0;
         u32 numTracksWithValues = 0;
 
-        _animationBoneInfo.resize(numBoneInfoBefore + numBonesToAdd);
         for (u32 i = 0; i < numBonesToAdd; i++)
         {
             AnimationBoneInfo& boneInfo = _animationBoneInfo[numBoneInfoBefore + i];
@@ -1131,39 +1222,44 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
             boneInfo.numTranslationSequences = static_cast<u16>(bone.translation.tracks.size());
             if (boneInfo.numTranslationSequences > 0)
             {
-                boneInfo.translationSequenceOffset = static_cast<u32>(_animationTrackInfo.size());
+                boneInfo.translationSequenceOffset = static_cast<u32>(_animationTrackInfo.AddCount(boneInfo.numTranslationSequences));
                 for (u32 j = 0; j < boneInfo.numTranslationSequences; j++)
                 {
                     CModel::ComplexAnimationTrack<vec3>& track = bone.translation.tracks[j];
-                    AnimationTrackInfo& trackInfo = _animationTrackInfo.emplace_back();
+                    AnimationTrackInfo& trackInfo = _animationTrackInfo[boneInfo.translationSequenceOffset + j];
 
                     trackInfo.sequenceIndex = track.sequenceId;
 
                     trackInfo.numTimestamps = static_cast<u16>(track.timestamps.size());
                     trackInfo.numValues = static_cast<u16>(track.values.size());
 
-                    trackInfo.timestampOffset = static_cast<u32>(_animationTrackTimestamps.size());
-                    trackInfo.valueOffset = static_cast<u32>(_animationTrackValues.size());
+                    trackInfo.timestampOffset = 0;
+                    trackInfo.valueOffset = 0;
 
                     // Add Timestamps
                     {
-                        size_t numTimestampsBefore = _animationTrackTimestamps.size();
                         size_t numTimestampsToAdd = track.timestamps.size();
+                        if (numTimestampsToAdd > 0)
+                        {
+                            size_t numTimestampsBefore = _animationTrackTimestamps.AddCount(numTimestampsToAdd);
+                            memcpy(&_animationTrackTimestamps[numTimestampsBefore], track.timestamps.data(), numTimestampsToAdd * sizeof(u32));
 
-                        _animationTrackTimestamps.resize(numTimestampsBefore + numTimestampsToAdd);
-                        memcpy(&_animationTrackTimestamps[numTimestampsBefore], track.timestamps.data(), numTimestampsToAdd * sizeof(u32));
+                            trackInfo.timestampOffset = static_cast<u32>(numTimestampsBefore);
+                        }
                     }
 
                     // Add Values
                     {
-                        size_t numValuesBefore = _animationTrackValues.size();
                         size_t numValuesToAdd = track.values.size();
-
-                        _animationTrackValues.resize(numValuesBefore + numValuesToAdd);
-
-                        for (size_t x = numValuesBefore; x < numValuesBefore + numValuesToAdd; x++)
+                        if (numValuesToAdd > 0)
                         {
-                            _animationTrackValues[x] = vec4(track.values[x - numValuesBefore], 0.f);
+                            size_t numValuesBefore = _animationTrackValues.AddCount(numValuesToAdd);
+                            for (size_t x = numValuesBefore; x < numValuesBefore + numValuesToAdd; x++)
+                            {
+                                _animationTrackValues[x] = vec4(track.values[x - numValuesBefore], 0.f);
+                            }
+
+                            trackInfo.valueOffset = static_cast<u32>(numValuesBefore);
                         }
                     }
 
@@ -1174,36 +1270,42 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
             boneInfo.numRotationSequences = static_cast<u16>(bone.rotation.tracks.size());
             if (boneInfo.numRotationSequences > 0)
             {
-                boneInfo.rotationSequenceOffset = static_cast<u32>(_animationTrackInfo.size());
+                boneInfo.rotationSequenceOffset = static_cast<u32>(_animationTrackInfo.AddCount(boneInfo.numRotationSequences));
                 for (u32 j = 0; j < boneInfo.numRotationSequences; j++)
                 {
                     CModel::ComplexAnimationTrack<vec4>& track = bone.rotation.tracks[j];
-                    AnimationTrackInfo& trackInfo = _animationTrackInfo.emplace_back();
+                    AnimationTrackInfo& trackInfo = _animationTrackInfo[boneInfo.rotationSequenceOffset + j];
 
                     trackInfo.sequenceIndex = track.sequenceId;
 
                     trackInfo.numTimestamps = static_cast<u16>(track.timestamps.size());
                     trackInfo.numValues = static_cast<u16>(track.values.size());
 
-                    trackInfo.timestampOffset = static_cast<u32>(_animationTrackTimestamps.size());
-                    trackInfo.valueOffset = static_cast<u32>(_animationTrackValues.size());
+                    trackInfo.timestampOffset = 0;
+                    trackInfo.valueOffset = 0;
 
                     // Add Timestamps
                     {
-                        size_t numTimestampsBefore = _animationTrackTimestamps.size();
                         size_t numTimestampsToAdd = track.timestamps.size();
+                        if (numTimestampsToAdd > 0)
+                        {
+                            size_t numTimestampsBefore = _animationTrackTimestamps.AddCount(numTimestampsToAdd);
+                            memcpy(&_animationTrackTimestamps[numTimestampsBefore], track.timestamps.data(), numTimestampsToAdd * sizeof(u32));
 
-                        _animationTrackTimestamps.resize(numTimestampsBefore + numTimestampsToAdd);
-                        memcpy(&_animationTrackTimestamps[numTimestampsBefore], track.timestamps.data(), numTimestampsToAdd * sizeof(u32));
+                            trackInfo.timestampOffset = static_cast<u32>(numTimestampsBefore);
+                        }
                     }
 
                     // Add Values
                     {
-                        size_t numValuesBefore = _animationTrackValues.size();
                         size_t numValuesToAdd = track.values.size();
+                        if (numValuesToAdd > 0)
+                        {
+                            size_t numValuesBefore = _animationTrackValues.AddCount(numValuesToAdd);
+                            memcpy(&_animationTrackValues[numValuesBefore], track.values.data(), numValuesToAdd * sizeof(vec4));
 
-                        _animationTrackValues.resize(numValuesBefore + numValuesToAdd);
-                        memcpy(&_animationTrackValues[numValuesBefore], track.values.data(), numValuesToAdd * sizeof(vec4));
+                            trackInfo.valueOffset = static_cast<u32>(numValuesBefore);
+                        }
                     }
 
                     numTracksWithValues += trackInfo.numValues;
@@ -1213,39 +1315,44 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
             boneInfo.numScaleSequences = static_cast<u16>(bone.scale.tracks.size());
             if (boneInfo.numScaleSequences > 0)
             {
-                boneInfo.scaleSequenceOffset = static_cast<u32>(_animationTrackInfo.size());
+                boneInfo.scaleSequenceOffset = static_cast<u32>(_animationTrackInfo.AddCount(boneInfo.numScaleSequences));
                 for (u32 j = 0; j < boneInfo.numScaleSequences; j++)
                 {
                     CModel::ComplexAnimationTrack<vec3>& track = bone.scale.tracks[j];
-                    AnimationTrackInfo& trackInfo = _animationTrackInfo.emplace_back();
+                    AnimationTrackInfo& trackInfo = _animationTrackInfo[boneInfo.scaleSequenceOffset + j];
 
                     trackInfo.sequenceIndex = track.sequenceId;
 
                     trackInfo.numTimestamps = static_cast<u16>(track.timestamps.size());
                     trackInfo.numValues = static_cast<u16>(track.values.size());
 
-                    trackInfo.timestampOffset = static_cast<u32>(_animationTrackTimestamps.size());
-                    trackInfo.valueOffset = static_cast<u32>(_animationTrackValues.size());
+                    trackInfo.timestampOffset = 0;
+                    trackInfo.valueOffset = 0;
 
                     // Add Timestamps
                     {
-                        size_t numTimestampsBefore = _animationTrackTimestamps.size();
                         size_t numTimestampsToAdd = track.timestamps.size();
+                        if (numTimestampsToAdd > 0)
+                        {
+                            size_t numTimestampsBefore = _animationTrackTimestamps.AddCount(numTimestampsToAdd);
+                            memcpy(&_animationTrackTimestamps[numTimestampsBefore], track.timestamps.data(), numTimestampsToAdd * sizeof(u32));
 
-                        _animationTrackTimestamps.resize(numTimestampsBefore + numTimestampsToAdd);
-                        memcpy(&_animationTrackTimestamps[numTimestampsBefore], track.timestamps.data(), numTimestampsToAdd * sizeof(u32));
+                            trackInfo.timestampOffset = static_cast<u32>(numTimestampsBefore);
+                        }
                     }
 
                     // Add Values
                     {
-                        size_t numValuesBefore = _animationTrackValues.size();
                         size_t numValuesToAdd = track.values.size();
-
-                        _animationTrackValues.resize(numValuesBefore + numValuesToAdd);
-
-                        for (size_t x = numValuesBefore; x < numValuesBefore + numValuesToAdd; x++)
+                        if (numValuesToAdd > 0)
                         {
-                            _animationTrackValues[x] = vec4(track.values[x - numValuesBefore], 0.f);
+                            size_t numValuesBefore = _animationTrackValues.AddCount(numValuesToAdd);
+                            for (size_t x = numValuesBefore; x < numValuesBefore + numValuesToAdd; x++)
+                            {
+                                _animationTrackValues[x] = vec4(track.values[x - numValuesBefore], 0.f);
+                            }
+
+                            trackInfo.valueOffset = static_cast<u32>(numValuesBefore);
                         }
                     }
 
@@ -1271,19 +1378,18 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
     }
 
     // Add vertices
-    size_t numVerticesBeforeAdd = _vertices.size();
     size_t numVerticesToAdd = cModel.vertices.size();
+    size_t numVerticesBeforeAdd = _vertices.AddCount(numVerticesToAdd);
 
-    _vertices.resize(numVerticesBeforeAdd + numVerticesToAdd);
     memcpy(&_vertices[numVerticesBeforeAdd], cModel.vertices.data(), numVerticesToAdd * sizeof(CModel::ComplexVertex));
 
+    complexModel.vertexOffset = static_cast<u32>(numVerticesBeforeAdd);
+    complexModel.numVertices = static_cast<u32>(numVerticesToAdd);
+
     // Handle the CullingData
-    size_t numCullingDataBeforeAdd = _cullingDatas.size();
+    size_t numCullingDataBeforeAdd = _cullingDatas.Add(cModel.cullingData);
     complexModel.cullingDataID = static_cast<u32>(numCullingDataBeforeAdd);
 
-    CModel::CullingData& cullingData = _cullingDatas.emplace_back();
-    cullingData = cModel.cullingData;
-
     // Handle this models renderbatches
     size_t numRenderBatches = static_cast<u32>(cModel.modelData.renderBatches.size());
     for (size_t i = 0; i < numRenderBatches; i++)
@@ -1313,20 +1419,18 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
         drawCallTemplate.vertexOffset = static_cast<u32>(numVerticesBeforeAdd);
 
         // Add indices
-        size_t numIndicesBeforeAdd = _indices.size();
         size_t numIndicesToAdd = renderBatch.indexCount;
+        size_t numIndicesBeforeAdd = _indices.AddCount(numIndicesToAdd);
 
-        _indices.resize(numIndicesBeforeAdd + numIndicesToAdd);
         memcpy(&_indices[numIndicesBeforeAdd], &cModel.modelData.indices[renderBatch.indexStart], numIndicesToAdd * sizeof(u16));
 
         drawCallTemplate.firstIndex = static_cast<u32>(numIndicesBeforeAdd);
         drawCallTemplate.indexCount = static_cast<u32>(numIndicesToAdd);
 
         // Add texture units
-        size_t numTextureUnitsBeforeAdd = _textureUnits.size();
         size_t numTextureUnitsToAdd = renderBatch.textureUnits.size();
+        size_t numTextureUnitsBeforeAdd = (numTextureUnitsToAdd > 0) ? _textureUnits.AddCount(numTextureUnitsToAdd) : 0;
 
-        _textureUnits.resize(numTextureUnitsBeforeAdd + numTextureUnitsToAdd);
         for (size_t j = 0; j < numTextureUnitsToAdd; j++)
         {
             TextureUnit& textureUnit = _textureUnits[numTextureUnitsBeforeAdd + j];
@@ -1354,6 +1458,9 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
                         Renderer::TextureDesc textureDesc;
                         textureDesc.path = textureSingleton.textureHashToPath[complexTexture.textureNameIndex];
                         _renderer->LoadTextureIntoArray(textureDesc, _cModelTextures, textureUnit.textureIds[t]);
+
+                        _textureRefCounts[textureUnit.textureIds[t]]++;
+                        complexModel.textureIDs.push_back(textureUnit.textureIds[t]);
                     }
                     else if (complexTexture.type == CModel::ComplexTextureType::COMPONENT_MONSTER_SKIN_1)
                     {
@@ -1362,6 +1469,9 @@ bool CModelRenderer::LoadComplexModel(ComplexModelToBeLoaded& toBeLoaded, Loaded
                         //textureDesc.path = modelTexturePath.replace_filename("SnakeSkinBlack.dds").string();
                         textureDesc.path = modelTexturePath.replace_filename("druidcatskinpurple.dds").string();
                         _renderer->LoadTextureIntoArray(textureDesc, _cModelTextures, textureUnit.textureIds[t]);
+
+                        _textureRefCounts[textureUnit.textureIds[t]]++;
+                        complexModel.textureIDs.push_back(textureUnit.textureIds[t]);
                     }
                 }
             }
@@ -1685,11 +1795,11 @@ bool CModelRenderer::IsRenderBatchTransparent(const CModel::ComplexRenderBatch&
     return false;
 }
 
-void CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain::Placement& placement)
+u32 CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain::Placement& placement)
 {
     // Add the instance
-    size_t numInstancesBeforeAdd = _instances.size();
-    Instance& instance = _instances.emplace_back();
+    size_t numInstancesBeforeAdd = _instances.AddCount(1);
+    Instance& instance = _instances[numInstancesBeforeAdd];
 
     vec3 pos = placement.position;
     vec3 rot = glm::radians(placement.rotation);
@@ -1701,8 +1811,17 @@ void CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain
     instance.modelId = complexModel.objectID;
     instance.instanceMatrix = glm::translate(mat4x4(1.0f), pos) * rotationMatrix * scaleMatrix;
 
-    BufferRangeFrame& boneDeformRangeFrame = _instanceBoneDeformRangeFrames.emplace_back();
-    BufferRangeFrame& boneInstanceRangeFrame = _instanceBoneInstanceRangeFrames.emplace_back();
+    complexModel.numInstances++;
+
+    // The range frames are indexed by instance, instances can reuse freed slots
+    if (numInstancesBeforeAdd >= _instanceBoneDeformRangeFrames.size())
+    {
+        _instanceBoneDeformRangeFrames.resize(numInstancesBeforeAdd + 1);
+        _instanceBoneInstanceRangeFrames.resize(numInstancesBeforeAdd + 1);
+    }
+
+    BufferRangeFrame& boneDeformRangeFrame = _instanceBoneDeformRangeFrames[numInstancesBeforeAdd];
+    BufferRangeFrame& boneInstanceRangeFrame = _instanceBoneInstanceRangeFrames[numInstancesBeforeAdd];
 
     if (complexModel.isAnimated)
     {
@@ -1764,7 +1883,10 @@ void CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain
         assert(boneInstanceRangeFrame.offset % sizeof(AnimationBoneInstance) == 0);
         instance.boneInstanceDataOffset = static_cast<u32>(boneInstanceRangeFrame.offset) / sizeof(AnimationBoneInstance);
 
-        _animationBoneInstances.resize(instance.boneInstanceDataOffset);
+        if (instance.boneInstanceDataOffset + numBones > _animationBoneInstances.size())
+        {
+            _animationBoneInstances.resize(instance.boneInstanceDataOffset + numBones);
+        }
     }
     else
     {
@@ -1773,14 +1895,17 @@ void CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain
     }
 
     // Add the opaque DrawCalls and DrawCallDatas
-    size_t numOpaqueDrawCallsBeforeAdd = _opaqueDrawCalls.size();
+    size_t numOpaqueDrawCallsBeforeAdd = _opaqueDrawCalls.AddCount(complexModel.numOpaqueDrawCalls);
+    size_t numOpaqueDrawCallDatasBeforeAdd = _opaqueDrawCallDatas.AddCount(complexModel.numOpaqueDrawCalls);
+    assert(numOpaqueDrawCallsBeforeAdd == numOpaqueDrawCallDatasBeforeAdd);
+
     for (u32 i = 0; i < complexModel.numOpaqueDrawCalls; i++)
     {
         const DrawCall& drawCallTemplate = complexModel.opaqueDrawCallTemplates[i];
         const DrawCallData& drawCallDataTemplate = complexModel.opaqueDrawCallDataTemplates[i];
 
-        DrawCall& drawCall = _opaqueDrawCalls.emplace_back();
-        DrawCallData& drawCallData = _opaqueDrawCallDatas.emplace_back();
+        DrawCall& drawCall = _opaqueDrawCalls[numOpaqueDrawCallsBeforeAdd + i];
+        DrawCallData& drawCallData = _opaqueDrawCallDatas[numOpaqueDrawCallsBeforeAdd + i];
 
         _opaqueDrawCallDataIndexToLoadedModelIndex[static_cast<u32>(numOpaqueDrawCallsBeforeAdd) + i] = complexModel.objectID;
 
@@ -1798,17 +1923,22 @@ void CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain
         // Fill in the data that shouldn't be templated
         drawCall.firstInstance = static_cast<u32>(numOpaqueDrawCallsBeforeAdd + i); // This is used in the shader to retrieve the DrawCallData
         drawCallData.instanceID = static_cast<u32>(numInstancesBeforeAdd);
+
+        _numOpaqueTriangles += drawCall.indexCount / 3;
     }
 
     // Add the transparent DrawCalls and DrawCallDatas
-    size_t numTransparentDrawCallsBeforeAdd = _transparentDrawCalls.size();
+    size_t numTransparentDrawCallsBeforeAdd = _transparentDrawCalls.AddCount(complexModel.numTransparentDrawCalls);
+    size_t numTransparentDrawCallDatasBeforeAdd = _transparentDrawCallDatas.AddCount(complexModel.numTransparentDrawCalls);
+    assert(numTransparentDrawCallsBeforeAdd == numTransparentDrawCallDatasBeforeAdd);
+
     for (u32 i = 0; i < complexModel.numTransparentDrawCalls; i++)
     {
         const DrawCall& drawCallTemplate = complexModel.transparentDrawCallTemplates[i];
         const DrawCallData& drawCallDataTemplate = complexModel.transparentDrawCallDataTemplates[i];
 
-        DrawCall& drawCall = _transparentDrawCalls.emplace_back();
-        DrawCallData& drawCallData = _transparentDrawCallDatas.emplace_back();
+        DrawCall& drawCall = _transparentDrawCalls[numTransparentDrawCallsBeforeAdd + i];
+        DrawCallData& drawCallData = _transparentDrawCallDatas[numTransparentDrawCallsBeforeAdd + i];
         _transparentDrawCallDataIndexToLoadedModelIndex[static_cast<u32>(numTransparentDrawCallsBeforeAdd) + i] = complexModel.objectID;
 
         // Copy data from the templates
@@ -1825,251 +1955,277 @@ void CModelRenderer::AddInstance(LoadedComplexModel& complexModel, const Terrain
         // Fill in the data that shouldn't be templated
         drawCall.firstInstance = static_cast<u32>(numTransparentDrawCallsBeforeAdd + i); // This is used in the shader to retrieve the DrawCallData
         drawCallData.instanceID = static_cast<u32>(numInstancesBeforeAdd);
+
+        _numTransparentTriangles += drawCall.indexCount / 3;
     }
+
+    return static_cast<u32>(numInstancesBeforeAdd);
 }
 
-void CModelRenderer::CreateBuffers()
+void CModelRenderer::RemoveInstances()
 {
-    // Create Vertex buffer
+    if (_instancesToBeRemoved.size() == 0)
+        return;
+
+    ZoneScoped;
+
+    std::vector<bool> isInstanceRemoved(_instances.Size(), false);
+
+    for (u32 instanceID : _instancesToBeRemoved)
     {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelVertexBuffer";
-        desc.size = sizeof(CModel::ComplexVertex) * _vertices.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
+        Instance& instance = _instances[instanceID];
+        LoadedComplexModel& complexModel = _loadedComplexModels[instance.modelId];
+
+        if (complexModel.isAnimated)
+        {
+            _animationBoneDeformRangeAllocator.Free(_instanceBoneDeformRangeFrames[instanceID]);
+            _animationBoneInstancesRangeAllocator.Free(_instanceBoneInstanceRangeFrames[instanceID]);
+        }
 
-        _vertexBuffer = _renderer->CreateAndFillBuffer(_vertexBuffer, desc, _vertices.data(), desc.size);
+        _instanceBoneDeformRangeFrames[instanceID] = BufferRangeFrame();
+        _instanceBoneInstanceRangeFrames[instanceID] = BufferRangeFrame();
+
+        if (--complexModel.numInstances == 0)
+        {
+            UnloadComplexModel(complexModel);
+        }
+
+        _instances.Remove(instanceID, 1);
+        isInstanceRemoved[instanceID] = true;
     }
-    
-    // Create Index buffer
+    _instancesToBeRemoved.clear();
+
+    CompactDrawCalls(_opaqueDrawCalls, _opaqueDrawCallDatas, _opaqueDrawCallDataIndexToLoadedModelIndex, isInstanceRemoved, _numOpaqueTriangles);
+    CompactDrawCalls(_transparentDrawCalls, _transparentDrawCallDatas, _transparentDrawCallDataIndexToLoadedModelIndex, isInstanceRemoved, _numTransparentTriangles);
+
+    _complexModelPlacementDetails.erase(std::remove_if(_complexModelPlacementDetails.begin(), _complexModelPlacementDetails.end(), [&](const Terrain::PlacementDetails& placementDetails)
+        {
+            return isInstanceRemoved[placementDetails.instanceIndex];
+        }), _complexModelPlacementDetails.end());
+
+    if (_texturesToUnload.size() > 0)
     {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelIndexBuffer";
-        desc.size = sizeof(u16) * _indices.size();
-        desc.usage = Renderer::BufferUsage::INDEX_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _indexBuffer = _renderer->CreateAndFillBuffer(_indexBuffer, desc, _indices.data(), desc.size);
+        _renderer->UnloadTexturesInArray(_cModelTextures, _texturesToUnload);
+        _texturesToUnload.clear();
     }
+}
 
-    // Create TextureUnit buffer
+void CModelRenderer::UnloadComplexModel(LoadedComplexModel& complexModel)
+{
+    // Indices and texture units were allocated per renderbatch, so we free them the same way
+    for (u32 i = 0; i < complexModel.numOpaqueDrawCalls; i++)
     {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelTextureUnitBuffer";
-        desc.size = sizeof(TextureUnit) * _textureUnits.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _textureUnitBuffer = _renderer->CreateAndFillBuffer(_textureUnitBuffer, desc, _textureUnits.data(), desc.size);
+        const DrawCall& drawCallTemplate = complexModel.opaqueDrawCallTemplates[i];
+        const DrawCallData& drawCallDataTemplate = complexModel.opaqueDrawCallDataTemplates[i];
+
+        _indices.Remove(drawCallTemplate.firstIndex, drawCallTemplate.indexCount);
+        _textureUnits.Remove(drawCallDataTemplate.textureUnitOffset, drawCallDataTemplate.numTextureUnits);
     }
 
-    // Create Instance buffer
+    for (u32 i = 0; i < complexModel.numTransparentDrawCalls; i++)
     {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelInstanceBuffer";
-        desc.size = sizeof(Instance) * _instances.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _instanceBuffer = _renderer->CreateAndFillBuffer(_instanceBuffer, desc, _instances.data(), desc.size);
+        const DrawCall& drawCallTemplate = complexModel.transparentDrawCallTemplates[i];
+        const DrawCallData& drawCallDataTemplate = complexModel.transparentDrawCallDataTemplates[i];
+
+        _indices.Remove(drawCallTemplate.firstIndex, drawCallTemplate.indexCount);
+        _textureUnits.Remove(drawCallDataTemplate.textureUnitOffset, drawCallDataTemplate.numTextureUnits);
     }
 
-    // Create CullingData buffer
+    _vertices.Remove(complexModel.vertexOffset, complexModel.numVertices);
+
+    if (complexModel.cullingDataID != std::numeric_limits<u32>().max())
     {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelCullDataBuffer";
-        desc.size = sizeof(CModel::CullingData) * _cullingDatas.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _cullingDataBuffer = _renderer->CreateAndFillBuffer(_cullingDataBuffer, desc, _cullingDatas.data(), desc.size);
+        _cullingDatas.Remove(complexModel.cullingDataID, 1);
     }
 
-    // Create AnimationSequence buffer
+    // Animation data
+    if (complexModel.objectID < _animationModelInfo.Size())
     {
-        size_t numSequences = _animationSequence.size();
-        if (numSequences > 0)
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationSequenceBuffer";
-            desc.size = sizeof(AnimationSequence) * numSequences;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationSequenceBuffer = _renderer->CreateAndFillBuffer(_animationSequenceBuffer, desc, _animationSequence.data(), desc.size);
-        }
-    }    
-    
-    // Create AnimationModelInfo buffer
-    {
-        size_t numModelInfo = _animationModelInfo.size();
-        if (numModelInfo > 0)
+        AnimationModelInfo& animationModelInfo = _animationModelInfo[complexModel.objectID];
+
+        auto RemoveTracks = [&](u32 trackOffset, u16 numTracks)
         {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationModelInfoBuffer";
-            desc.size = sizeof(AnimationModelInfo) * numModelInfo;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationModelInfoBuffer = _renderer->CreateAndFillBuffer(_animationModelInfoBuffer, desc, _animationModelInfo.data(), desc.size);
-        }
-    }    
-    
-    // Create AnimationBoneInfo buffer
-    {
-        size_t numBoneInfo = _animationBoneInfo.size();
-        if (numBoneInfo > 0)
+            for (u32 i = 0; i < numTracks; i++)
+            {
+                const AnimationTrackInfo& trackInfo = _animationTrackInfo[trackOffset + i];
+
+                _animationTrackTimestamps.Remove(trackInfo.timestampOffset, trackInfo.numTimestamps);
+                _animationTrackValues.Remove(trackInfo.valueOffset, trackInfo.numValues);
+            }
+
+            _animationTrackInfo.Remove(trackOffset, numTracks);
+        };
+
+        for (u32 i = 0; i < animationModelInfo.numBones; i++)
         {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationBoneInfoBuffer";
-            desc.size = sizeof(AnimationBoneInfo) * numBoneInfo;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationBoneInfoBuffer = _renderer->CreateAndFillBuffer(_animationBoneInfoBuffer, desc, _animationBoneInfo.data(), desc.size);
+            const AnimationBoneInfo& boneInfo = _animationBoneInfo[animationModelInfo.boneInfoOffset + i];
+
+            RemoveTracks(boneInfo.translationSequenceOffset, boneInfo.numTranslationSequences);
+            RemoveTracks(boneInfo.rotationSequenceOffset, boneInfo.numRotationSequences);
+            RemoveTracks(boneInfo.scaleSequenceOffset, boneInfo.numScaleSequences);
         }
+
+        _animationBoneInfo.Remove(animationModelInfo.boneInfoOffset, animationModelInfo.numBones);
+        _animationSequence.Remove(animationModelInfo.sequenceOffset, animationModelInfo.numSequences);
+
+        animationModelInfo = AnimationModelInfo();
+        _animationModelInfo.SetDirtyElement(complexModel.objectID);
     }
 
-    // Create AnimationSequence buffer
+    // Textures can be shared with other models, so only unload the ones nobody else uses
+    for (u32 textureID : complexModel.textureIDs)
     {
-        size_t numSequenceInfo = _animationTrackInfo.size();
-        if (numSequenceInfo > 0)
+        if (--_textureRefCounts[textureID] == 0)
         {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationTrackInfoBuffer";
-            desc.size = sizeof(AnimationTrackInfo) * numSequenceInfo;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationTrackInfoBuffer = _renderer->CreateAndFillBuffer(_animationTrackInfoBuffer, desc, _animationTrackInfo.data(), desc.size);
+            _texturesToUnload.push_back(textureID);
         }
     }
-    
-    // Create AnimationTimestamp buffer
+
+    _nameHashToIndexMap.erase(complexModel.nameHash);
+    _freeModelIDs.push_back(complexModel.objectID);
+
+    u32 objectID = complexModel.objectID;
+    complexModel = LoadedComplexModel();
+    complexModel.objectID = objectID;
+}
+
+void CModelRenderer::CompactDrawCalls(Renderer::GPUVector<DrawCall>& drawCalls, Renderer::GPUVector<DrawCallData>& drawCallDatas, robin_hood::unordered_map<u32, u32>& drawCallDataIndexToLoadedModelIndex, const std::vector<bool>& isInstanceRemoved, u32& numTriangles)
+{
+    // Culling and drawing run over the first N drawcalls, so the ones we keep are slid down to fill the holes
+    u32 numDrawCalls = static_cast<u32>(drawCalls.Size());
+    u32 numKept = 0;
+    u32 firstMoved = numDrawCalls;
+
+    for (u32 i = 0; i < numDrawCalls; i++)
     {
-        size_t numTrackTimestamps = _animationTrackTimestamps.size();
-        if (numTrackTimestamps > 0)
+        if (isInstanceRemoved[drawCallDatas[i].instanceID])
         {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationTrackTimestampBuffer";
-            desc.size = sizeof(u32) * numTrackTimestamps;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationTrackTimestampBuffer = _renderer->CreateAndFillBuffer(_animationTrackTimestampBuffer, desc, _animationTrackTimestamps.data(), desc.size);
+            numTriangles -= drawCalls[i].indexCount / 3;
+            continue;
         }
-    }
 
-    // Create AnimationValueVec buffer
-    {
-        size_t numTrackValues = _animationTrackValues.size();
-        if (numTrackValues > 0)
+        if (i != numKept)
         {
-            Renderer::BufferDesc desc;
-            desc.name = "AnimationTrackValueBuffer";
-            desc.size = sizeof(vec4) * numTrackValues;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _animationTrackValueBuffer = _renderer->CreateAndFillBuffer(_animationTrackValueBuffer, desc, _animationTrackValues.data(), desc.size);
+            firstMoved = std::min(firstMoved, numKept);
+
+            drawCalls[numKept] = drawCalls[i];
+            drawCalls[numKept].firstInstance = numKept; // This is used in the shader to retrieve the DrawCallData
+            drawCallDatas[numKept] = drawCallDatas[i];
+            drawCallDataIndexToLoadedModelIndex[numKept] = drawCallDataIndexToLoadedModelIndex[i];
         }
+
+        numKept++;
     }
 
-    if (_opaqueDrawCalls.size() > 0)
+    for (u32 i = numKept; i < numDrawCalls; i++)
     {
-        // Create OpaqueDrawCall and OpaqueCulledDrawCall buffer
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "CModelOpaqueDrawCallBuffer";
-            desc.size = sizeof(DrawCall) * _opaqueDrawCalls.size();
-            desc.usage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _opaqueDrawCallBuffer = _renderer->CreateAndFillBuffer(_opaqueDrawCallBuffer, desc, _opaqueDrawCalls.data(), desc.size);
+        drawCallDataIndexToLoadedModelIndex.erase(i);
+    }
 
-            desc.name = "CModelOpaqueCullDrawCallBuffer";
-            _opaqueCulledDrawCallBuffer = _renderer->CreateBuffer(_opaqueCulledDrawCallBuffer, desc);
-        }
+    drawCalls.Truncate(numKept);
+    drawCallDatas.Truncate(numKept);
 
-        // Create OpaqueDrawCallData buffer
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "CModelOpaqueDrawCallDataBuffer";
-            desc.size = sizeof(DrawCallData) * _opaqueDrawCallDatas.size();
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _opaqueDrawCallDataBuffer = _renderer->CreateAndFillBuffer(_opaqueDrawCallDataBuffer, desc, _opaqueDrawCallDatas.data(), desc.size);
-        }
+    if (firstMoved < numKept)
+    {
+        drawCalls.SetDirtyElements(firstMoved, numKept - firstMoved);
+        drawCallDatas.SetDirtyElements(firstMoved, numKept - firstMoved);
     }
+}
 
-    // Destroy TransparentDrawCall buffer
-    if (_transparentDrawCalls.size() > 0)
+void CModelRenderer::SyncToGPU()
+{
+    // Only the ranges touched since the last sync get uploaded, the buffers themselves are only recreated when they have to grow
+    _vertices.SyncToGPU(_renderer);
+    _indices.SyncToGPU(_renderer);
+    _textureUnits.SyncToGPU(_renderer);
+    bool instancesRecreated = _instances.SyncToGPU(_renderer);
+    _cullingDatas.SyncToGPU(_renderer);
+
+    _animationSequence.SyncToGPU(_renderer);
+    _animationModelInfo.SyncToGPU(_renderer);
+    _animationBoneInfo.SyncToGPU(_renderer);
+    _animationTrackInfo.SyncToGPU(_renderer);
+    _animationTrackTimestamps.SyncToGPU(_renderer);
+    _animationTrackValues.SyncToGPU(_renderer);
+
+    _opaqueDrawCallDatas.SyncToGPU(_renderer);
+    _transparentDrawCallDatas.SyncToGPU(_renderer);
+
+    // The culling output buffers are sized after the capacity of their inputs, so we only recreate them when those grow
+    if (_opaqueDrawCalls.SyncToGPU(_renderer))
     {
-        // Create TransparentDrawCall, TransparentCulledDrawCall and TransparentSortedCulledDrawCall buffer
-        {
-            u32 size = sizeof(DrawCall) * static_cast<u32>(_transparentDrawCalls.size());
+        Renderer::BufferDesc desc;
+        desc.name = "CModelOpaqueCullDrawCallBuffer";
+        desc.size = sizeof(DrawCall) * _opaqueDrawCalls.Capacity();
+        desc.usage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
+        _opaqueCulledDrawCallBuffer = _renderer->CreateBuffer(_opaqueCulledDrawCallBuffer, desc);
+    }
 
+    if (_transparentDrawCalls.SyncToGPU(_renderer))
+    {
+        size_t numDrawCalls = _transparentDrawCalls.Capacity();
+
+        // Create TransparentCulledDrawCall and TransparentSortedCulledDrawCall buffer
+        {
             Renderer::BufferDesc desc;
             desc.name = "CModelAlphaCullDrawCalls";
-            desc.size = size;
+            desc.size = sizeof(DrawCall) * numDrawCalls;
             desc.usage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
             _transparentCulledDrawCallBuffer = _renderer->CreateBuffer(_transparentCulledDrawCallBuffer, desc);
 
             desc.name = "CModelAlphaSortCullDrawCalls";
             _transparentSortedCulledDrawCallBuffer = _renderer->CreateBuffer(_transparentSortedCulledDrawCallBuffer, desc);
-
-            desc.name = "CModelAlphaDrawCalls";
-            desc.usage |= Renderer::BufferUsage::TRANSFER_SOURCE;
-            _transparentDrawCallBuffer = _renderer->CreateAndFillBuffer(_transparentDrawCallBuffer, desc, _transparentDrawCalls.data(), desc.size);
-        }
-
-        // Create TransparentDrawCallData buffer
-        {
-            Renderer::BufferDesc desc;
-            desc.name = "CModelAlphaDrawCallDataBuffer";
-            desc.size = sizeof(DrawCallData) * _transparentDrawCallDatas.size();
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _transparentDrawCallDataBuffer = _renderer->CreateAndFillBuffer(_transparentDrawCallDataBuffer, desc, _transparentDrawCallDatas.data(), desc.size);
         }
 
         // Create transparent sort keys/values buffer
         {
-            u32 numDrawCalls = static_cast<u32>(_transparentDrawCalls.size());
-            u32 keysSize = sizeof(u64) * numDrawCalls;
-            u32 valuesSize = sizeof(u32) * numDrawCalls;
-
             Renderer::BufferDesc desc;
             desc.name = "CModelAlphaSortKeys";
-            desc.size = keysSize;
+            desc.size = sizeof(u64) * numDrawCalls;
             desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_SOURCE | Renderer::BufferUsage::TRANSFER_DESTINATION;
             _transparentSortKeys = _renderer->CreateBuffer(_transparentSortKeys, desc);
 
             desc.name = "CModelAlphaSortValues";
-            desc.size = valuesSize;
+            desc.size = sizeof(u32) * numDrawCalls;
             _transparentSortValues = _renderer->CreateBuffer(_transparentSortValues, desc);
         }
     }
-    else
+
+    if (instancesRecreated)
     {
-        // Create transparent sort keys/values buffer
-        {
-            u32 keysSize = sizeof(u64) * 1;
-            u32 valuesSize = sizeof(u32) * 1;
+        size_t numInstances = _instances.Capacity();
 
+        {
             Renderer::BufferDesc desc;
-            desc.name = "CModelAlphaSortKeys";
-            desc.size = keysSize;
-            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_SOURCE | Renderer::BufferUsage::TRANSFER_DESTINATION;
-            _transparentSortKeys = _renderer->CreateBuffer(_transparentSortKeys, desc);
-
-            desc.name = "CModelAlphaSortValues";
-            desc.size = valuesSize;
-            _transparentSortValues = _renderer->CreateBuffer(_transparentSortValues, desc);
+            desc.name = "CModelVisibleInstanceMaskBuffer";
+            desc.size = sizeof(u32) * ((numInstances + 31) / 32);
+            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
+            _visibleInstanceMaskBuffer = _renderer->CreateBuffer(_visibleInstanceMaskBuffer, desc);
+        }
+        {
+            Renderer::BufferDesc desc;
+            desc.name = "CModelVisibleInstanceIndexBuffer";
+            desc.size = sizeof(u32) * numInstances;
+            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER;
+            _visibleInstanceIndexBuffer = _renderer->CreateBuffer(_visibleInstanceIndexBuffer, desc);
         }
     }
 
+    if (_visibleInstanceCountBuffer == Renderer::BufferID::Invalid())
     {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelVisibleInstanceMaskBuffer";
-        desc.size = sizeof(u32) * ((_instances.size() + 31) / 32);
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _visibleInstanceMaskBuffer = _renderer->CreateBuffer(_visibleInstanceMaskBuffer, desc);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelVisibleInstanceCountBuffer";
-        desc.size = sizeof(u32);
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _visibleInstanceCountBuffer = _renderer->CreateBuffer(_visibleInstanceCountBuffer, desc);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelVisibleInstanceIndexBuffer";
-        desc.size = sizeof(u32) * _instances.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER;
-        _visibleInstanceIndexBuffer = _renderer->CreateBuffer(_visibleInstanceIndexBuffer, desc);
-    }
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "CModelVisibleInstanceIndexBuffer";
-        desc.size = sizeof(VkDispatchIndirectCommand);
-        desc.usage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER;
-        _visibleInstanceCountArgumentBuffer32 = _renderer->CreateBuffer(_visibleInstanceCountArgumentBuffer32, desc);
+        {
+            Renderer::BufferDesc desc;
+            desc.name = "CModelVisibleInstanceCountBuffer";
+            desc.size = sizeof(u32);
+            desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
+            _visibleInstanceCountBuffer = _renderer->CreateBuffer(desc);
+        }
+        {
+            Renderer::BufferDesc desc;
+            desc.name = "CModelVisibleInstanceIndexBuffer";
+            desc.size = sizeof(VkDispatchIndirectCommand);
+            desc.usage = Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER | Renderer::BufferUsage::STORAGE_BUFFER;
+            _visibleInstanceCountArgumentBuffer32 = _renderer->CreateBuffer(desc);
+        }
     }
 }
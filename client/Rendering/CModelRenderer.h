@@ -14,6 +14,7 @@
 #include <Renderer/Descriptors/BufferDesc.h>
 #include <Renderer/Buffer.h>
 #include <Renderer/DescriptorSet.h>
+#include <Renderer/GPUVector.h>
 
 #include "../Gameplay/Map/Chunk.h"
 #include "CModel/CModel.h"
@@ -68,8 +69,15 @@ public:
     struct LoadedComplexModel
     {
         u32 objectID;
+        u32 nameHash = 0;
         std::string debugName = "";
 
+        // Geometry and textures are released once the last instance is unloaded
+        u32 numInstances = 0;
+        u32 vertexOffset = 0;
+        u32 numVertices = 0;
+        std::vector<u32> textureIDs;
+
         u32 cullingDataID = std::numeric_limits<u32>().max();
         u32 numBones = 0;
         bool isAnimated = false;
@@ -136,17 +144,18 @@ public:
     void AddComplexModelPass(Renderer::RenderGraph* renderGraph, RenderResources& resources, u8 frameIndex);
 
     void RegisterLoadFromChunk(u16 chunkID, const Terrain::Chunk& chunk, StringTable& stringTable);
+    void UnloadChunk(u16 chunkID);
     void ExecuteLoad();
 
     void Clear();
 
-    const std::vector<DrawCallData>& GetOpaqueDrawCallData() { return _opaqueDrawCallDatas; }
-    const std::vector<DrawCallData>& GetTransparentDrawCallData() { return _transparentDrawCallDatas; }
+    const std::vector<DrawCallData>& GetOpaqueDrawCallData() { return _opaqueDrawCallDatas.ReadGet(); }
+    const std::vector<DrawCallData>& GetTransparentDrawCallData() { return _transparentDrawCallDatas.ReadGet(); }
     const std::vector<LoadedComplexModel>& GetLoadedComplexModels() { return _loadedComplexModels; }
-    const std::vector<Instance>& GetInstances() { return _instances; }
+    const std::vector<Instance>& GetInstances() { return _instances.ReadGet(); }
     Instance& GetInstance(size_t index) { return _instances[index]; }
     const std::vector<Terrain::PlacementDetails>& GetPlacementDetails() { return _complexModelPlacementDetails; }
-    const std::vector<CModel::CullingData>& GetCullingData() { return _cullingDatas; }
+    const std::vector<CModel::CullingData>& GetCullingData() { return _cullingDatas.ReadGet(); }
 
     void AddAnimationRequest(AnimationRequest request)
     {
@@ -158,8 +167,8 @@ public:
     }
 
     u32 GetChunkPlacementDetailsOffset(u16 chunkID) { return _mapChunkToPlacementOffset[chunkID]; }
-    u32 GetNumLoadedCModels() { return static_cast<u32>(_loadedComplexModels.size()); }
-    u32 GetNumCModelPlacements() { return static_cast<u32>(_instances.size()); }
+    u32 GetNumLoadedCModels() { return static_cast<u32>(_nameHashToIndexMap.size()); }
+    u32 GetNumCModelPlacements() { return static_cast<u32>(_complexModelPlacementDetails.size()); }
     u32 GetModelIndexByDrawCallDataIndex(u32 index, bool isOpaque)
     {
         u32 modelIndex = std::numeric_limits<u32>().max();
@@ -173,9 +182,9 @@ public:
     }
     
     // Drawcall stats
-    u32 GetNumOpaqueDrawCalls() { return static_cast<u32>(_opaqueDrawCalls.size()); }
+    u32 GetNumOpaqueDrawCalls() { return static_cast<u32>(_opaqueDrawCalls.Size()); }
     u32 GetNumOpaqueSurvivingDrawCalls() { return _numOpaqueSurvivingDrawCalls; }
-    u32 GetNumTransparentDrawCalls() { return static_cast<u32>(_transparentDrawCalls.size()); }
+    u32 GetNumTransparentDrawCalls() { return static_cast<u32>(_transparentDrawCalls.Size()); }
     u32 GetNumTransparentSurvivingDrawCalls() { return _numTransparentSurvivingDrawCalls; }
 
     // Triangle stats
@@ -190,6 +199,7 @@ private:
         const Terrain::Placement* placement = nullptr;
         const std::string* name = nullptr;
         u32 nameHash = 0;
+        u16 chunkID = Terrain::MAP_CHUNK_ID_INVALID;
     };
 
     struct TextureUnit
@@ -315,9 +325,12 @@ private:
 
     bool IsRenderBatchTransparent(const CModel::ComplexRenderBatch& renderBatch, const CModel::ComplexModel& cModel);
 
-    void AddInstance(LoadedComplexModel& complexModel, const Terrain::Placement& placement);
+    u32 AddInstance(LoadedComplexModel& complexModel, const Terrain::Placement& placement);
+    void RemoveInstances();
+    void UnloadComplexModel(LoadedComplexModel& complexModel);
+    void CompactDrawCalls(Renderer::GPUVector<DrawCall>& drawCalls, Renderer::GPUVector<DrawCallData>& drawCallDatas, robin_hood::unordered_map<u32, u32>& drawCallDataIndexToLoadedModelIndex, const std::vector<bool>& isInstanceRemoved, u32& numTriangles);
 
-    void CreateBuffers();
+    void SyncToGPU();
 
 private:
     Renderer::Renderer* _renderer;
@@ -331,69 +344,62 @@ private:
     robin_hood::unordered_map<u32, u8> _uniqueIdCounter;
     robin_hood::unordered_map<u16, u32> _mapChunkToPlacementOffset;
     std::vector<Terrain::PlacementDetails> _complexModelPlacementDetails;
+    robin_hood::unordered_map<u16, std::vector<u32>> _chunkUniqueIDs;
+    robin_hood::unordered_map<u32, u32> _uniqueIdToInstance;
+    std::vector<u32> _instancesToBeRemoved;
 
     SafeVector<ComplexModelToBeLoaded> _complexModelsToBeLoaded; // TODO: Make this a concurrent queue
     std::vector<LoadedComplexModel> _loadedComplexModels;
     robin_hood::unordered_map<u32, u32> _nameHashToIndexMap;
+    std::vector<u32> _freeModelIDs;
+    std::vector<u16> _textureRefCounts; // Indexed by texture array slot, LoadTextureIntoArray hands out the same slot to every model using a texture
+    std::vector<u32> _texturesToUnload;
     robin_hood::unordered_map<u32, u32> _opaqueDrawCallDataIndexToLoadedModelIndex;
     robin_hood::unordered_map<u32, u32> _transparentDrawCallDataIndexToLoadedModelIndex;
 
-    std::vector<CModel::ComplexVertex> _vertices;
-    std::vector<u16> _indices;
-    std::vector<TextureUnit> _textureUnits;;
-    std::vector<Instance> _instances;
+    // These are sub-allocated GPU buffers, loads only upload what they added
+    Renderer::GPUVector<CModel::ComplexVertex> _vertices;
+    Renderer::GPUVector<u16> _indices;
+    Renderer::GPUVector<TextureUnit> _textureUnits;
+    Renderer::GPUVector<Instance> _instances;
     std::vector<BufferRangeFrame> _instanceBoneDeformRangeFrames;
     std::vector<BufferRangeFrame> _instanceBoneInstanceRangeFrames;
-    std::vector<CModel::CullingData> _cullingDatas;
+    Renderer::GPUVector<CModel::CullingData> _cullingDatas;
 
-    std::vector<AnimationSequence> _animationSequence;
-    std::vector<AnimationModelInfo> _animationModelInfo;
-    std::vector<AnimationBoneInfo> _animationBoneInfo;
+    Renderer::GPUVector<AnimationSequence> _animationSequence;
+    Renderer::GPUVector<AnimationModelInfo> _animationModelInfo;
+    Renderer::GPUVector<AnimationBoneInfo> _animationBoneInfo;
     std::vector<AnimationBoneInstance> _animationBoneInstances;
-    std::vector<AnimationTrackInfo> _animationTrackInfo;
-    std::vector<u32> _animationTrackTimestamps;
-    std::vector<vec4> _animationTrackValues;
+    Renderer::GPUVector<AnimationTrackInfo> _animationTrackInfo;
+    Renderer::GPUVector<u32> _animationTrackTimestamps;
+    Renderer::GPUVector<vec4> _animationTrackValues;
     BufferRangeAllocator _animationBoneDeformRangeAllocator;
     BufferRangeAllocator _animationBoneInstancesRangeAllocator;
     moodycamel::ConcurrentQueue<AnimationRequest> _animationRequests;
 
-    std::vector<DrawCall> _opaqueDrawCalls;
-    std::vector<DrawCallData> _opaqueDrawCallDatas;
+    // DrawCalls and DrawCallDatas are always added and removed together so their indices stay in sync
+    Renderer::GPUVector<DrawCall> _opaqueDrawCalls;
+    Renderer::GPUVector<DrawCallData> _opaqueDrawCallDatas;
 
-    std::vector<DrawCall> _transparentDrawCalls;
-    std::vector<DrawCallData> _transparentDrawCallDatas;
+    Renderer::GPUVector<DrawCall> _transparentDrawCalls;
+    Renderer::GPUVector<DrawCallData> _transparentDrawCallDatas;
 
-    Renderer::BufferID _vertexBuffer;
-    Renderer::BufferID _indexBuffer;
-    Renderer::BufferID _textureUnitBuffer;
-    Renderer::BufferID _instanceBuffer;
-    Renderer::BufferID _cullingDataBuffer;
     Renderer::BufferID _visibleInstanceMaskBuffer;
     Renderer::BufferID _visibleInstanceCountBuffer;
     Renderer::BufferID _visibleInstanceIndexBuffer;
     Renderer::BufferID _visibleInstanceCountArgumentBuffer32;
 
-    Renderer::BufferID _animationSequenceBuffer;
-    Renderer::BufferID _animationModelInfoBuffer;
-    Renderer::BufferID _animationBoneInfoBuffer;
     Renderer::BufferID _animationBoneDeformMatrixBuffer;
     Renderer::BufferID _animationBoneInstancesBuffer;
-    Renderer::BufferID _animationTrackInfoBuffer;
-    Renderer::BufferID _animationTrackTimestampBuffer;
-    Renderer::BufferID _animationTrackValueBuffer;
 
-    Renderer::BufferID _opaqueDrawCallBuffer;
     Renderer::BufferID _opaqueCulledDrawCallBuffer;
-    Renderer::BufferID _opaqueDrawCallDataBuffer;
     Renderer::BufferID _opaqueDrawCountBuffer;
     Renderer::BufferID _opaqueDrawCountReadBackBuffer;
     Renderer::BufferID _opaqueTriangleCountBuffer;
     Renderer::BufferID _opaqueTriangleCountReadBackBuffer;
 
-    Renderer::BufferID _transparentDrawCallBuffer;
     Renderer::BufferID _transparentCulledDrawCallBuffer;
     Renderer::BufferID _transparentSortedCulledDrawCallBuffer;
-    Renderer::BufferID _transparentDrawCallDataBuffer;
     Renderer::BufferID _transparentDrawCountBuffer;
     Renderer::BufferID _transparentDrawCountReadBackBuffer;
     Renderer::BufferID _transparentTriangleCountBuffer;
@@ -409,9 +415,9 @@ private:
     u32 _numOpaqueSurvivingDrawCalls;
     u32 _numTransparentSurvivingDrawCalls;
 
-    u32 _numOpaqueTriangles;
+    u32 _numOpaqueTriangles = 0;
     u32 _numOpaqueSurvivingTriangles;
-    u32 _numTransparentTriangles;
+    u32 _numTransparentTriangles = 0;
     u32 _numTransparentSurvivingTriangles;
 
     DebugRenderer* _debugRenderer;
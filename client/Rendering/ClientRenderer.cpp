@@ -20,6 +20,7 @@
 #include <GLFW/glfw3.h>
 #include <tracy/Tracy.hpp>
 #include <tracy/TracyVulkan.hpp>
+#include <taskflow/taskflow.hpp>
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -33,6 +34,8 @@ AutoCVar_Int CVAR_LightLockEnabled("lights.lock", "lock the light", 0, CVarFlags
 AutoCVar_Int CVAR_LightUseDefaultEnabled("lights.useDefault", "Use the map's default light", 0, CVarFlags::EditCheckbox);
 
 const size_t FRAME_ALLOCATOR_SIZE = 8 * 1024 * 1024; // 8 MB
+const size_t RECORDING_ALLOCATOR_SIZE = 2 * 1024 * 1024; // 2 MB
+const u32 NUM_RECORDING_WORKERS = 4;
 u32 MAIN_RENDER_LAYER = "MainLayer"_h; // _h will compiletime hash the string into a u32
 u32 DEPTH_PREPASS_RENDER_LAYER = "DepthPrepass"_h; // _h will compiletime hash the string into a u32
 
@@ -106,6 +109,8 @@ ClientRenderer::ClientRenderer()
     _terrainRenderer = new TerrainRenderer(_renderer, _debugRenderer, _cModelRenderer);
     _pixelQuery = new PixelQuery(_renderer);
 
+    _renderer->WarmupPipelines();
+
     ServiceLocator::SetClientRenderer(this);
 }
 
@@ -118,6 +123,10 @@ void ClientRenderer::Update(f32 deltaTime)
 {
     // Reset the memory in the frameAllocator
     _frameAllocator->Reset();
+    for (Memory::StackAllocator* allocator : _recordingAllocators)
+    {
+        allocator->Reset();
+    }
 
     _terrainRenderer->Update(deltaTime);
     _cModelRenderer->Update(deltaTime);
@@ -144,6 +153,8 @@ void ClientRenderer::Render()
     // Create rendergraph
     Renderer::RenderGraphDesc renderGraphDesc;
     renderGraphDesc.allocator = _frameAllocator; // We need to give our rendergraph an allocator to use
+    renderGraphDesc.taskflow = _recordingTaskflow;
+    renderGraphDesc.workerAllocators.assign(_recordingAllocators.begin(), _recordingAllocators.end());
     Renderer::RenderGraph renderGraph = _renderer->CreateRenderGraph(renderGraphDesc);
 
     _renderer->FlipFrame(_frameIndex);
@@ -179,12 +190,17 @@ void ClientRenderer::Render()
     {
         struct ClearPassData
         {
+            Renderer::RenderPassMutableResource color;
+            Renderer::RenderPassMutableResource objectIDs;
             Renderer::RenderPassMutableResource depth;
         };
 
         renderGraph.AddPass<ClearPassData>("ClearPass",
             [=](ClearPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
+            // The RenderGraph clears these to the clearColor / depthClearValue of their descs before the pass runs
+            data.color = builder.Write(_resources.color, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+            data.objectIDs = builder.Write(_resources.objectIDs, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
             data.depth = builder.Write(_resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
 
             return true; // Return true from setup to enable this pass, return false to disable it
@@ -194,11 +210,6 @@ void ClientRenderer::Render()
             GPU_SCOPED_PROFILER_ZONE(commandList, MainPass);
             commandList.MarkFrameStart(_frameIndex);
 
-            // Clear TODO: This should be handled by the parameters in Setup, and it should definitely not act on ImageID and DepthImageID
-            commandList.Clear(_resources.color, Color(135.0f / 255.0f, 206.0f / 255.0f, 250.0f / 255.0f, 1));
-            commandList.Clear(_resources.objectIDs, Color(0.0f, 0.0f, 0.0f, 0.0f));
-            commandList.Clear(_resources.depth, 0.0f);
-
             // Set viewport
             commandList.SetViewport(0, 0, static_cast<f32>(WIDTH), static_cast<f32>(HEIGHT), 0.0f, 1.0f);
             commandList.SetScissorRect(0, WIDTH, 0, HEIGHT);
@@ -227,12 +238,14 @@ void ClientRenderer::Render()
     struct PyramidPassData
     {
         Renderer::RenderPassResource depth;
+        Renderer::RenderPassMutableResource depthPyramid;
     };
 
     renderGraph.AddPass<PyramidPassData>("PyramidPass",
         [=](PyramidPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
-            data.depth = builder.Read(_resources.depth, Renderer::RenderGraphBuilder::ShaderStage::PIXEL);
+            data.depth = builder.Read(_resources.depth, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
+            data.depthPyramid = builder.Write(_resources.depthPyramid, Renderer::RenderGraphBuilder::WriteMode::UAV, Renderer::RenderGraphBuilder::LoadMode::DISCARD);
 
             return true; // Return true from setup to enable this pass, return false to disable it
         },
@@ -318,6 +331,11 @@ size_t ClientRenderer::GetVRAMBudget()
     return _renderer->GetVRAMBudget();
 }
 
+size_t ClientRenderer::GetTransientVRAMSaved()
+{
+    return _renderer->GetTransientVRAMSaved();
+}
+
 void ClientRenderer::CreatePermanentResources()
 {
     // Main color rendertarget
@@ -327,6 +345,7 @@ void ClientRenderer::CreatePermanentResources()
     mainColorDesc.dimensionType = Renderer::ImageDimensionType::DIMENSION_SCALE;
     mainColorDesc.format = Renderer::ImageFormat::R16G16B16A16_FLOAT;
     mainColorDesc.sampleCount = Renderer::SampleCount::SAMPLE_COUNT_1;
+    mainColorDesc.clearColor = Color(135.0f / 255.0f, 206.0f / 255.0f, 250.0f / 255.0f, 1.0f);
 
     _resources.color = _renderer->CreateImage(mainColorDesc);
 
@@ -337,6 +356,7 @@ void ClientRenderer::CreatePermanentResources()
     objectIDsDesc.dimensionType = Renderer::ImageDimensionType::DIMENSION_SCALE;
     objectIDsDesc.format = Renderer::ImageFormat::R32_UINT;
     objectIDsDesc.sampleCount = Renderer::SampleCount::SAMPLE_COUNT_1;
+    objectIDsDesc.clearColor = Color(0.0f, 0.0f, 0.0f, 0.0f);
 
     _resources.objectIDs = _renderer->CreateImage(objectIDsDesc);
 
@@ -356,6 +376,7 @@ void ClientRenderer::CreatePermanentResources()
     mainDepthDesc.dimensionType = Renderer::ImageDimensionType::DIMENSION_SCALE;
     mainDepthDesc.format = Renderer::DepthImageFormat::D32_FLOAT;
     mainDepthDesc.sampleCount = Renderer::SampleCount::SAMPLE_COUNT_1;
+    mainDepthDesc.depthClearValue = 0.0f; // Reverse Z
 
     _resources.depth = _renderer->CreateDepthImage(mainDepthDesc);
 
@@ -369,6 +390,16 @@ void ClientRenderer::CreatePermanentResources()
     _frameAllocator = new Memory::StackAllocator();
     _frameAllocator->Init(FRAME_ALLOCATOR_SIZE);
 
+    u32 numRecordingWorkers = glm::clamp(std::thread::hardware_concurrency() / 2, 1u, NUM_RECORDING_WORKERS);
+    _recordingTaskflow = new tf::Taskflow(numRecordingWorkers);
+    for (u32 i = 0; i < numRecordingWorkers; i++)
+    {
+        Memory::StackAllocator* allocator = new Memory::StackAllocator();
+        allocator->Init(RECORDING_ALLOCATOR_SIZE);
+
+        _recordingAllocators.push_back(allocator);
+    }
+
     _sceneRenderedSemaphore = _renderer->CreateNSemaphore();
     for (u32 i = 0; i < _frameSyncSemaphores.Num; i++)
     {
@@ -1,6 +1,8 @@
 #pragma once
 #include <NovusTypes.h>
 
+#include <vector>
+
 #include <Renderer/Descriptors/SamplerDesc.h>
 #include <Renderer/Descriptors/SemaphoreDesc.h>
 
@@ -18,6 +20,11 @@ namespace Memory
     class StackAllocator;
 }
 
+namespace tf
+{
+    class Taskflow;
+}
+
 class Window;
 class CameraFreeLook;
 class UIRenderer;
@@ -56,6 +63,7 @@ public:
 
     size_t GetVRAMUsage();
     size_t GetVRAMBudget();
+    size_t GetTransientVRAMSaved();
 
     const i32 WIDTH = 1920;
     const i32 HEIGHT = 1080;
@@ -68,6 +76,10 @@ private:
     Renderer::Renderer* _renderer;
     Memory::StackAllocator* _frameAllocator;
 
+    // RenderGraph passes record in parallel on these, every recording worker has its own allocator
+    tf::Taskflow* _recordingTaskflow;
+    std::vector<Memory::StackAllocator*> _recordingAllocators;
+
     u8 _frameIndex = 0;
 
     RenderResources _resources;
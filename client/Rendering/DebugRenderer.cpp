@@ -171,7 +171,7 @@ void DebugRenderer::AddUploadPass(Renderer::RenderGraph* renderGraph)
 			{
 				vertices.clear();
 			}
-		});
+		}, this);
 }
 
 void DebugRenderer::AddDrawArgumentPass(Renderer::RenderGraph* renderGraph, u8 frameIndex)
@@ -206,7 +206,7 @@ void DebugRenderer::AddDrawArgumentPass(Renderer::RenderGraph* renderGraph, u8 f
 
 			commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToIndirectArguments, _drawArgumentBuffer);
 			commandList.PipelineBarrier(Renderer::PipelineBarrierType::ComputeWriteToVertexBuffer, _debugVertexBuffer);
-		});
+		}, this);
 }
 
 void DebugRenderer::Add3DPass(Renderer::RenderGraph* renderGraph, RenderResources& resources, u8 frameIndex)
@@ -286,7 +286,7 @@ void DebugRenderer::Add3DPass(Renderer::RenderGraph* renderGraph, RenderResource
 
 				commandList.EndPipeline(pipeline);
 			}
-		});
+		}, this);
 }
 
 void DebugRenderer::Add2DPass(Renderer::RenderGraph* renderGraph, RenderResources& resources, u8 frameIndex)
@@ -351,7 +351,7 @@ void DebugRenderer::Add2DPass(Renderer::RenderGraph* renderGraph, RenderResource
 			commandList.DrawIndirect(_drawArgumentBuffer, GetDrawBufferOffset(DBG_VERTEX_BUFFER_LINES_2D), 1);
 
 			commandList.EndPipeline(pipeline);
-		});
+		}, this);
 }
 
 void DebugRenderer::DrawLine2D(const glm::vec2& from, const glm::vec2& to, uint32_t color)
@@ -49,7 +49,7 @@ void MapObjectRenderer::Update(f32 deltaTime)
     if (drawBoundingBoxes)
     {
         // Draw bounding boxes
-        for (u32 i = 0; i < _drawParameters.size(); i++)
+        for (u32 i = 0; i < _drawParameters.Size(); i++)
         {
             DrawParameters& drawParameters = _drawParameters[i];
             u32 instanceID = drawParameters.firstInstance;
@@ -80,7 +80,7 @@ void MapObjectRenderer::Update(f32 deltaTime)
     }
 
     // Read back from the culling counter
-    u32 numDrawCalls = static_cast<u32>(_drawParameters.size());
+    u32 numDrawCalls = static_cast<u32>(_drawParameters.Size());
     _numSurvivingDrawCalls = numDrawCalls;
     _numSurvivingTriangles = _numTriangles;
 
@@ -124,7 +124,7 @@ void MapObjectRenderer::AddMapObjectDepthPrepass(Renderer::RenderGraph* renderGr
         renderGraph->AddPass<MapObjectDepthPrepassData>("MapObject Depth Prepass",
             [=](MapObjectDepthPrepassData& data, Renderer::RenderGraphBuilder& builder) // Setup
             {
-                data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+                data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
 
                 return true; // Return true from setup to enable this pass, return false to disable it
             },
@@ -132,7 +132,7 @@ void MapObjectRenderer::AddMapObjectDepthPrepass(Renderer::RenderGraph* renderGr
             {
                 GPU_SCOPED_PROFILER_ZONE(commandList, MapObjectPass);
 
-                u32 drawCount = static_cast<u32>(_drawParameters.size());
+                u32 drawCount = static_cast<u32>(_drawParameters.Size());
                 if (drawCount == 0)
                     return;
 
@@ -157,7 +157,7 @@ void MapObjectRenderer::AddMapObjectDepthPrepass(Renderer::RenderGraph* renderGr
                     Renderer::ComputePipelineID pipeline = _renderer->CreatePipeline(pipelineDesc);
                     commandList.BeginPipeline(pipeline);
 
-                    const u32 drawCount = static_cast<u32>(_drawParameters.size());
+                    const u32 drawCount = static_cast<u32>(_drawParameters.Size());
                     if (!lockFrustum)
                     {
                         Camera* camera = ServiceLocator::GetCamera();
@@ -169,7 +169,7 @@ void MapObjectRenderer::AddMapObjectDepthPrepass(Renderer::RenderGraph* renderGr
                     }
 
                     _cullingDescriptorSet.Bind("_constants", _cullingConstantBuffer->GetBuffer(frameIndex));
-                    _cullingDescriptorSet.Bind("_drawCommands", _argumentBuffer);
+                    _cullingDescriptorSet.Bind("_drawCommands", _drawParameters.GetBuffer());
                     _cullingDescriptorSet.Bind("_culledDrawCommands", _culledArgumentBuffer);
                     _cullingDescriptorSet.Bind("_drawCount", _drawCountBuffer);
                     _cullingDescriptorSet.Bind("_triangleCount", _triangleCountBuffer);
@@ -242,9 +242,9 @@ void MapObjectRenderer::AddMapObjectDepthPrepass(Renderer::RenderGraph* renderGr
                 commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, &resources.globalDescriptorSet, frameIndex);
                 commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
 
-                commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+                commandList.SetIndexBuffer(_indices.GetBuffer(), Renderer::IndexFormat::UInt16);
 
-                Renderer::BufferID argumentBuffer = (cullingEnabled) ? _culledArgumentBuffer : _argumentBuffer;
+                Renderer::BufferID argumentBuffer = (cullingEnabled) ? _culledArgumentBuffer : _drawParameters.GetBuffer();
                 commandList.DrawIndexedIndirectCount(argumentBuffer, 0, _drawCountBuffer, 0, drawCount);
 
                 commandList.EndPipeline(pipeline);
@@ -256,7 +256,7 @@ void MapObjectRenderer::AddMapObjectDepthPrepass(Renderer::RenderGraph* renderGr
                 commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToTransferSrc, _triangleCountBuffer);
                 commandList.CopyBuffer(_triangleCountReadBackBuffer, 0, _triangleCountBuffer, 0, 4);
                 commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToTransferSrc, _triangleCountReadBackBuffer);
-            });
+            }, this);
     }
 }
 
@@ -269,6 +269,7 @@ void MapObjectRenderer::AddMapObjectPass(Renderer::RenderGraph* renderGraph, Ren
             Renderer::RenderPassMutableResource color;
             Renderer::RenderPassMutableResource objectIDs;
             Renderer::RenderPassMutableResource depth;
+            Renderer::RenderPassResource ambientObscurance;
         };
 
         const bool cullingEnabled = CVAR_MapObjectCullingEnabled.Get();
@@ -277,9 +278,10 @@ void MapObjectRenderer::AddMapObjectPass(Renderer::RenderGraph* renderGraph, Ren
         renderGraph->AddPass<MapObjectPassData>("MapObject Pass",
             [=](MapObjectPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
-            data.color = builder.Write(resources.color, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
-            data.objectIDs = builder.Write(resources.objectIDs, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
-            data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+            data.color = builder.Write(resources.color, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
+            data.objectIDs = builder.Write(resources.objectIDs, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
+            data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
+            data.ambientObscurance = builder.Read(resources.ambientObscurance, Renderer::RenderGraphBuilder::ShaderStage::PIXEL);
 
             return true; // Return true from setup to enable this pass, return false to disable it
         },
@@ -287,7 +289,7 @@ void MapObjectRenderer::AddMapObjectPass(Renderer::RenderGraph* renderGraph, Ren
         {
             GPU_SCOPED_PROFILER_ZONE(commandList, MapObjectPass);
 
-            u32 drawCount = static_cast<u32>(_drawParameters.size());
+            u32 drawCount = static_cast<u32>(_drawParameters.Size());
             if (drawCount == 0)
                 return;
 
@@ -331,13 +333,13 @@ void MapObjectRenderer::AddMapObjectPass(Renderer::RenderGraph* renderGraph, Ren
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, &resources.globalDescriptorSet, frameIndex);
             commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
 
-            commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+            commandList.SetIndexBuffer(_indices.GetBuffer(), Renderer::IndexFormat::UInt16);
 
-            Renderer::BufferID argumentBuffer = (cullingEnabled) ? _culledArgumentBuffer : _argumentBuffer;
+            Renderer::BufferID argumentBuffer = (cullingEnabled) ? _culledArgumentBuffer : _drawParameters.GetBuffer();
             commandList.DrawIndexedIndirectCount(argumentBuffer, 0, _drawCountBuffer, 0, drawCount);
 
             commandList.EndPipeline(pipeline);
-        });
+        }, this);
     }
 }
 
@@ -357,19 +359,52 @@ void MapObjectRenderer::RegisterMapObjectsToBeLoaded(u16 chunkID, const Terrain:
 {
     _mapChunkToPlacementOffset[chunkID] = static_cast<u32>(_mapObjectsToBeLoaded.Size());
 
+    std::vector<u32>& chunkUniqueIDs = _chunkUniqueIDs[chunkID];
+    chunkUniqueIDs.reserve(chunk.mapObjectPlacements.size());
+
     for (u32 i = 0; i < chunk.mapObjectPlacements.size(); i++)
     {
         const Terrain::Placement& mapObjectPlacement = chunk.mapObjectPlacements[i];
 
         u32 uniqueID = mapObjectPlacement.uniqueID;
+        chunkUniqueIDs.push_back(uniqueID);
+
         if (_uniqueIdCounter[uniqueID]++ == 0)
         {
             MapObjectToBeLoaded& mapObjectToBeLoaded = _mapObjectsToBeLoaded.EmplaceBack();
             mapObjectToBeLoaded.placement = &mapObjectPlacement;
             mapObjectToBeLoaded.nmorName = &stringTable.GetString(mapObjectPlacement.nameID);
             mapObjectToBeLoaded.nmorNameHash = stringTable.GetStringHash(mapObjectPlacement.nameID);
+            mapObjectToBeLoaded.chunkID = chunkID;
+        }
+    }
+}
+
+void MapObjectRenderer::UnloadChunk(u16 chunkID)
+{
+    auto chunkItr = _chunkUniqueIDs.find(chunkID);
+    if (chunkItr == _chunkUniqueIDs.end())
+        return;
+
+    // A placement that straddles chunk borders is referenced by every chunk it touches, only the last one to go removes it
+    for (u32 uniqueID : chunkItr->second)
+    {
+        auto counterItr = _uniqueIdCounter.find(uniqueID);
+        if (counterItr == _uniqueIdCounter.end() || --counterItr->second > 0)
+            continue;
+
+        _uniqueIdCounter.erase(counterItr);
+
+        auto instanceItr = _uniqueIdToInstance.find(uniqueID);
+        if (instanceItr != _uniqueIdToInstance.end())
+        {
+            _instancesToBeRemoved.push_back(instanceItr->second);
+            _uniqueIdToInstance.erase(instanceItr);
         }
     }
+
+    _chunkUniqueIDs.erase(chunkItr);
+    _mapChunkToPlacementOffset.erase(chunkID);
 }
 
 void MapObjectRenderer::ExecuteLoad()
@@ -378,9 +413,12 @@ void MapObjectRenderer::ExecuteLoad()
 
     size_t numMapObjectsToLoad = _mapObjectsToBeLoaded.Size();
 
-    if (numMapObjectsToLoad == 0)
+    if (numMapObjectsToLoad == 0 && _instancesToBeRemoved.size() == 0)
         return;
 
+    // Apply queued unloads before loading, that way new placements land in the slots they freed
+    RemoveInstances();
+
     _mapObjectsToBeLoaded.WriteLock(
         [&](std::vector<MapObjectToBeLoaded>& mapObjectsToBeLoaded)
         {
@@ -389,6 +427,17 @@ void MapObjectRenderer::ExecuteLoad()
                 ZoneScoped;
                 ZoneText(mapObjectToBeLoaded.nmorName->c_str(), mapObjectToBeLoaded.nmorName->length());
 
+                u32 uniqueID = mapObjectToBeLoaded.placement->uniqueID;
+                bool isChunkPlacement = mapObjectToBeLoaded.chunkID != Terrain::MAP_CHUNK_ID_INVALID;
+
+                // Skip placements whose chunks were unloaded while they were still queued
+                if (isChunkPlacement && _uniqueIdCounter.find(uniqueID) == _uniqueIdCounter.end())
+                    continue;
+
+                // Skip placements queued twice because their chunk was unloaded and loaded again, the first entry already added them
+                if (isChunkPlacement && _uniqueIdToInstance.find(uniqueID) != _uniqueIdToInstance.end())
+                    continue;
+
                 // Placements reference a path to a MapObject, several placements can reference the same object
                 // Because of this we want only the first load to actually load the object, subsequent loads should just return the id to the already loaded version
                 u32 mapObjectID;
@@ -396,12 +445,25 @@ void MapObjectRenderer::ExecuteLoad()
                 auto it = _nameHashToIndexMap.find(mapObjectToBeLoaded.nmorNameHash);
                 if (it == _nameHashToIndexMap.end())
                 {
-                    mapObjectID = static_cast<u32>(_loadedMapObjects.size());
-                    LoadedMapObject& mapObject = _loadedMapObjects.emplace_back();
+                    if (_freeMapObjectIDs.size() > 0)
+                    {
+                        mapObjectID = _freeMapObjectIDs.back();
+                        _freeMapObjectIDs.pop_back();
+
+                        _loadedMapObjects[mapObjectID] = LoadedMapObject();
+                    }
+                    else
+                    {
+                        mapObjectID = static_cast<u32>(_loadedMapObjects.size());
+                        _loadedMapObjects.emplace_back();
+                    }
+
+                    LoadedMapObject& mapObject = _loadedMapObjects[mapObjectID];
                     mapObject.objectID = mapObjectID;
+                    mapObject.nameHash = mapObjectToBeLoaded.nmorNameHash;
                     if (!LoadMapObject(mapObjectToBeLoaded, mapObject))
                     {
-                        _loadedMapObjects.pop_back();
+                        UnloadMapObject(mapObject);
                         continue;
                     }
 
@@ -415,17 +477,21 @@ void MapObjectRenderer::ExecuteLoad()
                 // Add Placement Details (This is used to go from a placement to LoadedMapObject or InstanceData
                 Terrain::PlacementDetails& placementDetails = _mapObjectPlacementDetails.emplace_back();
                 placementDetails.loadedIndex = mapObjectID;
-                placementDetails.instanceIndex = static_cast<u32>(_instances.size());
 
                 // Add placement as an instance here
-                AddInstance(_loadedMapObjects[mapObjectID], mapObjectToBeLoaded.placement);
+                placementDetails.instanceIndex = AddInstance(_loadedMapObjects[mapObjectID], mapObjectToBeLoaded.placement);
+
+                if (isChunkPlacement)
+                {
+                    _uniqueIdToInstance[uniqueID] = { placementDetails.instanceIndex, mapObjectID };
+                }
             }
         });
 
     {
-        ZoneScopedN("MapObjectRenderer::ExecuteLoad()::CreateBuffers()");
+        ZoneScopedN("MapObjectRenderer::ExecuteLoad()::SyncToGPU()");
 
-        CreateBuffers();
+        SyncToGPU();
         _mapObjectsToBeLoaded.Clear();
 
         // Calculate triangles
@@ -443,16 +509,23 @@ void MapObjectRenderer::Clear()
     _uniqueIdCounter.clear();
     _mapChunkToPlacementOffset.clear();
     _mapObjectPlacementDetails.clear();
+    _chunkUniqueIDs.clear();
+    _uniqueIdToInstance.clear();
+    _instancesToBeRemoved.clear();
     _loadedMapObjects.clear();
     _nameHashToIndexMap.clear();
-    _indices.clear();
-    _vertices.clear();
-    _drawParameters.clear();
-    _instances.clear();
-    _instanceLookupData.clear();
-    _materials.clear();
-    _materialParameters.clear();
-    _cullingData.clear();
+    _freeMapObjectIDs.clear();
+    std::fill(_textureRefCounts.begin(), _textureRefCounts.end(), static_cast<u16>(0));
+    _texturesToUnload.clear();
+    _indices.Clear();
+    _vertices.Clear();
+    _drawParameters.Clear();
+    _instances.Clear();
+    _instanceLookupData.Clear();
+    _materials.Clear();
+    _materialParameters.Clear();
+    _cullingData.Clear();
+    _numTriangles = 0;
 
     // Unload everything but the first texture in our array
     _renderer->UnloadTexturesInArray(_mapObjectTextures, 1);
@@ -460,10 +533,20 @@ void MapObjectRenderer::Clear()
 
 void MapObjectRenderer::CreatePermanentResources()
 {
+    _drawParameters.Init("MapObjectIndirectArgs", Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER, 16 * 1024);
+    _indices.Init("MapObjectIndexBuffer", Renderer::BufferUsage::INDEX_BUFFER, 1024 * 1024);
+    _vertices.Init("MapObjectVertexBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 512 * 1024);
+    _instances.Init("MapObjectInstanceBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 1024);
+    _instanceLookupData.Init("InstanceLookupDataBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 16 * 1024);
+    _materials.Init("MapObjectMaterialBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 4096);
+    _materialParameters.Init("MapObjectMaterialParamBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 16 * 1024);
+    _cullingData.Init("MapObjectCullingDataBuffer", Renderer::BufferUsage::STORAGE_BUFFER, 1024);
+
     Renderer::TextureArrayDesc textureArrayDesc;
     textureArrayDesc.size = 4096;
 
     _mapObjectTextures = _renderer->CreateTextureArray(textureArrayDesc);
+    _textureRefCounts.resize(textureArrayDesc.size);
     _passDescriptorSet.Bind("_textures", _mapObjectTextures);
 
     // Create a 1x1 pixel black texture
@@ -541,9 +624,6 @@ bool MapObjectRenderer::LoadMapObject(MapObjectToBeLoaded& mapObjectToBeLoaded,
     std::string nmorNameWithoutExtension = mapObjectToBeLoaded.nmorName->substr(0, mapObjectToBeLoaded.nmorName->length() - 5); // Remove .nmor
     std::stringstream ss;
 
-    mapObject.baseVertexOffset = static_cast<u32>(_vertices.size());
-    mapObject.baseCullingDataOffset = static_cast<u32>(_cullingData.size());
-
     for (u32 i = 0; i < mapObjectToBeLoaded.meshRoot.numMeshes; i++)
     {
         ss.clear();
@@ -595,7 +675,8 @@ bool MapObjectRenderer::LoadMapObject(MapObjectToBeLoaded& mapObjectToBeLoaded,
     }
 
     // Create per-MapObject culling data
-    Terrain::CullingData& mapObjectCullingData = _cullingData.emplace_back();
+    mapObject.baseCullingDataOffset = static_cast<u32>(_cullingData.AddCount(1));
+    Terrain::CullingData& mapObjectCullingData = _cullingData[mapObject.baseCullingDataOffset];
 
     for (Terrain::CullingData& cullingData : mapObject.cullingData)
     {
@@ -666,7 +747,8 @@ bool MapObjectRenderer::LoadRoot(std::filesystem::path nmorPath, MeshRoot& meshR
     // Read materials
     entt::registry* registry = ServiceLocator::GetGameRegistry();
     TextureSingleton& textureSingleton = registry->ctx<TextureSingleton>();
-    mapObject.baseMaterialOffset = static_cast<u32>(_materials.size());
+    mapObject.baseMaterialOffset = static_cast<u32>(_materials.AddCount(meshRoot.numMaterials));
+    mapObject.numMaterials = meshRoot.numMaterials;
 
     for (u32 i = 0; i < meshRoot.numMaterials; i++)
     {
@@ -674,7 +756,7 @@ bool MapObjectRenderer::LoadRoot(std::filesystem::path nmorPath, MeshRoot& meshR
         if (!buffer.GetBytes(reinterpret_cast<u8*>(&mapObjectMaterial), sizeof(Terrain::MapObjectMaterial)))
             return false;
 
-        Material& material = _materials.emplace_back();
+        Material& material = _materials[mapObject.baseMaterialOffset + i];
         material.materialType = mapObjectMaterial.materialType;
         material.unlit = mapObjectMaterial.flags.unlit;
 
@@ -696,6 +778,9 @@ bool MapObjectRenderer::LoadRoot(std::filesystem::path nmorPath, MeshRoot& meshR
                 _renderer->LoadTextureIntoArray(textureDesc, _mapObjectTextures, textureID);
 
                 material.textureIDs[j] = static_cast<u16>(textureID);
+
+                _textureRefCounts[textureID]++;
+                mapObject.textureIDs.push_back(textureID);
             }
         }
     }
@@ -761,18 +846,22 @@ bool MapObjectRenderer::LoadMesh(const std::filesystem::path nmoPath, Mesh& mesh
 
 bool MapObjectRenderer::LoadIndicesAndVertices(Bytebuffer& buffer, Mesh& mesh, LoadedMapObject& mapObject)
 {
-    mesh.baseIndexOffset = static_cast<u32>(_indices.size());
-    mesh.baseVertexOffset = static_cast<u32>(_vertices.size());
-
     // Read number of indices
     u32 indexCount;
     if (!buffer.Get<u32>(indexCount))
         return false;
 
-    _indices.resize(mesh.baseIndexOffset + indexCount);
+    mesh.baseIndexOffset = static_cast<u32>(_indices.AddCount(indexCount));
+
+    // Track the ranges as soon as they are allocated so a failed load can still release them
+    MeshRange& meshRange = mapObject.meshRanges.emplace_back();
+    meshRange.baseIndexOffset = mesh.baseIndexOffset;
+    meshRange.indexCount = indexCount;
+    meshRange.baseVertexOffset = 0;
+    meshRange.vertexCount = 0;
 
     // Read indices
-    if (!buffer.GetBytes(reinterpret_cast<u8*>(_indices.data() + mesh.baseIndexOffset), indexCount * sizeof(u16)))
+    if (!buffer.GetBytes(reinterpret_cast<u8*>(_indices.Data() + mesh.baseIndexOffset), indexCount * sizeof(u16)))
         return false;
     
     // Read number of vertices
@@ -780,14 +869,14 @@ bool MapObjectRenderer::LoadIndicesAndVertices(Bytebuffer& buffer, Mesh& mesh, L
     if (!buffer.Get<u32>(vertexCount))
         return false;
 
-    _vertices.resize(mesh.baseVertexOffset + vertexCount);
+    mesh.baseVertexOffset = static_cast<u32>(_vertices.AddCount(vertexCount));
+    meshRange.baseVertexOffset = mesh.baseVertexOffset;
+    meshRange.vertexCount = vertexCount;
     
     // Read vertices
-    if (!buffer.GetBytes(reinterpret_cast<u8*>(&_vertices.data()[mesh.baseVertexOffset]), vertexCount * sizeof(Terrain::MapObjectVertex)))
+    if (!buffer.GetBytes(reinterpret_cast<u8*>(_vertices.Data() + mesh.baseVertexOffset), vertexCount * sizeof(Terrain::MapObjectVertex)))
         return false;
 
-    vec3 position = _vertices[0].position;
-
     // Read number of vertex color sets
     u32 numVertexColorSets;
     if (!buffer.Get<u32>(numVertexColorSets))
@@ -854,11 +943,11 @@ bool MapObjectRenderer::LoadRenderBatches(Bytebuffer& buffer, Mesh& mesh, Loaded
         u32 renderBatchIndex = renderBatchesSize + i;
         Terrain::RenderBatch& renderBatch = mapObject.renderBatches[renderBatchIndex];
         // MaterialParameters
-        u32 materialParameterID = static_cast<u32>(_materialParameters.size());
+        u32 materialParameterID = static_cast<u32>(_materialParameters.AddCount(1));
 
         mapObject.materialParameterIDs.push_back(materialParameterID);
 
-        MaterialParameters& materialParameters = _materialParameters.emplace_back();
+        MaterialParameters& materialParameters = _materialParameters[materialParameterID];
         materialParameters.materialID = mapObject.baseMaterialOffset + renderBatch.materialID;
         materialParameters.exteriorLit = static_cast<u32>(mesh.renderFlags.exteriorLit || mesh.renderFlags.exterior);
     }
@@ -874,12 +963,10 @@ bool MapObjectRenderer::LoadRenderBatches(Bytebuffer& buffer, Mesh& mesh, Loaded
     return true;
 }
 
-void MapObjectRenderer::AddInstance(LoadedMapObject& mapObject, const Terrain::Placement* placement)
+u32 MapObjectRenderer::AddInstance(LoadedMapObject& mapObject, const Terrain::Placement* placement)
 {
-    u32 instanceID = static_cast<u32>(_instances.size());
-    mapObject.instanceIDs.push_back(instanceID);
-    
-    InstanceData& instance = _instances.emplace_back();
+    u32 instanceID = static_cast<u32>(_instances.AddCount(1));
+    InstanceData& instance = _instances[instanceID];
     
     vec3 pos = placement->position;
     vec3 rot = glm::radians(placement->rotation);
@@ -887,15 +974,18 @@ void MapObjectRenderer::AddInstance(LoadedMapObject& mapObject, const Terrain::P
 
     instance.instanceMatrix = glm::translate(mat4x4(1.0f), pos) * rotationMatrix;
 
-    for (u32 i = 0; i < mapObject.renderBatches.size(); i++)
+    size_t numRenderBatches = mapObject.renderBatches.size();
+    u32 baseDrawParameterID = static_cast<u32>(_drawParameters.AddCount(numRenderBatches));
+    u32 baseInstanceLookupID = static_cast<u32>(_instanceLookupData.AddCount(numRenderBatches));
+    assert(baseDrawParameterID == baseInstanceLookupID);
+
+    for (u32 i = 0; i < numRenderBatches; i++)
     {
         Terrain::RenderBatch& renderBatch = mapObject.renderBatches[i];
         RenderBatchOffsets& renderBatchOffsets = mapObject.renderBatchOffsets[i];
 
-        u32 drawParameterID = static_cast<u32>(_drawParameters.size());
-        DrawParameters& drawParameters = _drawParameters.emplace_back();
-
-        mapObject.drawParameterIDs.push_back(drawParameterID);
+        u32 drawParameterID = baseDrawParameterID + i;
+        DrawParameters& drawParameters = _drawParameters[drawParameterID];
 
         drawParameters.vertexOffset = renderBatchOffsets.baseVertexOffset;
         drawParameters.firstIndex = renderBatchOffsets.baseIndexOffset + renderBatch.startIndex;
@@ -903,7 +993,7 @@ void MapObjectRenderer::AddInstance(LoadedMapObject& mapObject, const Terrain::P
         drawParameters.firstInstance = drawParameterID;
         drawParameters.instanceCount = 1;
 
-        InstanceLookupData& instanceLookupData = _instanceLookupData.emplace_back();
+        InstanceLookupData& instanceLookupData = _instanceLookupData[drawParameterID];
         instanceLookupData.loadedObjectID = mapObject.objectID;
         instanceLookupData.instanceID = instanceID;
         instanceLookupData.materialParamID = mapObject.materialParameterIDs[i];
@@ -917,102 +1007,148 @@ void MapObjectRenderer::AddInstance(LoadedMapObject& mapObject, const Terrain::P
     }
 
     mapObject.instanceCount++;
+
+    return instanceID;
 }
 
-void MapObjectRenderer::CreateBuffers()
+void MapObjectRenderer::RemoveInstances()
 {
-    // Create Instance Lookup Buffer
+    if (_instancesToBeRemoved.size() == 0)
+        return;
+
+    ZoneScoped;
+
+    std::vector<bool> isInstanceRemoved(_instances.Size(), false);
+
+    for (const PlacedInstance& placedInstance : _instancesToBeRemoved)
     {
-        Renderer::BufferDesc desc;
-        desc.name = "InstanceLookupDataBuffer";
-        desc.size = sizeof(InstanceLookupData) * _instanceLookupData.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _instanceLookupBuffer = _renderer->CreateAndFillBuffer(_instanceLookupBuffer, desc, _instanceLookupData.data(), desc.size);
+        LoadedMapObject& mapObject = _loadedMapObjects[placedInstance.mapObjectID];
+        if (--mapObject.instanceCount == 0)
+        {
+            UnloadMapObject(mapObject);
+        }
 
-        _passDescriptorSet.Bind("_packedInstanceLookup", _instanceLookupBuffer);
-        _cullingDescriptorSet.Bind("_packedInstanceLookup", _instanceLookupBuffer);
+        _instances.Remove(placedInstance.instanceID, 1);
+        isInstanceRemoved[placedInstance.instanceID] = true;
     }
-    
-    // Create Indirect Argument buffer
+    _instancesToBeRemoved.clear();
+
+    // The culling shader dispatches over drawCount draws, so surviving draws are moved down in order to keep the array packed
+    u32 numDrawCalls = static_cast<u32>(_drawParameters.Size());
+    u32 numKept = 0;
+    u32 firstMoved = numDrawCalls;
+
+    for (u32 i = 0; i < numDrawCalls; i++)
     {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectIndirectArgs";
-        desc.size = sizeof(DrawParameters) * _drawParameters.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION | Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER;
-        _argumentBuffer = _renderer->CreateAndFillBuffer(_argumentBuffer, desc, _drawParameters.data(), desc.size);
+        if (isInstanceRemoved[_instanceLookupData[i].instanceID])
+            continue;
+
+        if (i != numKept)
+        {
+            firstMoved = std::min(firstMoved, numKept);
+
+            _drawParameters[numKept] = _drawParameters[i];
+            _drawParameters[numKept].firstInstance = numKept;
+            _instanceLookupData[numKept] = _instanceLookupData[i];
+        }
+
+        numKept++;
     }
 
-    // Create Culled Indirect Argument buffer
+    _drawParameters.Truncate(numKept);
+    _instanceLookupData.Truncate(numKept);
+
+    if (firstMoved < numKept)
     {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectCulledIndirectArgs";
-        desc.size = sizeof(DrawParameters) * _drawParameters.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION | Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER;
-        _culledArgumentBuffer = _renderer->CreateAndFillBuffer(_culledArgumentBuffer, desc, _drawParameters.data(), desc.size);
+        _drawParameters.SetDirtyElements(firstMoved, numKept - firstMoved);
+        _instanceLookupData.SetDirtyElements(firstMoved, numKept - firstMoved);
     }
 
-    // Create Vertex buffer
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectVertexBuffer";
-        desc.size = sizeof(Terrain::MapObjectVertex) * _vertices.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _vertexBuffer = _renderer->CreateAndFillBuffer(_vertexBuffer, desc, _vertices.data(), desc.size);
+    _mapObjectPlacementDetails.erase(std::remove_if(_mapObjectPlacementDetails.begin(), _mapObjectPlacementDetails.end(), [&](const Terrain::PlacementDetails& placementDetails)
+        {
+            return isInstanceRemoved[placementDetails.instanceIndex];
+        }), _mapObjectPlacementDetails.end());
 
-        _passDescriptorSet.Bind("_packedVertices", _vertexBuffer);
+    if (_texturesToUnload.size() > 0)
+    {
+        _renderer->UnloadTexturesInArray(_mapObjectTextures, _texturesToUnload);
+        _texturesToUnload.clear();
     }
+}
 
-    // Create Index buffer
+void MapObjectRenderer::UnloadMapObject(LoadedMapObject& mapObject)
+{
+    for (const MeshRange& meshRange : mapObject.meshRanges)
     {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectIndexBuffer";
-        desc.size = sizeof(u16) * _indices.size();
-        desc.usage = Renderer::BufferUsage::INDEX_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _indexBuffer = _renderer->CreateAndFillBuffer(_indexBuffer, desc, _indices.data(), desc.size);
+        _indices.Remove(meshRange.baseIndexOffset, meshRange.indexCount);
+        _vertices.Remove(meshRange.baseVertexOffset, meshRange.vertexCount);
     }
 
-    // Create Instance buffer
-    {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectInstanceBuffer";
-        desc.size = sizeof(InstanceData) * _instances.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _instanceBuffer = _renderer->CreateAndFillBuffer(_instanceBuffer, desc, _instances.data(), desc.size);
+    _materials.Remove(mapObject.baseMaterialOffset, mapObject.numMaterials);
 
-        _passDescriptorSet.Bind("_instanceData", _instanceBuffer);
-        _cullingDescriptorSet.Bind("_instanceData", _instanceBuffer);
+    for (u16 materialParameterID : mapObject.materialParameterIDs)
+    {
+        _materialParameters.Remove(materialParameterID, 1);
     }
 
-    // Create Material buffer
+    if (mapObject.baseCullingDataOffset != std::numeric_limits<u32>().max())
     {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectMaterialBuffer";
-        desc.size = sizeof(Material) * _materials.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _materialBuffer = _renderer->CreateAndFillBuffer(_materialBuffer, desc, _materials.data(), desc.size);
-
-        _passDescriptorSet.Bind("_packedMaterialData", _materialBuffer);
+        _cullingData.Remove(mapObject.baseCullingDataOffset, 1);
     }
 
-    // Create MaterialParam buffer
+    // Vertex color textures belong to this MapObject alone, slot 0 is our black texture and means it had none
+    for (u32 i = 0; i < 2; i++)
     {
-        Renderer::BufferDesc desc;
-        desc.name = "MapObjectMaterialParamBuffer";
-        desc.size = sizeof(MaterialParameters) * _materialParameters.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _materialParametersBuffer = _renderer->CreateAndFillBuffer(_materialParametersBuffer, desc, _materialParameters.data(), desc.size);
+        if (mapObject.vertexColorTextureIDs[i] != 0)
+        {
+            _texturesToUnload.push_back(mapObject.vertexColorTextureIDs[i]);
+        }
+    }
 
-        _passDescriptorSet.Bind("_packedMaterialParams", _materialParametersBuffer);
+    // Material textures can be shared with other MapObjects, so only unload the ones nobody else uses
+    for (u32 textureID : mapObject.textureIDs)
+    {
+        if (--_textureRefCounts[textureID] == 0)
+        {
+            _texturesToUnload.push_back(textureID);
+        }
     }
 
-    // Create CullingData buffer
+    _nameHashToIndexMap.erase(mapObject.nameHash);
+    _freeMapObjectIDs.push_back(mapObject.objectID);
+
+    u32 objectID = mapObject.objectID;
+    mapObject = LoadedMapObject();
+    mapObject.objectID = objectID;
+}
+
+void MapObjectRenderer::SyncToGPU()
+{
+    _instanceLookupData.SyncToGPU(_renderer);
+    _vertices.SyncToGPU(_renderer);
+    _indices.SyncToGPU(_renderer);
+    _instances.SyncToGPU(_renderer);
+    _materials.SyncToGPU(_renderer);
+    _materialParameters.SyncToGPU(_renderer);
+    _cullingData.SyncToGPU(_renderer);
+
+    // The culling output is sized after the capacity of its input, so we only recreate it when that grows
+    if (_drawParameters.SyncToGPU(_renderer))
     {
         Renderer::BufferDesc desc;
-        desc.name = "MapObjectCullingDataBuffer";
-        desc.size = sizeof(Terrain::CullingData) * _cullingData.size();
-        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
-        _cullingDataBuffer = _renderer->CreateAndFillBuffer(_cullingDataBuffer, desc, _cullingData.data(), desc.size);
-
-        _cullingDescriptorSet.Bind("_packedCullingData", _cullingDataBuffer);
+        desc.name = "MapObjectCulledIndirectArgs";
+        desc.size = sizeof(DrawParameters) * _drawParameters.Capacity();
+        desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION | Renderer::BufferUsage::INDIRECT_ARGUMENT_BUFFER;
+        _culledArgumentBuffer = _renderer->CreateBuffer(_culledArgumentBuffer, desc);
     }
+
+    // Any of the buffers might have been recreated, so rebind all of them
+    _passDescriptorSet.Bind("_packedInstanceLookup", _instanceLookupData.GetBuffer());
+    _cullingDescriptorSet.Bind("_packedInstanceLookup", _instanceLookupData.GetBuffer());
+    _passDescriptorSet.Bind("_packedVertices", _vertices.GetBuffer());
+    _passDescriptorSet.Bind("_instanceData", _instances.GetBuffer());
+    _cullingDescriptorSet.Bind("_instanceData", _instances.GetBuffer());
+    _passDescriptorSet.Bind("_packedMaterialData", _materials.GetBuffer());
+    _passDescriptorSet.Bind("_packedMaterialParams", _materialParameters.GetBuffer());
+    _cullingDescriptorSet.Bind("_packedCullingData", _cullingData.GetBuffer());
 }
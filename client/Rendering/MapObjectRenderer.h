@@ -10,9 +10,11 @@
 #include <Renderer/Descriptors/ImageDesc.h>
 #include <Renderer/Descriptors/DepthImageDesc.h>
 #include <Renderer/Descriptors/BufferDesc.h>
+#include <Renderer/GPUVector.h>
 
 #include "ViewConstantBuffer.h"
 #include "../Gameplay/Map/MapObject.h"
+#include "../Gameplay/Map/Chunk.h"
 
 namespace Renderer
 {
@@ -63,6 +65,7 @@ class MapObjectRenderer
         const Terrain::Placement* placement = nullptr;
         const std::string* nmorName = nullptr;
         u32 nmorNameHash = 0;
+        u16 chunkID = Terrain::MAP_CHUNK_ID_INVALID;
 
         MeshRoot meshRoot;
         std::vector<Mesh> meshes;
@@ -91,26 +94,43 @@ class MapObjectRenderer
         u32 baseVertexColor2Offset;
     };
 
+    struct MeshRange
+    {
+        u32 baseIndexOffset;
+        u32 indexCount;
+        u32 baseVertexOffset;
+        u32 vertexCount;
+    };
+
+    struct PlacedInstance
+    {
+        u32 instanceID;
+        u32 mapObjectID;
+    };
+
 public:
     struct LoadedMapObject
     {
         u32 objectID;
+        u32 nameHash = 0;
         std::string debugName = "";
 
-        std::vector<u32> drawParameterIDs;
         std::vector<u16> materialParameterIDs;
 
-        std::vector<u16> instanceIDs;
         std::vector<u32> instanceMaterialParameterIDs;
 
         std::vector<u32> vertexColors[2];
 
         u32 vertexColorTextureIDs[2] = { 0, 0 };
-        u32 instanceCount;
+        u32 instanceCount = 0;
 
-        u32 baseVertexOffset = 0;
         u32 baseMaterialOffset = 0;
-        u32 baseCullingDataOffset = 0;
+        u32 numMaterials = 0;
+        u32 baseCullingDataOffset = std::numeric_limits<u32>().max();
+
+        // Everything we hand back when the last placement of this MapObject is unloaded
+        std::vector<MeshRange> meshRanges;
+        std::vector<u32> textureIDs;
 
         // Renderbatches
         std::vector<Terrain::RenderBatch> renderBatches;
@@ -149,21 +169,22 @@ public:
 
     void RegisterMapObjectToBeLoaded(const std::string& mapObjectName, const Terrain::Placement& mapObjectPlacement);
     void RegisterMapObjectsToBeLoaded(u16 chunkID, const Terrain::Chunk& chunk, StringTable& stringTable);
+    void UnloadChunk(u16 chunkID);
     void ExecuteLoad();
 
     void Clear();
 
     const std::vector<LoadedMapObject>& GetLoadedMapObjects() { return _loadedMapObjects; }
-    const std::vector<InstanceData>& GetInstances() { return _instances; }
+    const std::vector<InstanceData>& GetInstances() { return _instances.ReadGet(); }
     const std::vector<Terrain::PlacementDetails>& GetPlacementDetails() { return _mapObjectPlacementDetails; }
-    const std::vector<InstanceLookupData>& GetInstanceLookupData() { return _instanceLookupData; }
+    const std::vector<InstanceLookupData>& GetInstanceLookupData() { return _instanceLookupData.ReadGet(); }
 
     u32 GetChunkPlacementDetailsOffset(u16 chunkID) { return _mapChunkToPlacementOffset[chunkID]; }
-    u32 GetNumLoadedMapObjects() { return static_cast<u32>(_loadedMapObjects.size()); }
-    u32 GetNumMapObjectPlacements() { return static_cast<u32>(_instances.size()); }
+    u32 GetNumLoadedMapObjects() { return static_cast<u32>(_nameHashToIndexMap.size()); }
+    u32 GetNumMapObjectPlacements() { return static_cast<u32>(_mapObjectPlacementDetails.size()); }
 
     // Drawcall stats
-    u32 GetNumDrawCalls() { return static_cast<u32>(_drawParameters.size()); }
+    u32 GetNumDrawCalls() { return static_cast<u32>(_drawParameters.Size()); }
     u32 GetNumSurvivingDrawCalls() { return _numSurvivingDrawCalls; }
 
     // Triangle stats
@@ -182,9 +203,11 @@ private:
 
     bool LoadRenderBatches(Bytebuffer& buffer, Mesh& mesh, LoadedMapObject& mapObject);
 
-    void AddInstance(LoadedMapObject& mapObject, const Terrain::Placement* placement);
+    u32 AddInstance(LoadedMapObject& mapObject, const Terrain::Placement* placement);
+    void RemoveInstances();
+    void UnloadMapObject(LoadedMapObject& mapObject);
 
-    void CreateBuffers();
+    void SyncToGPU();
 
     struct Material
     {
@@ -221,41 +244,40 @@ private:
 
     std::vector<LoadedMapObject> _loadedMapObjects;
     robin_hood::unordered_map<u32, u32> _nameHashToIndexMap;
-
-    std::vector<DrawParameters> _drawParameters;
-    std::vector<u16> _indices;
-    std::vector<Terrain::MapObjectVertex> _vertices;
-    std::vector<InstanceData> _instances;
-    std::vector<InstanceLookupData> _instanceLookupData;
-    std::vector<Material> _materials;
-    std::vector<MaterialParameters> _materialParameters;
-    std::vector<Terrain::CullingData> _cullingData;
+    std::vector<u32> _freeMapObjectIDs;
+
+    // These are sub-allocated GPU buffers, loads only upload what they added
+    // DrawParameters and InstanceLookupData are always added and removed together so their indices stay in sync
+    Renderer::GPUVector<DrawParameters> _drawParameters;
+    Renderer::GPUVector<u16> _indices;
+    Renderer::GPUVector<Terrain::MapObjectVertex> _vertices;
+    Renderer::GPUVector<InstanceData> _instances;
+    Renderer::GPUVector<InstanceLookupData> _instanceLookupData;
+    Renderer::GPUVector<Material> _materials;
+    Renderer::GPUVector<MaterialParameters> _materialParameters;
+    Renderer::GPUVector<Terrain::CullingData> _cullingData;
 
     Renderer::Buffer<CullingConstants>* _cullingConstantBuffer;
 
-    Renderer::BufferID _argumentBuffer;
     Renderer::BufferID _culledArgumentBuffer;
     Renderer::BufferID _drawCountBuffer;
     Renderer::BufferID _drawCountReadBackBuffer;
     Renderer::BufferID _triangleCountBuffer;
     Renderer::BufferID _triangleCountReadBackBuffer;
 
-    Renderer::BufferID _vertexBuffer;
-    Renderer::BufferID _indexBuffer;
-    Renderer::BufferID _instanceBuffer;
-    Renderer::BufferID _instanceLookupBuffer;
-    Renderer::BufferID _materialBuffer;
-    Renderer::BufferID _materialParametersBuffer;
-    Renderer::BufferID _cullingDataBuffer;
-
     Renderer::TextureArrayID _mapObjectTextures;
+    std::vector<u16> _textureRefCounts; // Indexed by texture array slot, LoadTextureIntoArray hands out the same slot to every material using a texture
+    std::vector<u32> _texturesToUnload;
 
     robin_hood::unordered_map<u32, u8> _uniqueIdCounter;
     robin_hood::unordered_map<u16, u32> _mapChunkToPlacementOffset;
     std::vector<Terrain::PlacementDetails> _mapObjectPlacementDetails;
+    robin_hood::unordered_map<u16, std::vector<u32>> _chunkUniqueIDs;
+    robin_hood::unordered_map<u32, PlacedInstance> _uniqueIdToInstance;
+    std::vector<PlacedInstance> _instancesToBeRemoved;
 
     u32 _numSurvivingDrawCalls;
-    u32 _numTriangles;
+    u32 _numTriangles = 0;
     u32 _numSurvivingTriangles;
 
     SafeVector<MapObjectToBeLoaded> _mapObjectsToBeLoaded;  // TODO: Make this a concurrent queue
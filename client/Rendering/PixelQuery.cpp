@@ -58,13 +58,13 @@ void PixelQuery::AddPixelQueryPass(Renderer::RenderGraph* renderGraph, RenderRes
     {
         struct PixelQueryPassData
         {
-            Renderer::RenderPassMutableResource objectIDs;
+            Renderer::RenderPassResource objectIDs;
         };
 
         renderGraph->AddPass<PixelQueryPassData>("Query Pass",
             [=](PixelQueryPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
             {
-                data.objectIDs = builder.Write(resources.objectIDs, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+                data.objectIDs = builder.Read(resources.objectIDs, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
 
                 return true; // Return true from setup to enable this pass, return false to disable it
             },
@@ -78,10 +78,6 @@ void PixelQuery::AddPixelQueryPass(Renderer::RenderGraph* renderGraph, RenderRes
                     std::string frameIndexStr = "FrameIndex: " + std::to_string(_frameIndex);
                     TracyMessage(frameIndexStr.c_str(), frameIndexStr.length());
 
-                    {
-                        ZoneScopedN("PixelQuery::ImageBarrier");
-                        commandList.ImageBarrier(resources.objectIDs);
-                    }
                     commandList.PushMarker("Pixel Queries " + std::to_string(numRequests), Color::White);
                     Renderer::ComputePipelineDesc queryPipelineDesc;
                     graphResources.InitializePipelineDesc(queryPipelineDesc);
@@ -119,7 +115,7 @@ void PixelQuery::AddPixelQueryPass(Renderer::RenderGraph* renderGraph, RenderRes
                     _requests[_frameIndex].clear();
                 }
                 _frameIndex = !_frameIndex;
-            });
+            }, this);
     }
 }
 
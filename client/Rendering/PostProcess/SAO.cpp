@@ -1,6 +1,7 @@
 #include "SAO.h"
 
 #include <Renderer/Renderer.h>
+#include <Renderer/RenderGraph.h>
 #include <Renderer/FrameResource.h>
 #include <Renderer/CommandList.h>
 
@@ -8,6 +9,10 @@ namespace PostProcess
 {
     struct SAOData : ISAOData
     {
+        Renderer::ImageDesc linearizedDepthDesc;
+        Renderer::ImageDesc aoDesc;
+
+        // Transient, these get acquired again every frame during Setup
         Renderer::ImageID linearizedDepthImage;
         Renderer::ImageID rawAOImage;
         Renderer::ImageID blurredImage;
@@ -28,22 +33,17 @@ namespace PostProcess
     {
         SAOData& data = *static_cast<SAOData*>(_data);
 
-        Renderer::ImageDesc imageDesc;
-        
-        imageDesc.dimensions = vec2(1.0f, 1.0f);
-        imageDesc.dimensionType = Renderer::ImageDimensionType::DIMENSION_SCALE;
-        imageDesc.format = Renderer::ImageFormat::R8G8B8A8_UNORM;
-        imageDesc.sampleCount = Renderer::SampleCount::SAMPLE_COUNT_1;
-        imageDesc.debugName = "SAORawAO";
-        data.rawAOImage = renderer->CreateImage(imageDesc);
-
-        imageDesc.debugName = "SAOBlurred";
-        data.blurredImage = renderer->CreateImage(imageDesc);
+        // Raw and blurred AO share this desc
+        data.aoDesc.dimensions = vec2(1.0f, 1.0f);
+        data.aoDesc.dimensionType = Renderer::ImageDimensionType::DIMENSION_SCALE;
+        data.aoDesc.format = Renderer::ImageFormat::R8G8B8A8_UNORM;
+        data.aoDesc.sampleCount = Renderer::SampleCount::SAMPLE_COUNT_1;
+        data.aoDesc.debugName = "SAOAO";
 
-        imageDesc.format = Renderer::ImageFormat::R32_FLOAT;
-        imageDesc.mipLevels = NUM_MIP_LEVELS;
-        imageDesc.debugName = "SAOLinearDepth";
-        data.linearizedDepthImage = renderer->CreateImage(imageDesc);
+        data.linearizedDepthDesc = data.aoDesc;
+        data.linearizedDepthDesc.format = Renderer::ImageFormat::R32_FLOAT;
+        data.linearizedDepthDesc.mipLevels = NUM_MIP_LEVELS;
+        data.linearizedDepthDesc.debugName = "SAOLinearDepth";
 
         Renderer::SamplerDesc samplerDesc;
         samplerDesc.enabled = true;
@@ -58,41 +58,103 @@ namespace PostProcess
         data.sampler = renderer->CreateSampler(samplerDesc);
     }
 
-    void SAO::CalculateSAO(Renderer::Renderer* renderer, Renderer::RenderGraphResources& graphResources, Renderer::CommandList& commandList, u32 frameIndex, const Params& params)
+    void SAO::AddPasses(Renderer::Renderer* renderer, Renderer::RenderGraph* renderGraph, u32 frameIndex, const Params& params, const void* recordingGroup)
     {
-        SAOData& data = *static_cast<SAOData*>(_data);
+        // The linearized depth is dead once the raw AO is computed, so the blurred image can reuse its memory
+        struct LinearizeDepthPassData
+        {
+            Renderer::RenderPassResource depth;
+            Renderer::RenderPassMutableResource linearizedDepth;
+        };
+
+        renderGraph->AddPass<LinearizeDepthPassData>("SAO Linearize Depth",
+            [=](LinearizeDepthPassData& passData, Renderer::RenderGraphBuilder& builder) // Setup
+        {
+            SAOData& data = *static_cast<SAOData*>(_data);
+            data.linearizedDepthImage = builder.Create(data.linearizedDepthDesc);
+
+            passData.depth = builder.Read(params.depth, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
+            passData.linearizedDepth = builder.Write(data.linearizedDepthImage, Renderer::RenderGraphBuilder::WriteMode::UAV, Renderer::RenderGraphBuilder::LoadMode::DISCARD);
 
-        commandList.PushMarker("ScalableAmbientObscurance", Color::White);
+            return true; // Return true from setup to enable this pass, return false to disable it
+        },
+            [=](LinearizeDepthPassData& passData, Renderer::RenderGraphResources& graphResources, Renderer::CommandList& commandList) // Execute
         {
             LinearizeDepth(renderer, graphResources, commandList, frameIndex, params);
+        }, recordingGroup);
 
+        struct RawAOPassData
+        {
+            Renderer::RenderPassResource linearizedDepth;
+            Renderer::RenderPassMutableResource rawAO;
+        };
+
+        renderGraph->AddPass<RawAOPassData>("SAO Raw AO",
+            [=](RawAOPassData& passData, Renderer::RenderGraphBuilder& builder) // Setup
+        {
+            SAOData& data = *static_cast<SAOData*>(_data);
+            data.rawAOImage = builder.Create(data.aoDesc);
+
+            passData.linearizedDepth = builder.Read(data.linearizedDepthImage, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
+            passData.rawAO = builder.Write(data.rawAOImage, Renderer::RenderGraphBuilder::WriteMode::UAV, Renderer::RenderGraphBuilder::LoadMode::DISCARD);
+
+            return true; // Return true from setup to enable this pass, return false to disable it
+        },
+            [=](RawAOPassData& passData, Renderer::RenderGraphResources& graphResources, Renderer::CommandList& commandList) // Execute
+        {
             ComputeRawAO(renderer, graphResources, commandList, frameIndex, params);
+        }, recordingGroup);
 
-            // Horizontal blur
-            {
-                BlurParams blurParams;
-                blurParams.input = data.rawAOImage;
-                blurParams.output = data.blurredImage;
-                blurParams.direction = uvec2(1, 0);
+        struct BlurPassData
+        {
+            Renderer::RenderPassResource input;
+            Renderer::RenderPassMutableResource output;
+        };
 
-                commandList.PushMarker("Blur Horizontal", Color::White);
-                Blur(renderer, graphResources, commandList, frameIndex, blurParams);
-                commandList.PopMarker();
-            }
+        renderGraph->AddPass<BlurPassData>("SAO Blur Horizontal",
+            [=](BlurPassData& passData, Renderer::RenderGraphBuilder& builder) // Setup
+        {
+            SAOData& data = *static_cast<SAOData*>(_data);
+            data.blurredImage = builder.Create(data.aoDesc);
 
-            // Vertical blur
-            {
-                BlurParams blurParams;
-                blurParams.input = data.blurredImage;
-                blurParams.output = params.output;
-                blurParams.direction = uvec2(0, 1);
-
-                commandList.PushMarker("Blur Vertical", Color::White);
-                Blur(renderer, graphResources, commandList, frameIndex, blurParams);
-                commandList.PopMarker();
-            }
-        }
-        commandList.PopMarker();
+            passData.input = builder.Read(data.rawAOImage, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
+            passData.output = builder.Write(data.blurredImage, Renderer::RenderGraphBuilder::WriteMode::UAV, Renderer::RenderGraphBuilder::LoadMode::DISCARD);
+
+            return true; // Return true from setup to enable this pass, return false to disable it
+        },
+            [=](BlurPassData& passData, Renderer::RenderGraphResources& graphResources, Renderer::CommandList& commandList) // Execute
+        {
+            SAOData& data = *static_cast<SAOData*>(_data);
+
+            BlurParams blurParams;
+            blurParams.input = data.rawAOImage;
+            blurParams.output = data.blurredImage;
+            blurParams.direction = uvec2(1, 0);
+
+            Blur(renderer, graphResources, commandList, frameIndex, blurParams);
+        }, recordingGroup);
+
+        renderGraph->AddPass<BlurPassData>("SAO Blur Vertical",
+            [=](BlurPassData& passData, Renderer::RenderGraphBuilder& builder) // Setup
+        {
+            SAOData& data = *static_cast<SAOData*>(_data);
+
+            passData.input = builder.Read(data.blurredImage, Renderer::RenderGraphBuilder::ShaderStage::COMPUTE);
+            passData.output = builder.Write(params.output, Renderer::RenderGraphBuilder::WriteMode::UAV, Renderer::RenderGraphBuilder::LoadMode::DISCARD);
+
+            return true; // Return true from setup to enable this pass, return false to disable it
+        },
+            [=](BlurPassData& passData, Renderer::RenderGraphResources& graphResources, Renderer::CommandList& commandList) // Execute
+        {
+            SAOData& data = *static_cast<SAOData*>(_data);
+
+            BlurParams blurParams;
+            blurParams.input = data.blurredImage;
+            blurParams.output = params.output;
+            blurParams.direction = uvec2(0, 1);
+
+            Blur(renderer, graphResources, commandList, frameIndex, blurParams);
+        }, recordingGroup);
     }
 
     void SAO::LinearizeDepth(Renderer::Renderer* renderer, Renderer::RenderGraphResources& graphResources, Renderer::CommandList& commandList, u32 frameIndex, const Params& params)
@@ -100,7 +162,6 @@ namespace PostProcess
         SAOData& data = *static_cast<SAOData*>(_data);
 
         commandList.PushMarker("LinearizeDepth", Color::White);
-        commandList.ImageBarrier(params.depth);
 
         // Linearize the first mip
         {
@@ -228,7 +289,6 @@ namespace PostProcess
         commandList.Dispatch(dispatchCount.x, dispatchCount.y, 1);
 
         commandList.EndPipeline(pipeline);
-        commandList.ImageBarrier(data.rawAOImage);
         commandList.PopMarker();
     }
 
@@ -267,6 +327,5 @@ namespace PostProcess
         commandList.Dispatch(dispatchCount.x, dispatchCount.y, 1);
 
         commandList.EndPipeline(pipeline);
-        commandList.ImageBarrier(params.output);
     }
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 namespace Renderer
 {
     class Renderer;
+    class RenderGraph;
     class RenderGraphResources;
     class CommandList;
 }
@@ -39,7 +40,8 @@ namespace PostProcess
             Renderer::ImageID output;
         };
 
-        static void CalculateSAO(Renderer::Renderer* renderer, Renderer::RenderGraphResources& graphResources, Renderer::CommandList& commandList, u32 frameIndex, const Params& params);
+        // Every step is its own pass with transient intermediate images, so the RenderGraph can alias the ones that don't overlap
+        static void AddPasses(Renderer::Renderer* renderer, Renderer::RenderGraph* renderGraph, u32 frameIndex, const Params& params, const void* recordingGroup);
 
     private:
         struct BlurParams
@@ -45,45 +45,48 @@ void PostProcessRenderer::AddCalculateSAOPass(Renderer::RenderGraph* renderGraph
 {
     bool saoEnabled = CVAR_SAOEnabled.Get() == 1;
 
-    struct CalculateSAOPassData
+    if (!saoEnabled)
     {
-    };
+        struct ClearSAOPassData
+        {
+            Renderer::RenderPassMutableResource ambientObscurance;
+        };
 
-    renderGraph->AddPass<CalculateSAOPassData>("Calculate SAO",
-        [=](CalculateSAOPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
-    {
-        return true; // Return true from setup to enable this pass, return false to disable it
-    },
-        [=](CalculateSAOPassData& data, Renderer::RenderGraphResources& graphResources, Renderer::CommandList& commandList) // Execute
-    {
-        if (saoEnabled)
+        renderGraph->AddPass<ClearSAOPassData>("Clear SAO",
+            [=](ClearSAOPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
+        {
+            // The RenderGraph clears this to white for us
+            data.ambientObscurance = builder.Write(_aoImage, Renderer::RenderGraphBuilder::WriteMode::UAV, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+
+            return true; // Return true from setup to enable this pass, return false to disable it
+        },
+            [=](ClearSAOPassData& data, Renderer::RenderGraphResources& graphResources, Renderer::CommandList& commandList) // Execute
         {
-            Camera* camera = ServiceLocator::GetCamera();
+        }, this);
 
-            PostProcess::SAO::Params params;
-            params.depth = resources.depth;
+        return;
+    }
 
-            vec2 resolution = _renderer->GetImageDimension(resources.color, 0);
+    Camera* camera = ServiceLocator::GetCamera();
 
-            params.nearPlane = camera->GetNearClip();
-            params.farPlane = camera->GetFarClip();
+    PostProcess::SAO::Params params;
+    params.depth = resources.depth;
 
-            params.projScale = CalculateProjScale(camera, resolution);
-            params.radius = CVAR_SAORadius.GetFloat();
-            params.bias = CVAR_SAOBias.GetFloat();
-            params.intensity = CVAR_SAOIntensity.GetFloat();
-            params.viewMatrix = camera->GetViewMatrix();
-            params.invProjMatrix = glm::inverse(camera->GetProjectionMatrix());
+    vec2 resolution = _renderer->GetImageDimension(resources.color, 0);
 
-            params.output = _aoImage;
+    params.nearPlane = camera->GetNearClip();
+    params.farPlane = camera->GetFarClip();
 
-            PostProcess::SAO::CalculateSAO(_renderer, graphResources, commandList, frameIndex, params);
-        }
-        else
-        {
-            commandList.Clear(_aoImage, Color(1, 1, 1, 1));
-        }
-    });
+    params.projScale = CalculateProjScale(camera, resolution);
+    params.radius = CVAR_SAORadius.GetFloat();
+    params.bias = CVAR_SAOBias.GetFloat();
+    params.intensity = CVAR_SAOIntensity.GetFloat();
+    params.viewMatrix = camera->GetViewMatrix();
+    params.invProjMatrix = glm::inverse(camera->GetProjectionMatrix());
+
+    params.output = _aoImage;
+
+    PostProcess::SAO::AddPasses(_renderer, renderGraph, frameIndex, params, this);
 }
 
 void PostProcessRenderer::AddPostProcessPass(Renderer::RenderGraph* renderGraph, RenderResources& resources, u8 frameIndex)
@@ -99,6 +102,7 @@ void PostProcessRenderer::CreatePermanentResources()
     imageDesc.format = Renderer::ImageFormat::R16G16B16A16_FLOAT;
     imageDesc.sampleCount = Renderer::SampleCount::SAMPLE_COUNT_1;
 
+    imageDesc.clearColor = Color(1, 1, 1, 1);
     imageDesc.debugName = "AmbientObscurance";
     _aoImage = _renderer->CreateImage(imageDesc);
 
@@ -391,7 +391,7 @@ void RendertargetVisualizer::AddVisualizerPass(Renderer::RenderGraph* renderGrap
 
                 RenderUtils::DepthOverlay(_renderer, graphResources, commandList, frameIndex, overlayParams);
             }
-        });
+        }, this);
 }
 
 bool RendertargetVisualizer::GetOverridingImageID(Renderer::ImageID& imageID)
@@ -109,7 +109,7 @@ void SkyboxRenderer::AddSkyboxPass(Renderer::RenderGraph* renderGraph, RenderRes
             commandList.Draw(3, 1, 0, 0);
 
             commandList.EndPipeline(pipeline);
-        });
+        }, this);
 }
 
 void SkyboxRenderer::CreatePermanentResources()
@@ -31,13 +31,15 @@ void SortUtils::Sort(Renderer::Renderer* renderer, Renderer::RenderGraphResource
 
         desc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
         desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-        Renderer::BufferID staging = renderer->CreateBuffer(desc);
+        Renderer::BufferID staging = renderer->CreateTemporaryBuffer(desc, 2);
 
         u32* numKeys = static_cast<u32*>(renderer->MapBuffer(staging));
         *numKeys = params.numKeys;
         renderer->UnmapBuffer(staging);
 
-        renderer->CopyBuffer(buffers.numKeysBuffer, 0, staging, 0, desc.size);
+        // The sort runs in this frame so the copy has to be part of our command list
+        commandList.CopyBuffer(buffers.numKeysBuffer, 0, staging, 0, desc.size);
+        commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToComputeShaderRW, buffers.numKeysBuffer);
     }
     
     // Then we copy the keys and payload into the first buffer
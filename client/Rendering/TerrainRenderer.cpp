@@ -5,6 +5,7 @@
 #include "WaterRenderer.h"
 #include "../Utils/ServiceLocator.h"
 #include "../Utils/MapUtils.h"
+#include "../Utils/MemoryMappedFile.h"
 
 #include "../ECS/Components/Singletons/MapSingleton.h"
 #include "../ECS/Components/Singletons/TextureSingleton.h"
@@ -21,6 +22,7 @@
 #include <GLFW/glfw3.h>
 #include <tracy/Tracy.hpp>
 #include <entt.hpp>
+#include <Utils/Timer.h>
 
 #include "Camera.h"
 #include "CVar/CVarSystem.h"
@@ -42,6 +44,10 @@ AutoCVar_Int CVAR_HeightBoxLockPosition("terrain.heightBox.LockPosition", "lock
 
 AutoCVar_Int CVAR_DrawCellGrid("terrain.cellGrid.Enable", "draw debug grid for displaying cells", 1, CVarFlags::EditCheckbox);
 
+AutoCVar_Int CVAR_StreamingEnabled("terrain.streaming.Enable", "stream chunks around the camera instead of loading the whole map, takes effect on map load", 1, CVarFlags::EditCheckbox);
+AutoCVar_Int CVAR_StreamingRadius("terrain.streaming.Radius", "radius in chunks around the camera to keep loaded", 8);
+AutoCVar_Int CVAR_StreamingChunksPerFrame("terrain.streaming.ChunksPerFrame", "max number of chunks to stream in per frame", 4);
+
 struct TerrainChunkData
 {
     u32 alphaMapID = 0;
@@ -117,6 +123,17 @@ void TerrainRenderer::Update(f32 deltaTime)
         DebugRenderCellTriangles(camera);
     }
 
+    // Slots unloaded CHUNK_SLOT_RETIRE_FRAMES frames ago are no longer read by anything in flight
+    _retiringChunkSlotsIndex = (_retiringChunkSlotsIndex + 1) % CHUNK_SLOT_RETIRE_FRAMES;
+    std::vector<u32>& retiredChunkSlots = _retiringChunkSlots[_retiringChunkSlotsIndex];
+    _freeChunkSlots.insert(_freeChunkSlots.end(), retiredChunkSlots.begin(), retiredChunkSlots.end());
+    retiredChunkSlots.clear();
+
+    if (_streamingRadius > 0)
+    {
+        UpdateStreaming(camera, static_cast<u32>(glm::max(CVAR_StreamingChunksPerFrame.Get(), 1)));
+    }
+
     const bool cullingEnabled = CVAR_CullingEnabled.Get();
     const bool gpuCullEnabled = CVAR_GPUCullingEnabled.Get();
 
@@ -215,35 +232,26 @@ void TerrainRenderer::CPUCulling(const Camera* camera)
     _culledInstances.clear();
     _culledInstances.reserve(_loadedChunks.Size() * Terrain::MAP_CELLS_PER_CHUNK);
 
-    const size_t chunkCount = _loadedChunks.Size();
-    size_t boundingBoxIndex = 0;
-    for (size_t i = 0; i < chunkCount; ++i)
-    {
-        for (u16 cellId = 0; cellId < Terrain::MAP_CELLS_PER_CHUNK; ++cellId)
+    _loadedChunks.ReadLock(
+        [&](const std::vector<u16>& loadedChunks)
         {
-            u32 index = static_cast<u32>(boundingBoxIndex++);
+            for (const u16 chunkId : loadedChunks)
+            {
+                const u32 chunkSlot = _chunkIDToSlot.at(chunkId);
 
-            const Geometry::AABoundingBox* boundingBox = nullptr;
-            _cellBoundingBoxes.ReadLock([&](const std::vector<Geometry::AABoundingBox>& boundingBoxes) {
-                boundingBox = &boundingBoxes[index];
-                });
+                for (u16 cellId = 0; cellId < Terrain::MAP_CELLS_PER_CHUNK; ++cellId)
+                {
+                    u32 index = chunkSlot * Terrain::MAP_CELLS_PER_CHUNK + cellId;
 
-            //const Geometry::AABoundingBox& boundingBox = _cellBoundingBoxes[index];
-            if (IsInsideFrustum(frustumPlanes, *boundingBox))
-            {
-                u16 chunkId = 0;
-                _loadedChunks.ReadLock(
-                    [&](const std::vector<u16>& loadedChunks)
+                    if (IsInsideFrustum(frustumPlanes, _cellBoundingBoxes[index]))
                     {
-                        chunkId = loadedChunks[i];
-                    });
-
-                CellInstance& cellInstance = _culledInstances.emplace_back();
-                cellInstance.packedChunkCellID = (chunkId << 16) | cellId;
-                cellInstance.instanceID = index;
+                        CellInstance& cellInstance = _culledInstances.emplace_back();
+                        cellInstance.packedChunkCellID = (chunkId << 16) | cellId;
+                        cellInstance.instanceID = index;
+                    }
+                }
             }
-        }
-    }
+        });
 
     _debugRenderer->DrawFrustum(lockedViewProjectionMatrix, 0xff0000ff);
 }
@@ -284,7 +292,7 @@ void TerrainRenderer::AddTerrainDepthPrepass(Renderer::RenderGraph* renderGraph,
         renderGraph->AddPass<TerrainDepthPrepassData>("Terrain Depth Prepass",
             [=](TerrainDepthPrepassData& data, Renderer::RenderGraphBuilder& builder) // Setup
             {
-                data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+                data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
 
                 return true; // Return true from setup to enable this pass, return false to disable it
             },
@@ -333,6 +341,9 @@ void TerrainRenderer::AddTerrainDepthPrepass(Renderer::RenderGraph* renderGraph,
                     }
                     _cullingConstants.occlusionEnabled = CVAR_OcclusionCullingEnabled.Get();
 
+                    const u32 cellCount = (u32)_loadedChunks.Size() * Terrain::MAP_CELLS_PER_CHUNK;
+                    _cullingConstants.numInstances = cellCount;
+
                     // Reset the counter
                     commandList.FillBuffer(_argumentBuffer, 0, 4, Terrain::NUM_INDICES_PER_CELL);
                     commandList.FillBuffer(_argumentBuffer, 4, 12, 0);
@@ -366,7 +377,6 @@ void TerrainRenderer::AddTerrainDepthPrepass(Renderer::RenderGraph* renderGraph,
                     commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::GLOBAL, &resources.globalDescriptorSet, frameIndex);
                     commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_cullingPassDescriptorSet, frameIndex);
 
-                    const u32 cellCount = (u32)_loadedChunks.Size() * Terrain::MAP_CELLS_PER_CHUNK;
                     commandList.Dispatch((cellCount + 31) / 32, 1, 1);
 
                     commandList.EndPipeline(pipeline);
@@ -455,7 +465,7 @@ void TerrainRenderer::AddTerrainDepthPrepass(Renderer::RenderGraph* renderGraph,
                         commandList.PipelineBarrier(Renderer::PipelineBarrierType::TransferDestToTransferSrc, _drawCountReadBackBuffer);
                     }
                 }
-            });
+            }, this);
     }
 
     _mapObjectRenderer->AddMapObjectDepthPrepass(renderGraph, resources, frameIndex);
@@ -470,6 +480,7 @@ void TerrainRenderer::AddTerrainPass(Renderer::RenderGraph* renderGraph, RenderR
             Renderer::RenderPassMutableResource color;
             Renderer::RenderPassMutableResource objectIDs;
             Renderer::RenderPassMutableResource depth;
+            Renderer::RenderPassResource ambientObscurance;
         };
 
         const bool cullingEnabled = CVAR_CullingEnabled.Get();
@@ -479,9 +490,10 @@ void TerrainRenderer::AddTerrainPass(Renderer::RenderGraph* renderGraph, RenderR
         renderGraph->AddPass<TerrainPassData>("Terrain Pass",
             [=](TerrainPassData& data, Renderer::RenderGraphBuilder& builder) // Setup
         {
-            data.color = builder.Write(resources.color, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
-            data.objectIDs = builder.Write(resources.objectIDs, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
-            data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+            data.color = builder.Write(resources.color, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
+            data.objectIDs = builder.Write(resources.objectIDs, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
+            data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
+            data.ambientObscurance = builder.Read(resources.ambientObscurance, Renderer::RenderGraphBuilder::ShaderStage::PIXEL);
 
             return true; // Return true from setup to enable this pass, return false to disable it
         },
@@ -580,7 +592,7 @@ void TerrainRenderer::AddTerrainPass(Renderer::RenderGraph* renderGraph, RenderR
             }
 
             commandList.EndPipeline(pipeline);
-        });
+        }, this);
     }
 
     // Subrenderers
@@ -598,6 +610,7 @@ void TerrainRenderer::CreatePermanentResources()
     textureColorArrayDesc.size = 4096;
 
     _terrainColorTextureArray = _renderer->CreateTextureArray(textureColorArrayDesc);
+    _colorTextureRefCounts.resize(textureColorArrayDesc.size);
     _passDescriptorSet.Bind("_terrainColorTextures"_h, _terrainColorTextureArray);
 
     Renderer::TextureArrayDesc textureAlphaArrayDesc;
@@ -773,15 +786,14 @@ void TerrainRenderer::RegisterChunkToBeLoaded(Terrain::Map& map, u16 chunkPosX,
     u16 chunkID;
     map.GetChunkIdFromChunkPosition(chunkPosX, chunkPosY, chunkID);
 
-    const auto chunkIt = map.chunks.find(chunkID);
-    if (chunkIt == map.chunks.cend())
+    if (!map.HasChunk(chunkID))
     {
         return;
     }
 
+    // The chunk itself gets faulted in by LoadChunk, that way decoding happens in parallel
     ChunkToBeLoaded& chunkToBeLoaded = _chunksToBeLoaded.emplace_back();
     chunkToBeLoaded.map = &map;
-    chunkToBeLoaded.chunk = &chunkIt->second;
     chunkToBeLoaded.chunkPosX = chunkPosX;
     chunkToBeLoaded.chunkPosY = chunkPosY;
     chunkToBeLoaded.chunkID = chunkID;
@@ -791,12 +803,175 @@ void TerrainRenderer::ExecuteLoad()
 {
     ZoneScopedN("TerrainRenderer::ExecuteLoad()");
 
-    size_t numChunksToLoad = _chunksToBeLoaded.size();
+    if (_chunksToBeLoaded.empty())
+        return;
+
+    // Hand out slots up front so LoadChunk can write into its own part of the buffers without locking
+    for (ChunkToBeLoaded& chunk : _chunksToBeLoaded)
+    {
+        if (_freeChunkSlots.empty())
+        {
+            DebugHandler::PrintFatal("TerrainRenderer ran out of chunk slots! (%u slots)", static_cast<u32>(_chunkSlots.size()));
+        }
+
+        chunk.chunkSlot = _freeChunkSlots.back();
+        _freeChunkSlots.pop_back();
+
+        _chunkSlots[chunk.chunkSlot].chunkID = chunk.chunkID;
+        _chunkIDToSlot[chunk.chunkID] = chunk.chunkSlot;
+    }
+
+    // Every chunk goes through three stages: map and page in its file, decode it (Chunk::Read plus border alignment) and finally pack and upload it into its slot.
+    // The stages of different chunks overlap, so chunks waiting on the disk don't hold up the ones that are already being decoded or packed.
+    struct ChunkLoadStages
+    {
+        bool alreadyDecoded = false;
+        MemoryMappedFile chunkFile;
+
+        Terrain::Chunk* chunk = nullptr;
+        StringTable* stringTable = nullptr;
+    };
+
+    const size_t numChunksToBeLoaded = _chunksToBeLoaded.size();
+    std::unique_ptr<ChunkLoadStages[]> chunkLoadStages = std::make_unique<ChunkLoadStages[]>(numChunksToBeLoaded);
+
+    auto readStage = [&](size_t index)
+    {
+        ZoneScopedN("TerrainRenderer::ExecuteLoad()::Read");
+
+        const ChunkToBeLoaded& chunk = _chunksToBeLoaded[index];
+        ChunkLoadStages& stages = chunkLoadStages[index];
+
+        // Chunks someone already faulted in (physics, a previous visit) skip straight to packing
+        stages.alreadyDecoded = chunk.map->IsChunkDecoded(chunk.chunkID);
+        if (stages.alreadyDecoded)
+            return;
+
+        if (chunk.map->MapChunkFile(chunk.chunkID, stages.chunkFile))
+        {
+            stages.chunkFile.Prefetch();
+        }
+    };
+
+    auto decodeStage = [&](size_t index)
+    {
+        ZoneScopedN("TerrainRenderer::ExecuteLoad()::Decode");
+
+        const ChunkToBeLoaded& chunk = _chunksToBeLoaded[index];
+        ChunkLoadStages& stages = chunkLoadStages[index];
+
+        if (stages.alreadyDecoded)
+        {
+            stages.chunk = chunk.map->GetChunkById(chunk.chunkID);
+        }
+        else if (stages.chunkFile.IsOpen())
+        {
+            stages.chunk = chunk.map->DecodeChunk(chunk.chunkID, stages.chunkFile);
+            stages.chunkFile.Close();
+        }
+
+        if (stages.chunk != nullptr)
+        {
+            stages.stringTable = chunk.map->GetStringTableById(chunk.chunkID);
+        }
+    };
+
+    auto packStage = [&](size_t index)
+    {
+        const ChunkToBeLoaded& chunk = _chunksToBeLoaded[index];
+        ChunkLoadStages& stages = chunkLoadStages[index];
+
+        if (stages.chunk == nullptr || stages.stringTable == nullptr)
+            return;
+
+        std::string chunkIDString = std::to_string(chunk.chunkID);
+
+        ZoneScoped;
+        ZoneText(chunkIDString.c_str(), chunkIDString.length());
+
+        LoadChunk(chunk, *stages.chunk, *stages.stringTable);
+    };
+
+#if PARALLEL_LOADING
+    tf::Taskflow tf;
+    for (size_t i = 0; i < numChunksToBeLoaded; i++)
+    {
+        tf::Task readTask = tf.emplace([&readStage, i]() { readStage(i); });
+        tf::Task decodeTask = tf.emplace([&decodeStage, i]() { decodeStage(i); });
+        tf::Task packTask = tf.emplace([&packStage, i]() { packStage(i); });
+
+        readTask.precede(decodeTask);
+        decodeTask.precede(packTask);
+    }
+    tf.wait_for_all();
+#else
+    for (size_t i = 0; i < numChunksToBeLoaded; i++)
+    {
+        readStage(i);
+        decodeStage(i);
+        packStage(i);
+    }
+#endif
+
+    // The subrenderers aren't thread safe yet, registering here keeps them out of the parallel section entirely
+    {
+        ZoneScopedN("TerrainRenderer::ExecuteLoad()::Subload");
+
+        for (size_t i = 0; i < numChunksToBeLoaded; i++)
+        {
+            const ChunkLoadStages& stages = chunkLoadStages[i];
+            if (stages.chunk == nullptr || stages.stringTable == nullptr)
+                continue;
+
+            const u16 chunkID = _chunksToBeLoaded[i].chunkID;
+            _mapObjectRenderer->RegisterMapObjectsToBeLoaded(chunkID, *stages.chunk, *stages.stringTable);
+            _complexModelRenderer->RegisterLoadFromChunk(chunkID, *stages.chunk, *stages.stringTable);
+        }
+    }
+
+    // Reference count the color textures so we know when we can evict them again
+    for (const ChunkToBeLoaded& chunk : _chunksToBeLoaded)
+    {
+        for (u32 diffuseID : _chunkSlots[chunk.chunkSlot].diffuseIDs)
+        {
+            if (_colorTextureRefCounts[diffuseID]++ == 0)
+            {
+                _numResidentColorTextures++;
+            }
+        }
+
+        _loadedChunks.PushBack(chunk.chunkID);
+    }
+
+    _chunksToBeLoaded.clear();
+}
+
+void TerrainRenderer::CreateChunkBuffers(u32 numChunkSlots)
+{
+    _chunkSlots.clear();
+    _chunkSlots.resize(numChunkSlots);
+
+    // Reversed so slots get handed out in ascending order
+    _freeChunkSlots.resize(numChunkSlots);
+    for (u32 i = 0; i < numChunkSlots; i++)
+    {
+        _freeChunkSlots[i] = numChunkSlots - 1 - i;
+    }
+
+    // These point into the old buffers
+    for (std::vector<u32>& retiringChunkSlots : _retiringChunkSlots)
+    {
+        retiringChunkSlots.clear();
+    }
+
+    _chunkIDToSlot.clear();
+    _cellBoundingBoxes.clear();
+    _cellBoundingBoxes.resize(numChunkSlots * Terrain::MAP_CELLS_PER_CHUNK);
 
     {
         Renderer::BufferDesc desc;
         desc.name = "CulledTerrainInstanceBuffer";
-        desc.size = sizeof(CellInstance) * Terrain::MAP_CELLS_PER_CHUNK * numChunksToLoad;
+        desc.size = sizeof(CellInstance) * Terrain::MAP_CELLS_PER_CHUNK * numChunkSlots;
         desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::VERTEX_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
         _instanceBuffer = _renderer->CreateBuffer(_instanceBuffer, desc);
     }
@@ -804,7 +979,7 @@ void TerrainRenderer::ExecuteLoad()
     {
         Renderer::BufferDesc desc;
         desc.name = "TerrainInstanceBuffer";
-        desc.size = sizeof(CellInstance) * Terrain::MAP_CELLS_PER_CHUNK * numChunksToLoad;
+        desc.size = sizeof(CellInstance) * Terrain::MAP_CELLS_PER_CHUNK * numChunkSlots;
         desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::VERTEX_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
         _culledInstanceBuffer = _renderer->CreateBuffer(_culledInstanceBuffer, desc);
     }
@@ -812,7 +987,7 @@ void TerrainRenderer::ExecuteLoad()
     {
         Renderer::BufferDesc desc;
         desc.name = "TerrainChunkBuffer";
-        desc.size = sizeof(TerrainChunkData) * numChunksToLoad;
+        desc.size = sizeof(TerrainChunkData) * numChunkSlots;
         desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
         _chunkBuffer = _renderer->CreateBuffer(_chunkBuffer, desc);
     }
@@ -820,7 +995,7 @@ void TerrainRenderer::ExecuteLoad()
     {
         Renderer::BufferDesc desc;
         desc.name = "TerrainCellBuffer";
-        desc.size = sizeof(TerrainCellData) * Terrain::MAP_CELLS_PER_CHUNK * numChunksToLoad;
+        desc.size = sizeof(TerrainCellData) * Terrain::MAP_CELLS_PER_CHUNK * numChunkSlots;
         desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
         _cellBuffer = _renderer->CreateBuffer(_cellBuffer, desc);
     }
@@ -828,7 +1003,7 @@ void TerrainRenderer::ExecuteLoad()
     {
         Renderer::BufferDesc desc;
         desc.name = "TerrainVertexBuffer";
-        desc.size = sizeof(TerrainVertex) * Terrain::NUM_VERTICES_PER_CHUNK * numChunksToLoad;
+        desc.size = sizeof(TerrainVertex) * Terrain::NUM_VERTICES_PER_CHUNK * numChunkSlots;
         desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
         _vertexBuffer = _renderer->CreateBuffer(_vertexBuffer, desc);
     }
@@ -836,40 +1011,221 @@ void TerrainRenderer::ExecuteLoad()
     {
         Renderer::BufferDesc desc;
         desc.name = "CellHeightRangeBuffer";
-        desc.size = sizeof(TerrainCellHeightRange) * Terrain::MAP_CELLS_PER_CHUNK * numChunksToLoad;
+        desc.size = sizeof(TerrainCellHeightRange) * Terrain::MAP_CELLS_PER_CHUNK * numChunkSlots;
         desc.usage = Renderer::BufferUsage::STORAGE_BUFFER | Renderer::BufferUsage::TRANSFER_DESTINATION;
         _cellHeightRangeBuffer = _renderer->CreateBuffer(_cellHeightRangeBuffer, desc);
     }
+}
 
-#if PARALLEL_LOADING
-    tf::Taskflow tf;
-    tf.parallel_for(_chunksToBeLoaded.begin(), _chunksToBeLoaded.end(), [&](const auto& chunk)
+void TerrainRenderer::UpdateStreaming(const Camera* camera, u32 maxChunksToLoad)
+{
+    ZoneScoped;
+
+    entt::registry* registry = ServiceLocator::GetGameRegistry();
+    MapSingleton& mapSingleton = registry->ctx<MapSingleton>();
+    Terrain::Map& currentMap = mapSingleton.GetCurrentMap();
+
+    if (!currentMap.IsLoadedMap() || currentMap.header.flags.UseMapObjectInsteadOfTerrain)
+        return;
+
+    // Changing the radius changes how many slots we need, so start over with freshly sized buffers
+    const i32 radius = glm::clamp(static_cast<i32>(CVAR_StreamingRadius.Get()), 1, static_cast<i32>(Terrain::MAP_CHUNKS_PER_MAP_STRIDE / 2));
+    if (radius != _streamingRadius)
+    {
+        std::vector<u16> residentChunks;
+        _loadedChunks.ReadLock([&](const std::vector<u16>& loadedChunks) { residentChunks = loadedChunks; });
+        UnloadChunks(residentChunks);
+
+        // Plus a ring of chunks around the radius, so chunks that just left it can retire while their replacements load
+        const u32 diameter = static_cast<u32>(radius) * 2 + 1;
+        CreateChunkBuffers(glm::min(diameter * diameter + (diameter + 1) * 4, Terrain::MAP_CHUNKS_PER_MAP));
+
+        _streamingRadius = radius;
+        _streamingCenterChunk = ivec2(-1, -1);
+    }
+
+    vec2 adtPos = Terrain::MapUtils::WorldPositionToADTCoordinates(camera->GetPosition());
+    vec2 chunkPos = Terrain::MapUtils::GetChunkFromAdtPosition(adtPos);
+
+    ivec2 centerChunk = glm::clamp(ivec2(glm::floor(chunkPos)), ivec2(0, 0), ivec2(static_cast<i32>(Terrain::MAP_CHUNKS_PER_MAP_STRIDE) - 1));
+
+    // Nothing changed since last frame and everything around us is loaded
+    if (centerChunk == _streamingCenterChunk && _numChunksPendingLoad == 0)
+        return;
+
+    _streamingCenterChunk = centerChunk;
+
+    // Evict chunks that left the radius
+    std::vector<u16> chunksToUnload;
+    _loadedChunks.ReadLock(
+        [&](const std::vector<u16>& loadedChunks)
         {
-            std::string chunkIDString = std::to_string(chunk.chunkID);
+            for (const u16 chunkID : loadedChunks)
+            {
+                ivec2 residentChunk = ivec2(chunkID % Terrain::MAP_CHUNKS_PER_MAP_STRIDE, chunkID / Terrain::MAP_CHUNKS_PER_MAP_STRIDE);
+                ivec2 distance = glm::abs(residentChunk - centerChunk);
 
-            ZoneScoped;
-            ZoneText(chunkIDString.c_str(), chunkIDString.length());
+                if (glm::max(distance.x, distance.y) > radius)
+                {
+                    chunksToUnload.push_back(chunkID);
+                }
+            }
+        });
 
-            LoadChunk(chunk);
+    UnloadChunks(chunksToUnload);
+
+    // Gather chunks inside the radius that aren't resident yet, closest first
+    std::vector<ivec2> chunksToLoad;
+
+    ivec2 startPos = glm::max(centerChunk - radius, ivec2(0, 0));
+    ivec2 endPos = glm::min(centerChunk + radius, ivec2(static_cast<i32>(Terrain::MAP_CHUNKS_PER_MAP_STRIDE) - 1));
+
+    for (i32 y = startPos.y; y <= endPos.y; y++)
+    {
+        for (i32 x = startPos.x; x <= endPos.x; x++)
+        {
+            u16 chunkID;
+            currentMap.GetChunkIdFromChunkPosition(x, y, chunkID);
+
+            if (_chunkIDToSlot.find(chunkID) != _chunkIDToSlot.end())
+                continue;
+
+            if (!currentMap.HasChunk(chunkID))
+                continue;
+
+            chunksToLoad.push_back(ivec2(x, y));
+        }
+    }
+
+    std::sort(chunksToLoad.begin(), chunksToLoad.end(), [centerChunk](const ivec2& a, const ivec2& b)
+        {
+            ivec2 distanceA = a - centerChunk;
+            ivec2 distanceB = b - centerChunk;
+            return (distanceA.x * distanceA.x + distanceA.y * distanceA.y) < (distanceB.x * distanceB.x + distanceB.y * distanceB.y);
         });
-    tf.wait_for_all();
-#else
-    for (const ChunkToBeLoaded& chunk : _chunksToBeLoaded)
+
+    // Freed slots take a few frames to retire, whatever doesn't fit yet gets loaded on a later frame
+    const u32 numChunksToLoad = glm::min(static_cast<u32>(chunksToLoad.size()), glm::min(maxChunksToLoad, static_cast<u32>(_freeChunkSlots.size())));
+    _numChunksPendingLoad = static_cast<u32>(chunksToLoad.size()) - numChunksToLoad;
+
+    if (numChunksToLoad == 0)
     {
-        std::string chunkIDString = std::to_string(chunk.chunkID);
+        if (!chunksToUnload.empty())
+        {
+            UploadInstances();
 
-        ZoneScoped;
-        ZoneText(chunkIDString.c_str(), chunkIDString.length());
+            // Flush the unloads queued in the subrenderers
+            _mapObjectRenderer->ExecuteLoad();
+            _complexModelRenderer->ExecuteLoad();
+        }
+        return;
+    }
 
-        LoadChunk(chunk);
+    for (u32 i = 0; i < numChunksToLoad; i++)
+    {
+        RegisterChunkToBeLoaded(currentMap, chunksToLoad[i].x, chunksToLoad[i].y);
     }
-#endif
 
-    _chunksToBeLoaded.clear();
+    ExecuteLoad();
+    UploadInstances();
+
+    _mapObjectRenderer->ExecuteLoad();
+    _complexModelRenderer->ExecuteLoad();
+}
+
+void TerrainRenderer::UnloadChunks(const std::vector<u16>& chunkIDs)
+{
+    ZoneScoped;
+
+    if (chunkIDs.empty())
+        return;
+
+    std::vector<u32> colorTexturesToUnload;
+    std::vector<u32> alphaTexturesToUnload;
+
+    for (const u16 chunkID : chunkIDs)
+    {
+        auto itr = _chunkIDToSlot.find(chunkID);
+        if (itr == _chunkIDToSlot.end())
+            continue;
+
+        const u32 chunkSlot = itr->second;
+        ChunkSlot& slot = _chunkSlots[chunkSlot];
+
+        for (u32 diffuseID : slot.diffuseIDs)
+        {
+            if (--_colorTextureRefCounts[diffuseID] == 0)
+            {
+                colorTexturesToUnload.push_back(diffuseID);
+                _numResidentColorTextures--;
+            }
+        }
+
+        if (slot.hasAlphaMap)
+        {
+            alphaTexturesToUnload.push_back(slot.alphaMapID);
+        }
+
+        slot = ChunkSlot();
+
+        // The subrenderers only queue their removals here, they are applied on their next ExecuteLoad
+        _mapObjectRenderer->UnloadChunk(chunkID);
+        _complexModelRenderer->UnloadChunk(chunkID);
+
+        _chunkIDToSlot.erase(itr);
+        _retiringChunkSlots[_retiringChunkSlotsIndex].push_back(chunkSlot);
+    }
+
+    _loadedChunks.WriteLock(
+        [&](std::vector<u16>& loadedChunks)
+        {
+            loadedChunks.erase(std::remove_if(loadedChunks.begin(), loadedChunks.end(), [&](u16 chunkID)
+                {
+                    return _chunkIDToSlot.find(chunkID) == _chunkIDToSlot.end();
+                }), loadedChunks.end());
+        });
+
+    // _colorTextureRefCounts only covers the terrain array, the renderer keeps textures that the model arrays or the UI also loaded
+    _renderer->UnloadTexturesInArray(_terrainColorTextureArray, colorTexturesToUnload);
+    _renderer->UnloadTexturesInArray(_terrainAlphaTextureArray, alphaTexturesToUnload);
+}
+
+void TerrainRenderer::UploadInstances()
+{
+    ZoneScoped;
+
+    const size_t cellCount = Terrain::MAP_CELLS_PER_CHUNK * _loadedChunks.Size();
+    if (cellCount == 0)
+        return;
+
+    auto uploadBuffer = _renderer->CreateUploadBuffer(_instanceBuffer, 0, sizeof(CellInstance) * cellCount);
+    CellInstance* instanceData = static_cast<CellInstance*>(uploadBuffer->mappedMemory);
+    u32 instanceDataIndex = 0;
+
+    _loadedChunks.ReadLock(
+        [&](const std::vector<u16>& loadedChunks)
+        {
+            for (const u16 chunkID : loadedChunks)
+            {
+                const u32 chunkSlot = _chunkIDToSlot.at(chunkID);
+
+                for (u32 cellID = 0; cellID < Terrain::MAP_CELLS_PER_CHUNK; ++cellID)
+                {
+                    CellInstance& instance = instanceData[instanceDataIndex++];
+                    instance.packedChunkCellID = (chunkID << 16) | (cellID & 0xffff);
+                    instance.instanceID = chunkSlot * Terrain::MAP_CELLS_PER_CHUNK + cellID;
+                }
+            }
+        });
+
+    assert(instanceDataIndex == cellCount);
 }
 
 bool TerrainRenderer::LoadMap(const NDBC::Map* map)
 {
+    ZoneScoped;
+    Timer timer;
+
     entt::registry* registry = ServiceLocator::GetGameRegistry();
     MapSingleton& mapSingleton = registry->ctx<MapSingleton>();
 
@@ -880,7 +1236,19 @@ bool TerrainRenderer::LoadMap(const NDBC::Map* map)
 
     // Clear Terrain, WMOs and Water
     _loadedChunks.Clear();
-    _cellBoundingBoxes.Clear();
+    _cellBoundingBoxes.clear();
+    _chunkSlots.clear();
+    _freeChunkSlots.clear();
+    for (std::vector<u32>& retiringChunkSlots : _retiringChunkSlots)
+    {
+        retiringChunkSlots.clear();
+    }
+    _chunkIDToSlot.clear();
+    std::fill(_colorTextureRefCounts.begin(), _colorTextureRefCounts.end(), static_cast<u16>(0));
+    _numResidentColorTextures = 0;
+    _numChunksPendingLoad = 0;
+    _streamingRadius = -1;
+
     _mapObjectRenderer->Clear();
     _complexModelRenderer->Clear();
     _waterRenderer->Clear();
@@ -895,6 +1263,11 @@ bool TerrainRenderer::LoadMap(const NDBC::Map* map)
     {
         _mapObjectRenderer->RegisterMapObjectToBeLoaded(currentMap.header.mapObjectName, currentMap.header.mapObjectPlacement);
     }
+    else if (CVAR_StreamingEnabled.Get())
+    {
+        // Load everything within the radius right away so we don't start out with an empty world, Update streams in the rest as the camera moves
+        UpdateStreaming(ServiceLocator::GetCamera(), Terrain::MAP_CHUNKS_PER_MAP);
+    }
     else
     {
         RegisterChunksToBeLoaded(currentMap, ivec2(32, 32), 32); // Load everything
@@ -903,42 +1276,9 @@ bool TerrainRenderer::LoadMap(const NDBC::Map* map)
         //RegisterChunksToBeLoaded(map, ivec2(40, 32), 8); // Razor Hill
         //RegisterChunksToBeLoaded(map, ivec2(22, 25), 8); // Borean Tundra
 
+        CreateChunkBuffers(static_cast<u32>(_chunksToBeLoaded.size()));
         ExecuteLoad();
-    
-        // Upload instance data
-        {
-            const size_t cellCount = Terrain::MAP_CELLS_PER_CHUNK * _loadedChunks.Size();
-
-            Renderer::BufferDesc uploadBufferDesc;
-            uploadBufferDesc.name = "TerrainInstanceUploadBuffer";
-            uploadBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-            uploadBufferDesc.size = sizeof(CellInstance) * cellCount;
-            uploadBufferDesc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
-
-            Renderer::BufferID instanceUploadBuffer = _renderer->CreateBuffer(uploadBufferDesc);
-            _renderer->QueueDestroyBuffer(instanceUploadBuffer);
-
-            void* instanceBufferMemory = _renderer->MapBuffer(instanceUploadBuffer);
-            CellInstance* instanceData = static_cast<CellInstance*>(instanceBufferMemory);
-            u32 instanceDataIndex = 0;
-
-            _loadedChunks.ReadLock(
-                [&](std::vector<u16> loadedChunks)
-                {
-                    for (const u16 chunkID : loadedChunks)
-                    {
-                        for (u32 cellID = 0; cellID < Terrain::MAP_CELLS_PER_CHUNK; ++cellID)
-                        {
-                            instanceData[instanceDataIndex].packedChunkCellID = (chunkID << 16) | (cellID & 0xffff);
-                            instanceData[instanceDataIndex++].instanceID = instanceDataIndex;
-                        }
-                    }
-                });
-            
-            assert(instanceDataIndex == cellCount);
-            _renderer->UnmapBuffer(instanceUploadBuffer);
-            _renderer->CopyBuffer(_instanceBuffer, 0, instanceUploadBuffer, 0, uploadBufferDesc.size);
-        }
+        UploadInstances();
     }
 
     _mapObjectRenderer->ExecuteLoad();
@@ -947,29 +1287,23 @@ bool TerrainRenderer::LoadMap(const NDBC::Map* map)
     // Load Water
     //_waterRenderer->LoadWater(_loadedChunks);
 
+    _lastMapLoadTime = timer.GetLifeTime();
+    DebugHandler::PrintSuccess("TerrainRenderer : Loaded map in %.2fms (%u chunks resident)", _lastMapLoadTime * 1000.0f, static_cast<u32>(_loadedChunks.Size()));
+
     return true;
 }
 
-void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
+void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded, const Terrain::Chunk& chunk, StringTable& stringTable)
 {
-    Terrain::Map& map = *chunkToBeLoaded.map;
     u16 chunkPosX = chunkToBeLoaded.chunkPosX;
     u16 chunkPosY = chunkToBeLoaded.chunkPosY;
-    u16 chunkID = chunkToBeLoaded.chunkID;
-    const Terrain::Chunk& chunk = *chunkToBeLoaded.chunk;
 
-    StringTable& stringTable = map.stringTables[chunkID];
     entt::registry* registry = ServiceLocator::GetGameRegistry();     
     TextureSingleton& textureSingleton = registry->ctx<TextureSingleton>();
 
-    size_t currentChunkIndex = 0;
-    _loadedChunks.WriteLock(
-        [&currentChunkIndex, chunkID](std::vector<u16>& loadedChunks)
-        {
-            currentChunkIndex = loadedChunks.size();
-            loadedChunks.push_back(chunkID);
-        }
-    );
+    // Each chunk owns its slot, so nothing below has to synchronize with other chunks being loaded
+    const size_t currentChunkIndex = chunkToBeLoaded.chunkSlot;
+    ChunkSlot& chunkSlot = _chunkSlots[currentChunkIndex];
 
     // Upload cell data.
     {
@@ -1020,6 +1354,11 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
                 }
 
                 cellData.diffuseIDs[layerCount++] = diffuseID;
+
+                if (std::find(chunkSlot.diffuseIDs.begin(), chunkSlot.diffuseIDs.end(), diffuseID) == chunkSlot.diffuseIDs.end())
+                {
+                    chunkSlot.diffuseIDs.push_back(diffuseID);
+                }
             }
         }
     }
@@ -1035,6 +1374,9 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
         {
             _renderer->LoadTextureIntoArray(chunkAlphaMapDesc, _terrainAlphaTextureArray, alphaID);
         }
+
+        chunkSlot.hasAlphaMap = true;
+        chunkSlot.alphaMapID = alphaID;
     }
 
     // Upload chunk data.
@@ -1099,6 +1441,9 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
         std::vector<TerrainCellHeightRange> heightRanges;
         heightRanges.reserve(Terrain::MAP_CELLS_PER_CHUNK);
 
+        std::vector<Geometry::AABoundingBox> boundingBoxes;
+        boundingBoxes.reserve(Terrain::MAP_CELLS_PER_CHUNK);
+
         for (u32 cellIndex = 0; cellIndex < Terrain::MAP_CELLS_PER_CHUNK; cellIndex++)
         {
             const Terrain::Cell& cell = chunk.cells[cellIndex];
@@ -1121,7 +1466,7 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
             max.y = chunkOrigin.x - ((cellX + 1) * Terrain::MAP_CELL_SIZE);
             max.z = *minmax.second;
 
-            Geometry::AABoundingBox& boundingBox = _cellBoundingBoxes.EmplaceBack();
+            Geometry::AABoundingBox& boundingBox = boundingBoxes.emplace_back();
             boundingBox.min = glm::max(min, max);
             boundingBox.max = glm::min(min, max);
 
@@ -1137,6 +1482,8 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
             heightRanges.push_back(heightRange);
         }
 
+        std::copy(boundingBoxes.begin(), boundingBoxes.end(), _cellBoundingBoxes.begin() + currentChunkIndex * Terrain::MAP_CELLS_PER_CHUNK);
+
         // Upload height ranges
         {
             size_t size = sizeof(TerrainCellHeightRange) * Terrain::MAP_CELLS_PER_CHUNK;
@@ -1146,13 +1493,4 @@ void TerrainRenderer::LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded)
             memcpy(uploadBuffer->mappedMemory, heightRanges.data(), size);
         }
     }
-
-    // TODO: Parallelize loading in the other renderers so we don't have to do this... But lets split this task into smaller chunks.
-    {
-        std::scoped_lock lock(_subLoadMutex);
-
-        ZoneScopedN("Subload");
-        _mapObjectRenderer->RegisterMapObjectsToBeLoaded(chunkID, chunk, stringTable);
-        _complexModelRenderer->RegisterLoadFromChunk(chunkID, chunk, stringTable);
-    }
 }
@@ -2,6 +2,7 @@
 #include <NovusTypes.h>
 
 #include <array>
+#include <robin_hood.h>
 
 #include <Utils/StringUtils.h>
 #include <Utils/SafeVector.h>
@@ -50,10 +51,19 @@ class TerrainRenderer
     struct ChunkToBeLoaded
     {
         Terrain::Map* map = nullptr;
-        Terrain::Chunk* chunk = nullptr;
         u16 chunkPosX;
         u16 chunkPosY;
         u16 chunkID;
+        u32 chunkSlot;
+    };
+
+    // Chunks are streamed into fixed slots in our GPU buffers, instanceID / 256 is the slot a cell lives in
+    struct ChunkSlot
+    {
+        u16 chunkID = Terrain::MAP_CHUNK_ID_INVALID;
+        bool hasAlphaMap = false;
+        u32 alphaMapID = 0;
+        std::vector<u32> diffuseIDs; // Unique indices into _terrainColorTextureArray used by this chunk
     };
 
     struct CullingConstants
@@ -61,6 +71,7 @@ class TerrainRenderer
         vec4 frustumPlanes[6];
         mat4x4 viewmat;
         u32 occlusionEnabled;
+        u32 numInstances;
     };
 
     struct CellInstance
@@ -89,7 +100,7 @@ public:
 
     bool LoadMap(const NDBC::Map* map);
 
-    const SafeVector<Geometry::AABoundingBox>& GetBoundingBoxes() { return _cellBoundingBoxes; }
+    const std::vector<Geometry::AABoundingBox>& GetBoundingBoxes() { return _cellBoundingBoxes; }
     MapObjectRenderer* GetMapObjectRenderer() { return _mapObjectRenderer; }
 
     // Drawcall stats
@@ -99,6 +110,15 @@ public:
     // Triangle stats
     u32 GetNumTriangles() { return Terrain::MAP_CELLS_PER_CHUNK * static_cast<u32>(_loadedChunks.Size()) * Terrain::NUM_TRIANGLES_PER_CELL; }
     u32 GetNumSurvivingTriangles() { return _numSurvivingDrawCalls * Terrain::NUM_TRIANGLES_PER_CELL; }
+
+    // Streaming stats
+    u32 GetNumResidentChunks() { return static_cast<u32>(_loadedChunks.Size()); }
+    u32 GetNumChunkSlots() { return static_cast<u32>(_chunkSlots.size()); }
+    u32 GetNumChunksPendingLoad() { return _numChunksPendingLoad; }
+    u32 GetNumResidentColorTextures() { return _numResidentColorTextures; }
+
+    // Time in seconds the last LoadMap call took, from reading the map index until the resident chunks were queued for upload
+    f32 GetLastMapLoadTime() { return _lastMapLoadTime; }
 private:
     void CreatePermanentResources();
 
@@ -106,12 +126,19 @@ private:
     void RegisterChunkToBeLoaded(Terrain::Map& map, u16 chunkPosX, u16 chunkPosY);
     void ExecuteLoad();
 
-    void LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded);
+    void CreateChunkBuffers(u32 numChunkSlots);
+    void UpdateStreaming(const Camera* camera, u32 maxChunksToLoad);
+    void UnloadChunks(const std::vector<u16>& chunkIDs);
+    void UploadInstances();
+
+    void LoadChunk(const ChunkToBeLoaded& chunkToBeLoaded, const Terrain::Chunk& chunk, StringTable& stringTable);
     //void LoadChunksAround(Terrain::Map& map, ivec2 middleChunk, u16 drawDistance);
     void CPUCulling(const Camera* camera);
 
     void DebugRenderCellTriangles(const Camera* camera);
 private:
+    static constexpr u32 CHUNK_SLOT_RETIRE_FRAMES = 3; // As long as the renderer keeps resources on its destroy lists
+
     Renderer::Renderer* _renderer; 
     
     CullingConstants _cullingConstants;
@@ -142,13 +169,25 @@ private:
     Renderer::DescriptorSet _cullingPassDescriptorSet;
 
     SafeVector<u16> _loadedChunks;
-    SafeVector<Geometry::AABoundingBox> _cellBoundingBoxes;
+    std::vector<Geometry::AABoundingBox> _cellBoundingBoxes; // Indexed by chunkSlot * MAP_CELLS_PER_CHUNK + cellID, presized so loads can write their own range without locking
+
+    std::vector<ChunkSlot> _chunkSlots;
+    std::vector<u32> _freeChunkSlots;
+    // Slots of unloaded chunks wait here until every frame that could still read them has retired, loads would otherwise overwrite them mid-frame
+    std::array<std::vector<u32>, CHUNK_SLOT_RETIRE_FRAMES> _retiringChunkSlots;
+    u32 _retiringChunkSlotsIndex = 0;
+    robin_hood::unordered_map<u16, u32> _chunkIDToSlot;
+    std::vector<u16> _colorTextureRefCounts;
+
+    i32 _streamingRadius = -1;
+    ivec2 _streamingCenterChunk = ivec2(-1, -1);
+    u32 _numChunksPendingLoad = 0;
+    u32 _numResidentColorTextures = 0;
+    f32 _lastMapLoadTime = 0.0f;
 
     std::vector<CellInstance> _culledInstances;
     std::vector<ChunkToBeLoaded> _chunksToBeLoaded;
 
-    std::mutex _subLoadMutex;
-
     u32 _numSurvivingDrawCalls;
     
     // Subrenderers
@@ -9,7 +9,7 @@
 #include <Renderer/Descriptors/FontDesc.h>
 #include <Renderer/Descriptors/TextureDesc.h>
 #include <Renderer/Descriptors/SamplerDesc.h>
-#include <Renderer/Buffer.h>
+#include <Renderer/Font.h>
 #include <Window/Window.h>
 #include <tracy/Tracy.hpp>
 #include <tracy/TracyVulkan.hpp>
@@ -17,6 +17,7 @@
 #include "../Utils/ServiceLocator.h"
 
 #include "../UI/ECS/Components/Singletons/UIDataSingleton.h"
+#include "../UI/ECS/Components/Singletons/UIHierarchySingleton.h"
 #include "../UI/ECS/Components/ElementInfo.h"
 #include "../UI/ECS/Components/Relation.h"
 #include "../UI/ECS/Components/Root.h"
@@ -38,6 +39,7 @@
 #include "../UI/ECS/Components/Dirty.h"
 #include "../UI/ECS/Components/BoundsDirty.h"
 #include "../UI/ECS/Components/SortKeyDirty.h"
+#include "../UI/ECS/Components/LayoutDirty.h"
 
 #include "../UI/ECS/Components/InputField.h"
 #include "../UI/ECS/Components/Checkbox.h"
@@ -55,6 +57,9 @@ UIRenderer::UIRenderer(Renderer::Renderer* renderer, DebugRenderer* debugRendere
 
     // Register UI singletons.
     UISingleton::UIDataSingleton& dataSingleton = registry->set<UISingleton::UIDataSingleton>();
+    dataSingleton.imageTextureArray = _imageTextures;
+    dataSingleton.emptyBorderIndex = _emptyBorderIndex;
+    registry->set<UISingleton::UIHierarchySingleton>();
 
     // Set up UI resolution. TODO Update when window size updates.
     i32 width, height;
@@ -87,6 +92,7 @@ UIRenderer::UIRenderer(Renderer::Renderer* renderer, DebugRenderer* debugRendere
     registry->reserve<UIComponent::Dirty>(ENTITIES_TO_PREALLOCATE);
     registry->reserve<UIComponent::BoundsDirty>(ENTITIES_TO_PREALLOCATE);
     registry->reserve<UIComponent::SortKeyDirty>(ENTITIES_TO_PREALLOCATE);
+    registry->reserve<UIComponent::LayoutDirty>(ENTITIES_TO_PREALLOCATE);
 
     registry->reserve<UIComponent::InputField>(ENTITIES_TO_PREALLOCATE);
     registry->reserve<UIComponent::Checkbox>(ENTITIES_TO_PREALLOCATE);
@@ -122,6 +128,9 @@ void UIRenderer::Update(f32 deltaTime)
 
 void UIRenderer::AddUIPass(Renderer::RenderGraph* renderGraph, RenderResources& resources, u8 frameIndex)
 {
+    // Glyphs that finished rasterising since last frame
+    Renderer::Font::UploadAtlas();
+
     // UI Pass
     struct UIPassData
     {
@@ -159,7 +168,7 @@ void UIRenderer::AddUIPass(Renderer::RenderGraph* renderGraph, RenderResources&
 
             // Panel Shaders
             Renderer::VertexShaderDesc vertexShaderDesc;
-            vertexShaderDesc.path = "UI/panel.vs.hlsl";
+            vertexShaderDesc.path = "UI/ui.vs.hlsl";
             pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
 
             Renderer::PixelShaderDesc pixelShaderDesc;
@@ -168,105 +177,62 @@ void UIRenderer::AddUIPass(Renderer::RenderGraph* renderGraph, RenderResources&
 
             Renderer::GraphicsPipelineID imagePipeline = _renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
 
-            // Text Shaders
-            vertexShaderDesc.path = "UI/text.vs.hlsl";
-            pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
-
+            // Text Shaders, the vertex shader is shared
             pixelShaderDesc.path = "UI/text.ps.hlsl";
             pipelineDesc.states.pixelShader = _renderer->LoadShader(pixelShaderDesc);
 
             Renderer::GraphicsPipelineID textPipeline = _renderer->CreatePipeline(pipelineDesc); // This will compile the pipeline and return the ID, or just return ID of cached pipeline
 
-            // Set pipeline
-            commandList.BeginPipeline(imagePipeline);
-            Renderer::GraphicsPipelineID activePipeline = imagePipeline;
-
-            commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
-
-            entt::registry* registry = ServiceLocator::GetUIRegistry();
-            auto renderGroup = registry->group<UIComponent::SortKey>(entt::get<UIComponent::Renderable, UIComponent::Visible, UIComponent::NotCulled>);
-            renderGroup.sort<UIComponent::SortKey>([](UIComponent::SortKey& first, UIComponent::SortKey& second) { return first.key < second.key; });
-            renderGroup.each([this, &commandList, frameIndex, &registry, &activePipeline, &textPipeline, &imagePipeline](const auto entity, UIComponent::SortKey& sortKey, UIComponent::Renderable& renderable)
-            {
-                switch (renderable.renderType)
-                {
-                case UI::RenderType::Text:
-                    {
-                        UIComponent::Text& text = registry->get<UIComponent::Text>(entity);
-                        if (!text.constantBuffer || text.vertexBufferID == Renderer::BufferID::Invalid())
-                            break;
-
-                        if (activePipeline != textPipeline)
-                        {
-                            commandList.EndPipeline(activePipeline);
-                            commandList.BeginPipeline(textPipeline);
-                            commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
-                            activePipeline = textPipeline;
-                        }
-
-                        commandList.PushMarker("Text", Color(0.0f, 0.1f, 0.0f));
+            BuildBatches();
+            if (_batches.size() == 0)
+                return;
 
-                        // Bind descriptors
-                        _drawTextDescriptorSet.Bind("_vertexData"_h, text.vertexBufferID);
-                        _drawTextDescriptorSet.Bind("_textData"_h, text.constantBuffer->GetBuffer(frameIndex));
-                        _drawTextDescriptorSet.Bind("_textureIDs"_h, text.textureIDBufferID);
-                        _drawTextDescriptorSet.Bind("_textures"_h, text.font->GetTextureArray());
+            // Everything the batches read lives in this frame's constant ring
+            Renderer::ConstantSlice vertices = _renderer->AllocateConstants(_batchVertices.size() * sizeof(UI::UIVertex));
+            memcpy(vertices.mappedMemory, _batchVertices.data(), vertices.size);
+            _passDescriptorSet.Bind("_vertices"_h, vertices);
 
-                        commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_DRAW, &_drawTextDescriptorSet, frameIndex);
+            Renderer::ConstantSlice instances = _renderer->AllocateConstants(_batchInstances.size() * sizeof(UIInstance));
+            memcpy(instances.mappedMemory, _batchInstances.data(), instances.size);
+            _passDescriptorSet.Bind("_instances"_h, instances);
 
-                        commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
-
-                        commandList.DrawIndexed(6, static_cast<u32>(text.glyphCount), 0, 0, 0);
+            if (_batchPanelData.size() > 0)
+            {
+                Renderer::ConstantSlice panelData = _renderer->AllocateConstants(_batchPanelData.size() * sizeof(UIComponent::Image::ImageConstantBuffer));
+                memcpy(panelData.mappedMemory, _batchPanelData.data(), panelData.size);
+                _passDescriptorSet.Bind("_panelData"_h, panelData);
+            }
 
-                        commandList.PopMarker();
-                        break;
-                    }
-                case UI::RenderType::Image:
+            if (_batchTextData.size() > 0)
+            {
+                Renderer::ConstantSlice textData = _renderer->AllocateConstants(_batchTextData.size() * sizeof(UIComponent::Text::TextConstantBuffer));
+                memcpy(textData.mappedMemory, _batchTextData.data(), textData.size);
+                _passDescriptorSet.Bind("_textData"_h, textData);
+                _passDescriptorSet.Bind("_fontTextures"_h, Renderer::Font::GetTextureArray());
+            }
+
+            Renderer::GraphicsPipelineID activePipeline = Renderer::GraphicsPipelineID::Invalid();
+            for (const UIBatch& batch : _batches)
+            {
+                Renderer::GraphicsPipelineID pipeline = (batch.renderType == UI::RenderType::Text) ? textPipeline : imagePipeline;
+                if (pipeline != activePipeline)
+                {
+                    if (activePipeline != Renderer::GraphicsPipelineID::Invalid())
                     {
-                        UIComponent::Image& image = registry->get<UIComponent::Image>(entity);
-                        if (!image.constantBuffer)
-                            return;
-
-                        if (activePipeline != imagePipeline)
-                        {
-                            commandList.EndPipeline(activePipeline);
-                            commandList.BeginPipeline(imagePipeline);
-                            commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
-                            activePipeline = imagePipeline;
-                        }
-
-                        commandList.PushMarker("Image", Color(0.0f, 0.1f, 0.0f));
-
-                        // Bind descriptors
-                        _drawImageDescriptorSet.Bind("_vertices"_h, image.vertexBufferID);
-                        _drawImageDescriptorSet.Bind("_panelData"_h, image.constantBuffer->GetBuffer(frameIndex));
-                        _drawImageDescriptorSet.Bind("_texture"_h, image.textureID);
-
-                        if (image.borderID != Renderer::TextureID::Invalid())
-                        {
-                            _drawImageDescriptorSet.Bind("_border"_h, image.borderID);
-                        }
-                        else
-                        {
-                            _drawImageDescriptorSet.Bind("_border"_h, _emptyBorder);
-                        }
-
-                        commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_DRAW, &_drawImageDescriptorSet, frameIndex);
-
-                        commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
-
-                        commandList.DrawIndexed(6, 1, 0, 0, 0);
-
-                        commandList.PopMarker();
-                        break;
+                        commandList.EndPipeline(activePipeline);
                     }
-                default:
-                    DebugHandler::PrintFatal("Renderable widget tried to render with invalid render type.");
+
+                    commandList.BeginPipeline(pipeline);
+                    commandList.BindDescriptorSet(Renderer::DescriptorSetSlot::PER_PASS, &_passDescriptorSet, frameIndex);
+                    commandList.SetIndexBuffer(_indexBuffer, Renderer::IndexFormat::UInt16);
+                    activePipeline = pipeline;
                 }
-            });
+
+                commandList.DrawIndexed(6, batch.numQuads, 0, 0, batch.firstQuad);
+            }
 
             commandList.EndPipeline(activePipeline);
-        });
+        }, this);
 }
 
 void UIRenderer::AddImguiPass(Renderer::RenderGraph* renderGraph, RenderResources& resources, u8 frameIndex)
@@ -307,7 +273,7 @@ void UIRenderer::AddImguiPass(Renderer::RenderGraph* renderGraph, RenderResource
 
             // Panel Shaders
             Renderer::VertexShaderDesc vertexShaderDesc;
-            vertexShaderDesc.path = "UI/panel.vs.hlsl";
+            vertexShaderDesc.path = "UI/ui.vs.hlsl";
             pipelineDesc.states.vertexShader = _renderer->LoadShader(vertexShaderDesc);
 
             Renderer::PixelShaderDesc pixelShaderDesc;
@@ -319,7 +285,72 @@ void UIRenderer::AddImguiPass(Renderer::RenderGraph* renderGraph, RenderResource
             commandList.BeginPipeline(activePipeline);
             commandList.DrawImgui();
             commandList.EndPipeline(activePipeline);
-        });
+        }, this);
+}
+
+void UIRenderer::BuildBatches()
+{
+    ZoneScoped;
+
+    _batchVertices.clear();
+    _batchInstances.clear();
+    _batchPanelData.clear();
+    _batchTextData.clear();
+    _batches.clear();
+
+    entt::registry* registry = ServiceLocator::GetUIRegistry();
+    auto renderGroup = registry->group<UIComponent::SortKey>(entt::get<UIComponent::Renderable, UIComponent::Visible, UIComponent::NotCulled>);
+    renderGroup.sort<UIComponent::SortKey>([](UIComponent::SortKey& first, UIComponent::SortKey& second) { return first.key < second.key; });
+    renderGroup.each([this, &registry](const auto entity, UIComponent::SortKey& sortKey, UIComponent::Renderable& renderable)
+    {
+        u32 firstQuad = static_cast<u32>(_batchInstances.size());
+
+        switch (renderable.renderType)
+        {
+        case UI::RenderType::Text:
+            {
+                UIComponent::Text& text = registry->get<UIComponent::Text>(entity);
+                if (text.glyphCount == 0)
+                    return;
+
+                u32 dataIndex = static_cast<u32>(_batchTextData.size());
+                _batchTextData.push_back(text.constants);
+
+                _batchVertices.insert(_batchVertices.end(), text.vertices.begin(), text.vertices.end());
+                for (u32 textureIndex : text.glyphTextureIndices)
+                {
+                    _batchInstances.push_back({ dataIndex, textureIndex });
+                }
+                break;
+            }
+        case UI::RenderType::Image:
+            {
+                UIComponent::Image& image = registry->get<UIComponent::Image>(entity);
+                if (image.textureID == Renderer::TextureID::Invalid())
+                    return;
+
+                u32 dataIndex = static_cast<u32>(_batchPanelData.size());
+                _batchPanelData.push_back(image.constants);
+
+                _batchVertices.insert(_batchVertices.end(), std::begin(image.vertices), std::end(image.vertices));
+                _batchInstances.push_back({ dataIndex, image.textureIndex });
+                break;
+            }
+        default:
+            DebugHandler::PrintFatal("Renderable widget tried to render with invalid render type.");
+        }
+
+        // Only a change of pipeline splits the batch, draw order is kept since batches are drawn in sort order
+        u32 numQuads = static_cast<u32>(_batchInstances.size()) - firstQuad;
+        if (_batches.size() > 0 && _batches.back().renderType == renderable.renderType)
+        {
+            _batches.back().numQuads += numQuads;
+        }
+        else
+        {
+            _batches.push_back({ renderable.renderType, firstQuad, numQuads });
+        }
+    });
 }
 
 void UIRenderer::CreatePermanentResources()
@@ -336,6 +367,13 @@ void UIRenderer::CreatePermanentResources()
     _linearSampler = _renderer->CreateSampler(samplerDesc);
     _passDescriptorSet.Bind("_sampler"_h, _linearSampler);
 
+    // Image textures
+    Renderer::TextureArrayDesc textureArrayDesc;
+    textureArrayDesc.size = 4096;
+
+    _imageTextures = _renderer->CreateTextureArray(textureArrayDesc);
+    _passDescriptorSet.Bind("_textures"_h, _imageTextures);
+
     // Index buffer
     static const u32 indexBufferSize = sizeof(u16) * 6;
 
@@ -375,5 +413,5 @@ void UIRenderer::CreatePermanentResources()
     emptyBorderDesc.format = Renderer::ImageFormat::R8G8B8A8_UNORM;
     emptyBorderDesc.data = new u8[4]{ 0, 0, 0, 0 };
     
-    _emptyBorder = _renderer->CreateDataTexture(emptyBorderDesc);
+    _emptyBorder = _renderer->CreateDataTextureIntoArray(emptyBorderDesc, _imageTextures, _emptyBorderIndex);
 }
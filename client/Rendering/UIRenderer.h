@@ -4,6 +4,10 @@
 #include <Renderer/Descriptors/ImageDesc.h>
 #include <Renderer/DescriptorSet.h>
 
+#include "../UI/ECS/Components/Renderable.h"
+#include "../UI/ECS/Components/Image.h"
+#include "../UI/ECS/Components/Text.h"
+
 namespace Renderer
 {
     class RenderGraph;
@@ -26,19 +30,39 @@ public:
     void AddImguiPass(Renderer::RenderGraph* renderGraph, RenderResources& resources, u8 frameIndex);
 
 private:
+    // Every visible quad goes into one vertex and instance stream, a batch is a run of elements that share a pipeline
+    struct UIInstance
+    {
+        u32 dataIndex;
+        u32 textureIndex;
+    };
+
+    struct UIBatch
+    {
+        UI::RenderType renderType;
+        u32 firstQuad;
+        u32 numQuads;
+    };
+
     void CreatePermanentResources();
+    void BuildBatches();
 
 private:
     Renderer::Renderer* _renderer;
     DebugRenderer* _debugRenderer;
 
+    Renderer::TextureArrayID _imageTextures;
     Renderer::TextureID _emptyBorder;
+    u32 _emptyBorderIndex = 0;
 
     Renderer::SamplerID _linearSampler;
     Renderer::BufferID _indexBuffer;
 
     Renderer::DescriptorSet _passDescriptorSet;
-    Renderer::DescriptorSet _drawImageDescriptorSet;
-    Renderer::DescriptorSet _drawTextDescriptorSet;
 
+    std::vector<UI::UIVertex> _batchVertices;
+    std::vector<UIInstance> _batchInstances;
+    std::vector<UIComponent::Image::ImageConstantBuffer> _batchPanelData;
+    std::vector<UIComponent::Text::TextConstantBuffer> _batchTextData;
+    std::vector<UIBatch> _batches;
 };
\ No newline at end of file
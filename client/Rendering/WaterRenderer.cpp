@@ -72,8 +72,8 @@ void WaterRenderer::AddWaterPass(Renderer::RenderGraph* renderGraph, RenderResou
     renderGraph->AddPass<WaterPassData>("Water Pass", 
         [=](WaterPassData& data, Renderer::RenderGraphBuilder& builder)
         {
-            data.color = builder.Write(resources.color, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
-            data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::CLEAR);
+            data.color = builder.Write(resources.color, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
+            data.depth = builder.Write(resources.depth, Renderer::RenderGraphBuilder::WriteMode::RENDERTARGET, Renderer::RenderGraphBuilder::LoadMode::LOAD);
 
             return true; // Return true from setup to enable this pass, return false to disable it
         }, 
@@ -182,7 +182,11 @@ bool WaterRenderer::RegisterChunksToBeLoaded(const std::vector<u16>& chunkIDs)
 
     for (const u16& chunkID : chunkIDs)
     {
-        Terrain::Chunk& chunk = currentMap.chunks[chunkID];
+        Terrain::Chunk* chunkPtr = currentMap.GetChunkById(chunkID);
+        if (chunkPtr == nullptr)
+            continue;
+
+        Terrain::Chunk& chunk = *chunkPtr;
 
         u16 chunkX = chunkID % Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
         u16 chunkY = chunkID / Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
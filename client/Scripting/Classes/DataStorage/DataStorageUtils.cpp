@@ -15,57 +15,90 @@ namespace ASDataStorageUtils
         r = ScriptEngine::SetNamespace("DataStorage");
         assert(r >= 0);
         {
-            ScriptEngine::RegisterScriptFunction("bool PutU8(string name, uint8 val)", asFUNCTION(PutU8));
-            ScriptEngine::RegisterScriptFunction("void EmplaceU8(string name, uint8 val)", asFUNCTION(EmplaceU8));
-            ScriptEngine::RegisterScriptFunction("bool GetU8(string name, uint8 &out val)", asFUNCTION(GetU8));
-            ScriptEngine::RegisterScriptFunction("bool ClearU8(string name)", asFUNCTION(ClearU8));
-
-            ScriptEngine::RegisterScriptFunction("bool PutU16(string name, uint16 val)", asFUNCTION(PutU16));
-            ScriptEngine::RegisterScriptFunction("void EmplaceU16(string name, uint16 val)", asFUNCTION(EmplaceU16));
-            ScriptEngine::RegisterScriptFunction("bool GetU16(string name, uint16 &out val)", asFUNCTION(GetU16));
-            ScriptEngine::RegisterScriptFunction("bool ClearU16(string name)", asFUNCTION(ClearU16));
-
-            ScriptEngine::RegisterScriptFunction("bool PutU32(string name, uint val)", asFUNCTION(PutU32));
-            ScriptEngine::RegisterScriptFunction("void EmplaceU32(string name, uint val)", asFUNCTION(EmplaceU32));
-            ScriptEngine::RegisterScriptFunction("bool GetU32(string name, uint &out val)", asFUNCTION(GetU32));
-            ScriptEngine::RegisterScriptFunction("bool ClearU32(string name)", asFUNCTION(ClearU32));
-
-            ScriptEngine::RegisterScriptFunction("bool PutU64(string name, uint64 val)", asFUNCTION(PutU64));
-            ScriptEngine::RegisterScriptFunction("void EmplaceU64(string name, uint64 val)", asFUNCTION(EmplaceU64));
-            ScriptEngine::RegisterScriptFunction("bool GetU64(string name, uint64 &out val)", asFUNCTION(GetU64));
-            ScriptEngine::RegisterScriptFunction("bool ClearU64(string name)", asFUNCTION(ClearU64));
-
-            ScriptEngine::RegisterScriptFunction("bool PutF32(string name, float val)", asFUNCTION(PutF32));
-            ScriptEngine::RegisterScriptFunction("void EmplaceF32(string name, float val)", asFUNCTION(EmplaceF32));
-            ScriptEngine::RegisterScriptFunction("bool GetF32(string name, float &out val)", asFUNCTION(GetF32));
-            ScriptEngine::RegisterScriptFunction("bool ClearF32(string name)", asFUNCTION(ClearF32));
-
-            ScriptEngine::RegisterScriptFunction("bool PutF64(string name, double val)", asFUNCTION(PutF64));
-            ScriptEngine::RegisterScriptFunction("void EmplaceF64(string name, double val)", asFUNCTION(EmplaceF64));
-            ScriptEngine::RegisterScriptFunction("bool GetF64(string name, double &out val)", asFUNCTION(GetF64));
-            ScriptEngine::RegisterScriptFunction("bool ClearF64(string name)", asFUNCTION(ClearF64));
-
-            ScriptEngine::RegisterScriptFunction("bool PutString(string name, string val)", asFUNCTION(PutString));
-            ScriptEngine::RegisterScriptFunction("void EmplaceString(string name, string val)", asFUNCTION(EmplaceString));
-            ScriptEngine::RegisterScriptFunction("bool GetString(string name, string &out val)", asFUNCTION(GetString));
-            ScriptEngine::RegisterScriptFunction("bool ClearString(string name)", asFUNCTION(ClearString));
-
-            ScriptEngine::RegisterScriptFunction("bool PutPointer(string name, void_ptr val)", asFUNCTION(PutPointer));
-            ScriptEngine::RegisterScriptFunction("void EmplacePointer(string name, void_ptr val)", asFUNCTION(EmplacePointer));
-            ScriptEngine::RegisterScriptFunction("bool GetPointer(string name, void_ptr &out val)", asFUNCTION(GetPointer));
-            ScriptEngine::RegisterScriptFunction("bool ClearPointer(string name)", asFUNCTION(ClearPointer));
-
-            ScriptEngine::RegisterScriptFunction("bool PutEntity(string name, Entity val)", asFUNCTION(PutEntity));
-            ScriptEngine::RegisterScriptFunction("void EmplaceEntity(string name, Entity val)", asFUNCTION(EmplaceEntity));
-            ScriptEngine::RegisterScriptFunction("bool GetEntity(string name, Entity &out val)", asFUNCTION(GetEntity));
-            ScriptEngine::RegisterScriptFunction("bool ClearEntity(string name)", asFUNCTION(ClearEntity));
+            // Meant for global initializers, e.g. const uint KEY = DataStorage::HashKey("Key"); so per frame lookups skip hashing
+            ScriptEngine::RegisterScriptFunction("uint HashKey(const string &in name)", asFUNCTION(HashKey));
+
+            ScriptEngine::RegisterScriptFunction("bool PutU8(const string &in name, uint8 val)", asFUNCTION(PutU8));
+            ScriptEngine::RegisterScriptFunction("void EmplaceU8(const string &in name, uint8 val)", asFUNCTION(EmplaceU8));
+            ScriptEngine::RegisterScriptFunction("bool GetU8(const string &in name, uint8 &out val)", asFUNCTION(GetU8));
+            ScriptEngine::RegisterScriptFunction("bool ClearU8(const string &in name)", asFUNCTION(ClearU8));
+
+            ScriptEngine::RegisterScriptFunction("bool PutU16(const string &in name, uint16 val)", asFUNCTION(PutU16));
+            ScriptEngine::RegisterScriptFunction("void EmplaceU16(const string &in name, uint16 val)", asFUNCTION(EmplaceU16));
+            ScriptEngine::RegisterScriptFunction("bool GetU16(const string &in name, uint16 &out val)", asFUNCTION(GetU16));
+            ScriptEngine::RegisterScriptFunction("bool ClearU16(const string &in name)", asFUNCTION(ClearU16));
+
+            ScriptEngine::RegisterScriptFunction("bool PutI32(const string &in name, int val)", asFUNCTION(PutI32));
+            ScriptEngine::RegisterScriptFunction("void EmplaceI32(const string &in name, int val)", asFUNCTION(EmplaceI32));
+            ScriptEngine::RegisterScriptFunction("bool GetI32(const string &in name, int &out val)", asFUNCTION(GetI32));
+            ScriptEngine::RegisterScriptFunction("bool ClearI32(const string &in name)", asFUNCTION(ClearI32));
+            ScriptEngine::RegisterScriptFunction("bool PutI32(uint key, int val)", asFUNCTION(PutI32ByKey));
+            ScriptEngine::RegisterScriptFunction("void EmplaceI32(uint key, int val)", asFUNCTION(EmplaceI32ByKey));
+            ScriptEngine::RegisterScriptFunction("bool GetI32(uint key, int &out val)", asFUNCTION(GetI32ByKey));
+            ScriptEngine::RegisterScriptFunction("bool ClearI32(uint key)", asFUNCTION(ClearI32ByKey));
+
+            ScriptEngine::RegisterScriptFunction("bool PutU32(const string &in name, uint val)", asFUNCTION(PutU32));
+            ScriptEngine::RegisterScriptFunction("void EmplaceU32(const string &in name, uint val)", asFUNCTION(EmplaceU32));
+            ScriptEngine::RegisterScriptFunction("bool GetU32(const string &in name, uint &out val)", asFUNCTION(GetU32));
+            ScriptEngine::RegisterScriptFunction("bool ClearU32(const string &in name)", asFUNCTION(ClearU32));
+            ScriptEngine::RegisterScriptFunction("bool PutU32(uint key, uint val)", asFUNCTION(PutU32ByKey));
+            ScriptEngine::RegisterScriptFunction("void EmplaceU32(uint key, uint val)", asFUNCTION(EmplaceU32ByKey));
+            ScriptEngine::RegisterScriptFunction("bool GetU32(uint key, uint &out val)", asFUNCTION(GetU32ByKey));
+            ScriptEngine::RegisterScriptFunction("bool ClearU32(uint key)", asFUNCTION(ClearU32ByKey));
+
+            ScriptEngine::RegisterScriptFunction("bool PutU64(const string &in name, uint64 val)", asFUNCTION(PutU64));
+            ScriptEngine::RegisterScriptFunction("void EmplaceU64(const string &in name, uint64 val)", asFUNCTION(EmplaceU64));
+            ScriptEngine::RegisterScriptFunction("bool GetU64(const string &in name, uint64 &out val)", asFUNCTION(GetU64));
+            ScriptEngine::RegisterScriptFunction("bool ClearU64(const string &in name)", asFUNCTION(ClearU64));
+
+            ScriptEngine::RegisterScriptFunction("bool PutF32(const string &in name, float val)", asFUNCTION(PutF32));
+            ScriptEngine::RegisterScriptFunction("void EmplaceF32(const string &in name, float val)", asFUNCTION(EmplaceF32));
+            ScriptEngine::RegisterScriptFunction("bool GetF32(const string &in name, float &out val)", asFUNCTION(GetF32));
+            ScriptEngine::RegisterScriptFunction("bool ClearF32(const string &in name)", asFUNCTION(ClearF32));
+            ScriptEngine::RegisterScriptFunction("bool PutF32(uint key, float val)", asFUNCTION(PutF32ByKey));
+            ScriptEngine::RegisterScriptFunction("void EmplaceF32(uint key, float val)", asFUNCTION(EmplaceF32ByKey));
+            ScriptEngine::RegisterScriptFunction("bool GetF32(uint key, float &out val)", asFUNCTION(GetF32ByKey));
+            ScriptEngine::RegisterScriptFunction("bool ClearF32(uint key)", asFUNCTION(ClearF32ByKey));
+
+            ScriptEngine::RegisterScriptFunction("bool PutF64(const string &in name, double val)", asFUNCTION(PutF64));
+            ScriptEngine::RegisterScriptFunction("void EmplaceF64(const string &in name, double val)", asFUNCTION(EmplaceF64));
+            ScriptEngine::RegisterScriptFunction("bool GetF64(const string &in name, double &out val)", asFUNCTION(GetF64));
+            ScriptEngine::RegisterScriptFunction("bool ClearF64(const string &in name)", asFUNCTION(ClearF64));
+
+            ScriptEngine::RegisterScriptFunction("bool PutString(const string &in name, const string &in val)", asFUNCTION(PutString));
+            ScriptEngine::RegisterScriptFunction("void EmplaceString(const string &in name, const string &in val)", asFUNCTION(EmplaceString));
+            ScriptEngine::RegisterScriptFunction("bool GetString(const string &in name, string &out val)", asFUNCTION(GetString));
+            ScriptEngine::RegisterScriptFunction("bool ClearString(const string &in name)", asFUNCTION(ClearString));
+            ScriptEngine::RegisterScriptFunction("bool PutString(uint key, const string &in val)", asFUNCTION(PutStringByKey));
+            ScriptEngine::RegisterScriptFunction("void EmplaceString(uint key, const string &in val)", asFUNCTION(EmplaceStringByKey));
+            ScriptEngine::RegisterScriptFunction("bool GetString(uint key, string &out val)", asFUNCTION(GetStringByKey));
+            ScriptEngine::RegisterScriptFunction("bool ClearString(uint key)", asFUNCTION(ClearStringByKey));
+
+            ScriptEngine::RegisterScriptFunction("bool PutPointer(const string &in name, void_ptr val)", asFUNCTION(PutPointer));
+            ScriptEngine::RegisterScriptFunction("void EmplacePointer(const string &in name, void_ptr val)", asFUNCTION(EmplacePointer));
+            ScriptEngine::RegisterScriptFunction("bool GetPointer(const string &in name, void_ptr &out val)", asFUNCTION(GetPointer));
+            ScriptEngine::RegisterScriptFunction("bool ClearPointer(const string &in name)", asFUNCTION(ClearPointer));
+
+            ScriptEngine::RegisterScriptFunction("bool PutEntity(const string &in name, Entity val)", asFUNCTION(PutEntity));
+            ScriptEngine::RegisterScriptFunction("void EmplaceEntity(const string &in name, Entity val)", asFUNCTION(EmplaceEntity));
+            ScriptEngine::RegisterScriptFunction("bool GetEntity(const string &in name, Entity &out val)", asFUNCTION(GetEntity));
+            ScriptEngine::RegisterScriptFunction("bool ClearEntity(const string &in name)", asFUNCTION(ClearEntity));
+            ScriptEngine::RegisterScriptFunction("bool PutEntity(uint key, Entity val)", asFUNCTION(PutEntityByKey));
+            ScriptEngine::RegisterScriptFunction("void EmplaceEntity(uint key, Entity val)", asFUNCTION(EmplaceEntityByKey));
+            ScriptEngine::RegisterScriptFunction("bool GetEntity(uint key, Entity &out val)", asFUNCTION(GetEntityByKey));
+            ScriptEngine::RegisterScriptFunction("bool ClearEntity(uint key)", asFUNCTION(ClearEntityByKey));
         }
 
         r = ScriptEngine::ResetNamespace();
         assert(r >= 0);
     }
 
-    bool PutU8(std::string name, u8 val)
+    u32 HashKey(const std::string& name)
+    {
+        return StringUtils::fnv1a_32(name.c_str(), name.length());
+    }
+
+    bool PutU8(const std::string& name, u8 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -73,7 +106,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.PutU8(nameHash, val);
     }
-    void EmplaceU8(std::string name, u8 val)
+    void EmplaceU8(const std::string& name, u8 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -81,7 +114,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         dataStorageSingleton.storage.EmplaceU8(nameHash, val);
     }
-    bool GetU8(std::string name, u8& val)
+    bool GetU8(const std::string& name, u8& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -89,7 +122,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.GetU8(nameHash, val);
     }
-    bool HasU8(std::string name)
+    bool HasU8(const std::string& name)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -97,7 +130,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.HasU8(nameHash);
     }
-    bool ClearU8(std::string name)
+    bool ClearU8(const std::string& name)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -106,7 +139,7 @@ namespace ASDataStorageUtils
         return dataStorageSingleton.storage.ClearU8(nameHash);
     }
 
-    bool PutU16(std::string name, u16 val)
+    bool PutU16(const std::string& name, u16 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -114,7 +147,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.PutU16(nameHash, val);
     }
-    void EmplaceU16(std::string name, u16 val)
+    void EmplaceU16(const std::string& name, u16 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -122,7 +155,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         dataStorageSingleton.storage.EmplaceU16(nameHash, val);
     }
-    bool GetU16(std::string name, u16& val)
+    bool GetU16(const std::string& name, u16& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -130,7 +163,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.GetU16(nameHash, val);
     }
-    bool HasU16(std::string name)
+    bool HasU16(const std::string& name)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -138,7 +171,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.HasU16(nameHash);
     }
-    bool ClearU16(std::string name)
+    bool ClearU16(const std::string& name)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -147,48 +180,129 @@ namespace ASDataStorageUtils
         return dataStorageSingleton.storage.ClearU16(nameHash);
     }
 
-    bool PutU32(std::string name, u32 val)
+    bool PutI32(const std::string& name, i32 val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return PutI32ByKey(nameHash, val);
+    }
+    void EmplaceI32(const std::string& name, i32 val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        EmplaceI32ByKey(nameHash, val);
+    }
+    bool GetI32(const std::string& name, i32& val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return GetI32ByKey(nameHash, val);
+    }
+    bool HasI32(const std::string& name)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return HasI32ByKey(nameHash);
+    }
+    bool ClearI32(const std::string& name)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return ClearI32ByKey(nameHash);
+    }
+    bool PutI32ByKey(u32 key, i32 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.PutU32(nameHash, val);
+        return dataStorageSingleton.i32Slots.Put(key, val);
     }
-    void EmplaceU32(std::string name, u32 val)
+    void EmplaceI32ByKey(u32 key, i32 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        dataStorageSingleton.storage.EmplaceU32(nameHash, val);
+        dataStorageSingleton.i32Slots.Emplace(key, val);
     }
-    bool GetU32(std::string name, u32& val)
+    bool GetI32ByKey(u32 key, i32& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.GetU32(nameHash, val);
+        return dataStorageSingleton.i32Slots.Get(key, val);
     }
-    bool HasU32(std::string name)
+    bool HasI32ByKey(u32 key)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.HasU32(nameHash);
+        return dataStorageSingleton.i32Slots.Has(key);
     }
-    bool ClearU32(std::string name)
+    bool ClearI32ByKey(u32 key)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
+        return dataStorageSingleton.i32Slots.Clear(key);
+    }
+
+    bool PutU32(const std::string& name, u32 val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return PutU32ByKey(nameHash, val);
+    }
+    void EmplaceU32(const std::string& name, u32 val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        EmplaceU32ByKey(nameHash, val);
+    }
+    bool GetU32(const std::string& name, u32& val)
+    {
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.ClearU32(nameHash);
+        return GetU32ByKey(nameHash, val);
+    }
+    bool HasU32(const std::string& name)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return HasU32ByKey(nameHash);
+    }
+    bool ClearU32(const std::string& name)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return ClearU32ByKey(nameHash);
+    }
+    bool PutU32ByKey(u32 key, u32 val)
+    {
+        entt::registry* registry = ServiceLocator::GetGameRegistry();
+        DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
+
+        return dataStorageSingleton.u32Slots.Put(key, val);
+    }
+    void EmplaceU32ByKey(u32 key, u32 val)
+    {
+        entt::registry* registry = ServiceLocator::GetGameRegistry();
+        DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
+
+        dataStorageSingleton.u32Slots.Emplace(key, val);
+    }
+    bool GetU32ByKey(u32 key, u32& val)
+    {
+        entt::registry* registry = ServiceLocator::GetGameRegistry();
+        DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
+
+        return dataStorageSingleton.u32Slots.Get(key, val);
+    }
+    bool HasU32ByKey(u32 key)
+    {
+        entt::registry* registry = ServiceLocator::GetGameRegistry();
+        DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
+
+        return dataStorageSingleton.u32Slots.Has(key);
+    }
+    bool ClearU32ByKey(u32 key)
+    {
+        entt::registry* registry = ServiceLocator::GetGameRegistry();
+        DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
+
+        return dataStorageSingleton.u32Slots.Clear(key);
     }
 
-    bool PutU64(std::string name, u64 val)
+    bool PutU64(const std::string& name, u64 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -196,7 +310,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.PutU64(nameHash, val);
     }
-    void EmplaceU64(std::string name, u64 val)
+    void EmplaceU64(const std::string& name, u64 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -204,7 +318,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         dataStorageSingleton.storage.EmplaceU64(nameHash, val);
     }
-    bool GetU64(std::string name, u64& val)
+    bool GetU64(const std::string& name, u64& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -212,7 +326,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.GetU64(nameHash, val);
     }
-    bool HasU64(std::string name)
+    bool HasU64(const std::string& name)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -220,7 +334,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.HasU64(nameHash);
     }
-    bool ClearU64(std::string name)
+    bool ClearU64(const std::string& name)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -229,48 +343,68 @@ namespace ASDataStorageUtils
         return dataStorageSingleton.storage.ClearU64(nameHash);
     }
 
-    bool PutF32(std::string name, f32 val)
+    bool PutF32(const std::string& name, f32 val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return PutF32ByKey(nameHash, val);
+    }
+    void EmplaceF32(const std::string& name, f32 val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        EmplaceF32ByKey(nameHash, val);
+    }
+    bool GetF32(const std::string& name, f32& val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return GetF32ByKey(nameHash, val);
+    }
+    bool HasF32(const std::string& name)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return HasF32ByKey(nameHash);
+    }
+    bool ClearF32(const std::string& name)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return ClearF32ByKey(nameHash);
+    }
+    bool PutF32ByKey(u32 key, f32 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.PutF32(nameHash, val);
+        return dataStorageSingleton.f32Slots.Put(key, val);
     }
-    void EmplaceF32(std::string name, f32 val)
+    void EmplaceF32ByKey(u32 key, f32 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        dataStorageSingleton.storage.EmplaceF32(nameHash, val);
+        dataStorageSingleton.f32Slots.Emplace(key, val);
     }
-    bool GetF32(std::string name, f32& val)
+    bool GetF32ByKey(u32 key, f32& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.GetF32(nameHash, val);
+        return dataStorageSingleton.f32Slots.Get(key, val);
     }
-    bool HasF32(std::string name)
+    bool HasF32ByKey(u32 key)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.HasF32(nameHash);
+        return dataStorageSingleton.f32Slots.Has(key);
     }
-    bool ClearF32(std::string name)
+    bool ClearF32ByKey(u32 key)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.ClearF32(nameHash);
+        return dataStorageSingleton.f32Slots.Clear(key);
     }
 
-    bool PutF64(std::string name, f64 val)
+    bool PutF64(const std::string& name, f64 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -278,7 +412,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.PutF64(nameHash, val);
     }
-    void EmplaceF64(std::string name, f64 val)
+    void EmplaceF64(const std::string& name, f64 val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -286,7 +420,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         dataStorageSingleton.storage.EmplaceF64(nameHash, val);
     }
-    bool GetF64(std::string name, f64& val)
+    bool GetF64(const std::string& name, f64& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -294,7 +428,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.GetF64(nameHash, val);
     }
-    bool HasF64(std::string name)
+    bool HasF64(const std::string& name)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -302,7 +436,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.HasF64(nameHash);
     }
-    bool ClearF64(std::string name)
+    bool ClearF64(const std::string& name)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -311,48 +445,68 @@ namespace ASDataStorageUtils
         return dataStorageSingleton.storage.ClearF64(nameHash);
     }
 
-    bool PutString(std::string name, std::string val)
+    bool PutString(const std::string& name, const std::string& val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return PutStringByKey(nameHash, val);
+    }
+    void EmplaceString(const std::string& name, const std::string& val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        EmplaceStringByKey(nameHash, val);
+    }
+    bool GetString(const std::string& name, std::string& val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return GetStringByKey(nameHash, val);
+    }
+    bool HasString(const std::string& name)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return HasStringByKey(nameHash);
+    }
+    bool ClearString(const std::string& name)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return ClearStringByKey(nameHash);
+    }
+    bool PutStringByKey(u32 key, const std::string& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.PutString(nameHash, val);
+        return dataStorageSingleton.stringSlots.Put(key, val);
     }
-    void EmplaceString(std::string name, std::string val)
+    void EmplaceStringByKey(u32 key, const std::string& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        dataStorageSingleton.storage.EmplaceString(nameHash, val);
+        dataStorageSingleton.stringSlots.Emplace(key, val);
     }
-    bool GetString(std::string name, std::string& val)
+    bool GetStringByKey(u32 key, std::string& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.GetString(nameHash, val);
+        return dataStorageSingleton.stringSlots.Get(key, val);
     }
-    bool HasString(std::string name)
+    bool HasStringByKey(u32 key)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.HasString(nameHash);
+        return dataStorageSingleton.stringSlots.Has(key);
     }
-    bool ClearString(std::string name)
+    bool ClearStringByKey(u32 key)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.ClearString(nameHash);
+        return dataStorageSingleton.stringSlots.Clear(key);
     }
 
-    bool PutPointer(std::string name, void* val)
+    bool PutPointer(const std::string& name, void* val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -360,7 +514,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.PutPointer(nameHash, val);
     }
-    void EmplacePointer(std::string name, void* val)
+    void EmplacePointer(const std::string& name, void* val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -368,7 +522,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         dataStorageSingleton.storage.EmplacePointer(nameHash, val);
     }
-    bool GetPointer(std::string name, void*& val)
+    bool GetPointer(const std::string& name, void*& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -376,7 +530,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.GetPointer(nameHash, val);
     }
-    bool HasPointer(std::string name)
+    bool HasPointer(const std::string& name)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -384,7 +538,7 @@ namespace ASDataStorageUtils
         u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
         return dataStorageSingleton.storage.HasPointer(nameHash);
     }
-    bool ClearPointer(std::string name)
+    bool ClearPointer(const std::string& name)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
@@ -393,44 +547,64 @@ namespace ASDataStorageUtils
         return dataStorageSingleton.storage.ClearPointer(nameHash);
     }
 
-    bool PutEntity(std::string name, entt::entity val)
+    bool PutEntity(const std::string& name, entt::entity val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return PutEntityByKey(nameHash, val);
+    }
+    void EmplaceEntity(const std::string& name, entt::entity val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        EmplaceEntityByKey(nameHash, val);
+    }
+    bool GetEntity(const std::string& name, entt::entity& val)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return GetEntityByKey(nameHash, val);
+    }
+    bool HasEntity(const std::string& name)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return HasEntityByKey(nameHash);
+    }
+    bool ClearEntity(const std::string& name)
+    {
+        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
+        return ClearEntityByKey(nameHash);
+    }
+    bool PutEntityByKey(u32 key, entt::entity val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.PutEntity(nameHash, val);
+        return dataStorageSingleton.entitySlots.Put(key, val);
     }
-    void EmplaceEntity(std::string name, entt::entity val)
+    void EmplaceEntityByKey(u32 key, entt::entity val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        dataStorageSingleton.storage.EmplaceEntity(nameHash, val);
+        dataStorageSingleton.entitySlots.Emplace(key, val);
     }
-    bool GetEntity(std::string name, entt::entity& val)
+    bool GetEntityByKey(u32 key, entt::entity& val)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.GetEntity(nameHash, val);
+        return dataStorageSingleton.entitySlots.Get(key, val);
     }
-    bool HasEntity(std::string name)
+    bool HasEntityByKey(u32 key)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.HasEntity(nameHash);
+        return dataStorageSingleton.entitySlots.Has(key);
     }
-    bool ClearEntity(std::string name)
+    bool ClearEntityByKey(u32 key)
     {
         entt::registry* registry = ServiceLocator::GetGameRegistry();
         DataStorageSingleton& dataStorageSingleton = registry->ctx<DataStorageSingleton>();
 
-        u32 nameHash = StringUtils::fnv1a_32(name.c_str(), name.length());
-        return dataStorageSingleton.storage.ClearEntity(nameHash);
+        return dataStorageSingleton.entitySlots.Clear(key);
     }
-}
+}
\ No newline at end of file
@@ -6,48 +6,81 @@ namespace ASDataStorageUtils
 {
     void RegisterNamespace();
 
-    bool PutU8(std::string name, u8 val);
-    void EmplaceU8(std::string name, u8 val);
-    bool GetU8(std::string name, u8& val);
-    bool ClearU8(std::string name);
-
-    bool PutU16(std::string name, u16 val);
-    void EmplaceU16(std::string name, u16 val);
-    bool GetU16(std::string name, u16& val);
-    bool ClearU16(std::string name);
-
-    bool PutU32(std::string name, u32 val);
-    void EmplaceU32(std::string name, u32 val);
-    bool GetU32(std::string name, u32& val);
-    bool ClearU32(std::string name);
-
-    bool PutU64(std::string name, u64 val);
-    void EmplaceU64(std::string name, u64 val);
-    bool GetU64(std::string name, u64& val);
-    bool ClearU64(std::string name);
-
-    bool PutF32(std::string name, f32 val);
-    void EmplaceF32(std::string name, f32 val);
-    bool GetF32(std::string name, f32& val);
-    bool ClearF32(std::string name);
-
-    bool PutF64(std::string name, f64 val);
-    void EmplaceF64(std::string name, f64 val);
-    bool GetF64(std::string name, f64& val);
-    bool ClearF64(std::string name);
-
-    bool PutString(std::string name, std::string val);
-    void EmplaceString(std::string name, std::string val);
-    bool GetString(std::string name, std::string& val);
-    bool ClearString(std::string name);
-
-    bool PutPointer(std::string name, void* val);
-    void EmplacePointer(std::string name, void* val);
-    bool GetPointer(std::string name, void*& val);
-    bool ClearPointer(std::string name);
-
-    bool PutEntity(std::string name, entt::entity val);
-    void EmplaceEntity(std::string name, entt::entity val);
-    bool GetEntity(std::string name, entt::entity& val);
-    bool ClearEntity(std::string name);
+    // Same hash as StringUtils::fnv1a_32 and "name"_h, scripts hash their keys once and pass the result to the key overloads
+    u32 HashKey(const std::string& name);
+
+    bool PutU8(const std::string& name, u8 val);
+    void EmplaceU8(const std::string& name, u8 val);
+    bool GetU8(const std::string& name, u8& val);
+    bool ClearU8(const std::string& name);
+
+    bool PutU16(const std::string& name, u16 val);
+    void EmplaceU16(const std::string& name, u16 val);
+    bool GetU16(const std::string& name, u16& val);
+    bool ClearU16(const std::string& name);
+
+    bool PutI32(const std::string& name, i32 val);
+    void EmplaceI32(const std::string& name, i32 val);
+    bool GetI32(const std::string& name, i32& val);
+    bool ClearI32(const std::string& name);
+    bool PutI32ByKey(u32 key, i32 val);
+    void EmplaceI32ByKey(u32 key, i32 val);
+    bool GetI32ByKey(u32 key, i32& val);
+    bool HasI32ByKey(u32 key);
+    bool ClearI32ByKey(u32 key);
+
+    bool PutU32(const std::string& name, u32 val);
+    void EmplaceU32(const std::string& name, u32 val);
+    bool GetU32(const std::string& name, u32& val);
+    bool ClearU32(const std::string& name);
+    bool PutU32ByKey(u32 key, u32 val);
+    void EmplaceU32ByKey(u32 key, u32 val);
+    bool GetU32ByKey(u32 key, u32& val);
+    bool HasU32ByKey(u32 key);
+    bool ClearU32ByKey(u32 key);
+
+    bool PutU64(const std::string& name, u64 val);
+    void EmplaceU64(const std::string& name, u64 val);
+    bool GetU64(const std::string& name, u64& val);
+    bool ClearU64(const std::string& name);
+
+    bool PutF32(const std::string& name, f32 val);
+    void EmplaceF32(const std::string& name, f32 val);
+    bool GetF32(const std::string& name, f32& val);
+    bool ClearF32(const std::string& name);
+    bool PutF32ByKey(u32 key, f32 val);
+    void EmplaceF32ByKey(u32 key, f32 val);
+    bool GetF32ByKey(u32 key, f32& val);
+    bool HasF32ByKey(u32 key);
+    bool ClearF32ByKey(u32 key);
+
+    bool PutF64(const std::string& name, f64 val);
+    void EmplaceF64(const std::string& name, f64 val);
+    bool GetF64(const std::string& name, f64& val);
+    bool ClearF64(const std::string& name);
+
+    bool PutString(const std::string& name, const std::string& val);
+    void EmplaceString(const std::string& name, const std::string& val);
+    bool GetString(const std::string& name, std::string& val);
+    bool ClearString(const std::string& name);
+    bool PutStringByKey(u32 key, const std::string& val);
+    void EmplaceStringByKey(u32 key, const std::string& val);
+    bool GetStringByKey(u32 key, std::string& val);
+    bool HasStringByKey(u32 key);
+    bool ClearStringByKey(u32 key);
+
+    bool PutPointer(const std::string& name, void* val);
+    void EmplacePointer(const std::string& name, void* val);
+    bool GetPointer(const std::string& name, void*& val);
+    bool ClearPointer(const std::string& name);
+
+    bool PutEntity(const std::string& name, entt::entity val);
+    void EmplaceEntity(const std::string& name, entt::entity val);
+    bool GetEntity(const std::string& name, entt::entity& val);
+    bool ClearEntity(const std::string& name);
+    bool PutEntityByKey(u32 key, entt::entity val);
+    void EmplaceEntityByKey(u32 key, entt::entity val);
+    bool GetEntityByKey(u32 key, entt::entity& val);
+    bool HasEntityByKey(u32 key);
+    bool ClearEntityByKey(u32 key);
 };
\ No newline at end of file
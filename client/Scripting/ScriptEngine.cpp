@@ -1,5 +1,6 @@
 #include "ScriptEngine.h"
 #include <Utils/DebugHandler.h>
+#include <Utils/XXHash64.h>
 
 // Types to register
 #include "Addons/scriptarray/scriptarray.h"
@@ -19,6 +20,7 @@
 thread_local asIScriptEngine* ScriptEngine::_scriptEngine = nullptr;
 thread_local asIScriptContext* ScriptEngine::_scriptContext = nullptr;
 thread_local std::string ScriptEngine::_scriptCurrentObjectName = "";
+thread_local u64 ScriptEngine::_registeredAPIHash = 0;
 
 void ScriptEngine::Initialize()
 {
@@ -47,6 +49,103 @@ asIScriptContext* ScriptEngine::GetScriptContext()
     return _scriptContext;
 }
 
+u64 ScriptEngine::GetRegisteredAPIHash()
+{
+    Initialize();
+    if (_registeredAPIHash != 0)
+        return _registeredAPIHash;
+
+    // Build a textual dump of the registered API, declarations include namespaces and parameter names
+    std::string signature = ANGELSCRIPT_VERSION_STRING;
+    signature += '\n';
+
+    const auto AppendFunction = [&signature](const asIScriptFunction* function)
+    {
+        signature += function->GetDeclaration(true, true, true);
+        signature += '\n';
+    };
+
+    for (asUINT i = 0; i < _scriptEngine->GetObjectTypeCount(); i++)
+    {
+        asITypeInfo* type = _scriptEngine->GetObjectTypeByIndex(i);
+        signature += type->GetNamespace();
+        signature += "::";
+        signature += type->GetName();
+        signature += ' ' + std::to_string(type->GetFlags()) + ' ' + std::to_string(type->GetSize()) + '\n';
+
+        for (asUINT j = 0; j < type->GetBehaviourCount(); j++)
+        {
+            asEBehaviours behaviour;
+            AppendFunction(type->GetBehaviourByIndex(j, &behaviour));
+        }
+        for (asUINT j = 0; j < type->GetFactoryCount(); j++)
+        {
+            AppendFunction(type->GetFactoryByIndex(j));
+        }
+        for (asUINT j = 0; j < type->GetMethodCount(); j++)
+        {
+            AppendFunction(type->GetMethodByIndex(j, false));
+        }
+        for (asUINT j = 0; j < type->GetPropertyCount(); j++)
+        {
+            signature += type->GetPropertyDeclaration(j, true);
+            signature += '\n';
+        }
+    }
+
+    for (asUINT i = 0; i < _scriptEngine->GetEnumCount(); i++)
+    {
+        asITypeInfo* enumType = _scriptEngine->GetEnumByIndex(i);
+        signature += enumType->GetNamespace();
+        signature += "::";
+        signature += enumType->GetName();
+        signature += '\n';
+
+        for (asUINT j = 0; j < enumType->GetEnumValueCount(); j++)
+        {
+            i32 value = 0;
+            signature += enumType->GetEnumValueByIndex(j, &value);
+            signature += '=' + std::to_string(value) + '\n';
+        }
+    }
+
+    for (asUINT i = 0; i < _scriptEngine->GetFuncdefCount(); i++)
+    {
+        AppendFunction(_scriptEngine->GetFuncdefByIndex(i)->GetFuncdefSignature());
+    }
+
+    for (asUINT i = 0; i < _scriptEngine->GetTypedefCount(); i++)
+    {
+        asITypeInfo* typeDef = _scriptEngine->GetTypedefByIndex(i);
+        signature += typeDef->GetName();
+        signature += '=' + std::to_string(typeDef->GetTypedefTypeId()) + '\n';
+    }
+
+    for (asUINT i = 0; i < _scriptEngine->GetGlobalFunctionCount(); i++)
+    {
+        AppendFunction(_scriptEngine->GetGlobalFunctionByIndex(i));
+    }
+
+    for (asUINT i = 0; i < _scriptEngine->GetGlobalPropertyCount(); i++)
+    {
+        const char* name = nullptr;
+        const char* nameSpace = nullptr;
+        i32 typeId = 0;
+        bool isConst = false;
+        _scriptEngine->GetGlobalPropertyByIndex(i, &name, &nameSpace, &typeId, &isConst);
+
+        signature += nameSpace;
+        signature += "::";
+        signature += name;
+        signature += ' ';
+        signature += _scriptEngine->GetTypeDeclaration(typeId, true);
+        signature += '\n';
+    }
+
+    _registeredAPIHash = XXHash64::hash(signature.data(), signature.size(), 0);
+    return _registeredAPIHash;
+}
+
 i32 ScriptEngine::SetNamespace(std::string name)
 {
     return _scriptEngine->SetDefaultNamespace(name.c_str());
@@ -12,6 +12,9 @@ public:
     static asIScriptEngine* GetScriptEngine();
     static asIScriptContext* GetScriptContext();
 
+    // Hash of everything registered with the engine, compiled bytecode is only valid against the API it was built with
+    static u64 GetRegisteredAPIHash();
+
     static i32 SetNamespace(std::string name);
     static i32 ResetNamespace();
     static i32 RegisterScriptClass(std::string name, i32 byteSize, u32 flags);
@@ -63,4 +66,5 @@ private:
     static thread_local asIScriptEngine* _scriptEngine;
     static thread_local asIScriptContext* _scriptContext;
     static thread_local std::string _scriptCurrentObjectName;
+    static thread_local u64 _registeredAPIHash;
 };
\ No newline at end of file
@@ -3,6 +3,9 @@
 
 #include <Utils/DebugHandler.h>
 #include <Utils/Timer.h>
+#include <Utils/XXHash64.h>
+#include <fstream>
+#include <cstring>
 
 #include "../ECS/Components/Singletons/ScriptSingleton.h"
 #include "../ECS/Components/Singletons/DataStorageSingleton.h"
@@ -22,6 +25,58 @@ AutoCVar_String CVAR_ScriptPath("script.path", "path to the scripting folder", "
 namespace fs = std::filesystem;
 std::string ScriptHandler::_scriptFolder = "";
 
+// Compiled modules are cached next to their script, e.g. "main.as" gets "main.as.asbc"
+constexpr char BYTECODE_CACHE_EXTENSION[] = ".asbc";
+constexpr u32 BYTECODE_CACHE_MAGIC = 0x4342534E; // NSBC
+constexpr u32 BYTECODE_CACHE_VERSION = 1;
+
+class ByteCodeStream : public asIBinaryStream
+{
+public:
+    ByteCodeStream(std::vector<u8>& data, size_t readOffset = 0) : _data(data), _readOffset(readOffset) { }
+
+    int Write(const void* ptr, asUINT size) override
+    {
+        const u8* bytes = static_cast<const u8*>(ptr);
+        _data.insert(_data.end(), bytes, bytes + size);
+        return 0;
+    }
+
+    int Read(void* ptr, asUINT size) override
+    {
+        if (_readOffset + size > _data.size())
+            return -1;
+
+        std::memcpy(ptr, &_data[_readOffset], size);
+        _readOffset += size;
+        return 0;
+    }
+
+private:
+    std::vector<u8>& _data;
+    size_t _readOffset;
+};
+
+static bool ReadFile(const fs::path& path, std::vector<u8>& data)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), data.size()));
+}
+
+static u64 HashFile(const fs::path& path)
+{
+    std::vector<u8> data;
+    if (!ReadFile(path, data))
+        return 0;
+
+    return XXHash64::hash(data.data(), data.size(), 0);
+}
+
 void ScriptHandler::ReloadScripts()
 {
     DebugHandler::Print("Reloading scripts...");
@@ -55,7 +110,7 @@ void ScriptHandler::LoadScriptDirectory(std::string& scriptFolder)
     size_t count = 0;
     for (auto& scriptPath : fs::recursive_directory_iterator(absolutePath))
     {
-        if (scriptPath.is_directory())
+        if (scriptPath.is_directory() || scriptPath.path().extension() == BYTECODE_CACHE_EXTENSION)
             continue;
 
         if (LoadScript(scriptPath.path()))
@@ -72,34 +127,43 @@ bool ScriptHandler::LoadScript(fs::path scriptPath)
     asIScriptEngine* scriptEngine = ScriptEngine::GetScriptEngine();
     std::string moduleName = scriptPath.filename().string();
 
-    CScriptBuilder builder;
-    int r = builder.StartNewModule(scriptEngine, moduleName.c_str());
-    if (r < 0)
-    {
-        // If the code fails here it is usually because there
-        // is no more memory to allocate the module
-        DebugHandler::PrintError("[Script]: Unrecoverable error while starting a new module.");
-        return false;
-    }
-    r = builder.AddSectionFromFile(scriptPath.string().c_str());
-    if (r < 0)
-    {
-        // The builder wasn't able to load the file. Maybe the file
-        // has been removed, or the wrong name was given, or some
-        // preprocessing commands are incorrectly written.
-        DebugHandler::PrintError("[Script]: Please correct the errors in the script and try again.\n");
-        return false;
-    }
-    r = builder.BuildModule();
-    if (r < 0)
+    fs::path cachePath = scriptPath;
+    cachePath += BYTECODE_CACHE_EXTENSION;
+
+    asIScriptModule* mod = LoadCachedModule(cachePath, moduleName);
+    if (!mod)
     {
-        // An error occurred. Instruct the script writer to fix the
-        // compilation errors that were listed in the output stream.
-        DebugHandler::PrintError("[Script]: Please correct the errors in the script and try again.\n");
-        return false;
+        CScriptBuilder builder;
+        int r = builder.StartNewModule(scriptEngine, moduleName.c_str());
+        if (r < 0)
+        {
+            // If the code fails here it is usually because there
+            // is no more memory to allocate the module
+            DebugHandler::PrintError("[Script]: Unrecoverable error while starting a new module.");
+            return false;
+        }
+        r = builder.AddSectionFromFile(scriptPath.string().c_str());
+        if (r < 0)
+        {
+            // The builder wasn't able to load the file. Maybe the file
+            // has been removed, or the wrong name was given, or some
+            // preprocessing commands are incorrectly written.
+            DebugHandler::PrintError("[Script]: Please correct the errors in the script and try again.\n");
+            return false;
+        }
+        r = builder.BuildModule();
+        if (r < 0)
+        {
+            // An error occurred. Instruct the script writer to fix the
+            // compilation errors that were listed in the output stream.
+            DebugHandler::PrintError("[Script]: Please correct the errors in the script and try again.\n");
+            return false;
+        }
+
+        mod = scriptEngine->GetModule(moduleName.c_str());
+        SaveCachedModule(cachePath, builder, mod);
     }
 
-    asIScriptModule* mod = scriptEngine->GetModule(moduleName.c_str());
     asIScriptFunction* func = mod->GetFunctionByDecl("void main()");
     if (func == 0)
     {
@@ -112,7 +176,7 @@ bool ScriptHandler::LoadScript(fs::path scriptPath)
     // Create our context, prepare it, and then execute
     asIScriptContext* ctx = scriptEngine->CreateContext();
     ctx->Prepare(func);
-    r = ctx->Execute();
+    int r = ctx->Execute();
     if (r != asEXECUTION_FINISHED)
     {
         // The execution didn't complete as expected. Determine what happened.
@@ -127,4 +191,88 @@ bool ScriptHandler::LoadScript(fs::path scriptPath)
 
     ctx->Release();
     return true;
-}
\ No newline at end of file
+}
+
+asIScriptModule* ScriptHandler::LoadCachedModule(const fs::path& cachePath, const std::string& moduleName)
+{
+    std::vector<u8> data;
+    if (!ReadFile(cachePath, data))
+        return nullptr;
+
+    ByteCodeStream stream(data);
+
+    u32 magic = 0;
+    u32 version = 0;
+    u64 apiHash = 0;
+    u32 numSources = 0;
+    if (stream.Read(&magic, sizeof(u32)) < 0 || stream.Read(&version, sizeof(u32)) < 0 || stream.Read(&apiHash, sizeof(u64)) < 0 || stream.Read(&numSources, sizeof(u32)) < 0)
+        return nullptr;
+
+    if (magic != BYTECODE_CACHE_MAGIC || version != BYTECODE_CACHE_VERSION || apiHash != ScriptEngine::GetRegisteredAPIHash())
+        return nullptr;
+
+    // The script and everything it includes has to be unchanged
+    for (u32 i = 0; i < numSources; i++)
+    {
+        u16 pathLength = 0;
+        if (stream.Read(&pathLength, sizeof(u16)) < 0)
+            return nullptr;
+
+        std::string sourcePath(pathLength, '\0');
+        u64 sourceHash = 0;
+        if (stream.Read(sourcePath.data(), pathLength) < 0 || stream.Read(&sourceHash, sizeof(u64)) < 0)
+            return nullptr;
+
+        if (HashFile(sourcePath) != sourceHash)
+            return nullptr;
+    }
+
+    asIScriptModule* mod = ScriptEngine::GetScriptEngine()->GetModule(moduleName.c_str(), asGM_ALWAYS_CREATE);
+    if (mod->LoadByteCode(&stream) < 0)
+    {
+        // Stale or corrupt, the caller rebuilds from source and overwrites it
+        mod->Discard();
+        return nullptr;
+    }
+
+    return mod;
+}
+
+void ScriptHandler::SaveCachedModule(const fs::path& cachePath, const CScriptBuilder& builder, asIScriptModule* module)
+{
+    std::vector<u8> data;
+    ByteCodeStream stream(data);
+
+    const u64 apiHash = ScriptEngine::GetRegisteredAPIHash();
+    const u32 numSources = builder.GetSectionCount();
+    stream.Write(&BYTECODE_CACHE_MAGIC, sizeof(u32));
+    stream.Write(&BYTECODE_CACHE_VERSION, sizeof(u32));
+    stream.Write(&apiHash, sizeof(u64));
+    stream.Write(&numSources, sizeof(u32));
+
+    for (u32 i = 0; i < numSources; i++)
+    {
+        const std::string sourcePath = builder.GetSectionName(i);
+        const u16 pathLength = static_cast<u16>(sourcePath.length());
+        const u64 sourceHash = HashFile(sourcePath);
+
+        stream.Write(&pathLength, sizeof(u16));
+        stream.Write(sourcePath.data(), pathLength);
+        stream.Write(&sourceHash, sizeof(u64));
+    }
+
+    if (module->SaveByteCode(&stream) < 0)
+    {
+        DebugHandler::PrintWarning("[Script]: Failed to save bytecode for %s", module->GetName());
+        return;
+    }
+
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        DebugHandler::PrintWarning("[Script]: Failed to write bytecode cache %s", cachePath.string().c_str());
+        return;
+    }
+
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
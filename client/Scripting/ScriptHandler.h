@@ -5,6 +5,8 @@
 #include <entity/fwd.hpp>
 #include "angelscript.h"
 
+class CScriptBuilder;
+
 class ScriptHandler
 {
 public:
@@ -15,6 +17,9 @@ public:
 private:
     static bool LoadScript(std::filesystem::path path);
 
+    static asIScriptModule* LoadCachedModule(const std::filesystem::path& cachePath, const std::string& moduleName);
+    static void SaveCachedModule(const std::filesystem::path& cachePath, const CScriptBuilder& builder, asIScriptModule* module);
+
     ScriptHandler();
 
 private:
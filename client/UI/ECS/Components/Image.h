@@ -1,7 +1,7 @@
 #pragma once
 #include <NovusTypes.h>
 #include <Renderer/Renderer.h>
-#include <Renderer/Buffer.h>
+#include "../../UITypes.h"
 
 namespace UI
 {
@@ -31,15 +31,18 @@ namespace UIComponent
             UI::Box borderInset; // 16 bytes
             UI::Box slicingOffset; // 16 bytes
             vec2 size ; // 8 bytes
+            u32 borderIndex = 0; // 4 bytes
 
-            u8 padding[8] = {};
+            u8 padding[4] = {};
         };
         Image(){ }
 
         UI::ImageStylesheet style;
         Renderer::TextureID textureID = Renderer::TextureID::Invalid();
         Renderer::TextureID borderID = Renderer::TextureID::Invalid();
-        Renderer::BufferID vertexBufferID = Renderer::BufferID::Invalid();
-        Renderer::Buffer<ImageConstantBuffer>* constantBuffer = nullptr;
+        u32 textureIndex = 0; // Index into the UI renderer's image texture array
+
+        UI::UIVertex vertices[4];
+        ImageConstantBuffer constants; // Copied into the UI batch every frame the image is drawn
     };
 }
\ No newline at end of file
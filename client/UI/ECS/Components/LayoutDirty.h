@@ -0,0 +1,8 @@
+#pragma once
+
+namespace UIComponent
+{
+    struct LayoutDirty
+    {
+    };
+}
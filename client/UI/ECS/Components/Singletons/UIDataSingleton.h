@@ -2,6 +2,7 @@
 #include "NovusTypes.h"
 #include <entity/fwd.hpp>
 #include <robin_hood.h>
+#include <Renderer/Descriptors/TextureArrayDesc.h>
 
 namespace UIScripting
 {
@@ -25,5 +26,9 @@ namespace UISingleton
         //Resolution
         const f32 referenceHeight = 1080.f;
         hvec2 UIRESOLUTION = hvec2(0.0f, 0.f);
+
+        // Images load into one array so the UI renderer can batch them
+        Renderer::TextureArrayID imageTextureArray = Renderer::TextureArrayID::Invalid();
+        u32 emptyBorderIndex = 0;
     };
 }
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include <NovusTypes.h>
+#include <entity/entity.hpp>
+#include <robin_hood.h>
+#include <limits>
+#include <vector>
+
+namespace UISingleton
+{
+    struct UIHierarchySingleton
+    {
+    public:
+        static constexpr u32 INVALID_NODE = std::numeric_limits<u32>::max();
+
+        struct Node
+        {
+            entt::entity entity = entt::null;
+            u32 parent = INVALID_NODE;
+            u32 subtreeEnd = 0; // One past the last descendant
+        };
+
+        UIHierarchySingleton() { }
+
+        // Every element flattened depth first from the roots, parents always come before their children
+        // and a subtree is the contiguous range [index, subtreeEnd) so it can be walked without recursion
+        std::vector<Node> nodes;
+        robin_hood::unordered_map<entt::entity, u32> entityToNode;
+
+        // Set when elements are created, destroyed or reparented, the layout system reflattens before its next pass
+        bool isDirty = true;
+    };
+}
@@ -2,9 +2,43 @@
 #include <NovusTypes.h>
 #include "../../UITypes.h"
 #include <Renderer/Renderer.h>
-#include <Renderer/Buffer.h>
 #include <Renderer/Font.h>
 #include <vector>
+#include <memory>
+
+namespace UI
+{
+    // A visible glyph, positioned relative to the origin of its line
+    struct TextLayoutGlyph
+    {
+        vec2 offset = vec2(0.f, 0.f);
+        vec2 size = vec2(0.f, 0.f);
+        FBox texCoords;
+        u32 textureIndex = 0;
+    };
+
+    struct TextLayoutLine
+    {
+        size_t firstByte = 0;
+        u32 firstGlyph = 0; // Into TextLayout::glyphs
+        u32 glyphCount = 0;
+        f32 width = 0.f;
+    };
+
+    // Wrapped glyph runs for a string, shared through the layout cache so treat it as immutable once built
+    struct TextLayout
+    {
+        std::string text = "";
+        Renderer::Font* font = nullptr;
+        f32 maxWidth = 0.f;
+        u32 maxLines = 0;
+        size_t startByte = 0;
+        size_t endByte = 0; // Everything from here on didn't fit
+
+        std::vector<TextLayoutLine> lines;
+        std::vector<TextLayoutGlyph> glyphs;
+    };
+}
 
 namespace UIComponent
 {
@@ -17,7 +51,7 @@ namespace UIComponent
             Color outlineColor = Color(); // 16 bytes
             f32 outlineWidth = 0.f; // 4 bytes
 
-            u8 padding[220] = {};
+            u8 padding[12] = {}; // Keeps the stride of the batched StructuredBuffer at 48 bytes
         };
 
     public:
@@ -34,10 +68,10 @@ namespace UIComponent
         bool multiline = false;
 
         Renderer::Font* font = nullptr;
+        std::shared_ptr<const UI::TextLayout> layout; // Last layout, edits re-layout incrementally from it
 
-        size_t vertexBufferGlyphCount = 0;
-        Renderer::BufferID vertexBufferID = Renderer::BufferID::Invalid();
-        Renderer::BufferID textureIDBufferID = Renderer::BufferID::Invalid();
-        Renderer::Buffer<TextConstantBuffer>* constantBuffer = nullptr;
+        std::vector<UI::UIVertex> vertices; // 4 per glyph
+        std::vector<u32> glyphTextureIndices;
+        TextConstantBuffer constants;
     };
 }
\ No newline at end of file
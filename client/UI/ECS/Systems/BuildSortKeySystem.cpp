@@ -1,25 +1,35 @@
 #include "BuildSortKeySystem.h"
 #include <entity/registry.hpp>
 
-#include "../../../Utils/ServiceLocator.h"
-#include "../Components/Relation.h"
+#include "../Components/Singletons/UIHierarchySingleton.h"
 #include "../Components/SortKey.h"
 #include "../Components/SortKeyDirty.h"
 
-#include "../../Utils/SortUtils.h"
-
 namespace UISystem
 {
     void BuildSortKeySystem::Update(entt::registry& registry)
     {
-        auto sortView = registry.view<UIComponent::Relation, UIComponent::SortKey, UIComponent::SortKeyDirty>();
-        sortView.each([&](entt::entity entity, UIComponent::Relation& relation, UIComponent::SortKey& sortKey)
+        const UISingleton::UIHierarchySingleton& hierarchy = registry.ctx<UISingleton::UIHierarchySingleton>();
+
+        auto sortView = registry.view<UIComponent::SortKey, UIComponent::SortKeyDirty>();
+        sortView.each([&](entt::entity entity, UIComponent::SortKey& sortKey)
         {
+            auto itr = hierarchy.entityToNode.find(entity);
+            if (itr == hierarchy.entityToNode.end())
+                return;
+
             sortKey.data.compoundDepth = 0;
 
+            // The flattened subtree is already in the order the depths are handed out
             u32 compoundDepth = 1;
-            UIUtils::Sort::UpdateChildDepths(&registry, entity, compoundDepth);
+            const u32 subtreeEnd = hierarchy.nodes[itr->second].subtreeEnd;
+            for (u32 i = itr->second + 1; i < subtreeEnd; i++)
+            {
+                UIComponent::SortKey& childSortKey = registry.get<UIComponent::SortKey>(hierarchy.nodes[i].entity);
+                childSortKey.data.depthLayer = sortKey.data.depthLayer;
+                childSortKey.data.depth = sortKey.data.depth;
+                childSortKey.data.compoundDepth = compoundDepth++;
+            }
         });
-
     }
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 #include "../Components/Singletons/UIDataSingleton.h"
 #include "../Components/Destroy.h"
 #include "../../angelscript/BaseElement.h"
+#include "../../Utils/TransformUtils.h"
 
 namespace UISystem
 {
@@ -13,6 +14,9 @@ namespace UISystem
 
         // Destroy elements queued for destruction.
         auto deleteView = registry.view<UIComponent::Destroy>();
+        if (deleteView.empty())
+            return;
+
         deleteView.each([&](entt::entity entityId) 
         {
             delete dataSingleton.entityToElement[entityId];
@@ -20,5 +24,7 @@ namespace UISystem
         });
         registry.destroy(deleteView.begin(), deleteView.end());
 
+        UIUtils::Transform::MarkHierarchyDirty(&registry);
+
     }
 }
\ No newline at end of file
@@ -1,21 +1,69 @@
 #include "UpdateBoundsSystem.h"
 #include <entity/registry.hpp>
+#include <algorithm>
 
+#include "../Components/Singletons/UIHierarchySingleton.h"
 #include "../Components/Transform.h"
 #include "../Components/Relation.h"
 #include "../Components/Collision.h"
 #include "../Components/BoundsDirty.h"
-#include "../../Utils/ColllisionUtils.h"
+#include "../../Utils/TransformUtils.h"
 
 
 namespace UISystem
 {
     void UpdateBoundsSystem::Update(entt::registry& registry)
     {
-        auto boundsUpdateView = registry.view<UIComponent::Transform, UIComponent::Collision, UIComponent::Relation, UIComponent::BoundsDirty>();
-        boundsUpdateView.each([&](entt::entity entityId, UIComponent::Transform& transform, UIComponent::Collision& collision, UIComponent::Relation& relation)
+        const UISingleton::UIHierarchySingleton& hierarchy = registry.ctx<UISingleton::UIHierarchySingleton>();
+
+        auto boundsUpdateView = registry.view<UIComponent::BoundsDirty>();
+        if (boundsUpdateView.empty())
+            return;
+
+        std::vector<u8> dirtyNodes(hierarchy.nodes.size(), 0);
+        for (entt::entity entity : boundsUpdateView)
+        {
+            auto itr = hierarchy.entityToNode.find(entity);
+            if (itr == hierarchy.entityToNode.end())
+                continue;
+
+            // A dirty element drags its whole subtree along
+            const u32 index = itr->second;
+            std::fill(dirtyNodes.begin() + index, dirtyNodes.begin() + hierarchy.nodes[index].subtreeEnd, 1);
+        }
+
+        // Children come after their parents, walking backwards means child bounds are final before a parent merges them
+        for (size_t i = hierarchy.nodes.size(); i-- > 0;)
         {
-            UIUtils::Collision::UpdateBounds(&registry, entityId, true);
-        });
+            if (!dirtyNodes[i])
+                continue;
+
+            const UISingleton::UIHierarchySingleton::Node& node = hierarchy.nodes[i];
+            auto [collision, transform, relation] = registry.get<UIComponent::Collision, UIComponent::Transform, UIComponent::Relation>(node.entity);
+
+            collision.minBound = UIUtils::Transform::GetMinBounds(&transform);
+            collision.maxBound = UIUtils::Transform::GetMaxBounds(&transform);
+
+            if (collision.HasFlag(UI::CollisionFlags::INCLUDE_CHILDBOUNDS))
+            {
+                for (const UI::UIChild& child : relation.children)
+                {
+                    const UIComponent::Collision* childCollision = &registry.get<UIComponent::Collision>(child.entId);
+
+                    if (childCollision->minBound.x < collision.minBound.x) { collision.minBound.x = childCollision->minBound.x; }
+                    if (childCollision->minBound.y < collision.minBound.y) { collision.minBound.y = childCollision->minBound.y; }
+
+                    if (childCollision->maxBound.x > collision.maxBound.x) { collision.maxBound.x = childCollision->maxBound.x; }
+                    if (childCollision->maxBound.y > collision.maxBound.y) { collision.maxBound.y = childCollision->maxBound.y; }
+                }
+            }
+
+            if (node.parent == UISingleton::UIHierarchySingleton::INVALID_NODE)
+                continue;
+
+            const UIComponent::Collision* parentCollision = &registry.get<UIComponent::Collision>(hierarchy.nodes[node.parent].entity);
+            if (parentCollision->HasFlag(UI::CollisionFlags::INCLUDE_CHILDBOUNDS))
+                dirtyNodes[node.parent] = 1;
+        }
     }
-}
\ No newline at end of file
+}
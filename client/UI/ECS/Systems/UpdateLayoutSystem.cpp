@@ -0,0 +1,124 @@
+#include "UpdateLayoutSystem.h"
+#include <entity/registry.hpp>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+
+#include "../Components/Singletons/UIHierarchySingleton.h"
+#include "../Components/Transform.h"
+#include "../Components/Relation.h"
+#include "../Components/Root.h"
+#include "../Components/Dirty.h"
+#include "../Components/BoundsDirty.h"
+#include "../Components/LayoutDirty.h"
+
+#include "../../Utils/TransformUtils.h"
+
+namespace UISystem
+{
+    void RebuildHierarchy(entt::registry& registry, UISingleton::UIHierarchySingleton& hierarchy)
+    {
+        ZoneScopedNC("UpdateLayoutSystem::RebuildHierarchy", tracy::Color::Gainsboro);
+
+        hierarchy.nodes.clear();
+        hierarchy.entityToNode.clear();
+
+        std::vector<std::pair<entt::entity, u32>> stack;
+        auto rootView = registry.view<UIComponent::Root>();
+        for (entt::entity root : rootView)
+        {
+            stack.push_back({ root, UISingleton::UIHierarchySingleton::INVALID_NODE });
+
+            while (stack.size() > 0)
+            {
+                auto [entity, parent] = stack.back();
+                stack.pop_back();
+
+                const u32 index = static_cast<u32>(hierarchy.nodes.size());
+                hierarchy.nodes.push_back({ entity, parent, index + 1 });
+                hierarchy.entityToNode[entity] = index;
+
+                // Push in reverse so children keep their order, sort keys depend on it
+                const UIComponent::Relation& relation = registry.get<UIComponent::Relation>(entity);
+                for (auto it = relation.children.rbegin(); it != relation.children.rend(); it++)
+                {
+                    if (registry.valid(it->entId))
+                        stack.push_back({ it->entId, index });
+                }
+            }
+        }
+
+        // Descendants always sit after their parent, so walking backwards closes every subtree before its parent is reached
+        for (size_t i = hierarchy.nodes.size(); i-- > 0;)
+        {
+            const UISingleton::UIHierarchySingleton::Node& node = hierarchy.nodes[i];
+            if (node.parent == UISingleton::UIHierarchySingleton::INVALID_NODE)
+                continue;
+
+            u32& parentEnd = hierarchy.nodes[node.parent].subtreeEnd;
+            parentEnd = std::max(parentEnd, node.subtreeEnd);
+        }
+
+        hierarchy.isDirty = false;
+    }
+
+    void UpdateLayoutSystem::Update(entt::registry& registry)
+    {
+        UISingleton::UIHierarchySingleton& hierarchy = registry.ctx<UISingleton::UIHierarchySingleton>();
+        if (hierarchy.isDirty)
+            RebuildHierarchy(registry, hierarchy);
+
+        auto layoutView = registry.view<UIComponent::LayoutDirty>();
+        if (layoutView.empty())
+            return;
+
+        std::vector<u8> dirtyNodes(hierarchy.nodes.size(), 0);
+        for (entt::entity entity : layoutView)
+        {
+            auto itr = hierarchy.entityToNode.find(entity);
+            if (itr != hierarchy.entityToNode.end())
+                dirtyNodes[itr->second] = 1;
+        }
+        registry.clear<UIComponent::LayoutDirty>();
+
+        // Scratch transforms for the subtree being laid out, indexed relative to its first node
+        std::vector<UIComponent::Transform*> transforms;
+
+        for (u32 i = 0; i < hierarchy.nodes.size();)
+        {
+            if (!dirtyNodes[i])
+            {
+                i++;
+                continue;
+            }
+
+            // Anything dirty inside this subtree gets recomputed along with it
+            const u32 subtreeEnd = hierarchy.nodes[i].subtreeEnd;
+            transforms.resize(subtreeEnd - i);
+            transforms[0] = &registry.get<UIComponent::Transform>(hierarchy.nodes[i].entity);
+
+            for (u32 j = i + 1; j < subtreeEnd; j++)
+            {
+                const UISingleton::UIHierarchySingleton::Node& node = hierarchy.nodes[j];
+                const UIComponent::Transform* parentTransform = transforms[node.parent - i];
+
+                UIComponent::Transform* transform = &registry.get<UIComponent::Transform>(node.entity);
+                transforms[j - i] = transform;
+
+                transform->anchorPosition = UIUtils::Transform::GetAnchorPositionInElement(parentTransform, transform->anchor);
+                if (transform->HasFlag(UI::TransformFlags::FILL_PARENTSIZE))
+                    transform->size = parentTransform->size;
+            }
+
+            for (u32 j = i; j < subtreeEnd; j++)
+            {
+                const entt::entity entity = hierarchy.nodes[j].entity;
+                if (!registry.has<UIComponent::Dirty>(entity))
+                    registry.emplace<UIComponent::Dirty>(entity);
+                if (!registry.has<UIComponent::BoundsDirty>(entity))
+                    registry.emplace<UIComponent::BoundsDirty>(entity);
+            }
+
+            i = subtreeEnd;
+        }
+    }
+}
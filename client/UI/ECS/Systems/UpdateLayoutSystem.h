@@ -0,0 +1,11 @@
+#pragma once
+#include <entity/fwd.hpp>
+
+namespace UISystem
+{
+    class UpdateLayoutSystem
+    {
+    public:
+        static void Update(entt::registry& registry);
+    };
+}
@@ -2,7 +2,6 @@
 #include <entity/registry.hpp>
 #include <tracy/Tracy.hpp>
 #include "../../render-lib/Renderer/Descriptors/ModelDesc.h"
-#include "../../render-lib/Renderer/Buffer.h"
 
 #include "../../../Utils/ServiceLocator.h"
 #include "../Components/Singletons/UIDataSingleton.h"
@@ -17,11 +16,9 @@
 
 namespace UISystem
 {
-    void CalculateVertices(const vec2& pos, const vec2& size, const UI::FBox& texCoords, std::vector<UISystem::UIVertex>& vertices)
+    void CalculateVertices(const vec2& pos, const vec2& size, const UI::FBox& texCoords, UI::UIVertex* vertices)
     {
         const UISingleton::UIDataSingleton& dataSingleton = ServiceLocator::GetUIRegistry()->ctx<UISingleton::UIDataSingleton>();
-        vertices.clear();
-        vertices.reserve(4);
 
         vec2 upperLeftPos = vec2(pos.x, pos.y);
         vec2 upperRightPos = vec2(pos.x + size.x, pos.y);
@@ -36,19 +33,19 @@ namespace UISystem
         lowerRightPos /= dataSingleton.UIRESOLUTION;
 
         // UI Vertices
-        UISystem::UIVertex& upperLeft = vertices.emplace_back();
+        UI::UIVertex& upperLeft = vertices[0];
         upperLeft.pos = vec2(upperLeftPos.x, 1.0f - upperLeftPos.y);
         upperLeft.uv = vec2(texCoords.left, texCoords.top);
 
-        UISystem::UIVertex& upperRight = vertices.emplace_back();
+        UI::UIVertex& upperRight = vertices[1];
         upperRight.pos = vec2(upperRightPos.x, 1.0f - upperRightPos.y);
         upperRight.uv = vec2(texCoords.right, texCoords.top);
 
-        UISystem::UIVertex& lowerLeft = vertices.emplace_back();
+        UI::UIVertex& lowerLeft = vertices[2];
         lowerLeft.pos = vec2(lowerLeftPos.x, 1.0f - lowerLeftPos.y);
         lowerLeft.uv = vec2(texCoords.left, texCoords.bottom);
 
-        UISystem::UIVertex& lowerRight = vertices.emplace_back();
+        UI::UIVertex& lowerRight = vertices[3];
         lowerRight.pos = vec2(lowerRightPos.x, 1.0f - lowerRightPos.y);
         lowerRight.uv = vec2(texCoords.right, texCoords.bottom);
     }
@@ -73,53 +70,33 @@ namespace UISystem
 
             {
                 ZoneScopedNC("(Re)load Texture", tracy::Color::RoyalBlue);
-                image.textureID = renderer->LoadTexture(Renderer::TextureDesc{ image.style.texture });
+                Renderer::TextureDesc textureDesc{ image.style.texture };
+                image.textureID = renderer->LoadTextureIntoArray(textureDesc, dataSingleton.imageTextureArray, image.textureIndex);
             }
 
             if (!image.style.border.empty())
             {
                 ZoneScopedNC("(Re)load Border", tracy::Color::RoyalBlue);
-                image.borderID = renderer->LoadTexture(Renderer::TextureDesc{ image.style.border });
+                Renderer::TextureDesc borderDesc{ image.style.border };
+                image.borderID = renderer->LoadTextureIntoArray(borderDesc, dataSingleton.imageTextureArray, image.constants.borderIndex);
             }
-
-            // Create constant buffer if necessary
-            auto constantBuffer = image.constantBuffer;
-            if (constantBuffer == nullptr)
+            else
             {
-                constantBuffer = new Renderer::Buffer<UIComponent::Image::ImageConstantBuffer>(renderer, "UpdateElementSystemConstantBuffer", Renderer::BufferUsage::UNIFORM_BUFFER, Renderer::BufferCPUAccess::WriteOnly);
-                image.constantBuffer = constantBuffer;
+                image.constants.borderIndex = dataSingleton.emptyBorderIndex;
             }
-            constantBuffer->resource.color = image.style.color;
-            constantBuffer->resource.borderSize = image.style.borderSize;
-            constantBuffer->resource.borderInset = image.style.borderInset;
-            constantBuffer->resource.slicingOffset = image.style.slicingOffset;
-            constantBuffer->resource.size = transform.size;
-            constantBuffer->ApplyAll();
+
+            image.constants.color = image.style.color;
+            image.constants.borderSize = image.style.borderSize;
+            image.constants.borderInset = image.style.borderInset;
+            image.constants.slicingOffset = image.style.slicingOffset;
+            image.constants.size = transform.size;
 
             // Transform Updates.
             const vec2& pos = UIUtils::Transform::GetMinBounds(&transform);
             const vec2& size = transform.size;
             const UI::FBox& texCoords = image.style.texCoord;
 
-            std::vector<UISystem::UIVertex> vertices;
-            CalculateVertices(pos, size, texCoords, vertices);
-
-            static const u32 bufferSize = sizeof(UISystem::UIVertex) * 4; // 4 vertices per image
-
-            if (image.vertexBufferID == Renderer::BufferID::Invalid())
-            {
-                Renderer::BufferDesc desc;
-                desc.name = "ImageVertices";
-                desc.size = bufferSize;
-                desc.usage = Renderer::BufferUsage::UNIFORM_BUFFER;
-                desc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-                image.vertexBufferID = renderer->CreateBuffer(desc);
-            }
-
-            void* dst = renderer->MapBuffer(image.vertexBufferID);
-            memcpy(dst, vertices.data(), bufferSize);
-            renderer->UnmapBuffer(image.vertexBufferID);
+            CalculateVertices(pos, size, texCoords, image.vertices);
         });
 
         auto textView = registry.view<UIComponent::Transform, UIComponent::Text, UIComponent::Dirty>();
@@ -134,109 +111,42 @@ namespace UISystem
                 text.font = Renderer::Font::GetFont(renderer, text.style.fontPath, text.style.fontSize);
             }
 
-            std::vector<f32> lineWidths;
-            std::vector<size_t> lineBreakPoints;
-            size_t finalCharacter = UIUtils::Text::CalculateLineWidthsAndBreaks(&text, transform.size.x, transform.size.y, lineWidths, lineBreakPoints);
+            const u32 maxLines = UIUtils::Text::GetMaxLines(&text, transform.size.y);
+            text.layout = UIUtils::Text::GetLayout(&text, text.pushback, transform.size.x, maxLines);
+            const UI::TextLayout& layout = *text.layout;
 
-            size_t textLengthWithoutSpaces = std::count_if(text.text.begin() + text.pushback, text.text.end() - (text.text.length() - finalCharacter), [](char c) { return !std::isspace(c); });
+            text.glyphCount = layout.glyphs.size();
+            text.vertices.resize(text.glyphCount * 4); // 4 vertices per glyph
+            text.glyphTextureIndices.resize(text.glyphCount);
 
-            // If textLengthWithoutSpaces is bigger than the amount of glyphs we allocated in our buffer we need to reallocate the buffer
-            static const u32 perGlyphVertexSize = sizeof(UISystem::UIVertex) * 4; // 4 vertices per glyph
-            if (textLengthWithoutSpaces > text.vertexBufferGlyphCount)
+            if (text.glyphCount > 0)
             {
-                if (text.vertexBufferID != Renderer::BufferID::Invalid())
-                {
-                    renderer->QueueDestroyBuffer(text.vertexBufferID);
-                }
-                if (text.textureIDBufferID != Renderer::BufferID::Invalid())
-                {
-                    renderer->QueueDestroyBuffer(text.textureIDBufferID);
-                }
+                const vec2 alignment = UIUtils::Text::GetAlignment(&text);
+                const vec2 origin = UIUtils::Transform::GetAnchorPositionInElement(&transform, alignment);
+                const f32 lineHeight = text.style.fontSize * text.style.lineHeightMultiplier;
 
-                Renderer::BufferDesc vertexBufferDesc;
-                vertexBufferDesc.name = "TextView";
-                vertexBufferDesc.size = textLengthWithoutSpaces * perGlyphVertexSize;
-                vertexBufferDesc.usage = Renderer::BufferUsage::STORAGE_BUFFER;
-                vertexBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
+                vec2 linePosition = origin;
+                linePosition.y += text.style.fontSize * (1 - alignment.y) * layout.lines.size();
 
-                text.vertexBufferID = renderer->CreateBuffer(vertexBufferDesc);
-
-                Renderer::BufferDesc textureIDBufferDesc;
-                textureIDBufferDesc.name = "TexturesIDs";
-                textureIDBufferDesc.size = textLengthWithoutSpaces * sizeof(u32); // 1 u32 per glyph
-                textureIDBufferDesc.usage = Renderer::BufferUsage::STORAGE_BUFFER;
-                textureIDBufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
-
-                text.textureIDBufferID = renderer->CreateBuffer(textureIDBufferDesc);
-
-                text.vertexBufferGlyphCount = textLengthWithoutSpaces;
-            }
-            text.glyphCount = textLengthWithoutSpaces;
-
-            if (textLengthWithoutSpaces > 0)
-            {
-                vec2 alignment = UIUtils::Text::GetAlignment(&text);
-                vec2 currentPosition = UIUtils::Transform::GetAnchorPositionInElement(&transform, alignment);
-                f32 startX = currentPosition.x;
-                currentPosition.x -= lineWidths[0] * alignment.x;
-                currentPosition.y += text.style.fontSize * (1 - alignment.y) * lineWidths.size();
-
-                std::vector<UISystem::UIVertex> vertices;
-
-                UISystem::UIVertex* baseVertices = reinterpret_cast<UISystem::UIVertex*>(renderer->MapBuffer(text.vertexBufferID));
-                u32* baseTextureID = reinterpret_cast<u32*>(renderer->MapBuffer(text.textureIDBufferID));
-
-                size_t currentLine = 0;
-                size_t glyph = 0;
-                for (size_t i = text.pushback; i < finalCharacter; i++)
+                for (const UI::TextLayoutLine& line : layout.lines)
                 {
-                    const char character = text.text[i];
-                    if (currentLine < lineBreakPoints.size() && lineBreakPoints[currentLine] == i)
-                    {
-                        currentLine++;
-                        currentPosition.y += text.style.fontSize * text.style.lineHeightMultiplier;
-                        currentPosition.x = startX - lineWidths[currentLine] * alignment.x;
-                    }
+                    linePosition.x = origin.x - line.width * alignment.x;
 
-                    if (character == '\n')
+                    for (u32 i = line.firstGlyph; i < line.firstGlyph + line.glyphCount; i++)
                     {
-                        continue;
-                    }
-                    else if (std::isspace(character))
-                    {
-                        currentPosition.x += text.style.fontSize * 0.15f;
-                        continue;
-                    }
-
-                    const Renderer::FontChar& fontChar = text.font->GetChar(character);
-                    const vec2& pos = currentPosition + vec2(fontChar.xOffset, fontChar.yOffset);
-                    const vec2& size = vec2(fontChar.width, fontChar.height);
-                    UI::FBox texCoords{ 0.f, 1.f, 1.f, 0.f };
-
-                    vertices.clear();
-                    CalculateVertices(pos, size, texCoords, vertices);
+                        const UI::TextLayoutGlyph& glyph = layout.glyphs[i];
 
-                    UISystem::UIVertex* dst = &baseVertices[glyph * 4]; // 4 vertices per glyph
-                    memcpy(dst, vertices.data(), perGlyphVertexSize);
-                    baseTextureID[glyph] = fontChar.textureIndex;
+                        CalculateVertices(linePosition + glyph.offset, glyph.size, glyph.texCoords, &text.vertices[i * 4]);
+                        text.glyphTextureIndices[i] = glyph.textureIndex;
+                    }
 
-                    currentPosition.x += fontChar.advance;
-                    glyph++;
+                    linePosition.y += lineHeight;
                 }
-
-                renderer->UnmapBuffer(text.vertexBufferID);
-                renderer->UnmapBuffer(text.textureIDBufferID);
             }
 
-            // Create constant buffer if necessary
-            if (!text.constantBuffer)
-                text.constantBuffer = new Renderer::Buffer<UIComponent::Text::TextConstantBuffer>(renderer, "UpdateElementSystemConstantBuffer", Renderer::BufferUsage::UNIFORM_BUFFER, Renderer::BufferCPUAccess::WriteOnly);
-
-            text.constantBuffer->resource.textColor = text.style.color;
-            text.constantBuffer->resource.outlineColor = text.style.outlineColor;
-            text.constantBuffer->resource.outlineWidth = text.style.outlineWidth;
-            text.constantBuffer->Apply(0);
-            text.constantBuffer->Apply(1);
+            text.constants.textColor = text.style.color;
+            text.constants.outlineColor = text.style.outlineColor;
+            text.constants.outlineWidth = text.style.outlineWidth;
         });
     }
 }
\ No newline at end of file
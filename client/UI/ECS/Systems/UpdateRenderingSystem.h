@@ -3,12 +3,6 @@
 
 namespace UISystem
 {
-    struct UIVertex
-    {
-        vec2 pos;
-        vec2 uv;
-    };
-
     class UpdateRenderingSystem
     {
     public:
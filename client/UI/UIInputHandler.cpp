@@ -143,7 +143,7 @@ namespace UIInput
 
             UIUtils::MarkDirty(registry, dataSingleton.draggedWidget);
             UIUtils::MarkChildrenDirty(registry, dataSingleton.draggedWidget);
-            UIUtils::Transform::UpdateChildPositions(registry, dataSingleton.draggedWidget);
+            UIUtils::Transform::MarkLayoutDirty(registry, dataSingleton.draggedWidget);
             UIUtils::Collision::MarkBoundsDirty(registry, dataSingleton.draggedWidget);
         }
 
@@ -232,7 +232,7 @@ namespace UIInput
         if (elementInfo.type == UI::ElementType::UITYPE_INPUTFIELD)
         {
             UIScripting::InputField* inputField = reinterpret_cast<UIScripting::InputField*>(elementInfo.scriptingObject);
-            inputField->HandleCharInput((char)unicodeKey);
+            inputField->HandleCharInput(unicodeKey);
             inputField->MarkSelfDirty();
         }
 
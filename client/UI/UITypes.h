@@ -81,4 +81,11 @@ namespace UI
 
         f32 lineHeightMultiplier = 1.15f;
     };
+
+    // Positions are in UV space, flipped so 0 is the bottom of the screen
+    struct UIVertex
+    {
+        vec2 pos;
+        vec2 uv;
+    };
 }
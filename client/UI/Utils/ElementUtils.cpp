@@ -34,6 +34,8 @@ namespace UIUtils
         dataSingleton->focusedWidget = entt::null;
         dataSingleton->hoveredWidget = entt::null;
         dataSingleton->draggedWidget = entt::null;
+
+        UIUtils::Transform::MarkHierarchyDirty(registry);
     }
 
     void MarkChildrenDirty(entt::registry* registry, const entt::entity entityId)
@@ -69,5 +71,6 @@ namespace UIUtils
         childTransform.anchorPosition = UIUtils::Transform::GetAnchorPositionOnScreen(childTransform.anchor);
 
         parentRelation.children.erase(std::remove_if(parentRelation.children.begin(), parentRelation.children.end(), [child](UI::UIChild& uiChild) { return uiChild.entId == child; }), parentRelation.children.end());
+        UIUtils::Transform::MarkHierarchyDirty(registry);
     }
 }
\ No newline at end of file
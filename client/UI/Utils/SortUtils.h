@@ -5,13 +5,5 @@
 
 namespace UIUtils::Sort
 {
-    /*
-    *   Recursively updates depths of children changing it by modifier.
-    *   registry: Pointer to UI Registry.
-    *   transform: Transform from which to start update.
-    *   modifer: amount to modify depth by.
-    */
-    void UpdateChildDepths(entt::registry* registry, entt::entity parent, u32& compoundDepth);
-
     void MarkSortTreeDirty(entt::registry* registry, entt::entity entity);
 };
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "TextUtils.h"
+#include <Utils/XXHash64.h>
+#include <robin_hood.h>
 #include <tracy/Tracy.hpp>
+#include <limits>
+#include <mutex>
 
 namespace UIUtils::Text
 {
@@ -21,16 +25,18 @@ namespace UIUtils::Text
         if (text->text.length() == 0)
             return 0;
 
-        auto GetAdvance = [&](char c) { return std::isspace(c) ? text->style.fontSize * 0.15f : text->font->GetChar(c).advance; };
+        std::shared_ptr<const Renderer::ShapedText> shapedText = text->font->Shape(text->text);
+        const Renderer::ShapedText& glyphs = *shapedText;
 
         size_t oldPushback = Math::Min(text->pushback, text->text.length() - 1);
-        size_t finalCharacter = oldPushback;
+        size_t glyph = GetGlyphAtByte(glyphs, oldPushback);
+        oldPushback = GetGlyphByte(text, glyphs, glyph);
 
         f32 lineLength = 0.f;
         bool overflowed = false;
-        for (; finalCharacter < text->text.length(); finalCharacter++)
+        for (; glyph < glyphs.size(); glyph++)
         {
-            lineLength += GetAdvance(text->text[finalCharacter]);
+            lineLength += glyphs[glyph].advance;
 
             if (lineLength >= maxWidth)
             {
@@ -38,6 +44,7 @@ namespace UIUtils::Text
                 break;
             }
         }
+        const size_t finalCharacter = GetGlyphByte(text, glyphs, glyph);
 
         if (writeHead >= oldPushback && (!overflowed || writeHead <= finalCharacter))
             return oldPushback;
@@ -46,12 +53,16 @@ namespace UIUtils::Text
         const f32 bufferSpace = maxWidth * (overflowed ? 1.f - bufferDecimal : bufferDecimal);
         lineLength = 0.f;
 
-        for (size_t i = writeHead - 1; i > 0; --i)
+        const size_t writeHeadGlyph = GetGlyphAtByte(glyphs, writeHead);
+        if (writeHeadGlyph == 0)
+            return 0;
+
+        for (size_t i = writeHeadGlyph - 1; i > 0; --i)
         {
-            lineLength += GetAdvance(text->text[i]);
+            lineLength += glyphs[i].advance;
 
             if (lineLength > bufferSpace)
-                return i + 1;
+                return GetGlyphByte(text, glyphs, i + 1);
         }
 
         return 0;
@@ -86,134 +97,225 @@ namespace UIUtils::Text
         return lineBreakPoints[pushbackLine];
     }
     
-    size_t CalculateLineWidthsAndBreaks(const UIComponent::Text* text, f32 maxWidth, f32 maxHeight, std::vector<f32>& lineWidths, std::vector<size_t>& lineBreakPoints)
+    constexpr size_t MAX_LAYOUT_CACHE_ENTRIES = 1024;
+    static std::mutex _layoutCacheMutex;
+    static robin_hood::unordered_map<u64, std::shared_ptr<const UI::TextLayout>> _layoutCache;
+
+    struct LayoutKey
+    {
+        u64 font;
+        u64 textHash;
+        u64 startByte;
+        f32 fontSize;
+        f32 maxWidth;
+        u32 maxLines;
+        u32 padding = 0;
+    };
+
+    // Wraps glyphs into lines from firstGlyph onwards, every line starts from a clean state so layout can resume at any line
+    void LayoutLines(UI::TextLayout& layout, const Renderer::ShapedText& glyphs, size_t firstGlyph)
     {
         ZoneScoped;
-        assert(text->font);
 
-        if (text->text.length() == 0)
-            return 0;
-
-        lineWidths.clear();
-        lineWidths.push_back(0);
-        lineBreakPoints.clear();
+        const auto GetByte = [&](size_t glyph) { return glyph < glyphs.size() ? glyphs[glyph].byteIndex : layout.text.length(); };
 
-        const u32 MaxLines = static_cast<u32>(text->multiline ? maxHeight / (text->style.fontSize * text->style.lineHeightMultiplier) : 1);
-        size_t wordStart = 0;
+        size_t wordStart = firstGlyph;
+        u32 wordFirstGlyph = static_cast<u32>(layout.glyphs.size());
+        f32 wordStartX = 0.f;
         f32 wordWidth = 0.f;
-        f32 advance = 0.f;
 
-        const auto IsLastLine = [&]() { return lineWidths.size() == MaxLines; };
-        const auto BreakWord = [&](size_t i)
+        const auto BeginLine = [&](size_t glyph)
+        {
+            UI::TextLayoutLine& line = layout.lines.emplace_back();
+            line.firstByte = GetByte(glyph);
+            line.firstGlyph = static_cast<u32>(layout.glyphs.size());
+
+            wordStart = glyph;
+            wordFirstGlyph = line.firstGlyph;
+            wordStartX = 0.f;
+            wordWidth = 0.f;
+        };
+        const auto BreakWord = [&](size_t glyph)
         {
-            wordStart = i + 1;
+            wordStart = glyph + 1;
+            wordFirstGlyph = static_cast<u32>(layout.glyphs.size());
+            wordStartX = layout.lines.back().width;
             wordWidth = 0.f;
         };
-        const auto BreakLine = [&](size_t i)
+        const auto EndLayout = [&](size_t glyph)
         {
-            lineWidths.push_back(0);
-            lineBreakPoints.push_back(i);
+            UI::TextLayoutLine& line = layout.lines.back();
+            line.glyphCount = static_cast<u32>(layout.glyphs.size()) - line.firstGlyph;
+            layout.endByte = GetByte(glyph);
         };
 
-        for (size_t i = text->pushback; i < text->text.length(); i++)
+        BeginLine(firstGlyph);
+        for (size_t i = firstGlyph; i < glyphs.size(); i++)
         {
-            if (text->text[i] == '\n')
+            const Renderer::ShapedGlyph& glyph = glyphs[i];
+            const bool isLastLine = layout.lines.size() >= layout.maxLines;
+
+            // The newline ends its line, so the next line starts clean after it
+            if (glyph.codepoint == '\n')
             {
-                if (IsLastLine())
-                    return i;
+                if (isLastLine)
+                    return EndLayout(i);
 
-                BreakWord(i);
-                BreakLine(i);
+                UI::TextLayoutLine& line = layout.lines.back();
+                line.glyphCount = static_cast<u32>(layout.glyphs.size()) - line.firstGlyph;
+                BeginLine(i + 1);
                 continue;
             }
 
-            if (std::isspace(text->text[i]))
+            UI::TextLayoutLine* line = &layout.lines.back();
+            // A glyph wider than the box still goes on its own line rather than leaving an empty one behind
+            if (line->width + glyph.advance > layout.maxWidth && line->firstByte != glyph.byteIndex)
             {
-                advance = text->style.fontSize * 0.15f;
-                BreakWord(i);
-            }
-            else
-            {
-                advance = text->font->GetChar(text->text[i]).advance;
-                wordWidth += advance;
-            }
+                if (isLastLine)
+                    return EndLayout(i);
 
-            if (lineWidths.back() + advance > maxWidth)
-            {
-                if (IsLastLine())
-                    return i;
+                if (glyph.isWhitespace)
+                {
+                    // Trailing whitespace hangs off the end of the line
+                    line->glyphCount = static_cast<u32>(layout.glyphs.size()) - line->firstGlyph;
+                    BeginLine(i + 1);
+                    continue;
+                }
 
-                if (wordWidth > maxWidth)
-                    BreakLine(i);
+                if (wordStart == i || GetByte(wordStart) == line->firstByte || wordWidth + glyph.advance > layout.maxWidth)
+                {
+                    // The word doesn't fit on a line of its own, cut it here
+                    line->glyphCount = static_cast<u32>(layout.glyphs.size()) - line->firstGlyph;
+                    BeginLine(i);
+                }
                 else
                 {
-                    BreakLine(wordStart);
-                    advance = wordWidth;
+                    // Move the started word down to a new line
+                    const u32 movedFirstGlyph = wordFirstGlyph;
+                    const f32 movedStartX = wordStartX;
+                    const f32 movedWidth = wordWidth;
+
+                    line->glyphCount = movedFirstGlyph - line->firstGlyph;
+                    line->width = movedStartX;
+
+                    UI::TextLayoutLine& newLine = layout.lines.emplace_back();
+                    newLine.firstByte = GetByte(wordStart);
+                    newLine.firstGlyph = movedFirstGlyph;
+                    newLine.width = movedWidth;
+
+                    for (size_t j = movedFirstGlyph; j < layout.glyphs.size(); j++)
+                    {
+                        layout.glyphs[j].offset.x -= movedStartX;
+                    }
+                    wordStartX = 0.f;
                 }
+                line = &layout.lines.back();
             }
 
-            lineWidths.back() += advance;
+            if (glyph.isWhitespace)
+            {
+                line->width += glyph.advance;
+                BreakWord(i);
+                continue;
+            }
+
+            const Renderer::FontChar fontChar = layout.font->GetChar(glyph.codepoint);
+
+            UI::TextLayoutGlyph& layoutGlyph = layout.glyphs.emplace_back();
+            layoutGlyph.offset = vec2(line->width + fontChar.xOffset, fontChar.yOffset);
+            layoutGlyph.size = vec2(fontChar.width, fontChar.height);
+            layoutGlyph.texCoords = UI::FBox{ fontChar.uvMin.y, fontChar.uvMax.x, fontChar.uvMax.y, fontChar.uvMin.x };
+            layoutGlyph.textureIndex = fontChar.textureIndex;
+
+            line->width += glyph.advance;
+            wordWidth += glyph.advance;
         }
 
-        return text->text.length();
+        EndLayout(glyphs.size());
     }
 
-    void CalculateAllLineWidthsAndBreaks(const UIComponent::Text* text, f32 maxWidth, std::vector<f32>& lineWidths, std::vector<size_t>& lineBreakPoints)
+    std::shared_ptr<const UI::TextLayout> GetLayout(const UIComponent::Text* text, size_t startByte, f32 maxWidth, u32 maxLines)
     {
         ZoneScoped;
         assert(text->font);
 
-        lineWidths.clear();
-        lineWidths.push_back(0);
-        lineBreakPoints.clear();
-        size_t wordStart = 0;
-        f32 wordWidth = 0.f;
-        f32 advance = 0.f;
+        LayoutKey key;
+        key.font = reinterpret_cast<u64>(text->font);
+        key.textHash = XXHash64::hash(text->text.data(), text->text.size(), 0);
+        key.startByte = startByte;
+        key.fontSize = text->style.fontSize;
+        key.maxWidth = maxWidth;
+        key.maxLines = maxLines;
+        const u64 hash = XXHash64::hash(&key, sizeof(LayoutKey), 0);
 
-        const auto BreakWord = [&](size_t i)
         {
-            wordStart = i + 1;
-            wordWidth = 0.f;
-        };
-        const auto BreakLine = [&](size_t i)
-        {
-            lineWidths.push_back(0);
-            lineBreakPoints.push_back(i);
-        };
+            std::lock_guard lock(_layoutCacheMutex);
+
+            auto itr = _layoutCache.find(hash);
+            if (itr != _layoutCache.end() && itr->second->text == text->text)
+                return itr->second;
+        }
+
+        std::shared_ptr<const Renderer::ShapedText> shapedText = text->font->Shape(text->text);
+        const Renderer::ShapedText& glyphs = *shapedText;
+
+        std::shared_ptr<UI::TextLayout> layout = std::make_shared<UI::TextLayout>();
+        layout->text = text->text;
+        layout->font = text->font;
+        layout->maxWidth = maxWidth;
+        layout->maxLines = maxLines;
+        layout->startByte = Math::Min(startByte, text->text.length());
 
-        for (size_t i = 0; i < text->text.length(); i++)
+        size_t firstGlyph = GetGlyphAtByte(glyphs, layout->startByte);
+
+        // Keep every line that ends before the edit, the line in front of the edited one is redone too since a shorter word can pull back onto it
+        const UI::TextLayout* previous = text->layout.get();
+        if (previous && previous->font == layout->font && previous->maxWidth == maxWidth && previous->maxLines == maxLines && previous->startByte == layout->startByte)
         {
-            if (text->text[i] == '\n')
-            {
-                BreakWord(i);
-                BreakLine(i);
-                continue;
-            }
+            const size_t changedByte = std::distance(previous->text.begin(), std::mismatch(previous->text.begin(), previous->text.end(), text->text.begin(), text->text.end()).first);
 
-            if (std::isspace(text->text[i]))
+            size_t keptLines = 0;
+            while (keptLines < previous->lines.size() && previous->lines[keptLines].firstByte <= changedByte)
             {
-                advance = text->style.fontSize * 0.15f;
-                BreakWord(i);
-            }
-            else
-            {
-                advance = text->font->GetChar(text->text[i]).advance;
-                wordWidth += advance;
+                keptLines++;
             }
+            keptLines = keptLines >= 2 ? keptLines - 2 : 0;
 
-            if (lineWidths.back() + advance > maxWidth)
+            if (keptLines > 0)
             {
+                const UI::TextLayoutLine& resumeLine = previous->lines[keptLines];
 
-                if (wordWidth > maxWidth)
-                    BreakLine(i);
-                else
-                {
-                    BreakLine(wordStart);
-                    advance = wordWidth;
-                }
+                layout->lines.assign(previous->lines.begin(), previous->lines.begin() + keptLines);
+                layout->glyphs.assign(previous->glyphs.begin(), previous->glyphs.begin() + resumeLine.firstGlyph);
+                firstGlyph = GetGlyphAtByte(glyphs, resumeLine.firstByte);
             }
+        }
+
+        LayoutLines(*layout, glyphs, firstGlyph);
+
+        std::lock_guard lock(_layoutCacheMutex);
+        if (_layoutCache.size() >= MAX_LAYOUT_CACHE_ENTRIES)
+            _layoutCache.clear();
+
+        _layoutCache[hash] = layout;
+        return layout;
+    }
+
+    void CalculateAllLineWidthsAndBreaks(const UIComponent::Text* text, f32 maxWidth, std::vector<f32>& lineWidths, std::vector<size_t>& lineBreakPoints)
+    {
+        ZoneScoped;
+        assert(text->font);
+
+        std::shared_ptr<const UI::TextLayout> layout = GetLayout(text, 0, maxWidth, std::numeric_limits<u32>::max());
+
+        lineWidths.clear();
+        lineBreakPoints.clear();
+        for (size_t i = 0; i < layout->lines.size(); i++)
+        {
+            if (i > 0)
+                lineBreakPoints.push_back(layout->lines[i].firstByte);
 
-            lineWidths.back() += advance;
+            lineWidths.push_back(layout->lines[i].width);
         }
     }
 }
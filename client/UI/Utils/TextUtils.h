@@ -1,6 +1,7 @@
 #pragma once
 #include <NovusTypes.h>
 #include "../ECS/Components/Text.h"
+#include <algorithm>
 
 namespace UIUtils::Text
 {
@@ -41,6 +42,21 @@ namespace UIUtils::Text
         return vec2(GetHorizontalAlignment(text->horizontalAlignment), GetVerticalAlignment(text->verticalAlignment));
     }
 
+    /*
+    *   Index of the first shaped glyph starting at or after byteIndex, glyphs.size() if there is none.
+    */
+    inline static size_t GetGlyphAtByte(const Renderer::ShapedText& glyphs, size_t byteIndex)
+    {
+        auto it = std::lower_bound(glyphs.begin(), glyphs.end(), byteIndex, [](const Renderer::ShapedGlyph& glyph, size_t index) { return glyph.byteIndex < index; });
+        return std::distance(glyphs.begin(), it);
+    }
+
+    // Byte offset of a shaped glyph, one past the last glyph maps to the end of the text
+    inline static size_t GetGlyphByte(const UIComponent::Text* text, const Renderer::ShapedText& glyphs, size_t glyphIndex)
+    {
+        return glyphIndex < glyphs.size() ? glyphs[glyphIndex].byteIndex : text->text.length();
+    }
+
     /*
     *   Calculate Pushback index.
     *   text: Text to calculate pushback for.
@@ -54,15 +70,24 @@ namespace UIUtils::Text
     size_t CalculateMultilinePushback(const UIComponent::Text* text, const size_t writeHead, const f32 maxWidth, const f32 maxHeight);
 
 
+    inline static u32 GetMaxLines(const UIComponent::Text* text, f32 maxHeight)
+    {
+        if (!text->multiline)
+            return 1;
+
+        return Math::Max(static_cast<u32>(maxHeight / (text->style.fontSize * text->style.lineHeightMultiplier)), 1u);
+    }
+
     /*
-    *   Calculate Line Widths & Line Break points from pushback.
-    *   text: Text to calculate for.
+    *   Get the wrapped layout of a text, cached by font, string, start and box so unchanged texts are free.
+    *   A miss re-lays out from the first changed line of text->layout when that was built for the same box.
+    *   text: Text to lay out.
+    *   startByte: Byte to start laying out from, usually the pushback.
     *   maxWidth: Max width of a line.
-    *   maxHeight: Max heights of all lines summed.
-    *   lineWidths: Calculated line widths.
-    *   lineBreakPoints: Calculated line breakpoints.
+    *   maxLines: Max number of lines, the layout ends where the last line overflows.
     */
-    size_t CalculateLineWidthsAndBreaks(const UIComponent::Text* text, f32 maxWidth, f32 maxHeight, std::vector<f32>& lineWidths, std::vector<size_t>& lineBreakPoints);
+    std::shared_ptr<const UI::TextLayout> GetLayout(const UIComponent::Text* text, size_t startByte, f32 maxWidth, u32 maxLines);
+
     /*
     *   Calculate Line Widths & Line Break points indepentent from pushback.
     */
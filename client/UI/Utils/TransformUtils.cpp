@@ -7,7 +7,8 @@
 #include "entity/registry.hpp"
 
 #include "../ECS/Components/Singletons/UIDataSingleton.h"
-#include "../ECS/Components/Relation.h"
+#include "../ECS/Components/Singletons/UIHierarchySingleton.h"
+#include "../ECS/Components/LayoutDirty.h"
 
 namespace UIUtils::Transform
 {
@@ -28,47 +29,14 @@ namespace UIUtils::Transform
         return uiResolution * anchorPosition;
     }
 
-    void UpdateChildTransforms(entt::registry* registry, entt::entity entity)
+    void MarkLayoutDirty(entt::registry* registry, entt::entity entity)
     {
-        auto [transform, relation] = registry->get<UIComponent::Transform, UIComponent::Relation>(entity);
-
-        if (!relation.children.size())
-            return;
-        
-        const hvec2 minAnchorBound = GetMinBounds(&transform) + hvec2(transform.padding.left, transform.padding.top);
-        const hvec2 adjustedSize = transform.size - hvec2(transform.padding.right, transform.padding.bottom);
-
-        for (const UI::UIChild& child : relation.children)
-        {
-            UIComponent::Transform* childTransform = &registry->get<UIComponent::Transform>(child.entId);
-
-            childTransform->anchorPosition = minAnchorBound + adjustedSize * childTransform->anchor;
-            if (childTransform->HasFlag(UI::TransformFlags::FILL_PARENTSIZE))
-                childTransform->size = transform.size;
-
-            UpdateChildTransforms(registry, child.entId);
-        }
+        if (!registry->has<UIComponent::LayoutDirty>(entity))
+            registry->emplace<UIComponent::LayoutDirty>(entity);
     }
 
-    void UpdateChildPositions(entt::registry* registry, entt::entity entity)
+    void MarkHierarchyDirty(entt::registry* registry)
     {
-        auto [transform, relation] = registry->get<UIComponent::Transform, UIComponent::Relation>(entity);
-
-        if (!relation.children.size())
-            return;
-
-        const hvec2 minAnchorBound = GetMinBounds(&transform) + hvec2(transform.padding.left, transform.padding.top);
-        const hvec2 adjustedSize = transform.size - hvec2(transform.padding.right, transform.padding.bottom);
-
-        for (const UI::UIChild& child : relation.children)
-        {
-            UIComponent::Transform* childTransform = &registry->get<UIComponent::Transform>(child.entId);
-            childTransform->anchorPosition = minAnchorBound + adjustedSize * childTransform->anchor;
-        }
-
-        for (const UI::UIChild& child : relation.children)
-        {
-            UpdateChildPositions(registry, child.entId);
-        }
+        registry->ctx<UISingleton::UIHierarchySingleton>().isDirty = true;
     }
 }
\ No newline at end of file
@@ -42,7 +42,16 @@ namespace UIUtils::Transform
 
     hvec2 GetAnchorPositionOnScreen(hvec2 anchorPosition);
 
-    void UpdateChildTransforms(entt::registry* registry, entt::entity entity);
-
-    void UpdateChildPositions(entt::registry* registry, entt::entity entity);
+    /*
+    *   Queues the children of entity to be re-anchored (and resized if filling their parent) by the next layout pass.
+    *   registry: Pointer to UI Registry.
+    *   entity: Element whose transform changed.
+    */
+    void MarkLayoutDirty(entt::registry* registry, entt::entity entity);
+
+    /*
+    *   Flags the flattened hierarchy for a rebuild, call whenever elements are created, destroyed or reparented.
+    *   registry: Pointer to UI Registry.
+    */
+    void MarkHierarchyDirty(entt::registry* registry);
 };
\ No newline at end of file
@@ -50,6 +50,8 @@ namespace UIScripting
             collision->SetFlag(UI::CollisionFlags::COLLISION);
             registry->emplace<UIComponent::Collidable>(_entityId);
         }
+
+        UIUtils::Transform::MarkHierarchyDirty(registry);
     }
 
     vec2 BaseElement::GetScreenPosition() const
@@ -69,7 +71,7 @@ namespace UIScripting
 
         transform->position = position;
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkLayoutDirty(registry, _entityId);
     }
 
     vec2 BaseElement::GetSize() const
@@ -87,7 +89,7 @@ namespace UIScripting
             return;
         transform->size = size;
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkLayoutDirty(registry, _entityId);
     }
     bool BaseElement::GetFillParentSize() const
     {
@@ -109,7 +111,7 @@ namespace UIScripting
         auto parentTransform = &registry->get<UIComponent::Transform>(relation.parent);
         transform.size = UIUtils::Transform::GetInnerSize(parentTransform);
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkLayoutDirty(registry, _entityId);
     }
 
     void BaseElement::SetTransform(const vec2& position, const vec2& size)
@@ -121,7 +123,7 @@ namespace UIScripting
         if (!transform->HasFlag(UI::TransformFlags::FILL_PARENTSIZE))
             transform->size = size;
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkLayoutDirty(registry, _entityId);
     }
 
     vec2 BaseElement::GetAnchor() const
@@ -143,7 +145,7 @@ namespace UIScripting
         else
             transform.anchorPosition = UIUtils::Transform::GetAnchorPositionInElement(&registry->get<UIComponent::Transform>(relation.parent), anchor);
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkLayoutDirty(registry, _entityId);
     }
 
     vec2 BaseElement::GetLocalAnchor() const
@@ -160,7 +162,7 @@ namespace UIScripting
             return;
         transform->localAnchor = localAnchor;
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkLayoutDirty(registry, _entityId);
     }
 
     void BaseElement::SetPadding(f32 top, f32 right, f32 bottom, f32 left)
@@ -169,7 +171,7 @@ namespace UIScripting
         auto transform = &registry->get<UIComponent::Transform>(_entityId);
         transform->padding = UI::HBox{ f16(top), f16(right), f16(bottom), f16(left) };
 
-        UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+        UIUtils::Transform::MarkLayoutDirty(registry, _entityId);
     }
 
     UI::DepthLayer BaseElement::GetDepthLayer() const
@@ -252,9 +254,10 @@ namespace UIScripting
         sortKey.data.depthLayer = parentSortKey.data.depthLayer;
         sortKey.data.depth = parentSortKey.data.depth;
         UIUtils::Sort::MarkSortTreeDirty(registry, parent->GetEntityId());
+        UIUtils::Transform::MarkHierarchyDirty(registry);
 
         if (relation->children.size())
-            UIUtils::Transform::UpdateChildTransforms(registry, _entityId);
+            UIUtils::Transform::MarkLayoutDirty(registry, _entityId);
     }
     void BaseElement::UnsetParent()
     {
@@ -372,5 +375,6 @@ namespace UIScripting
         registry->remove<UIComponent::Root>(element->GetEntityId());
 
         registry->get<UIComponent::Relation>(_entityId).children.push_back({ element->GetEntityId(), element->GetType() });
+        UIUtils::Transform::MarkHierarchyDirty(registry);
     }
 }
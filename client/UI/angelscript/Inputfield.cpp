@@ -102,16 +102,44 @@ namespace UIScripting
         MarkSelfDirty();
     }
 
-    void InputField::HandleCharInput(const char input)
+    // The write head is a byte index into UTF-8 text, these step it over whole codepoints
+    static size_t GetPreviousCodepointStart(const std::string& text, size_t index)
+    {
+        if (index == 0)
+            return 0;
+
+        do
+        {
+            index--;
+        } while (index > 0 && (static_cast<u8>(text[index]) & 0xC0) == 0x80);
+
+        return index;
+    }
+    static size_t GetNextCodepointStart(const std::string& text, size_t index)
+    {
+        if (index >= text.length())
+            return text.length();
+
+        do
+        {
+            index++;
+        } while (index < text.length() && (static_cast<u8>(text[index]) & 0xC0) == 0x80);
+
+        return index;
+    }
+
+    void InputField::HandleCharInput(const u32 codepoint)
     {
         entt::registry* registry = ServiceLocator::GetUIRegistry();
         UIComponent::Text* text = &registry->get<UIComponent::Text>(_entityId);
         UIComponent::InputField* inputField = &registry->get<UIComponent::InputField>(_entityId);
 
-        text->text.insert(inputField->writeHeadIndex, 1, input);
+        std::string encoded;
+        Renderer::Font::EncodeUTF8(codepoint, encoded);
+        text->text.insert(inputField->writeHeadIndex, encoded);
 
-        // Move pointer one step to the right.
-        inputField->writeHeadIndex++;
+        // Move pointer past the inserted character.
+        inputField->writeHeadIndex += encoded.length();
     }
 
     void InputField::RemovePreviousCharacter()
@@ -123,8 +151,9 @@ namespace UIScripting
         if (text->text.empty() || inputField->writeHeadIndex == 0)
             return;
 
-        text->text.erase(inputField->writeHeadIndex - 1, 1);
-        inputField->writeHeadIndex--;
+        const size_t characterStart = GetPreviousCodepointStart(text->text, inputField->writeHeadIndex);
+        text->text.erase(characterStart, inputField->writeHeadIndex - characterStart);
+        inputField->writeHeadIndex = characterStart;
     }
     void InputField::RemoveNextCharacter()
     {
@@ -135,14 +164,17 @@ namespace UIScripting
         if (text->text.empty() || inputField->writeHeadIndex == 0)
             return;
 
-        text->text.erase(inputField->writeHeadIndex, 1);
+        const size_t characterEnd = GetNextCodepointStart(text->text, inputField->writeHeadIndex);
+        text->text.erase(inputField->writeHeadIndex, characterEnd - inputField->writeHeadIndex);
     }
 
     void InputField::MovePointerLeft()
     {
-        UIComponent::InputField* inputField = &ServiceLocator::GetUIRegistry()->get<UIComponent::InputField>(_entityId);
-        if (inputField->writeHeadIndex > 0)
-            inputField->writeHeadIndex--;
+        entt::registry* registry = ServiceLocator::GetUIRegistry();
+        const UIComponent::Text* text = &registry->get<UIComponent::Text>(_entityId);
+        UIComponent::InputField* inputField = &registry->get<UIComponent::InputField>(_entityId);
+
+        inputField->writeHeadIndex = GetPreviousCodepointStart(text->text, inputField->writeHeadIndex);
     }
     void InputField::MovePointerRight()
     {
@@ -150,8 +182,7 @@ namespace UIScripting
         const UIComponent::Text* text = &registry->get<UIComponent::Text>(_entityId);
         UIComponent::InputField* inputField = &registry->get<UIComponent::InputField>(_entityId);
 
-        if (inputField->writeHeadIndex < text->text.length())
-            inputField->writeHeadIndex++;
+        inputField->writeHeadIndex = GetNextCodepointStart(text->text, inputField->writeHeadIndex);
     }
     void InputField::SetWriteHeadPosition(size_t position)
     {
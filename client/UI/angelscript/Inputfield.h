@@ -18,7 +18,7 @@ namespace UIScripting
         void HandleKeyInput(i32 key);
 
         //InputField Functions
-        void HandleCharInput(const char input);
+        void HandleCharInput(const u32 codepoint);
 
         void RemovePreviousCharacter();
         void RemoveNextCharacter();
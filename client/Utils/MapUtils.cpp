@@ -2,11 +2,16 @@
 #include "../ECS/Components/Singletons/NDBCSingleton.h"
 
 #include <Utils/FileReader.h>
+#include <Utils/Timer.h>
+#include <tracy/Tracy.hpp>
 #include <filesystem>
 namespace fs = std::filesystem;
 
 bool Terrain::MapUtils::LoadMap(entt::registry* registry, const NDBC::Map* map)
 {
+    ZoneScoped;
+    Timer timer;
+
     MapSingleton& mapSingleton = registry->ctx<MapSingleton>();
     NDBCSingleton& ndbcSingleton = registry->ctx<NDBCSingleton>();
 
@@ -34,101 +39,72 @@ bool Terrain::MapUtils::LoadMap(entt::registry* registry, const NDBC::Map* map)
     currentMap.id = map->id;
     currentMap.name = mapInternalName;
 
+    // We only look at file names here, chunks are decoded when they are first requested through Map::GetChunkById
+    fs::path mapHeaderPath;
     bool nmapFound = false;
+
     for (const auto& entry : std::filesystem::recursive_directory_iterator(absolutePath))
     {
         auto file = std::filesystem::path(entry.path());
+        auto extension = file.extension();
 
-        if (file.extension() != ".nmap")
-            continue;
-
-        std::string fileName = file.filename().replace_extension("").string();
-        if (fileName != mapInternalName)
-            continue;
-
-        FileReader mapHeaderFile(entry.path().string(), file.filename().string());
-        if (!mapHeaderFile.Open())
+        if (extension == ".nmap")
         {
-            DebugHandler::PrintError("Failed to read map (%s)", mapInternalName.c_str());
-            return false;
-        }
+            std::string fileName = file.filename().replace_extension("").string();
+            if (fileName != mapInternalName)
+                continue;
 
-        if (!Terrain::MapHeader::Read(mapHeaderFile, currentMap.header))
-        {
-            DebugHandler::PrintError("Failed to load map header for (%s)", mapInternalName.c_str());
-            return false;
+            mapHeaderPath = file;
+            nmapFound = true;
         }
-
-        nmapFound = true;
-        break;
-    }
-
-    if (!nmapFound)
-    {
-        DebugHandler::PrintError("Failed to find nmap file for map (%s)", mapInternalName.c_str());
-        return false;
-    }
-
-    // Load Chunks if map does not use Map Object as base
-    if (!currentMap.header.flags.UseMapObjectInsteadOfTerrain)
-    {
-        size_t loadedChunks = 0;
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(absolutePath))
+        else if (extension == ".nchunk")
         {
-            auto file = std::filesystem::path(entry.path());
-            if (file.extension() != ".nchunk")
-                continue;
-
             // Make sure filename is the same, multiple maps can have chunks in the same folder
             std::string fileName = file.filename().string();
             if (strncmp(fileName.c_str(), mapInternalName.c_str(), mapInternalName.length()) != 0)
                 continue;
 
-            FileReader chunkFile(entry.path().string(), file.filename().string());
-            if (!chunkFile.Open())
-            {
-                DebugHandler::PrintError("Failed to load map chunk (%s)", file.filename().string().c_str());
-                return false;
-            }
-
-            Terrain::Chunk chunk;
-            StringTable chunkStringTable;
-            if (!Terrain::Chunk::Read(chunkFile, chunk, chunkStringTable))
-            {
-                DebugHandler::PrintError("Failed to load map chunk for (%s)", file.filename().string().c_str());
-                return false;
-            }
-
-            std::vector<std::string> splitName = StringUtils::SplitString(file.filename().string(), '_');
+            std::vector<std::string> splitName = StringUtils::SplitString(file.filename().replace_extension("").string(), '_');
             size_t numberOfSplits = splitName.size();
 
-            std::string mapInternalName = splitName[0];
-            for (size_t i = 1; i < numberOfSplits - 2; i++)
-            {
-                mapInternalName += "_" + splitName[i];
-            }
-
             u16 x = std::stoi(splitName[numberOfSplits - 2]);
             u16 y = std::stoi(splitName[numberOfSplits - 1]);
-            u32 chunkId = x + (y * Terrain::MAP_CHUNKS_PER_MAP_STRIDE);
+            u16 chunkId = x + (y * Terrain::MAP_CHUNKS_PER_MAP_STRIDE);
 
-            currentMap.chunks[chunkId] = chunk;
-            currentMap.stringTables[chunkId].CopyFrom(chunkStringTable);
+            currentMap.chunkPaths[chunkId] = file.string();
+        }
+    }
 
-            Terrain::MapUtils::AlignCellBorders(currentMap.chunks[chunkId]);
+    if (!nmapFound)
+    {
+        DebugHandler::PrintError("Failed to find nmap file for map (%s)", mapInternalName.c_str());
+        return false;
+    }
 
-            loadedChunks++;
-        }
+    FileReader mapHeaderFile(mapHeaderPath.string(), mapHeaderPath.filename().string());
+    if (!mapHeaderFile.Open())
+    {
+        DebugHandler::PrintError("Failed to read map (%s)", mapInternalName.c_str());
+        return false;
+    }
 
-        if (loadedChunks == 0)
-        {
-            DebugHandler::PrintError("0 map chunks found in (%s)", absolutePath.string().c_str());
-            return false;
-        }
+    if (!Terrain::MapHeader::Read(mapHeaderFile, currentMap.header))
+    {
+        DebugHandler::PrintError("Failed to load map header for (%s)", mapInternalName.c_str());
+        return false;
+    }
 
-        Terrain::MapUtils::AlignChunkBorders(currentMap);
+    // Chunks are only used if the map does not use a Map Object as base
+    if (currentMap.header.flags.UseMapObjectInsteadOfTerrain)
+    {
+        currentMap.chunkPaths.clear();
+    }
+    else if (currentMap.chunkPaths.size() == 0)
+    {
+        DebugHandler::PrintError("0 map chunks found in (%s)", absolutePath.string().c_str());
+        return false;
     }
 
-    DebugHandler::PrintSuccess("Loaded Map (%s)", mapInternalName.c_str());
+    DebugHandler::PrintSuccess("Loaded Map (%s) with %u chunks in %.2fms", mapInternalName.c_str(), static_cast<u32>(currentMap.chunkPaths.size()), timer.GetLifeTime() * 1000.0f);
     return true;
 }
\ No newline at end of file
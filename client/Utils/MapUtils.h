@@ -118,61 +118,6 @@ namespace Terrain
             }
         }
 
-        inline void AlignChunkBorders(Terrain::Map& map)
-        {
-            for (auto& chunkItr : map.chunks)
-            {
-                const u16& chunkID = chunkItr.first;
-                Terrain::Chunk& chunk = chunkItr.second;
-
-                u16 chunkX = chunkID % Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
-                u16 chunkY = chunkID / Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
-
-                u16 chunkAboveID = chunkID - Terrain::MAP_CHUNKS_PER_MAP_STRIDE;
-                u16 chunkLeftID = chunkID - 1;
-
-                bool hasChunkAbove = map.chunks.find(chunkAboveID) != map.chunks.end();
-                bool hasChunkLeft = map.chunks.find(chunkLeftID) != map.chunks.end();
-
-                if (hasChunkAbove)
-                {
-                    Terrain::Chunk& chunkAbove = map.chunks[chunkAboveID];
-                    u32 aboveStartCellID = Terrain::MAP_CELLS_PER_CHUNK - Terrain::MAP_CELLS_PER_CHUNK_SIDE;
-
-                    for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK_SIDE; i++)
-                    {
-                        Terrain::Cell& currentCell = chunk.cells[i];
-                        Terrain::Cell& aboveCell = chunkAbove.cells[aboveStartCellID + i];
-
-                        // Avoid fixing the very first height value within the cell grid (This is handled by "hasChunkLeft"
-                        for (u32 currentHeightID = 1; currentHeightID < Terrain::MAP_CELL_OUTER_GRID_STRIDE; currentHeightID++)
-                        {
-                            u32 aboveHeightID = currentHeightID + (Terrain::MAP_CELL_TOTAL_GRID_SIZE - Terrain::MAP_CELL_OUTER_GRID_STRIDE);
-                            currentCell.heightData[currentHeightID] = aboveCell.heightData[aboveHeightID];
-                        }
-                    }
-                }
-
-                if (hasChunkLeft)
-                {
-                    Terrain::Chunk& chunkLeft = map.chunks[chunkLeftID];
-                    u32 leftStartCellID = Terrain::MAP_CELLS_PER_CHUNK_SIDE - 1;
-
-                    for (u32 i = 0; i < Terrain::MAP_CELLS_PER_CHUNK; i += Terrain::MAP_CELLS_PER_CHUNK_SIDE)
-                    {
-                        Terrain::Cell& currentCell = chunk.cells[i];
-                        Terrain::Cell& leftCell = chunkLeft.cells[leftStartCellID + i];
-
-                        for (u32 currentHeightID = 0; currentHeightID < Terrain::MAP_CELL_TOTAL_GRID_SIZE; currentHeightID += Terrain::MAP_CELL_TOTAL_GRID_STRIDE)
-                        {
-                            u32 aboveHeightID = currentHeightID + (Terrain::MAP_CELL_OUTER_GRID_STRIDE - 1);
-                            currentCell.heightData[currentHeightID] = leftCell.heightData[aboveHeightID];
-                        }
-                    }
-                }
-            }
-        }
-
         inline vec2 WorldPositionToADTCoordinates(const vec3& position)
         {
             // This is translated to remap positions [-17066 .. 17066] to [0 ..  34132]
@@ -339,11 +284,11 @@ namespace Terrain
             u32 chunkId = GetChunkIdFromChunkPos(chunkPos);
 
             Terrain::Map& currentMap = mapSingleton.GetCurrentMap();
-            auto chunkItr = currentMap.chunks.find(chunkId);
-            if (chunkItr == currentMap.chunks.end())
+            Terrain::Chunk* chunk = currentMap.GetChunkById(chunkId);
+            if (chunk == nullptr)
                 return false;
 
-            Terrain::Chunk& currentChunk = chunkItr->second;
+            Terrain::Chunk& currentChunk = *chunk;
 
             vec2 cellPos = (chunkRemainder * Terrain::MAP_CHUNK_SIZE) / Terrain::MAP_CELL_SIZE;
             vec2 cellRemainder = cellPos - glm::floor(cellPos);
@@ -407,11 +352,11 @@ namespace Terrain
             u32 chunkId = GetChunkIdFromChunkPos(chunkPos);
 
             Terrain::Map& currentMap = mapSingleton.GetCurrentMap();
-            auto chunkItr = currentMap.chunks.find(chunkId);
-            if (chunkItr == currentMap.chunks.end())
+            Terrain::Chunk* chunk = currentMap.GetChunkById(chunkId);
+            if (chunk == nullptr)
                 return triangles;
 
-            Terrain::Chunk& currentChunk = chunkItr->second;
+            Terrain::Chunk& currentChunk = *chunk;
 
             vec2 cellPos = (chunkRemainder * Terrain::MAP_CHUNK_SIZE) / Terrain::MAP_CELL_SIZE;
             vec2 cellRemainder = cellPos - glm::floor(cellPos);
@@ -502,11 +447,11 @@ namespace Terrain
             u32 chunkId = GetChunkIdFromChunkPos(chunkPos);
 
             Terrain::Map& currentMap = mapSingleton.GetCurrentMap();
-            auto chunkItr = currentMap.chunks.find(chunkId);
-            if (chunkItr == currentMap.chunks.end())
+            Terrain::Chunk* chunk = currentMap.GetChunkById(chunkId);
+            if (chunk == nullptr)
                 return false;
 
-            Terrain::Chunk& currentChunk = chunkItr->second;
+            Terrain::Chunk& currentChunk = *chunk;
 
             vec2 cellPos = (chunkRemainder * Terrain::MAP_CHUNK_SIZE) / Terrain::MAP_CELL_SIZE;
             vec2 cellRemainder = cellPos - glm::floor(cellPos);
@@ -0,0 +1,118 @@
+#include "MemoryMappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+bool MemoryMappedFile::Open(const std::string& path)
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr)
+    {
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    void* data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+    {
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    _fileHandle = fileHandle;
+    _mappingHandle = mappingHandle;
+    _data = static_cast<const u8*>(data);
+    _size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    i32 fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor == -1)
+        return false;
+
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        close(fileDescriptor);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (data == MAP_FAILED)
+    {
+        close(fileDescriptor);
+        return false;
+    }
+
+    _fileDescriptor = fileDescriptor;
+    _data = static_cast<const u8*>(data);
+    _size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    return true;
+}
+
+void MemoryMappedFile::Close()
+{
+    if (_data == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(_data);
+    CloseHandle(_mappingHandle);
+    CloseHandle(_fileHandle);
+
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+#else
+    munmap(const_cast<u8*>(_data), _size);
+    close(_fileDescriptor);
+
+    _fileDescriptor = -1;
+#endif
+
+    _data = nullptr;
+    _size = 0;
+}
+
+void MemoryMappedFile::Prefetch() const
+{
+    if (_data == nullptr)
+        return;
+
+#ifndef _WIN32
+    madvise(const_cast<u8*>(_data), _size, MADV_WILLNEED);
+#endif
+
+    constexpr size_t pageSize = 4096;
+
+    u8 checksum = 0;
+    for (size_t i = 0; i < _size; i += pageSize)
+    {
+        checksum += _data[i];
+    }
+
+    // Keeps the compiler from throwing the loop away
+    volatile u8 sink = checksum;
+    (void)sink;
+}
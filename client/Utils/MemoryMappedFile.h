@@ -0,0 +1,34 @@
+#pragma once
+#include <NovusTypes.h>
+#include <string>
+
+// Read-only view of a file on disk, the OS pages the contents in as they get touched
+class MemoryMappedFile
+{
+public:
+    MemoryMappedFile() { }
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+    ~MemoryMappedFile() { Close(); }
+
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return _data != nullptr; }
+    const u8* GetData() const { return _data; }
+    size_t GetSize() const { return _size; }
+
+    // Touches every page of the mapping so the disk reads happen now instead of wherever the data first gets used
+    void Prefetch() const;
+
+private:
+    const u8* _data = nullptr;
+    size_t _size = 0;
+
+#ifdef _WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#else
+    i32 _fileDescriptor = -1;
+#endif
+};
@@ -31,6 +31,8 @@
 #include "Commands/PipelineBarrier.h"
 #include "Commands/ImageBarrier.h"
 #include "Commands/DepthImageBarrier.h"
+#include "Commands/DiscardImage.h"
+#include "Commands/DiscardDepthImage.h"
 #include "Commands/DrawImgui.h"
 #include "Commands/PushConstant.h"
 
@@ -255,14 +257,28 @@ namespace Renderer
     {
         ZoneScopedC(tracy::Color::Red3);
         const Commands::ImageBarrier* actualData = static_cast<const Commands::ImageBarrier*>(data);
-        renderer->ImageBarrier(commandList, actualData->image);
+        renderer->ImageBarrier(commandList, actualData->image, actualData->srcStages, actualData->dstStages);
     }
 
     void BackendDispatch::DepthImageBarrier(Renderer* renderer, CommandListID commandList, const void* data)
     {
         ZoneScopedC(tracy::Color::Red3);
         const Commands::DepthImageBarrier* actualData = static_cast<const Commands::DepthImageBarrier*>(data);
-        renderer->DepthImageBarrier(commandList, actualData->image);
+        renderer->DepthImageBarrier(commandList, actualData->image, actualData->srcStages, actualData->dstStages);
+    }
+
+    void BackendDispatch::DiscardImage(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        ZoneScopedC(tracy::Color::Red3);
+        const Commands::DiscardImage* actualData = static_cast<const Commands::DiscardImage*>(data);
+        renderer->DiscardImage(commandList, actualData->image);
+    }
+
+    void BackendDispatch::DiscardDepthImage(Renderer* renderer, CommandListID commandList, const void* data)
+    {
+        ZoneScopedC(tracy::Color::Red3);
+        const Commands::DiscardDepthImage* actualData = static_cast<const Commands::DiscardDepthImage*>(data);
+        renderer->DiscardDepthImage(commandList, actualData->image);
     }
 
     void BackendDispatch::DrawImgui(Renderer* renderer, CommandListID commandList, const void* data)
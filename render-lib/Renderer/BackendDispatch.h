@@ -55,6 +55,8 @@ namespace Renderer
         static void PipelineBarrier(Renderer* renderer, CommandListID commandList, const void* data);
         static void ImageBarrier(Renderer* renderer, CommandListID commandList, const void* data);
         static void DepthImageBarrier(Renderer* renderer, CommandListID commandList, const void* data);
+        static void DiscardImage(Renderer* renderer, CommandListID commandList, const void* data);
+        static void DiscardDepthImage(Renderer* renderer, CommandListID commandList, const void* data);
 
         static void DrawImgui(Renderer* renderer, CommandListID commandList, const void* data);
 
@@ -22,6 +22,12 @@ namespace Renderer
             for (u32 i = 0; i < _buffers.Num; ++i)
             {
                 _buffers.Get(i) = renderer->CreateBuffer(desc);
+
+                // Mapped once up front, Apply is just a memcpy after this
+                if (cpuAccess != BufferCPUAccess::None)
+                {
+                    _mappedMemory.Get(i) = renderer->MapBuffer(_buffers.Get(i));
+                }
             }
         }
 
@@ -32,10 +38,7 @@ namespace Renderer
 
         void Apply(u32 frameIndex)
         {
-            const BufferID buffer = GetBuffer(frameIndex);
-            void* mappedMemory = _renderer->MapBuffer(buffer);
-            memcpy(mappedMemory, &resource, sizeof(resource));
-            _renderer->UnmapBuffer(buffer);
+            memcpy(_mappedMemory.Get(frameIndex), &resource, sizeof(resource));
         }
 
         void ApplyAll()
@@ -54,5 +57,6 @@ namespace Renderer
     private:
         Renderer* _renderer;
         FrameResource<BufferID, 2> _buffers;
+        FrameResource<void*, 2> _mappedMemory;
     };
 }
\ No newline at end of file
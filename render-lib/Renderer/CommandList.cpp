@@ -32,6 +32,8 @@
 #include "Commands/PipelineBarrier.h"
 #include "Commands/ImageBarrier.h"
 #include "Commands/DepthImageBarrier.h"
+#include "Commands/DiscardImage.h"
+#include "Commands/DiscardDepthImage.h"
 #include "Commands/DrawImgui.h"
 #include "Commands/PushConstant.h"
 
@@ -86,6 +88,17 @@ namespace Renderer
 #endif
     }
 
+    void CommandList::Append(CommandList& commandList)
+    {
+        assert(commandList._markerScope == 0); // We need to pop all markers that we push
+
+        for (int i = 0; i < commandList._functions.Count(); i++)
+        {
+            _functions.Insert(commandList._functions[i]);
+            _data.Insert(commandList._data[i]);
+        }
+    }
+
     CommandList::CommandList(Renderer* renderer, Memory::Allocator* allocator)
         : _renderer(renderer)
         , _allocator(allocator)
@@ -486,28 +499,54 @@ namespace Renderer
 #endif
     }
 
-    void CommandList::ImageBarrier(ImageID image)
+    void CommandList::ImageBarrier(ImageID image, u8 srcStages, u8 dstStages)
     {
         assert(image != ImageID::Invalid());
         Commands::ImageBarrier* command = AddCommand<Commands::ImageBarrier>();
         command->image = image;
+        command->srcStages = srcStages;
+        command->dstStages = dstStages;
 
 #if COMMANDLIST_DEBUG_IMMEDIATE_MODE
         Commands::ImageBarrier::DISPATCH_FUNCTION(_renderer, _immediateCommandList, command);
 #endif
     }
 
-    void CommandList::ImageBarrier(DepthImageID image)
+    void CommandList::ImageBarrier(DepthImageID image, u8 srcStages, u8 dstStages)
     {
         assert(image != DepthImageID::Invalid());
         Commands::DepthImageBarrier* command = AddCommand<Commands::DepthImageBarrier>();
         command->image = image;
+        command->srcStages = srcStages;
+        command->dstStages = dstStages;
 
 #if COMMANDLIST_DEBUG_IMMEDIATE_MODE
         Commands::DepthImageBarrier::DISPATCH_FUNCTION(_renderer, _immediateCommandList, command);
 #endif
     }
 
+    void CommandList::DiscardImage(ImageID image)
+    {
+        assert(image != ImageID::Invalid());
+        Commands::DiscardImage* command = AddCommand<Commands::DiscardImage>();
+        command->image = image;
+
+#if COMMANDLIST_DEBUG_IMMEDIATE_MODE
+        Commands::DiscardImage::DISPATCH_FUNCTION(_renderer, _immediateCommandList, command);
+#endif
+    }
+
+    void CommandList::DiscardImage(DepthImageID image)
+    {
+        assert(image != DepthImageID::Invalid());
+        Commands::DiscardDepthImage* command = AddCommand<Commands::DiscardDepthImage>();
+        command->image = image;
+
+#if COMMANDLIST_DEBUG_IMMEDIATE_MODE
+        Commands::DiscardDepthImage::DISPATCH_FUNCTION(_renderer, _immediateCommandList, command);
+#endif
+    }
+
     void CommandList::DrawImgui()
     {
         Commands::DrawImgui* command = AddCommand<Commands::DrawImgui>();
@@ -14,7 +14,7 @@
 #include "Descriptors/ComputePipelineDesc.h"
 #include "Descriptors/SemaphoreDesc.h"
 
-#define COMMANDLIST_DEBUG_IMMEDIATE_MODE 1 // This makes it easier to debug the renderer by providing better callstacks if it asserts or crashes inside of render-lib
+#define COMMANDLIST_DEBUG_IMMEDIATE_MODE 0 // This makes it easier to debug the renderer by providing better callstacks if it asserts or crashes inside of render-lib, it also makes RenderGraph record every pass on the calling thread
 
 #if TRACY_ENABLE
 #define GPU_SCOPED_PROFILER_ZONE(commandList, name) \
@@ -92,8 +92,13 @@ namespace Renderer
         void UpdateBuffer(BufferID dstBuffer, u64 dstBufferOffset, u64 size, void* data);
 
         void PipelineBarrier(PipelineBarrierType type, BufferID buffer);
-        void ImageBarrier(ImageID image);
-        void ImageBarrier(DepthImageID image);
+        // Without stages this is a full barrier, the RenderGraph passes the stages it derived from the passes Read and Write calls
+        void ImageBarrier(ImageID image, u8 srcStages = PIPELINE_STAGE_NONE, u8 dstStages = PIPELINE_STAGE_NONE);
+        void ImageBarrier(DepthImageID image, u8 srcStages = PIPELINE_STAGE_NONE, u8 dstStages = PIPELINE_STAGE_NONE);
+
+        // Throws away the contents of the image, the RenderGraph does this before the first use of an aliased transient image
+        void DiscardImage(ImageID image);
+        void DiscardImage(DepthImageID image);
 
         void DrawImgui();
 
@@ -103,6 +108,9 @@ namespace Renderer
         // Execute gets friend-called from RenderGraph
         void Execute();
 
+        // Appends the commands of a CommandList recorded on another thread, the commands still live in that CommandLists allocator
+        void Append(CommandList& commandList);
+
         template<typename Command>
         Command* AddCommand()
         {
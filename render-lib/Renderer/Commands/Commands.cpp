@@ -28,6 +28,8 @@
 #include "PipelineBarrier.h"
 #include "ImageBarrier.h"
 #include "DepthImageBarrier.h"
+#include "DiscardImage.h"
+#include "DiscardDepthImage.h"
 #include "DrawImgui.h"
 #include "PushConstant.h"
 
@@ -68,6 +70,8 @@ namespace Renderer
         const BackendDispatchFunction PipelineBarrier::DISPATCH_FUNCTION = &BackendDispatch::PipelineBarrier;
         const BackendDispatchFunction ImageBarrier::DISPATCH_FUNCTION = &BackendDispatch::ImageBarrier;
         const BackendDispatchFunction DepthImageBarrier::DISPATCH_FUNCTION = &BackendDispatch::DepthImageBarrier;
+        const BackendDispatchFunction DiscardImage::DISPATCH_FUNCTION = &BackendDispatch::DiscardImage;
+        const BackendDispatchFunction DiscardDepthImage::DISPATCH_FUNCTION = &BackendDispatch::DiscardDepthImage;
         const BackendDispatchFunction DrawImgui::DISPATCH_FUNCTION = &BackendDispatch::DrawImgui;
         const BackendDispatchFunction PushConstant::DISPATCH_FUNCTION = &BackendDispatch::PushConstant;
     }
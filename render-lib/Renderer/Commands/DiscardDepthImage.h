@@ -0,0 +1,17 @@
+#pragma once
+#include <NovusTypes.h>
+#include "../BackendDispatch.h"
+#include "../Descriptors/DepthImageDesc.h"
+
+namespace Renderer
+{
+    namespace Commands
+    {
+        struct DiscardDepthImage
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            DepthImageID image = DepthImageID::Invalid();
+        };
+    }
+}
\ No newline at end of file
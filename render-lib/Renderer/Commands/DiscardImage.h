@@ -0,0 +1,17 @@
+#pragma once
+#include <NovusTypes.h>
+#include "../BackendDispatch.h"
+#include "../Descriptors/ImageDesc.h"
+
+namespace Renderer
+{
+    namespace Commands
+    {
+        struct DiscardImage
+        {
+            static const BackendDispatchFunction DISPATCH_FUNCTION;
+
+            ImageID image = ImageID::Invalid();
+        };
+    }
+}
\ No newline at end of file
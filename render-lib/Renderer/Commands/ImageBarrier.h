@@ -12,6 +12,8 @@ namespace Renderer
             static const BackendDispatchFunction DISPATCH_FUNCTION;
 
             ImageID image = ImageID::Invalid();
+            u8 srcStages = PIPELINE_STAGE_NONE;
+            u8 dstStages = PIPELINE_STAGE_NONE;
         };
     }
 }
\ No newline at end of file
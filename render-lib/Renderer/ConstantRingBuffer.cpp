@@ -0,0 +1,105 @@
+#include "ConstantRingBuffer.h"
+#include "Renderer.h"
+
+#include <Utils/DebugHandler.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+
+namespace Renderer
+{
+    void ConstantRingBuffer::Init(Renderer* renderer, size_t blockSize)
+    {
+        _renderer = renderer;
+        _blockSize = blockSize;
+    }
+
+    void ConstantRingBuffer::BeginFrame(u32 frameIndex)
+    {
+        ZoneScoped;
+        std::scoped_lock lock(_mutex);
+
+        _frameIndex = frameIndex;
+        _blockIndex = 0;
+        _blockOffset = 0;
+        _usedSize = 0;
+
+        // The frame fence has been waited on, so nothing the GPU reads from these blocks is in flight anymore
+        std::vector<Block>& blocks = _frameBlocks.Get(frameIndex);
+        if (blocks.size() > 1)
+        {
+            size_t totalSize = 0;
+            for (Block& block : blocks)
+            {
+                totalSize += block.size;
+                DestroyBlock(block);
+            }
+            blocks.clear();
+
+            blocks.push_back(CreateBlock(totalSize));
+        }
+    }
+
+    ConstantSlice ConstantRingBuffer::Allocate(size_t size)
+    {
+        size_t alignedSize = (size + SLICE_ALIGNMENT - 1) & ~static_cast<size_t>(SLICE_ALIGNMENT - 1);
+
+        std::scoped_lock lock(_mutex);
+
+        std::vector<Block>& blocks = _frameBlocks.Get(_frameIndex);
+        if (blocks.size() == 0)
+        {
+            blocks.push_back(CreateBlock(std::max(_blockSize, alignedSize)));
+        }
+
+        if (_blockOffset + alignedSize > blocks[_blockIndex].size)
+        {
+            blocks.push_back(CreateBlock(std::max(_blockSize, alignedSize)));
+            _blockIndex = static_cast<u32>(blocks.size()) - 1;
+            _blockOffset = 0;
+        }
+
+        Block& block = blocks[_blockIndex];
+
+        ConstantSlice slice;
+        slice.buffer = block.buffer;
+        slice.offset = static_cast<u32>(_blockOffset);
+        slice.size = static_cast<u32>(size);
+        slice.mappedMemory = block.mappedMemory + _blockOffset;
+
+        _blockOffset += alignedSize;
+        _usedSize += alignedSize;
+
+        return slice;
+    }
+
+    ConstantRingBuffer::Block ConstantRingBuffer::CreateBlock(size_t size)
+    {
+        BufferDesc desc;
+        desc.name = "ConstantRingBlock";
+        desc.size = size;
+        desc.usage = BufferUsage::UNIFORM_BUFFER | BufferUsage::STORAGE_BUFFER;
+        desc.cpuAccess = BufferCPUAccess::WriteOnly;
+
+        Block block;
+        block.buffer = _renderer->CreateBuffer(desc);
+        block.size = size;
+
+        // Stays mapped for the lifetime of the block
+        block.mappedMemory = static_cast<u8*>(_renderer->MapBuffer(block.buffer));
+        if (block.mappedMemory == nullptr)
+        {
+            DebugHandler::PrintFatal("ConstantRingBuffer: Failed to map a block of %u bytes", static_cast<u32>(size));
+        }
+
+        return block;
+    }
+
+    void ConstantRingBuffer::DestroyBlock(Block& block)
+    {
+        _renderer->UnmapBuffer(block.buffer);
+        _renderer->QueueDestroyBuffer(block.buffer);
+
+        block = Block();
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <NovusTypes.h>
+#include "FrameResource.h"
+#include "Descriptors/BufferDesc.h"
+
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace Renderer
+{
+    class Renderer;
+
+    // A piece of the current frame's constant memory, it gets overwritten once the same frame index comes around again
+    struct ConstantSlice
+    {
+        BufferID buffer = BufferID::Invalid();
+        u32 offset = 0;
+        u32 size = 0;
+        void* mappedMemory = nullptr;
+    };
+
+    // Linear allocator over persistently mapped uniform buffers, one set per frame in flight
+    // If a frame runs out of room it chains another block, the next time that frame index starts they get merged into one big enough for all of them
+    class ConstantRingBuffer
+    {
+    public:
+        static constexpr u32 SLICE_ALIGNMENT = 256; // The largest minUniformBufferOffsetAlignment the spec allows
+
+        void Init(Renderer* renderer, size_t blockSize);
+        void BeginFrame(u32 frameIndex);
+
+        // Thread safe, render graph passes record in parallel
+        [[nodiscard]] ConstantSlice Allocate(size_t size);
+
+        template <typename T>
+        [[nodiscard]] ConstantSlice Push(const T& data)
+        {
+            ConstantSlice slice = Allocate(sizeof(T));
+            memcpy(slice.mappedMemory, &data, sizeof(T));
+
+            return slice;
+        }
+
+        size_t GetUsedSize() { return _usedSize; }
+
+    private:
+        struct Block
+        {
+            BufferID buffer = BufferID::Invalid();
+            u8* mappedMemory = nullptr;
+            size_t size = 0;
+        };
+
+        Block CreateBlock(size_t size);
+        void DestroyBlock(Block& block);
+
+    private:
+        Renderer* _renderer = nullptr;
+        size_t _blockSize = 0;
+
+        std::mutex _mutex;
+        FrameResource<std::vector<Block>, 2> _frameBlocks;
+        u32 _frameIndex = 0;
+        u32 _blockIndex = 0;
+        size_t _blockOffset = 0;
+        size_t _usedSize = 0;
+    };
+}
@@ -113,6 +113,11 @@ namespace Renderer
     }
 
     void DescriptorSet::Bind(u32 nameHash, BufferID buffer)
+    {
+        Bind(nameHash, buffer, 0, 0);
+    }
+
+    void DescriptorSet::Bind(u32 nameHash, BufferID buffer, u32 offset, u32 range)
     {
         for (u32 i = 0; i < _boundDescriptors.size(); i++)
         {
@@ -120,6 +125,8 @@ namespace Renderer
             {
                 _boundDescriptors[i].descriptorType = DescriptorType::DESCRIPTOR_TYPE_BUFFER;
                 _boundDescriptors[i].bufferID = buffer;
+                _boundDescriptors[i].bufferOffset = offset;
+                _boundDescriptors[i].bufferRange = range;
                 return;
             }
         }
@@ -129,6 +136,13 @@ namespace Renderer
         boundDescriptor.nameHash = nameHash;
         boundDescriptor.descriptorType = DESCRIPTOR_TYPE_BUFFER;
         boundDescriptor.bufferID = buffer;
+        boundDescriptor.bufferOffset = offset;
+        boundDescriptor.bufferRange = range;
+    }
+
+    void DescriptorSet::Bind(u32 nameHash, const ConstantSlice& slice)
+    {
+        Bind(nameHash, slice.buffer, slice.offset, slice.size);
     }
 
     void DescriptorSet::Bind(StringUtils::StringHash nameHash, DepthImageID imageID)
@@ -7,6 +7,7 @@
 #include "Descriptors/ImageDesc.h"
 #include "Descriptors/DepthImageDesc.h"
 #include "Descriptors/TextureArrayDesc.h"
+#include "ConstantRingBuffer.h"
 
 namespace Renderer
 {
@@ -33,6 +34,8 @@ namespace Renderer
         SamplerID samplerID;
         TextureArrayID textureArrayID;
         BufferID bufferID;
+        u32 bufferOffset;
+        u32 bufferRange; // 0 binds the whole buffer
     };
 
     enum DescriptorSetSlot
@@ -69,6 +72,8 @@ namespace Renderer
 
         void Bind(const std::string& name, BufferID buffer);
         void Bind(u32 nameHash, BufferID buffer);
+        void Bind(u32 nameHash, BufferID buffer, u32 offset, u32 range);
+        void Bind(u32 nameHash, const ConstantSlice& slice);
 
         const std::vector<Descriptor>& GetDescriptors() const { return _boundDescriptors; }
 
@@ -7,6 +7,11 @@ namespace Memory
     class Allocator;
 }
 
+namespace tf
+{
+    class Taskflow;
+}
+
 namespace Renderer
 {
     class Renderer;
@@ -14,5 +19,10 @@ namespace Renderer
     struct RenderGraphDesc
     {
         Memory::Allocator* allocator;
+
+        // Optional, passes added with a recording group get recorded in parallel on this taskflow
+        // Every worker needs its own allocator since they are not threadsafe, we won't run more workers than we have allocators
+        tf::Taskflow* taskflow = nullptr;
+        std::vector<Memory::Allocator*> workerAllocators;
     };
-}
\ No newline at end of file
+}
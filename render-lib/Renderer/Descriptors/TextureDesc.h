@@ -8,6 +8,7 @@ namespace Renderer
     struct TextureDesc
     {
         std::string path = "";
+        bool loadSynchronously = false; // Decode and stage on the calling thread instead of returning a placeholder, for tools that need the real image immediately
     };
 
     struct DataTextureDesc
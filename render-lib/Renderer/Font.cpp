@@ -2,31 +2,67 @@
 #include "stb_truetype.h"
 
 #include "Font.h"
+#include "FontAtlas.h"
 #include "Renderer.h"
 #include <Utils/XXHash64.h>
 #include <Utils/FileReader.h>
 #include <Utils/DebugHandler.h>
+#include <tracy/Tracy.hpp>
 #include <filesystem>
 
 namespace Renderer
 {
     robin_hood::unordered_map<u64, Font*> Font::_fonts;
+    FontAtlas* Font::_atlas = nullptr;
 
-    FontChar& Font::GetChar(char character)
+    FontChar Font::GetChar(u32 codepoint)
     {
-        auto it = _chars.find(character);
+        std::scoped_lock lock(_charsMutex);
+
+        auto it = _chars.find(codepoint);
         if (it == _chars.end())
         {
-            FontChar fontChar;
-            if (!InitChar(character, fontChar))
-            {
-                DebugHandler::PrintFatal("The font does not support this character");
-            }
+            it = _chars.emplace(codepoint, InitChar(codepoint)).first;
+        }
+
+        return it->second;
+    }
 
-            _chars[character] = fontChar;
+    std::shared_ptr<const ShapedText> Font::Shape(const std::string& text)
+    {
+        u64 hash = XXHash64::hash(text.data(), text.size(), 0);
+        {
+            std::scoped_lock lock(_shapeCacheMutex);
+
+            auto it = _shapeCache.find(hash);
+            if (it != _shapeCache.end())
+                return it->second;
         }
 
-        return _chars[character];
+        ZoneScoped;
+
+        std::shared_ptr<ShapedText> shapedText = std::make_shared<ShapedText>();
+        shapedText->reserve(text.size());
+
+        for (size_t i = 0; i < text.size();)
+        {
+            ShapedGlyph& glyph = shapedText->emplace_back();
+            glyph.byteIndex = static_cast<u32>(i);
+            glyph.codepoint = DecodeUTF8(text, i);
+            glyph.isWhitespace = IsWhitespace(glyph.codepoint);
+            glyph.advance = glyph.isWhitespace ? GetWhitespaceAdvance() : GetChar(glyph.codepoint).advance;
+        }
+
+        std::scoped_lock lock(_shapeCacheMutex);
+
+        // Callers hold on to the shared_ptr, so throwing everything away is safe and keeps edited strings from piling up
+        if (_shapeCache.size() >= MAX_SHAPE_CACHE_ENTRIES)
+        {
+            _shapeCache.clear();
+        }
+
+        _shapeCache[hash] = shapedText;
+        return shapedText;
     }
 
     Font* Font::GetFont(Renderer* renderer, const std::string& fontPath, f32 fontSize)
@@ -37,8 +73,15 @@ namespace Renderer
         auto it = _fonts.find(hash);
         if (it == _fonts.end())
         {
+            if (_atlas == nullptr)
+            {
+                _atlas = new FontAtlas(renderer);
+            }
+
             Font* font = new Font();
             font->_renderer = renderer;
+            font->desc.path = fontPath;
+            font->desc.size = fontSize;
 
             std::filesystem::path path = std::filesystem::absolute(fontPath);
             FileReader file(path.string(), path.filename().string());
@@ -49,26 +92,17 @@ namespace Renderer
 
             std::shared_ptr<Bytebuffer> buffer = Bytebuffer::Borrow<209715200>();
             file.Read(buffer.get(), file.Length());
+            font->_fontData.assign(buffer->GetDataPointer(), buffer->GetDataPointer() + file.Length());
 
             font->fontInfo = new stbtt_fontinfo();
-            stbtt_InitFont(font->fontInfo, buffer->GetDataPointer(), 0);
+            stbtt_InitFont(font->fontInfo, font->_fontData.data(), 0);
 
             font->scale = stbtt_ScaleForPixelHeight(font->fontInfo, fontSize);
 
-            // Create texture array
-            TextureArrayDesc desc;
-            desc.size = 128;
-
-            font->_textureArray = renderer->CreateTextureArray(desc);
-
             // Preload char 32 to 127 (commonly used ASCII characters)
-            for (int i = 32; i < 127; i++)
+            for (u32 i = 32; i < 127; i++)
             {
-                FontChar fontChar;
-                if (font->InitChar(i, fontChar))
-                {
-                    font->_chars[i] = fontChar;
-                }
+                font->_chars[i] = font->InitChar(i);
             }
             
             _fonts[hash] = font;
@@ -77,33 +111,147 @@ namespace Renderer
         return _fonts[hash];
     }
 
-    bool Font::InitChar(char character, FontChar& fontChar)
+    TextureArrayID Font::GetTextureArray()
     {
-        fontChar.data = stbtt_GetCodepointSDF(fontInfo, scale, character, desc.padding, 128, 64.0f, &fontChar.width, &fontChar.height, &fontChar.xOffset, &fontChar.yOffset);
+        return (_atlas != nullptr) ? _atlas->GetTextureArray() : TextureArrayID::Invalid();
+    }
 
-        if (fontChar.width == 0 && fontChar.height == 0)
-            return false;
+    void Font::UploadAtlas()
+    {
+        if (_atlas != nullptr)
+        {
+            _atlas->UploadDirtyPages();
+        }
+    }
 
-        int advance;
-        stbtt_GetCodepointHMetrics(fontInfo, character, &advance, NULL);
-        fontChar.advance = advance * scale;
+    void Font::Deinit()
+    {
+        // The atlas worker reads the fonts, so it has to be joined before they're freed
+        delete _atlas;
+        _atlas = nullptr;
 
-        DataTextureDesc textureDesc;
-        textureDesc.width = fontChar.width;
-        textureDesc.height = fontChar.height;
-        textureDesc.format = ImageFormat::R8_UNORM;
-        textureDesc.data = fontChar.data;
-        textureDesc.debugName = desc.path + " " + character;
+        for (auto& [hash, font] : _fonts)
+        {
+            delete font->fontInfo;
+            delete font;
+        }
+        _fonts.clear();
+    }
 
-        _renderer->CreateDataTextureIntoArray(textureDesc, _textureArray, fontChar.textureIndex);
+    u32 Font::DecodeUTF8(const std::string& text, size_t& index)
+    {
+        constexpr u32 replacementCharacter = 0xFFFD;
 
-        delete[] textureDesc.data;
+        u8 lead = static_cast<u8>(text[index++]);
+        if (lead < 0x80)
+            return lead;
 
-        return true;
+        u32 numContinuationBytes;
+        u32 codepoint;
+        if ((lead & 0xE0) == 0xC0)
+        {
+            numContinuationBytes = 1;
+            codepoint = lead & 0x1F;
+        }
+        else if ((lead & 0xF0) == 0xE0)
+        {
+            numContinuationBytes = 2;
+            codepoint = lead & 0x0F;
+        }
+        else if ((lead & 0xF8) == 0xF0)
+        {
+            numContinuationBytes = 3;
+            codepoint = lead & 0x07;
+        }
+        else
+        {
+            return replacementCharacter; // Stray continuation byte or invalid lead
+        }
+
+        for (u32 i = 0; i < numContinuationBytes; i++)
+        {
+            if (index >= text.size() || (static_cast<u8>(text[index]) & 0xC0) != 0x80)
+                return replacementCharacter; // Truncated, leave index on the byte that broke the sequence
+
+            codepoint = (codepoint << 6) | (static_cast<u8>(text[index++]) & 0x3F);
+        }
+
+        return codepoint;
     }
 
-    TextureArrayID Font::GetTextureArray()
+    void Font::EncodeUTF8(u32 codepoint, std::string& out)
     {
-        return _textureArray;
+        if (codepoint < 0x80)
+        {
+            out += static_cast<char>(codepoint);
+        }
+        else if (codepoint < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (codepoint >> 6));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (codepoint >> 12));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (codepoint >> 18));
+            out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    bool Font::IsWhitespace(u32 codepoint)
+    {
+        switch (codepoint)
+        {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\v':
+        case '\f':
+        case '\r':
+        case 0x00A0: // No-break space
+        case 0x3000: // Ideographic space
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    FontChar Font::InitChar(u32 codepoint)
+    {
+        FontChar fontChar;
+
+        // Codepoints the font doesn't have map to glyph 0, which is the font's own missing glyph box
+        i32 glyphIndex = stbtt_FindGlyphIndex(fontInfo, codepoint);
+
+        i32 advance;
+        stbtt_GetGlyphHMetrics(fontInfo, glyphIndex, &advance, nullptr);
+        fontChar.advance = advance * scale;
+
+        // Same box stbtt_GetGlyphSDF produces, so the atlas can reserve room before the SDF exists
+        i32 x0, y0, x1, y1;
+        stbtt_GetGlyphBitmapBoxSubpixel(fontInfo, glyphIndex, scale, scale, 0.0f, 0.0f, &x0, &y0, &x1, &y1);
+        if (x0 == x1 || y0 == y1)
+            return fontChar;
+
+        fontChar.xOffset = x0 - desc.padding;
+        fontChar.yOffset = y0 - desc.padding;
+        fontChar.width = (x1 - x0) + desc.padding * 2;
+        fontChar.height = (y1 - y0) + desc.padding * 2;
+
+        FontAtlas::GlyphRect rect = _atlas->AddGlyph(fontInfo, scale, glyphIndex, desc.padding, fontChar.width, fontChar.height);
+
+        const f32 pageSize = static_cast<f32>(FontAtlas::PAGE_SIZE);
+        fontChar.textureIndex = rect.page;
+        fontChar.uvMin = vec2(rect.x, rect.y) / pageSize;
+        fontChar.uvMax = vec2(rect.x + rect.width, rect.y + rect.height) / pageSize;
+
+        return fontChar;
     }
-}
\ No newline at end of file
+}
@@ -4,24 +4,40 @@
 #include "Descriptors/TextureArrayDesc.h"
 #include "Descriptors/FontDesc.h"
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 struct stbtt_fontinfo;
 
 namespace Renderer
 {
     class Renderer;
+    class FontAtlas;
 
     struct FontChar
     {
-        f32 advance;
-        i32 xOffset;
-        i32 yOffset;
+        f32 advance = 0.0f;
+        i32 xOffset = 0;
+        i32 yOffset = 0;
         i32 width = 0;
         i32 height = 0;
-        u8* data;
 
-        u32 textureIndex;
+        u32 textureIndex = 0; // The atlas page the glyph lives in
+        vec2 uvMin = vec2(0.0f, 0.0f);
+        vec2 uvMax = vec2(0.0f, 0.0f);
     };
 
+    // One codepoint of a shaped string
+    struct ShapedGlyph
+    {
+        u32 byteIndex; // Where the codepoint starts in the UTF-8 text
+        u32 codepoint;
+        f32 advance;
+        bool isWhitespace;
+    };
+    using ShapedText = std::vector<ShapedGlyph>;
+
     struct Font
     {
         FontDesc desc;
@@ -29,24 +45,47 @@ namespace Renderer
         stbtt_fontinfo* fontInfo;
         float scale;
 
-        FontChar& GetChar(char character);
-        TextureArrayID GetTextureArray();
+        FontChar GetChar(u32 codepoint);
+        f32 GetWhitespaceAdvance() const { return desc.size * 0.15f; }
+
+        // Decodes and measures the string once, unchanged strings hit the cache after that
+        std::shared_ptr<const ShapedText> Shape(const std::string& text);
 
         static Font* GetFont(Renderer* renderer, const std::string& fontPath, f32 fontSize);
-        
+
+        // Every font shares one atlas, so text using different fonts can be drawn together
+        static TextureArrayID GetTextureArray();
+        // Uploads glyphs the atlas worker finished since last frame, call before recording the UI
+        static void UploadAtlas();
+        // Stops the atlas worker and frees every font, call on shutdown before the renderer goes away
+        static void Deinit();
+
+        // Returns the codepoint starting at index and moves index past it, malformed sequences decode as U+FFFD
+        static u32 DecodeUTF8(const std::string& text, size_t& index);
+        static void EncodeUTF8(u32 codepoint, std::string& out);
+        static bool IsWhitespace(u32 codepoint);
+
     private:
         Font() = default;
 
-        bool InitChar(char character, FontChar& fontChar);
+        FontChar InitChar(u32 codepoint);
 
     private:
+        static constexpr size_t MAX_SHAPE_CACHE_ENTRIES = 4096;
+
         static robin_hood::unordered_map<u64, Font*> _fonts;
-        robin_hood::unordered_map<char, FontChar> _chars;
+        static FontAtlas* _atlas;
+
+        std::vector<u8> _fontData; // stb_truetype keeps pointing into this, the atlas worker reads it too
+
+        std::mutex _charsMutex;
+        robin_hood::unordered_map<u32, FontChar> _chars;
 
-        TextureArrayID _textureArray = TextureArrayID::Invalid();
+        std::mutex _shapeCacheMutex;
+        robin_hood::unordered_map<u64, std::shared_ptr<const ShapedText>> _shapeCache;
 
         Renderer* _renderer;
 
         friend class Renderer;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,185 @@
+#include "FontAtlas.h"
+#include "Renderer.h"
+#include "stb_truetype.h"
+
+#include <Utils/DebugHandler.h>
+#include <tracy/Tracy.hpp>
+
+#include <algorithm>
+
+namespace Renderer
+{
+    FontAtlas::FontAtlas(Renderer* renderer)
+        : _renderer(renderer)
+    {
+        TextureArrayDesc desc;
+        desc.size = MAX_PAGES;
+
+        _textureArray = renderer->CreateTextureArray(desc);
+        _workerThread = std::thread(&FontAtlas::RasterizeWorker, this);
+    }
+
+    FontAtlas::~FontAtlas()
+    {
+        {
+            std::scoped_lock lock(_jobMutex);
+            _stopWorker = true;
+        }
+        _jobCondition.notify_all();
+
+        _workerThread.join();
+    }
+
+    FontAtlas::GlyphRect FontAtlas::AddGlyph(const stbtt_fontinfo* fontInfo, f32 scale, i32 glyphIndex, i32 padding, u32 width, u32 height)
+    {
+        if (width > PAGE_SIZE || height > PAGE_SIZE)
+        {
+            DebugHandler::PrintFatal("FontAtlas: Glyph of %ux%u doesn't fit in a %u page", width, height, PAGE_SIZE);
+        }
+
+        GlyphRect rect;
+        rect.width = width;
+        rect.height = height;
+
+        {
+            std::scoped_lock lock(_pagesMutex);
+
+            // Leave a texel between glyphs so bilinear sampling doesn't pick up the neighbour
+            const u32 paddedWidth = width + 1;
+            const u32 paddedHeight = height + 1;
+
+            if (_pages.size() > 0)
+            {
+                Page& page = _pages.back();
+                if (page.cursorX + paddedWidth > PAGE_SIZE)
+                {
+                    page.shelfY += page.shelfHeight;
+                    page.shelfHeight = 0;
+                    page.cursorX = 0;
+                }
+            }
+
+            if (_pages.size() == 0 || _pages.back().shelfY + paddedHeight > PAGE_SIZE)
+            {
+                if (_pages.size() == MAX_PAGES)
+                {
+                    DebugHandler::PrintFatal("FontAtlas: Ran out of pages, increase MAX_PAGES");
+                }
+
+                Page& page = _pages.emplace_back();
+                page.pixels.resize(PAGE_SIZE * PAGE_SIZE);
+            }
+
+            Page& page = _pages.back();
+            rect.page = static_cast<u32>(_pages.size()) - 1;
+            rect.x = page.cursorX;
+            rect.y = page.shelfY;
+
+            page.cursorX += paddedWidth;
+            page.shelfHeight = std::max(page.shelfHeight, paddedHeight);
+        }
+
+        {
+            std::scoped_lock lock(_jobMutex);
+            _jobs.push({ fontInfo, scale, glyphIndex, padding, rect });
+        }
+        _jobCondition.notify_one();
+
+        return rect;
+    }
+
+    void FontAtlas::UploadDirtyPages()
+    {
+        ZoneScoped;
+        std::scoped_lock lock(_pagesMutex);
+
+        for (u32 i = 0; i < _pages.size(); i++)
+        {
+            Page& page = _pages[i];
+
+            if (page.texture != TextureID::Invalid())
+            {
+                // Only the new glyphs go up, the rest of the page is already on the GPU
+                size_t numUploaded = 0;
+                for (; numUploaded < page.dirtyRects.size(); numUploaded++)
+                {
+                    const GlyphRect& rect = page.dirtyRects[numUploaded];
+                    const u8* pixels = &page.pixels[rect.y * PAGE_SIZE + rect.x];
+
+                    // Out of staging memory for this frame, the rest go up next frame
+                    if (!_renderer->UpdateDataTexture(page.texture, rect.x, rect.y, rect.width, rect.height, pixels, PAGE_SIZE))
+                        break;
+                }
+
+                page.dirtyRects.erase(page.dirtyRects.begin(), page.dirtyRects.begin() + numUploaded);
+                continue;
+            }
+
+            DataTextureDesc desc;
+            desc.width = PAGE_SIZE;
+            desc.height = PAGE_SIZE;
+            desc.format = ImageFormat::R8_UNORM;
+            desc.data = page.pixels.data();
+            desc.debugName = "FontAtlasPage " + std::to_string(i);
+
+            u32 arrayIndex;
+            page.texture = _renderer->CreateDataTextureIntoArray(desc, _textureArray, arrayIndex);
+
+            // Glyphs store their page as the array index
+            if (arrayIndex != i)
+            {
+                DebugHandler::PrintFatal("FontAtlas: Page %u ended up in array slot %u", i, arrayIndex);
+            }
+
+            // The whole page went up, including every glyph rasterised so far
+            page.dirtyRects.clear();
+        }
+    }
+
+    void FontAtlas::RasterizeWorker()
+    {
+        while (true)
+        {
+            RasterizeJob job;
+            {
+                std::unique_lock lock(_jobMutex);
+                _jobCondition.wait(lock, [&]() { return _stopWorker || !_jobs.empty(); });
+
+                if (_stopWorker)
+                    return;
+
+                job = _jobs.front();
+                _jobs.pop();
+            }
+
+            ZoneScopedN("RasterizeGlyph");
+
+            i32 width, height, xOffset, yOffset;
+            u8* sdf = stbtt_GetGlyphSDF(job.fontInfo, job.scale, job.glyphIndex, job.padding, 128, 64.0f, &width, &height, &xOffset, &yOffset);
+            if (sdf == nullptr)
+                continue;
+
+            const u32 copyWidth = std::min(static_cast<u32>(width), job.rect.width);
+            const u32 copyHeight = std::min(static_cast<u32>(height), job.rect.height);
+
+            {
+                std::scoped_lock lock(_pagesMutex);
+                Page& page = _pages[job.rect.page];
+
+                for (u32 row = 0; row < copyHeight; row++)
+                {
+                    u8* dst = &page.pixels[(job.rect.y + row) * PAGE_SIZE + job.rect.x];
+                    memcpy(dst, &sdf[row * width], copyWidth);
+                }
+
+                // Vulkan doesn't allow empty copies
+                if (copyWidth > 0 && copyHeight > 0)
+                {
+                    page.dirtyRects.push_back(job.rect);
+                }
+            }
+
+            stbtt_FreeSDF(sdf, nullptr);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <NovusTypes.h>
+#include "Descriptors/TextureDesc.h"
+#include "Descriptors/TextureArrayDesc.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+struct stbtt_fontinfo;
+
+namespace Renderer
+{
+    class Renderer;
+
+    // SDF glyphs of every font packed into a few R8 pages, each page is one slot of the texture array
+    // Room is reserved as soon as a glyph is requested, the SDF is rasterised on a worker and only its rect is uploaded once that's done
+    class FontAtlas
+    {
+    public:
+        static constexpr u32 PAGE_SIZE = 1024;
+        static constexpr u32 MAX_PAGES = 32;
+
+        struct GlyphRect
+        {
+            u32 page = 0;
+            u32 x = 0;
+            u32 y = 0;
+            u32 width = 0;
+            u32 height = 0;
+        };
+
+        FontAtlas(Renderer* renderer);
+        ~FontAtlas();
+
+        // fontInfo is read on the worker, it has to outlive the atlas
+        GlyphRect AddGlyph(const stbtt_fontinfo* fontInfo, f32 scale, i32 glyphIndex, i32 padding, u32 width, u32 height);
+
+        // Creates the pages that were added and uploads the glyphs rasterised since the last call, do this before recording anything that samples the atlas
+        void UploadDirtyPages();
+
+        TextureArrayID GetTextureArray() { return _textureArray; }
+
+    private:
+        struct Page
+        {
+            std::vector<u8> pixels;
+            TextureID texture = TextureID::Invalid();
+            std::vector<GlyphRect> dirtyRects; // Rasterised but not uploaded yet
+
+            // Shelf packing, glyphs fill a row left to right and the next row starts below the tallest one
+            u32 shelfY = 0;
+            u32 shelfHeight = 0;
+            u32 cursorX = 0;
+        };
+
+        struct RasterizeJob
+        {
+            const stbtt_fontinfo* fontInfo;
+            f32 scale;
+            i32 glyphIndex;
+            i32 padding;
+            GlyphRect rect;
+        };
+
+        void RasterizeWorker();
+
+    private:
+        Renderer* _renderer = nullptr;
+        TextureArrayID _textureArray = TextureArrayID::Invalid();
+
+        std::mutex _pagesMutex;
+        std::vector<Page> _pages;
+
+        std::thread _workerThread;
+        std::mutex _jobMutex;
+        std::condition_variable _jobCondition;
+        std::queue<RasterizeJob> _jobs;
+        bool _stopWorker = false;
+    };
+}
@@ -0,0 +1,250 @@
+#pragma once
+#include "Renderer.h"
+#include "Descriptors/BufferDesc.h"
+
+#include <Utils/DebugHandler.h>
+#include <Memory/BufferRangeAllocator.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace Renderer
+{
+    // A CPU side vector mirrored into a growable GPU buffer
+    // Ranges are sub-allocated so freed ranges get reused, and SyncToGPU only uploads the elements that changed since the last sync
+    template <typename T>
+    class GPUVector
+    {
+    public:
+        void Init(const std::string& debugName, u8 usage, size_t initialCapacity = 1024)
+        {
+            _debugName = debugName;
+            _usage = usage | BufferUsage::TRANSFER_DESTINATION;
+
+            _allocator.Init(0, std::max(initialCapacity, static_cast<size_t>(1)) * sizeof(T));
+        }
+
+        // Allocates count contiguous elements and returns the index of the first one, the elements are marked dirty
+        size_t AddCount(size_t count)
+        {
+            if (count == 0)
+                return 0;
+
+            BufferRangeFrame frame;
+            if (!_allocator.Allocate(count * sizeof(T), frame))
+            {
+                size_t currentSize = _allocator.Size();
+                size_t newSize = std::max(static_cast<size_t>(static_cast<f64>(currentSize) * 1.25), currentSize + count * sizeof(T));
+                newSize -= newSize % sizeof(T);
+
+                _allocator.Grow(newSize);
+
+                if (!_allocator.Allocate(count * sizeof(T), frame))
+                {
+                    DebugHandler::PrintFatal("GPUVector: Failed to allocate %u elements in '%s'", static_cast<u32>(count), _debugName.c_str());
+                }
+            }
+
+            size_t index = frame.offset / sizeof(T);
+            if (index + count > _vector.size())
+            {
+                _vector.resize(index + count);
+            }
+
+            SetDirtyElements(index, count);
+            return index;
+        }
+
+        size_t Add(const T& element)
+        {
+            size_t index = AddCount(1);
+            _vector[index] = element;
+
+            return index;
+        }
+
+        // Hands the range back to the allocator, the elements are reset so the GPU sees an empty slot until it's reused
+        void Remove(size_t index, size_t count)
+        {
+            if (count == 0)
+                return;
+
+            BufferRangeFrame frame;
+            frame.offset = index * sizeof(T);
+            frame.size = count * sizeof(T);
+
+            if (!_allocator.Free(frame))
+            {
+                DebugHandler::PrintFatal("GPUVector: Failed to free %u elements at %u in '%s'", static_cast<u32>(count), static_cast<u32>(index), _debugName.c_str());
+            }
+
+            std::fill(_vector.begin() + index, _vector.begin() + index + count, T());
+            SetDirtyElements(index, count);
+        }
+
+        void SetDirtyElement(size_t index)
+        {
+            SetDirtyElements(index, 1);
+        }
+
+        void SetDirtyElements(size_t index, size_t count)
+        {
+            if (count == 0)
+                return;
+
+            // Loads mostly append, so extend the last range when we can
+            if (_dirtyRanges.size() > 0)
+            {
+                DirtyRange& last = _dirtyRanges.back();
+                if (index >= last.first && index <= last.first + last.count)
+                {
+                    last.count = std::max(last.count, index + count - last.first);
+                    return;
+                }
+            }
+
+            _dirtyRanges.push_back({ index, count });
+        }
+
+        // Returns true if the GPU buffer was recreated, anything sized after Capacity() needs to be recreated too
+        bool SyncToGPU(Renderer* renderer)
+        {
+            bool wasRecreated = false;
+
+            size_t neededSize = std::max(_vector.size(), static_cast<size_t>(1)) * sizeof(T);
+            if (_buffer == BufferID::Invalid() || _bufferSize < neededSize)
+            {
+                size_t newSize = std::max(_allocator.Size(), neededSize);
+
+                BufferDesc desc;
+                desc.name = _debugName;
+                desc.size = newSize;
+                desc.usage = _usage;
+
+                if (_buffer != BufferID::Invalid())
+                {
+                    renderer->QueueDestroyBuffer(_buffer);
+                }
+
+                _buffer = renderer->CreateBuffer(desc);
+                _bufferSize = newSize;
+                wasRecreated = true;
+
+                // Copying the old buffer over would run on the graphics queue after this frame's staging uploads and clobber them,
+                // so upload everything live from the CPU copy instead, it's always up to date
+                _dirtyRanges.clear();
+                SetDirtyElements(0, _vector.size());
+            }
+
+            if (_dirtyRanges.size() == 0)
+                return wasRecreated;
+
+            std::sort(_dirtyRanges.begin(), _dirtyRanges.end(), [](const DirtyRange& a, const DirtyRange& b) { return a.first < b.first; });
+
+            // Merge overlapping and touching ranges so we get as few uploads as possible
+            size_t numMerged = 0;
+            for (size_t i = 1; i < _dirtyRanges.size(); i++)
+            {
+                DirtyRange& merged = _dirtyRanges[numMerged];
+                const DirtyRange& range = _dirtyRanges[i];
+
+                if (range.first <= merged.first + merged.count)
+                {
+                    merged.count = std::max(merged.count, range.first + range.count - merged.first);
+                }
+                else
+                {
+                    _dirtyRanges[++numMerged] = range;
+                }
+            }
+            _dirtyRanges.resize(numMerged + 1);
+
+            // A grow marks the whole vector dirty, so big ranges are split to stay within a staging buffer
+            constexpr size_t maxElementsPerUpload = std::max(MAX_UPLOAD_SIZE / sizeof(T), static_cast<size_t>(1));
+            for (const DirtyRange& range : _dirtyRanges)
+            {
+                for (size_t first = range.first; first < range.first + range.count; first += maxElementsPerUpload)
+                {
+                    size_t count = std::min(maxElementsPerUpload, range.first + range.count - first);
+
+                    size_t offset = first * sizeof(T);
+                    size_t size = count * sizeof(T);
+
+                    auto uploadBuffer = renderer->CreateUploadBuffer(_buffer, offset, size);
+                    memcpy(uploadBuffer->mappedMemory, &_vector[first], size);
+                }
+            }
+            _dirtyRanges.clear();
+
+            return wasRecreated;
+        }
+
+        // Drops every element from count onwards, only valid while the vector is kept tightly packed (nothing was ever Removed)
+        void Truncate(size_t count)
+        {
+            if (count >= _vector.size())
+                return;
+
+            _allocator.Reset();
+            if (count > 0)
+            {
+                BufferRangeFrame frame;
+                _allocator.Allocate(count * sizeof(T), frame);
+            }
+
+            _vector.resize(count);
+
+            // Don't upload anything that no longer exists
+            for (DirtyRange& range : _dirtyRanges)
+            {
+                range.first = std::min(range.first, count);
+                range.count = std::min(range.count, count - range.first);
+            }
+            _dirtyRanges.erase(std::remove_if(_dirtyRanges.begin(), _dirtyRanges.end(), [](const DirtyRange& range) { return range.count == 0; }), _dirtyRanges.end());
+        }
+
+        void Clear()
+        {
+            _vector.clear();
+            _dirtyRanges.clear();
+            _allocator.Reset();
+        }
+
+        // Includes the removed elements that haven't been reused yet, they are default constructed
+        size_t Size() const { return _vector.size(); }
+        // Number of elements the GPU buffer has room for
+        size_t Capacity() const { return _bufferSize / sizeof(T); }
+
+        T& operator[](size_t index) { return _vector[index]; }
+        const T& operator[](size_t index) const { return _vector[index]; }
+
+        T* Data() { return _vector.data(); }
+        const std::vector<T>& ReadGet() const { return _vector; }
+
+        typename std::vector<T>::iterator begin() { return _vector.begin(); }
+        typename std::vector<T>::iterator end() { return _vector.end(); }
+        typename std::vector<T>::const_iterator begin() const { return _vector.begin(); }
+        typename std::vector<T>::const_iterator end() const { return _vector.end(); }
+
+        BufferID GetBuffer() const { return _buffer; }
+
+    private:
+        static constexpr size_t MAX_UPLOAD_SIZE = 8 * 1024 * 1024;
+
+        struct DirtyRange
+        {
+            size_t first;
+            size_t count;
+        };
+
+        std::string _debugName = "";
+        u8 _usage = 0;
+
+        std::vector<T> _vector;
+        std::vector<DirtyRange> _dirtyRanges;
+        BufferRangeAllocator _allocator;
+
+        BufferID _buffer = BufferID::Invalid();
+        size_t _bufferSize = 0;
+    };
+}
@@ -1,17 +1,42 @@
 #include "RenderGraph.h"
 #include "Renderer.h"
 
+#include <vector>
+#include <algorithm>
+#include <limits>
 #include <tracy/Tracy.hpp>
+#include <taskflow/taskflow.hpp>
 #include <Memory/Allocator.h>
 #include <Containers/DynamicArray.h>
 
 namespace Renderer
 {
+    enum class TransitionType : u8
+    {
+        BARRIER,
+        CLEAR,
+        DISCARD // First use of a transient image this frame, its memory may have belonged to another image
+    };
+
+    // A barrier, clear or discard that needs to happen before a compiled pass executes
+    struct PassTransition
+    {
+        u32 passIndex;
+        u16 resource;
+        u8 srcStages;
+        u8 dstStages;
+        bool isDepth;
+        TransitionType type;
+    };
+
     struct RenderGraphData : IRenderGraphData
     {
         RenderGraphData(Memory::Allocator* allocator)
             : passes(allocator, 32)
             , executingPasses(allocator, 32)
+            , executingPassIndices(allocator, 32)
+            , compiledPasses(allocator, 32)
+            , transitions(allocator, 64)
             , signalSemaphores(allocator, 4)
             , waitSemaphores(allocator, 4)
         {
@@ -20,11 +45,20 @@ namespace Renderer
 
         DynamicArray<IRenderPass*> passes;
         DynamicArray<IRenderPass*> executingPasses;
+        DynamicArray<u32> executingPassIndices; // Index into passes, this is what the builder tags the accesses of a pass with
+        DynamicArray<IRenderPass*> compiledPasses; // The executing passes that survived culling
+        DynamicArray<PassTransition> transitions; // Sorted by passIndex
 
         DynamicArray<SemaphoreID> signalSemaphores;
         DynamicArray<SemaphoreID> waitSemaphores;
     };
 
+    struct RecordingGroup
+    {
+        const void* key;
+        std::vector<u32> passIndices;
+    };
+
     RenderGraph::RenderGraph(Memory::Allocator* allocator, Renderer* renderer)
         : _data(Memory::Allocator::New<RenderGraphData>(allocator, allocator))
         , _renderer(renderer)
@@ -75,14 +109,334 @@ namespace Renderer
         ZoneScopedNC("RenderGraph::Setup", tracy::Color::Red2)
 
         RenderGraphData* data = static_cast<RenderGraphData*>(_data);
+
+        u32 passIndex = 0;
         for (IRenderPass* pass : data->passes)
         {
             ZoneScopedC(tracy::Color::Red2)
             ZoneName(pass->_name, pass->_nameLength)
 
+            _renderGraphBuilder->_currentPassIndex = passIndex;
             if (pass->Setup(_renderGraphBuilder))
             {
                 data->executingPasses.Insert(pass);
+                data->executingPassIndices.Insert(passIndex);
+            }
+
+            passIndex++;
+        }
+
+        Compile();
+    }
+
+    void RenderGraph::Compile()
+    {
+        ZoneScopedNC("RenderGraph::Compile", tracy::Color::Red2)
+
+        RenderGraphData* data = static_cast<RenderGraphData*>(_data);
+        DynamicArray<RenderGraphBuilder::Access>& accesses = _renderGraphBuilder->_accesses;
+        RenderGraphResources& resources = _renderGraphBuilder->GetResources();
+
+        const u32 invalidIndex = std::numeric_limits<u32>::max();
+        u32 numPasses = static_cast<u32>(data->passes.Count());
+        u32 numExecutingPasses = static_cast<u32>(data->executingPasses.Count());
+        u32 numAccesses = static_cast<u32>(accesses.Count());
+
+        // Passes set up in order, so the accesses of every pass are contiguous
+        DynamicArray<u32> passToExecutingIndex(_desc.allocator, numPasses);
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            passToExecutingIndex.Insert(invalidIndex);
+        }
+
+        for (u32 i = 0; i < numExecutingPasses; i++)
+        {
+            passToExecutingIndex[data->executingPassIndices[i]] = i;
+        }
+
+        DynamicArray<u32> firstAccess(_desc.allocator, numExecutingPasses);
+        DynamicArray<u32> accessCount(_desc.allocator, numExecutingPasses);
+        for (u32 i = 0; i < numExecutingPasses; i++)
+        {
+            firstAccess.Insert(0);
+            accessCount.Insert(0);
+        }
+
+        u32 numImages = 0;
+        u32 numDepthImages = 0;
+        for (u32 i = 0; i < numAccesses; i++)
+        {
+            RenderGraphBuilder::Access& access = accesses[i];
+
+            if (access.isDepth)
+            {
+                numDepthImages = std::max(numDepthImages, access.resource + 1u);
+            }
+            else
+            {
+                numImages = std::max(numImages, access.resource + 1u);
+            }
+
+            u32 executingIndex = passToExecutingIndex[access.passIndex];
+            if (executingIndex == invalidIndex)
+                continue; // This passes Setup returned false
+
+            if (accessCount[executingIndex] == 0)
+            {
+                firstAccess[executingIndex] = i;
+            }
+            accessCount[executingIndex]++;
+        }
+
+        struct ResourceState
+        {
+            u8 lastWriteStages = PIPELINE_STAGE_NONE;
+            u8 readStages = PIPELINE_STAGE_NONE; // Stages that have read the resource since lastWriteStages wrote it
+            bool isNeeded = false;
+
+            // Transient images get their memory placed by lifetime
+            u32 firstPass = std::numeric_limits<u32>::max();
+            u32 lastPass = 0;
+        };
+
+        // Depth images go after the color images
+        DynamicArray<ResourceState> states(_desc.allocator, numImages + numDepthImages);
+        for (u32 i = 0; i < numImages + numDepthImages; i++)
+        {
+            states.Insert(ResourceState());
+        }
+
+        auto getState = [&](const RenderGraphBuilder::Access& access) -> ResourceState&
+        {
+            return states[access.isDepth ? numImages + access.resource : access.resource];
+        };
+
+        // Cull back to front, a pass survives if it has no declared writes, writes an imported resource or writes a transient resource that a surviving pass consumes
+        DynamicArray<bool> keepPass(_desc.allocator, numExecutingPasses);
+        for (u32 i = 0; i < numExecutingPasses; i++)
+        {
+            keepPass.Insert(true);
+        }
+
+        for (u32 i = numExecutingPasses; i-- > 0;)
+        {
+            u32 first = firstAccess[i];
+            u32 last = first + accessCount[i];
+
+            bool hasWrites = false;
+            bool isNeeded = false;
+            for (u32 j = first; j < last; j++)
+            {
+                RenderGraphBuilder::Access& access = accesses[j];
+                if (access.isWrite)
+                {
+                    hasWrites = true;
+                    isNeeded |= !access.isTransient || getState(access).isNeeded;
+                }
+            }
+
+            keepPass[i] = !hasWrites || isNeeded;
+            if (!keepPass[i])
+                continue;
+
+            // Writes that don't load overwrite whatever earlier passes left in the resource
+            for (u32 j = first; j < last; j++)
+            {
+                RenderGraphBuilder::Access& access = accesses[j];
+                if (access.isWrite && access.loadMode != RenderGraphBuilder::LoadMode::LOAD)
+                {
+                    getState(access).isNeeded = false;
+                }
+            }
+
+            for (u32 j = first; j < last; j++)
+            {
+                RenderGraphBuilder::Access& access = accesses[j];
+                if (!access.isWrite || access.loadMode == RenderGraphBuilder::LoadMode::LOAD)
+                {
+                    getState(access).isNeeded = true;
+                }
+            }
+        }
+
+        // Plan barriers and clears front to back, resources enter the frame without pending hazards since the previous frame is waited on with a semaphore
+        for (u32 i = 0; i < numExecutingPasses; i++)
+        {
+            if (!keepPass[i])
+                continue;
+
+            u32 compiledPassIndex = static_cast<u32>(data->compiledPasses.Count());
+            data->compiledPasses.Insert(data->executingPasses[i]);
+
+            u32 first = firstAccess[i];
+            u32 last = first + accessCount[i];
+
+            auto addTransition = [&](const RenderGraphBuilder::Access& access, u8 srcStages, u8 dstStages, TransitionType type)
+            {
+                PassTransition transition;
+                transition.passIndex = compiledPassIndex;
+                transition.resource = access.resource;
+                transition.srcStages = srcStages;
+                transition.dstStages = dstStages;
+                transition.isDepth = access.isDepth;
+                transition.type = type;
+
+                data->transitions.Insert(transition);
+            };
+
+            // Barriers are decided from the state before this pass, so a pass reading and writing the same resource doesn't wait on itself
+            for (u32 j = first; j < last; j++)
+            {
+                RenderGraphBuilder::Access& access = accesses[j];
+                ResourceState& state = getState(access);
+
+                if (access.isTransient)
+                {
+                    if (state.firstPass == std::numeric_limits<u32>::max())
+                    {
+                        state.firstPass = compiledPassIndex;
+                        addTransition(access, PIPELINE_STAGE_NONE, PIPELINE_STAGE_NONE, TransitionType::DISCARD);
+                    }
+
+                    state.lastPass = compiledPassIndex;
+                }
+
+                if (access.isWrite)
+                {
+                    if (access.loadMode == RenderGraphBuilder::LoadMode::CLEAR)
+                    {
+                        // Clearing does a full transition, so it doubles as the barrier
+                        addTransition(access, PIPELINE_STAGE_NONE, PIPELINE_STAGE_NONE, TransitionType::CLEAR);
+                    }
+                    else if (state.readStages != PIPELINE_STAGE_NONE)
+                    {
+                        addTransition(access, state.readStages, access.stages, TransitionType::BARRIER); // Write after read
+                    }
+                    else if (state.lastWriteStages != PIPELINE_STAGE_NONE)
+                    {
+                        // Color rendertarget to rendertarget is covered by the external dependency of our render passes
+                        bool isColorRenderTargetChain = !access.isDepth && state.lastWriteStages == PIPELINE_STAGE_RENDERTARGET && access.stages == PIPELINE_STAGE_RENDERTARGET;
+                        if (!isColorRenderTargetChain)
+                        {
+                            addTransition(access, state.lastWriteStages, access.stages, TransitionType::BARRIER); // Write after write
+                        }
+                    }
+                }
+                else
+                {
+                    u8 unsynchronizedStages = access.stages & ~state.readStages;
+                    if (state.lastWriteStages != PIPELINE_STAGE_NONE && unsynchronizedStages != PIPELINE_STAGE_NONE)
+                    {
+                        addTransition(access, state.lastWriteStages, unsynchronizedStages, TransitionType::BARRIER); // Read after write
+                    }
+                }
+            }
+
+            for (u32 j = first; j < last; j++)
+            {
+                RenderGraphBuilder::Access& access = accesses[j];
+                if (!access.isWrite)
+                {
+                    getState(access).readStages |= access.stages;
+                }
+            }
+
+            for (u32 j = first; j < last; j++)
+            {
+                RenderGraphBuilder::Access& access = accesses[j];
+                if (access.isWrite)
+                {
+                    ResourceState& state = getState(access);
+                    state.lastWriteStages = access.stages;
+                    state.readStages = PIPELINE_STAGE_NONE;
+                }
+            }
+        }
+
+        // Hand the lifetimes of the transient images to the backend, it lets the ones that never overlap share memory
+        std::vector<TransientImageLifetime> lifetimes;
+        for (u32 i = 0; i < numImages + numDepthImages; i++)
+        {
+            ResourceState& state = states[i];
+            if (state.firstPass == std::numeric_limits<u32>::max())
+                continue;
+
+            TransientImageLifetime& lifetime = lifetimes.emplace_back();
+            if (i < numImages)
+            {
+                lifetime.image = resources.GetImage(RenderPassResource(static_cast<RenderPassResource::type>(i)));
+            }
+            else
+            {
+                lifetime.depthImage = resources.GetDepthImage(RenderPassResource(static_cast<RenderPassResource::type>(i - numImages)));
+            }
+
+            lifetime.firstPass = state.firstPass;
+            lifetime.lastPass = state.lastPass;
+        }
+
+        _renderer->PlaceTransientImages(lifetimes.data(), static_cast<u32>(lifetimes.size()));
+    }
+
+    void RenderGraph::AddPassTransitions(u32 compiledPassIndex, CommandList& commandList)
+    {
+        RenderGraphData* data = static_cast<RenderGraphData*>(_data);
+        RenderGraphResources& resources = _renderGraphBuilder->GetResources();
+
+        // Transitions are sorted by pass, so we can binary search for the first one belonging to this pass
+        u32 numTransitions = static_cast<u32>(data->transitions.Count());
+        u32 low = 0;
+        u32 high = numTransitions;
+        while (low < high)
+        {
+            u32 middle = (low + high) / 2;
+            if (data->transitions[middle].passIndex < compiledPassIndex)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        for (u32 i = low; i < numTransitions && data->transitions[i].passIndex == compiledPassIndex; i++)
+        {
+            PassTransition& transition = data->transitions[i];
+
+            if (transition.isDepth)
+            {
+                DepthImageID image = resources.GetDepthImage(RenderPassResource(transition.resource));
+                if (transition.type == TransitionType::CLEAR)
+                {
+                    const DepthImageDesc& desc = _renderer->GetDepthImageDesc(image);
+                    commandList.Clear(image, desc.depthClearValue, DepthClearFlags::DEPTH, desc.stencilClearValue);
+                }
+                else if (transition.type == TransitionType::DISCARD)
+                {
+                    commandList.DiscardImage(image);
+                }
+                else
+                {
+                    commandList.ImageBarrier(image, transition.srcStages, transition.dstStages);
+                }
+            }
+            else
+            {
+                ImageID image = resources.GetImage(RenderPassResource(transition.resource));
+                if (transition.type == TransitionType::CLEAR)
+                {
+                    const ImageDesc& desc = _renderer->GetImageDesc(image);
+                    commandList.Clear(image, desc.clearColor);
+                }
+                else if (transition.type == TransitionType::DISCARD)
+                {
+                    commandList.DiscardImage(image);
+                }
+                else
+                {
+                    commandList.ImageBarrier(image, transition.srcStages, transition.dstStages);
+                }
             }
         }
     }
@@ -107,15 +461,32 @@ namespace Renderer
             commandList.AddWaitSemaphore(waitSemaphore);
         }
 
-        // TODO: Parallel_for this
         commandList.PushMarker("RenderGraph", Color(0.0f, 0.0f, 0.4f));
-        for (IRenderPass* pass : data->executingPasses)
+#if COMMANDLIST_DEBUG_IMMEDIATE_MODE
+        // Immediate mode dispatches while we record, so every pass has to be recorded on this thread
+        u32 passIndex = 0;
+        for (IRenderPass* pass : data->compiledPasses)
         {
             ZoneScopedC(tracy::Color::Red2)
             ZoneName(pass->_name, pass->_nameLength)
 
+            AddPassTransitions(passIndex++, commandList);
             pass->Execute(resources, commandList);
         }
+#else
+        // Indexed like compiledPasses, the CommandLists live in the allocator of whoever recorded them
+        std::vector<CommandList*> passCommandLists;
+        RecordPasses(resources, passCommandLists);
+
+        {
+            ZoneScopedNC("Append Passes", tracy::Color::Red2)
+            for (u32 i = 0; i < passCommandLists.size(); i++)
+            {
+                AddPassTransitions(i, commandList);
+                commandList.Append(*passCommandLists[i]);
+            }
+        }
+#endif
         commandList.PopMarker();
         
         {
@@ -123,4 +494,92 @@ namespace Renderer
             commandList.Execute();
         }
     }
+
+    void RenderGraph::RecordPasses(RenderGraphResources& resources, std::vector<CommandList*>& passCommandLists)
+    {
+        ZoneScopedNC("RenderGraph::RecordPasses", tracy::Color::Red2);
+
+        RenderGraphData* data = static_cast<RenderGraphData*>(_data);
+
+        u32 numPasses = static_cast<u32>(data->compiledPasses.Count());
+        passCommandLists.resize(numPasses);
+
+        const bool canRecordInParallel = _desc.taskflow != nullptr && _desc.workerAllocators.size() > 0;
+
+        // Sort the passes into their recording groups, keeping the order they were added in
+        std::vector<RecordingGroup> recordingGroups;
+        std::vector<u32> localPassIndices;
+
+        for (u32 i = 0; i < numPasses; i++)
+        {
+            const void* key = data->compiledPasses[i]->_recordingGroup;
+
+            if (!canRecordInParallel || key == nullptr)
+            {
+                localPassIndices.push_back(i);
+                continue;
+            }
+
+            auto itr = std::find_if(recordingGroups.begin(), recordingGroups.end(), [key](const RecordingGroup& group) { return group.key == key; });
+            if (itr == recordingGroups.end())
+            {
+                RecordingGroup& group = recordingGroups.emplace_back();
+                group.key = key;
+                itr = recordingGroups.end() - 1;
+            }
+
+            itr->passIndices.push_back(i);
+        }
+
+        auto recordPass = [&](u32 passIndex, Memory::Allocator* allocator)
+        {
+            IRenderPass* pass = data->compiledPasses[passIndex];
+
+            ZoneScopedC(tracy::Color::Red2)
+            ZoneName(pass->_name, pass->_nameLength)
+
+            CommandList* passCommandList = Memory::Allocator::New<CommandList>(allocator, _renderer, allocator);
+            pass->Execute(resources, *passCommandList);
+
+            passCommandLists[passIndex] = passCommandList;
+        };
+
+        // Every worker owns one allocator, groups get spread over the workers round robin
+        size_t numWorkers = std::min(recordingGroups.size(), _desc.workerAllocators.size());
+        for (size_t workerIndex = 0; workerIndex < numWorkers; workerIndex++)
+        {
+            _desc.taskflow->emplace([&, workerIndex, numWorkers]()
+            {
+                Memory::Allocator* allocator = _desc.workerAllocators[workerIndex];
+                RenderGraphResources::SetThreadFrameAllocator(allocator);
+
+                for (size_t groupIndex = workerIndex; groupIndex < recordingGroups.size(); groupIndex += numWorkers)
+                {
+                    for (u32 passIndex : recordingGroups[groupIndex].passIndices)
+                    {
+                        recordPass(passIndex, allocator);
+                    }
+                }
+
+                RenderGraphResources::SetThreadFrameAllocator(nullptr);
+            });
+        }
+
+        if (numWorkers > 0)
+        {
+            _desc.taskflow->silent_dispatch();
+        }
+
+        // Record the passes without a group while the workers are busy
+        for (u32 passIndex : localPassIndices)
+        {
+            recordPass(passIndex, _desc.allocator);
+        }
+
+        if (numWorkers > 0)
+        {
+            ZoneScopedNC("Wait for workers", tracy::Color::Red2)
+            _desc.taskflow->wait_for_all();
+        }
+    }
 }
\ No newline at end of file
@@ -19,10 +19,12 @@ namespace Renderer
     public:
         ~RenderGraph();
 
+        // Passes with the same recordingGroup share CPU side state (descriptor sets, constants etc) and record in order on the same worker
+        // Different groups record in parallel with each other, passes without a group record on the thread calling Execute
         template <typename PassData>
-        void AddPass(std::string name, std::function<bool(PassData&, RenderGraphBuilder&)> onSetup, std::function<void(PassData&, RenderGraphResources&, CommandList&)> onExecute)
+        void AddPass(std::string name, std::function<bool(PassData&, RenderGraphBuilder&)> onSetup, std::function<void(PassData&, RenderGraphResources&, CommandList&)> onExecute, const void* recordingGroup = nullptr)
         {
-            IRenderPass* pass = Memory::Allocator::New<RenderPass<PassData>>(_desc.allocator, name, onSetup, onExecute);
+            IRenderPass* pass = Memory::Allocator::New<RenderPass<PassData>>(_desc.allocator, name, onSetup, onExecute, recordingGroup);
             AddPass(pass);
         }
 
@@ -39,6 +41,9 @@ namespace Renderer
         bool Init(RenderGraphDesc& desc);
 
         void AddPass(IRenderPass* pass);
+        void Compile();
+        void AddPassTransitions(u32 compiledPassIndex, CommandList& commandList);
+        void RecordPasses(RenderGraphResources& resources, std::vector<CommandList*>& passCommandLists);
 
     private:
         IRenderGraphData* _data;
@@ -5,13 +5,12 @@
 namespace Renderer
 {
     RenderGraphBuilder::RenderGraphBuilder(Memory::Allocator* allocator, Renderer* renderer)
-        : _renderer(renderer)
+        : _allocator(allocator)
+        , _renderer(renderer)
         , _resources(allocator)
-    {
-
-    }
-
-    void RenderGraphBuilder::Compile(CommandList* /*commandList*/)
+        , _accesses(allocator, 128)
+        , _transientImages(allocator, 8)
+        , _transientDepthImages(allocator, 8)
     {
 
     }
@@ -21,48 +20,114 @@ namespace Renderer
         return _resources;
     }
 
-    ImageID RenderGraphBuilder::Create(ImageDesc& /*desc*/)
+    ImageID RenderGraphBuilder::Create(ImageDesc& desc)
     {
-        return ImageID::Invalid();
+        ImageID id = _renderer->AcquireTransientImage(desc);
+        _transientImages.Insert(id);
+
+        return id;
     }
 
-    DepthImageID RenderGraphBuilder::Create(DepthImageDesc& /*desc*/)
+    DepthImageID RenderGraphBuilder::Create(DepthImageDesc& desc)
     {
-        return DepthImageID::Invalid();
+        DepthImageID id = _renderer->AcquireTransientDepthImage(desc);
+        _transientDepthImages.Insert(id);
+
+        return id;
     }
 
-    RenderPassResource RenderGraphBuilder::Read(ImageID id, ShaderStage /*shaderStage*/)
+    RenderPassResource RenderGraphBuilder::Read(ImageID id, ShaderStage shaderStage)
     {
         RenderPassResource resource = _resources.GetResource(id);
+        AddAccess(static_cast<RenderPassResource::type>(resource), false, false, GetPipelineStages(shaderStage), LoadMode::LOAD);
 
         return resource;
     }
 
     RenderPassResource RenderGraphBuilder::Read(TextureID id, ShaderStage /*shaderStage*/)
     {
+        // Textures are immutable once loaded, so there is nothing to synchronize
         RenderPassResource resource = _resources.GetResource(id);
 
         return resource;
     }
 
-    RenderPassResource RenderGraphBuilder::Read(DepthImageID id, ShaderStage /*shaderStage*/)
+    RenderPassResource RenderGraphBuilder::Read(DepthImageID id, ShaderStage shaderStage)
     {
         RenderPassResource resource = _resources.GetResource(id);
+        AddAccess(static_cast<RenderPassResource::type>(resource), true, false, GetPipelineStages(shaderStage), LoadMode::LOAD);
 
         return resource;
     }
 
-    RenderPassMutableResource RenderGraphBuilder::Write(ImageID id, WriteMode /*writeMode*/, LoadMode /*loadMode*/)
+    RenderPassMutableResource RenderGraphBuilder::Write(ImageID id, WriteMode writeMode, LoadMode loadMode)
     {
         RenderPassMutableResource resource = _resources.GetMutableResource(id);
+        AddAccess(static_cast<RenderPassMutableResource::type>(resource), false, true, GetPipelineStages(writeMode), loadMode);
 
         return resource;
     }
 
-    RenderPassMutableResource RenderGraphBuilder::Write(DepthImageID id, WriteMode /*writeMode*/, LoadMode /*loadMode*/)
+    RenderPassMutableResource RenderGraphBuilder::Write(DepthImageID id, WriteMode writeMode, LoadMode loadMode)
     {
         RenderPassMutableResource resource = _resources.GetMutableResource(id);
+        AddAccess(static_cast<RenderPassMutableResource::type>(resource), true, true, GetPipelineStages(writeMode), loadMode);
 
         return resource;
     }
-}
\ No newline at end of file
+
+    void RenderGraphBuilder::AddAccess(u16 resource, bool isDepth, bool isWrite, u8 stages, LoadMode loadMode)
+    {
+        Access access;
+        access.passIndex = _currentPassIndex;
+        access.resource = resource;
+        access.stages = stages;
+        access.loadMode = loadMode;
+        access.isDepth = isDepth;
+        access.isWrite = isWrite;
+        access.isTransient = isDepth ? IsTransient(_resources.GetDepthImage(RenderPassResource(resource))) : IsTransient(_resources.GetImage(RenderPassResource(resource)));
+
+        _accesses.Insert(access);
+    }
+
+    bool RenderGraphBuilder::IsTransient(ImageID id)
+    {
+        for (ImageID& transientID : _transientImages)
+        {
+            if (transientID == id)
+                return true;
+        }
+
+        return false;
+    }
+
+    bool RenderGraphBuilder::IsTransient(DepthImageID id)
+    {
+        for (DepthImageID& transientID : _transientDepthImages)
+        {
+            if (transientID == id)
+                return true;
+        }
+
+        return false;
+    }
+
+    u8 RenderGraphBuilder::GetPipelineStages(ShaderStage shaderStage)
+    {
+        switch (shaderStage)
+        {
+            case ShaderStage::VERTEX: return PIPELINE_STAGE_VERTEX_SHADER;
+            case ShaderStage::PIXEL: return PIPELINE_STAGE_PIXEL_SHADER;
+            case ShaderStage::COMPUTE: return PIPELINE_STAGE_COMPUTE_SHADER;
+        }
+
+        // We don't know who reads it, so we can't be picky
+        return PIPELINE_STAGE_VERTEX_SHADER | PIPELINE_STAGE_PIXEL_SHADER | PIPELINE_STAGE_COMPUTE_SHADER;
+    }
+
+    u8 RenderGraphBuilder::GetPipelineStages(WriteMode writeMode)
+    {
+        // UAV writes are assumed to come from compute, we don't do pixel shader UAV writes
+        return writeMode == WriteMode::RENDERTARGET ? PIPELINE_STAGE_RENDERTARGET : PIPELINE_STAGE_COMPUTE_SHADER;
+    }
+}
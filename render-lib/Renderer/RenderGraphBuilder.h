@@ -10,6 +10,8 @@
 #include "Descriptors/ImageDesc.h"
 #include "Descriptors/DepthImageDesc.h"
 
+#include <Containers/DynamicArray.h>
+
 namespace Memory
 {
     class Allocator;
@@ -61,15 +63,38 @@ namespace Renderer
         RenderPassMutableResource Write(DepthImageID id, WriteMode writeMode, LoadMode loadMode);
 
     private:
-        void Compile(CommandList* commandList);
+        // Every Read and Write call gets recorded, the RenderGraph compiles these into culling decisions, barriers and clears
+        struct Access
+        {
+            u32 passIndex;
+            u16 resource;
+            u8 stages;
+            LoadMode loadMode;
+            bool isDepth;
+            bool isWrite;
+            bool isTransient;
+        };
+
         RenderGraphResources& GetResources();
 
+        void AddAccess(u16 resource, bool isDepth, bool isWrite, u8 stages, LoadMode loadMode);
+        bool IsTransient(ImageID id);
+        bool IsTransient(DepthImageID id);
+
+        static u8 GetPipelineStages(ShaderStage shaderStage);
+        static u8 GetPipelineStages(WriteMode writeMode);
+
     private:
         Memory::Allocator* _allocator;
         Renderer* _renderer;
 
         RenderGraphResources _resources;
 
+        u32 _currentPassIndex = 0;
+        DynamicArray<Access> _accesses;
+        DynamicArray<ImageID> _transientImages;
+        DynamicArray<DepthImageID> _transientDepthImages;
+
         friend class RenderGraph;
     };
 }
\ No newline at end of file
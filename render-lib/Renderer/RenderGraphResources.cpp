@@ -20,12 +20,24 @@ namespace Renderer
         DynamicArray<DepthImageID> trackedDepthImages;
     };
 
+    thread_local Memory::Allocator* threadFrameAllocator = nullptr;
+
 	RenderGraphResources::RenderGraphResources(Memory::Allocator* allocator)
 		: _allocator(allocator)
         , _data(Memory::Allocator::New<RenderGraphResourcesData>(allocator, allocator))
     {
 	}
 
+    Memory::Allocator* RenderGraphResources::GetFrameAllocator()
+    {
+        return threadFrameAllocator != nullptr ? threadFrameAllocator : _allocator;
+    }
+
+    void RenderGraphResources::SetThreadFrameAllocator(Memory::Allocator* allocator)
+    {
+        threadFrameAllocator = allocator;
+    }
+
     void RenderGraphResources::InitializePipelineDesc(GraphicsPipelineDesc& desc)
     {
         desc.ResourceToImageID = [&](RenderPassResource resource)
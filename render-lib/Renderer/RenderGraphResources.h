@@ -24,12 +24,16 @@ namespace Renderer
         template<typename T, typename... Args>
         T* FrameNew(Args... args)
         {
-            return Memory::Allocator::New<T>(_allocator, args...);
+            return Memory::Allocator::New<T>(GetFrameAllocator(), args...);
         }
 
     private:
         RenderGraphResources(Memory::Allocator* allocator);
 
+        // Passes recording on a worker thread allocate from that workers allocator instead of the shared one
+        Memory::Allocator* GetFrameAllocator();
+        static void SetThreadFrameAllocator(Memory::Allocator* allocator);
+
         ImageID GetImage(RenderPassResource resource);
         ImageID GetImage(RenderPassMutableResource resource);
         DepthImageID GetDepthImage(RenderPassResource resource);
@@ -47,5 +51,6 @@ namespace Renderer
         IRenderGraphResourcesData* _data = nullptr;
 
         friend class RenderGraphBuilder;
+        friend class RenderGraph;
     };
 }
\ No newline at end of file
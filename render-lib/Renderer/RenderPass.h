@@ -21,6 +21,9 @@ namespace Renderer
 
         char _name[32];
         u8 _nameLength = 0;
+
+        // Passes sharing a recording group record in order on the same worker, nullptr records on the thread calling RenderGraph::Execute
+        const void* _recordingGroup = nullptr;
     };
 
     template <typename PassData>
@@ -30,10 +33,12 @@ namespace Renderer
         typedef std::function<bool(PassData&, RenderGraphBuilder&)> SetupFunction;
         typedef std::function<void(PassData&, RenderGraphResources&, CommandList&)> ExecuteFunction;
     
-        RenderPass(std::string& name, SetupFunction onSetup, ExecuteFunction onExecute)
+        RenderPass(std::string& name, SetupFunction onSetup, ExecuteFunction onExecute, const void* recordingGroup)
             : _onSetup(onSetup)
             , _onExecute(onExecute)
         {
+            _recordingGroup = recordingGroup;
+
             if (name.length() >= 32)
             {
                 DebugHandler::PrintFatal("We encountered a render pass name (%s) that is longer than 31 characters, we have this limit because we store the string internally and not on the heap.", name.c_str());
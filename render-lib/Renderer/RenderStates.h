@@ -515,6 +515,17 @@ namespace Renderer
         AllCommands,
     };
 
+    // The RenderGraph derives image barriers from these, PIPELINE_STAGE_NONE on both sides means a full barrier
+    enum PipelineStage : u8
+    {
+        PIPELINE_STAGE_NONE             = 0,
+        PIPELINE_STAGE_VERTEX_SHADER    = (1 << 0),
+        PIPELINE_STAGE_PIXEL_SHADER     = (1 << 1),
+        PIPELINE_STAGE_COMPUTE_SHADER   = (1 << 2),
+        PIPELINE_STAGE_RENDERTARGET     = (1 << 3), // Color attachment output for color images, fragment tests for depth images
+        PIPELINE_STAGE_TRANSFER         = (1 << 4),
+    };
+
     inline ImageComponentType ToImageComponentType(ImageFormat imageFormat)
     {
         switch (imageFormat)
@@ -1,7 +1,9 @@
 #pragma once
 #include <NovusTypes.h>
+#include <vector>
 
 #include "DescriptorSet.h"
+#include "ConstantRingBuffer.h"
 
 // Descriptors
 #include "Descriptors/BufferDesc.h"
@@ -36,6 +38,16 @@ namespace Renderer
     class RenderGraph;
     struct RenderGraphDesc;
 
+    // The first and last compiled pass of a frame that uses a transient image, exactly one of the IDs is valid
+    struct TransientImageLifetime
+    {
+        ImageID image = ImageID::Invalid();
+        DepthImageID depthImage = DepthImageID::Invalid();
+
+        u32 firstPass = 0;
+        u32 lastPass = 0;
+    };
+
     class Renderer
     {
     public:
@@ -43,6 +55,8 @@ namespace Renderer
         virtual void Deinit() = 0;
 
         virtual void ReloadShaders(bool forceRecompileAll) = 0;
+        virtual void WarmupPipelines() = 0; // Builds the pipelines we know about from previous runs, call this during loading to avoid hitches on the first frames
+        virtual void SavePipelineCache() = 0;
 
         virtual ~Renderer();
 
@@ -56,6 +70,12 @@ namespace Renderer
         virtual [[nodiscard]] ImageID CreateImage(ImageDesc& desc) = 0;
         virtual [[nodiscard]] DepthImageID CreateDepthImage(DepthImageDesc& desc) = 0;
 
+        // Transient images only live for the frame that acquired them, the backend hands them out again once the frame has been flipped
+        virtual [[nodiscard]] ImageID AcquireTransientImage(const ImageDesc& desc) = 0;
+        virtual [[nodiscard]] DepthImageID AcquireTransientDepthImage(const DepthImageDesc& desc) = 0;
+        // Transient images whose lifetimes don't overlap get placed in the same memory, acquired images missing from lifetimes are treated as unused this frame
+        virtual void PlaceTransientImages(const TransientImageLifetime* lifetimes, u32 numLifetimes) = 0;
+
         virtual [[nodiscard]] SamplerID CreateSampler(SamplerDesc& sampler) = 0;
         virtual [[nodiscard]] SemaphoreID CreateNSemaphore() = 0;
 
@@ -66,6 +86,9 @@ namespace Renderer
 
         virtual [[nodiscard]] TextureID CreateDataTexture(DataTextureDesc& desc) = 0;
         virtual [[nodiscard]] TextureID CreateDataTextureIntoArray(DataTextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex) = 0;
+        // Uploads a rect of a data texture without recreating it, pixels points at the rect's first texel and its rows are pixelsRowLength texels apart
+        // Returns false if this frame has no staging memory left for rect updates, nothing was uploaded and the caller should try again next frame
+        virtual [[nodiscard]] bool UpdateDataTexture(TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* pixels, u32 pixelsRowLength) = 0;
 
         // Loading
         virtual [[nodiscard]] TextureID LoadTexture(TextureDesc& desc) = 0;
@@ -77,7 +100,9 @@ namespace Renderer
 
         // Unloading
         virtual void UnloadTexture(TextureID textureID) = 0;
+        // Loaded textures are shared between every array they were loaded into, these only destroy a texture once no other array holds it
         virtual void UnloadTexturesInArray(TextureArrayID textureArrayID, u32 unloadStartIndex) = 0;
+        virtual void UnloadTexturesInArray(TextureArrayID textureArrayID, const std::vector<u32>& arrayIndices) = 0; // Frees the given slots so later loads into the array can reuse them
 
         // Command List Functions
         virtual [[nodiscard]] CommandListID BeginCommandList() = 0;
@@ -111,8 +136,10 @@ namespace Renderer
         virtual void CopyImage(CommandListID commandListID, ImageID dstImageID, uvec2 dstPos, u32 dstMipLevel, ImageID srcImageID, uvec2 srcPos, u32 srcMipLevel, uvec2 size) = 0;
         virtual void CopyBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range) = 0;
         virtual void PipelineBarrier(CommandListID commandListID, PipelineBarrierType type, BufferID buffer) = 0;
-        virtual void ImageBarrier(CommandListID commandListID, ImageID image) = 0;
-        virtual void DepthImageBarrier(CommandListID commandListID, DepthImageID image) = 0;
+        virtual void ImageBarrier(CommandListID commandListID, ImageID image, u8 srcStages, u8 dstStages) = 0;
+        virtual void DepthImageBarrier(CommandListID commandListID, DepthImageID image, u8 srcStages, u8 dstStages) = 0;
+        virtual void DiscardImage(CommandListID commandListID, ImageID image) = 0;
+        virtual void DiscardDepthImage(CommandListID commandListID, DepthImageID image) = 0;
         virtual void PushConstant(CommandListID commandListID, void* data, u32 offset, u32 size) = 0;
         virtual void FillBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, u32 data) = 0;
         virtual void UpdateBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, void* data) = 0;
@@ -131,11 +158,19 @@ namespace Renderer
         [[nodiscard]] BufferID CreateAndFillBuffer(BufferDesc desc, void* data, size_t dataSize);
         [[nodiscard]] BufferID CreateAndFillBuffer(BufferID bufferID, BufferDesc desc, const std::function<void(void*)>& callback); // Deletes the current BufferID if it's not invalid
         [[nodiscard]] BufferID CreateAndFillBuffer(BufferDesc desc, const std::function<void(void*)>& callback);
+        // Doesn't block, the copy runs at the start of the next frame before its render graph. Record into a CommandList if you need it this frame
+        // Queued copies run after every CreateUploadBuffer of the same frame no matter which was called first, so don't copy into a range you also upload to
         virtual void CopyBuffer(BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range) = 0;
 
         virtual [[nodiscard]] void* MapBuffer(BufferID buffer) = 0;
         virtual void UnmapBuffer(BufferID buffer) = 0;
 
+        // Per frame constants, bind the slice with DescriptorSet::Bind(nameHash, slice). Only valid after this frame's FlipFrame
+        [[nodiscard]] ConstantSlice AllocateConstants(size_t size) { return _constantRing.Allocate(size); }
+        template <typename T>
+        [[nodiscard]] ConstantSlice PushConstants(const T& data) { return _constantRing.Push(data); }
+        [[nodiscard]] size_t GetConstantRingUsage() { return _constantRing.GetUsedSize(); }
+
         // Utils
         virtual void FlipFrame(u32 frameIndex) = 0;
 
@@ -147,14 +182,22 @@ namespace Renderer
 
         virtual [[nodiscard]] size_t GetVRAMUsage() = 0;
         virtual [[nodiscard]] size_t GetVRAMBudget() = 0;
+        virtual [[nodiscard]] size_t GetTransientVRAMSaved() = 0; // Bytes transient images would take without aliasing, minus what their shared heaps take
 
         virtual [[nodiscard]] u32 GetNumImages() = 0;
         virtual [[nodiscard]] u32 GetNumDepthImages() = 0;
 
+        // Descriptor set cache stats for the last frame
+        virtual [[nodiscard]] u32 GetNumDescriptorSetCacheHits() = 0;
+        virtual [[nodiscard]] u32 GetNumDescriptorSetCacheMisses() = 0;
+        virtual [[nodiscard]] u32 GetNumCachedDescriptorSets() = 0;
+
         virtual void InitImgui() = 0;
         virtual void DrawImgui(CommandListID commandListID) = 0;
 
     protected:
-        Renderer() {}; // Pure virtual class, disallow creation of it
+        Renderer() { _constantRing.Init(this, 1024 * 1024); }; // Pure virtual class, disallow creation of it
+
+        ConstantRingBuffer _constantRing;
     };
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "BufferHandlerVK.h"
 #include "RenderDeviceVK.h"
 #include "DebugMarkerUtilVK.h"
+#include "DescriptorSetBuilderVK.h"
 
 #include <vector>
 #include <queue>
@@ -127,7 +128,7 @@ namespace Renderer
             bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
             bufferInfo.size = desc.size;
             bufferInfo.usage = usage;
-            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE; // Staging uploads hand the ranges they write over to the graphics queue, see UploadBufferHandlerVK
             
             VmaMemoryUsage memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
             if (desc.cpuAccess == BufferCPUAccess::ReadOnly)
@@ -174,6 +175,7 @@ namespace Renderer
 
             Buffer& buffer = data.buffers[(BufferID::type)bufferID];
 
+            _device->_descriptorMegaPool->InvalidateBuffer(buffer.buffer);
             vmaDestroyBuffer(_device->_allocator, buffer.buffer, buffer.allocation);
 
             ReturnBufferID(bufferID);
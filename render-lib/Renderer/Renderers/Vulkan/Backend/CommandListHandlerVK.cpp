@@ -2,7 +2,11 @@
 #include "RenderDeviceVK.h"
 
 #include <queue>
+#include <array>
 #include <vector>
+#include <mutex>
+#include <atomic>
+#include <limits>
 #include <cassert>
 #include <vulkan/vulkan.h>
 #include <Utils/DebugHandler.h>
@@ -16,6 +20,7 @@ namespace Renderer
         struct CommandList
         {
             std::vector<VkSemaphore> waitSemaphores;
+            std::vector<VkPipelineStageFlags> waitDstStageMasks;
             std::vector<VkSemaphore> signalSemaphores;
 
             VkCommandBuffer commandBuffer;
@@ -38,9 +43,15 @@ namespace Renderer
 
         struct CommandListHandlerVKData : ICommandListHandlerVKData
         {
-            std::vector<CommandList> commandLists;
+            // Fixed storage so indexing never races with another thread creating a command list, CommandListID is only a u8 anyway.
+            // Slots below numCommandLists are never moved, only CreateCommandList fills new ones (under mutex)
+            std::array<CommandList, static_cast<size_t>(std::numeric_limits<CommandListID::type>::max()) + 1> commandLists;
+            std::atomic<u32> numCommandLists = 0;
             std::array<CommandListFamily, QueueType::COUNT> commandListFamilies;
 
+            // Upload threads begin and submit command lists while the main thread is recording, this guards the families and the queues
+            std::mutex mutex;
+
             u8 frameIndex = 0;
             FrameResource<VkFence, 2> frameFences;
         };
@@ -77,6 +88,7 @@ namespace Renderer
         void CommandListHandlerVK::ResetCommandBuffers()
         {
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
+            std::scoped_lock lock(data.mutex);
 
             for (u32 i = 0; i < data.commandListFamilies.size(); i++)
             {
@@ -105,11 +117,20 @@ namespace Renderer
             u32 queueTypeIndex = static_cast<u32>(queueType);
 
             CommandListID id;
-            if (!data.commandListFamilies[queueTypeIndex].availableCommandLists.empty())
+            bool hasAvailableCommandList = false;
             {
-                id = data.commandListFamilies[queueTypeIndex].availableCommandLists.front();
-                data.commandListFamilies[queueTypeIndex].availableCommandLists.pop();
+                std::scoped_lock lock(data.mutex);
+
+                if (!data.commandListFamilies[queueTypeIndex].availableCommandLists.empty())
+                {
+                    id = data.commandListFamilies[queueTypeIndex].availableCommandLists.front();
+                    data.commandListFamilies[queueTypeIndex].availableCommandLists.pop();
+                    hasAvailableCommandList = true;
+                }
+            }
 
+            if (hasAvailableCommandList)
+            {
                 CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
 
                 VkCommandBufferBeginInfo beginInfo = {};
@@ -174,30 +195,27 @@ namespace Renderer
                 submitInfo.commandBufferCount = 1;
                 submitInfo.pCommandBuffers = &commandList.commandBuffer;
 
-                u32 numWaitSemaphores = static_cast<u32>(commandList.waitSemaphores.size());
-                std::vector<VkPipelineStageFlags> dstStageMasks(numWaitSemaphores);
-
-                for (VkPipelineStageFlags& dstStageMask : dstStageMasks)
-                {
-                    dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-                }
-
-                submitInfo.waitSemaphoreCount = numWaitSemaphores;
+                submitInfo.waitSemaphoreCount = static_cast<u32>(commandList.waitSemaphores.size());
                 submitInfo.pWaitSemaphores = commandList.waitSemaphores.data();
-                submitInfo.pWaitDstStageMask = dstStageMasks.data();
+                submitInfo.pWaitDstStageMask = commandList.waitDstStageMasks.data();
                 
                 submitInfo.signalSemaphoreCount = static_cast<u32>(commandList.signalSemaphores.size());
                 submitInfo.pSignalSemaphores = commandList.signalSemaphores.data();
 
+                std::scoped_lock lock(data.mutex);
                 vkQueueSubmit(queue, 1, &submitInfo, fence);
             }
 
             commandList.waitSemaphores.clear();
+            commandList.waitDstStageMasks.clear();
             commandList.signalSemaphores.clear();
             commandList.boundGraphicsPipeline = GraphicsPipelineID::Invalid();
 
             u32 queueTypeIndex = static_cast<u32>(commandList.queueType);
-            data.commandListFamilies[queueTypeIndex].closedCommandLists.Get(data.frameIndex).push(id);
+            {
+                std::scoped_lock lock(data.mutex);
+                data.commandListFamilies[queueTypeIndex].closedCommandLists.Get(data.frameIndex).push(id);
+            }
         }
 
         VkCommandBuffer CommandListHandlerVK::GetCommandBuffer(CommandListID id)
@@ -205,23 +223,24 @@ namespace Renderer
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
 
             // Lets make sure this id exists
-            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+            assert(data.numCommandLists.load(std::memory_order_acquire) > static_cast<CommandListID::type>(id));
 
             CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
 
             return commandList.commandBuffer;
         }
 
-        void CommandListHandlerVK::AddWaitSemaphore(CommandListID id, VkSemaphore semaphore)
+        void CommandListHandlerVK::AddWaitSemaphore(CommandListID id, VkSemaphore semaphore, VkPipelineStageFlags dstStageMask)
         {
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
 
             // Lets make sure this id exists
-            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+            assert(data.numCommandLists.load(std::memory_order_acquire) > static_cast<CommandListID::type>(id));
 
             CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
 
             commandList.waitSemaphores.push_back(semaphore);
+            commandList.waitDstStageMasks.push_back(dstStageMask);
         }
 
         void CommandListHandlerVK::AddSignalSemaphore(CommandListID id, VkSemaphore semaphore)
@@ -229,7 +248,7 @@ namespace Renderer
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
 
             // Lets make sure this id exists
-            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+            assert(data.numCommandLists.load(std::memory_order_acquire) > static_cast<CommandListID::type>(id));
 
             CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
 
@@ -241,7 +260,7 @@ namespace Renderer
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
 
             // Lets make sure this id exists
-            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+            assert(data.numCommandLists.load(std::memory_order_acquire) > static_cast<CommandListID::type>(id));
 
             CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
 
@@ -253,7 +272,7 @@ namespace Renderer
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
 
             // Lets make sure this id exists
-            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+            assert(data.numCommandLists.load(std::memory_order_acquire) > static_cast<CommandListID::type>(id));
 
             CommandList& commandList = data.commandLists[static_cast<CommandListID::type>(id)];
 
@@ -265,7 +284,7 @@ namespace Renderer
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
 
             // Lets make sure this id exists
-            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+            assert(data.numCommandLists.load(std::memory_order_acquire) > static_cast<CommandListID::type>(id));
 
             return data.commandLists[static_cast<CommandListID::type>(id)].boundGraphicsPipeline;
         }
@@ -275,7 +294,7 @@ namespace Renderer
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
 
             // Lets make sure this id exists
-            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+            assert(data.numCommandLists.load(std::memory_order_acquire) > static_cast<CommandListID::type>(id));
 
             return data.commandLists[static_cast<CommandListID::type>(id)].boundComputePipeline;
         }
@@ -303,7 +322,7 @@ namespace Renderer
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
 
             // Lets make sure this id exists
-            assert(data.commandLists.size() > static_cast<CommandListID::type>(id));
+            assert(data.numCommandLists.load(std::memory_order_acquire) > static_cast<CommandListID::type>(id));
 
             return data.commandLists[static_cast<CommandListID::type>(id)].tracyScope;
         }
@@ -318,14 +337,11 @@ namespace Renderer
         {
             CommandListHandlerVKData& data = static_cast<CommandListHandlerVKData&>(*_data);
 
-            size_t id = data.commandLists.size();
-            assert(id < CommandListID::MaxValue());
-
             CommandList commandList;
             commandList.queueType = queueType;
 
             // Create commandpool
-            QueueFamilyIndices queueFamilyIndices = _device->FindQueueFamilies(_device->_physicalDevice);
+            const QueueFamilyIndices& queueFamilyIndices = _device->_queueFamilyIndices;
 
             u32 queueFamilyIndex = 0;
             switch (queueType)
@@ -343,7 +359,7 @@ namespace Renderer
 
             VkCommandPoolCreateInfo poolInfo = {};
             poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-            poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+            poolInfo.queueFamilyIndex = queueFamilyIndex;
             poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
             if (vkCreateCommandPool(_device->_device, &poolInfo, nullptr, &commandList.commandPool) != VK_SUCCESS)
@@ -374,7 +390,19 @@ namespace Renderer
                 DebugHandler::PrintFatal("Failed to begin recording command buffer!");
             }
 
-            data.commandLists.push_back(commandList);
+            size_t id;
+            {
+                std::scoped_lock lock(data.mutex);
+
+                id = data.numCommandLists.load(std::memory_order_relaxed);
+                if (id >= data.commandLists.size())
+                {
+                    DebugHandler::PrintFatal("Ran out of command lists, we have %u", static_cast<u32>(data.commandLists.size()));
+                }
+
+                data.commandLists[id] = commandList;
+                data.numCommandLists.store(static_cast<u32>(id + 1), std::memory_order_release);
+            }
 
             return CommandListID(static_cast<CommandListID::type>(id));
         }
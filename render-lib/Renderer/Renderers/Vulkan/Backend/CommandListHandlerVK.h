@@ -40,7 +40,7 @@ namespace Renderer
 
             VkCommandBuffer GetCommandBuffer(CommandListID id);
 
-            void AddWaitSemaphore(CommandListID id, VkSemaphore semaphore);
+            void AddWaitSemaphore(CommandListID id, VkSemaphore semaphore, VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
             void AddSignalSemaphore(CommandListID id, VkSemaphore semaphore);
 
             void SetBoundGraphicsPipeline(CommandListID id, GraphicsPipelineID pipelineID);
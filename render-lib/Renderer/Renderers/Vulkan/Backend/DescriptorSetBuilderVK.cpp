@@ -4,12 +4,17 @@
 #include "RenderDeviceVK.h"
 
 #include <Utils/StringUtils.h>
+#include <Utils/XXHash64.h>
+#include <algorithm>
 #include <vulkan/vulkan.h>
 
 namespace Renderer
 {
     namespace Backend
     {
+        // Cached sets that haven't been bound for this many frames get evicted and their VkDescriptorSet reused for something else
+        constexpr u64 DESCRIPTOR_CACHE_MAX_UNUSED_FRAMES = 60;
+
         DescriptorSetBuilderVK::DescriptorSetBuilderVK(GraphicsPipelineID pipelineID, PipelineHandlerVK* pipelineHandler, ShaderHandlerVK* shaderHandler, DescriptorMegaPoolVK* parentPool)
         {
             _pipelineType = PipelineType::Graphics;
@@ -380,11 +385,81 @@ namespace Renderer
                 }
             }
 
+            if (lifetime == DescriptorLifetime::Cached)
+            {
+                std::vector<VkBuffer> referencedBuffers;
+                u64 contentHash;
+                u64 verifyHash;
+                CalculateDescriptorHashes(set, *layout, contentHash, verifyHash, referencedBuffers);
+                u32 variableCount = next != nullptr ? counts[0] : 0;
+
+                bool needsUpdate = false;
+                VkDescriptorSet cachedSet = _parentPool->AllocateCachedDescriptor(contentHash, verifyHash, *layout, variableCount, referencedBuffers, next, needsUpdate);
+
+                if (needsUpdate)
+                {
+                    UpdateDescriptor(set, cachedSet, *_parentPool->_device);
+                }
+
+                return cachedSet;
+            }
+
             VkDescriptorSet newSet = _parentPool->AllocateDescriptor(*layout, lifetime, next);
             UpdateDescriptor(set, newSet, *_parentPool->_device);
             return newSet;
         }
 
+        void DescriptorSetBuilderVK::CalculateDescriptorHashes(i32 set, VkDescriptorSetLayout layout, u64& contentHash, u64& verifyHash, std::vector<VkBuffer>& referencedBuffers)
+        {
+            // Each step is seeded with the previous result, so starting the two chains from different seeds keeps their collisions unrelated
+            contentHash = 0;
+            verifyHash = 0x9E3779B97F4A7C15;
+
+            auto hash = [&contentHash, &verifyHash](const void* data, size_t size)
+            {
+                contentHash = XXHash64::hash(data, size, contentHash);
+                verifyHash = XXHash64::hash(data, size, verifyHash);
+            };
+
+            // This has to cover exactly what UpdateDescriptor would write into the set
+            hash(&layout, sizeof(layout));
+
+            for (const ImageWriteDescriptor& imageWrite : _imageWrites)
+            {
+                if (imageWrite.dstSet != set)
+                    continue;
+
+                hash(&imageWrite.dstBinding, sizeof(imageWrite.dstBinding));
+                hash(&imageWrite.descriptorType, sizeof(imageWrite.descriptorType));
+
+                if (imageWrite.imageArray != nullptr)
+                {
+                    hash(&imageWrite.imageCount, sizeof(imageWrite.imageCount));
+                    hash(imageWrite.imageArray, sizeof(VkDescriptorImageInfo) * imageWrite.imageCount);
+                }
+                else
+                {
+                    hash(&imageWrite.imageInfo.sampler, sizeof(imageWrite.imageInfo.sampler));
+                    hash(&imageWrite.imageInfo.imageView, sizeof(imageWrite.imageInfo.imageView));
+                    hash(&imageWrite.imageInfo.imageLayout, sizeof(imageWrite.imageInfo.imageLayout));
+                }
+            }
+
+            for (const BufferWriteDescriptor& bufferWrite : _bufferWrites)
+            {
+                if (bufferWrite.dstSet != set)
+                    continue;
+
+                hash(&bufferWrite.dstBinding, sizeof(bufferWrite.dstBinding));
+                hash(&bufferWrite.descriptorType, sizeof(bufferWrite.descriptorType));
+                hash(&bufferWrite.bufferInfo.buffer, sizeof(bufferWrite.bufferInfo.buffer));
+                hash(&bufferWrite.bufferInfo.offset, sizeof(bufferWrite.bufferInfo.offset));
+                hash(&bufferWrite.bufferInfo.range, sizeof(bufferWrite.bufferInfo.range));
+
+                referencedBuffers.push_back(bufferWrite.bufferInfo.buffer);
+            }
+        }
+
         VkDescriptorSet DescriptorMegaPoolVK::AllocateDescriptor(VkDescriptorSetLayout layout, DescriptorLifetime lifetime, void* next)
         {
             if (lifetime == DescriptorLifetime::Static)
@@ -401,20 +476,177 @@ namespace Renderer
             }
         }
 
+        VkDescriptorSet DescriptorMegaPoolVK::AllocateCachedDescriptor(u64 contentHash, u64 verifyHash, VkDescriptorSetLayout layout, u32 variableCount, const std::vector<VkBuffer>& referencedBuffers, void* next, bool& needsUpdate)
+        {
+            std::scoped_lock lock(_cacheMutex);
+            RetireSetsUsingDestroyedBuffers();
+
+            auto itr = _cachedSets.find(contentHash);
+            if (itr != _cachedSets.end())
+            {
+                CachedDescriptorSet& cachedSet = itr->second;
+                if (cachedSet.layout == layout && cachedSet.variableCount == variableCount && cachedSet.verifyHash == verifyHash)
+                {
+                    cachedSet.lastUsedFrame = _frameNumber;
+                    _currentFrameCacheStats.numHits++;
+
+                    needsUpdate = false;
+                    return cachedSet.set;
+                }
+
+                // Hash collision, the old set might still be in flight so it has to age out before we can reuse it
+                _retiredSets.push_back(cachedSet);
+                _cachedSets.erase(itr);
+            }
+
+            _currentFrameCacheStats.numMisses++;
+
+            CachedDescriptorSet newCachedSet;
+            newCachedSet.layout = layout;
+            newCachedSet.variableCount = variableCount;
+            newCachedSet.verifyHash = verifyHash;
+            newCachedSet.lastUsedFrame = _frameNumber;
+            newCachedSet.buffers = referencedBuffers;
+
+            auto freeItr = _freeSets.find(GetFreeListKey(layout, variableCount));
+            if (freeItr != _freeSets.end() && !freeItr->second.empty())
+            {
+                newCachedSet.set = freeItr->second.back();
+                freeItr->second.pop_back();
+            }
+            else
+            {
+                _cachedHandle.Allocate(layout, newCachedSet.set, next);
+            }
+
+            _cachedSets[contentHash] = newCachedSet;
+
+            needsUpdate = true;
+            return newCachedSet.set;
+        }
+
+        void DescriptorMegaPoolVK::InvalidateBuffer(VkBuffer buffer)
+        {
+            std::scoped_lock lock(_cacheMutex);
+            _destroyedBuffers.insert(buffer);
+        }
+
+        void DescriptorMegaPoolVK::InvalidateCache()
+        {
+            std::scoped_lock lock(_cacheMutex);
+
+            for (auto& itr : _cachedSets)
+            {
+                _retiredSets.push_back(itr.second);
+            }
+            _cachedSets.clear();
+        }
+
+        void DescriptorMegaPoolVK::ResetCache()
+        {
+            std::scoped_lock lock(_cacheMutex);
+
+            _cachedSets.clear();
+            _retiredSets.clear();
+            _freeSets.clear();
+            _destroyedBuffers.clear();
+
+            // Every cached set came from these pools, so resetting them frees all of them at once.
+            // The handle has to go back first, a Flip only resets the pools the allocator pool holds on to
+            _cachedHandle.Return();
+            _cachedAllocatorPool->Flip();
+            _cachedHandle = _cachedAllocatorPool->GetAllocator();
+        }
+
+        u64 DescriptorMegaPoolVK::GetFreeListKey(VkDescriptorSetLayout layout, u32 variableCount)
+        {
+            u64 hash = XXHash64::hash(&layout, sizeof(layout), 0);
+            return XXHash64::hash(&variableCount, sizeof(variableCount), hash);
+        }
+
+        void DescriptorMegaPoolVK::RecycleCachedDescriptor(const CachedDescriptorSet& cachedSet)
+        {
+            _freeSets[GetFreeListKey(cachedSet.layout, cachedSet.variableCount)].push_back(cachedSet.set);
+        }
+
+        void DescriptorMegaPoolVK::RetireSetsUsingDestroyedBuffers()
+        {
+            if (_destroyedBuffers.empty())
+                return;
+
+            for (auto itr = _cachedSets.begin(); itr != _cachedSets.end();)
+            {
+                const std::vector<VkBuffer>& buffers = itr->second.buffers;
+                bool usesDestroyedBuffer = std::any_of(buffers.begin(), buffers.end(), [&](VkBuffer buffer) { return _destroyedBuffers.count(buffer) > 0; });
+
+                if (usesDestroyedBuffer)
+                {
+                    _retiredSets.push_back(std::move(itr->second));
+                    itr = _cachedSets.erase(itr);
+                }
+                else
+                {
+                    ++itr;
+                }
+            }
+
+            _destroyedBuffers.clear();
+        }
+
         void DescriptorMegaPoolVK::Init(i32 numFrames, RenderDeviceVK* device)
         {
             _device = device;
+            _numFrames = numFrames;
 
             _dynamicAllocatorPool = DescriptorAllocatorPoolVK::Create(device, numFrames);
             _staticAllocatorPool = DescriptorAllocatorPoolVK::Create(device, 1);
+            _cachedAllocatorPool = DescriptorAllocatorPoolVK::Create(device, 1);
             _dynamicHandle = _dynamicAllocatorPool->GetAllocator();
             _staticHandle = _staticAllocatorPool->GetAllocator();
+            _cachedHandle = _cachedAllocatorPool->GetAllocator();
         }
 
         void DescriptorMegaPoolVK::SetFrame(i32 frameNumber)
         {
             _dynamicAllocatorPool->Flip();
             _dynamicHandle = _dynamicAllocatorPool->GetAllocator();
+
+            std::scoped_lock lock(_cacheMutex);
+            RetireSetsUsingDestroyedBuffers();
+            _frameNumber++;
+
+            _cacheStats = _currentFrameCacheStats;
+            _cacheStats.numCachedSets = static_cast<u32>(_cachedSets.size());
+            _currentFrameCacheStats = DescriptorSetCacheStats();
+
+            for (auto itr = _cachedSets.begin(); itr != _cachedSets.end();)
+            {
+                if (_frameNumber - itr->second.lastUsedFrame > DESCRIPTOR_CACHE_MAX_UNUSED_FRAMES)
+                {
+                    RecycleCachedDescriptor(itr->second);
+                    itr = _cachedSets.erase(itr);
+                }
+                else
+                {
+                    ++itr;
+                }
+            }
+
+            // Once every frame that could have bound a retired set has finished on the GPU we can rewrite it
+            for (size_t i = 0; i < _retiredSets.size();)
+            {
+                if (_frameNumber - _retiredSets[i].lastUsedFrame > static_cast<u64>(_numFrames))
+                {
+                    RecycleCachedDescriptor(_retiredSets[i]);
+
+                    _retiredSets[i] = _retiredSets.back();
+                    _retiredSets.pop_back();
+                }
+                else
+                {
+                    i++;
+                }
+            }
         }
     }
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include <NovusTypes.h>
 #include <vector>
+#include <mutex>
+#include <robin_hood.h>
 #include <vulkan/vulkan_core.h>
 
 #include "DescriptorAllocatorVK.h"
@@ -19,7 +21,8 @@ namespace Renderer
         enum class DescriptorLifetime 
         {
             Static,
-            PerFrame
+            PerFrame,
+            Cached // Reuses an existing set if one with the same layout and resources was built recently
         };
 
         struct DescriptorMegaPoolVK;
@@ -53,6 +56,10 @@ namespace Renderer
             void UpdateDescriptor(i32 set, VkDescriptorSet& descriptor, RenderDeviceVK& device);
             VkDescriptorSet BuildDescriptor(i32 set, DescriptorLifetime lifetime);
 
+        private:
+            // contentHash is the cache key, verifyHash runs over the same data with a different seed so a collision in the key can't hand out the wrong set
+            void CalculateDescriptorHashes(i32 set, VkDescriptorSetLayout layout, u64& contentHash, u64& verifyHash, std::vector<VkBuffer>& referencedBuffers);
+
         private:
             enum class PipelineType
             {
@@ -102,10 +109,29 @@ namespace Renderer
             VkDescriptorPool pool;
         };
 
+        struct DescriptorSetCacheStats
+        {
+            u32 numHits = 0;
+            u32 numMisses = 0;
+            u32 numCachedSets = 0;
+        };
+
         struct DescriptorMegaPoolVK
         {
             VkDescriptorSet AllocateDescriptor(VkDescriptorSetLayout layout, DescriptorLifetime lifetime, void* next = nullptr);
 
+            // Returns a set previously built with the same contentHash and verifyHash, or a fresh one in which case needsUpdate is set and the caller has to write it
+            VkDescriptorSet AllocateCachedDescriptor(u64 contentHash, u64 verifyHash, VkDescriptorSetLayout layout, u32 variableCount, const std::vector<VkBuffer>& referencedBuffers, void* next, bool& needsUpdate);
+
+            // Retires cached sets referencing this buffer, a new buffer could get the same handle after it's destroyed
+            void InvalidateBuffer(VkBuffer buffer);
+            // Stops handing out cached sets, call this when resources they might reference get destroyed
+            void InvalidateCache();
+            // Frees every cached set back to its pool, only safe while the GPU is idle since the layouts they were built from are about to be destroyed
+            void ResetCache();
+
+            const DescriptorSetCacheStats& GetCacheStats() { return _cacheStats; }
+
             void Init(i32 numFrames, RenderDeviceVK* device);
             void SetFrame(i32 frameNumber);
 
@@ -115,7 +141,40 @@ namespace Renderer
             DescriptorAllocatorPoolVK* _dynamicAllocatorPool;
             DescriptorAllocatorPoolVK* _staticAllocatorPool;
 
+            // Cached sets get pools of their own so ResetCache can reset them wholesale without touching static sets
+            DescriptorAllocatorHandleVK _cachedHandle;
+            DescriptorAllocatorPoolVK* _cachedAllocatorPool;
+
             RenderDeviceVK* _device;
+
+        private:
+            struct CachedDescriptorSet
+            {
+                VkDescriptorSet set;
+                VkDescriptorSetLayout layout;
+                u32 variableCount;
+                u64 verifyHash;
+                u64 lastUsedFrame;
+                std::vector<VkBuffer> buffers;
+            };
+
+            u64 GetFreeListKey(VkDescriptorSetLayout layout, u32 variableCount);
+            void RecycleCachedDescriptor(const CachedDescriptorSet& cachedSet);
+            void RetireSetsUsingDestroyedBuffers();
+
+        private:
+            std::mutex _cacheMutex;
+
+            i32 _numFrames = 0;
+            u64 _frameNumber = 0;
+
+            robin_hood::unordered_map<u64, CachedDescriptorSet> _cachedSets; // Keyed on the hash of the layout and everything written into the set
+            std::vector<CachedDescriptorSet> _retiredSets; // Invalidated sets, these wait until the GPU can't be using them anymore before getting recycled
+            robin_hood::unordered_map<u64, std::vector<VkDescriptorSet>> _freeSets; // Evicted sets ready to be rewritten, keyed on layout and variable count
+            robin_hood::unordered_set<VkBuffer> _destroyedBuffers; // Batched up so we only walk the cache once no matter how many buffers got destroyed
+
+            DescriptorSetCacheStats _cacheStats;
+            DescriptorSetCacheStats _currentFrameCacheStats;
         };
     }
 }
\ No newline at end of file
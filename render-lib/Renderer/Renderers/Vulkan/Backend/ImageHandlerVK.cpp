@@ -1,12 +1,16 @@
 #include "ImageHandlerVK.h"
 #include <Utils/DebugHandler.h>
 #include <Utils/StringUtils.h>
+#include <Utils/XXHash64.h>
 #include <vulkan/vulkan.h>
 #include <vector>
+#include <algorithm>
+#include <limits>
 
 #include "RenderDeviceVK.h"
 #include "FormatConverterVK.h"
 #include "DebugMarkerUtilVK.h"
+#include "../../../Renderer.h"
 
 namespace Renderer
 {
@@ -46,6 +50,7 @@ namespace Renderer
             std::vector<VkImageView> mipViews;
 
             bool isSwapchain = false;
+            bool isTransient = false; // Transient images don't own their memory, it belongs to a transient heap
         };
 
         struct DepthImage
@@ -55,12 +60,60 @@ namespace Renderer
             VmaAllocation allocation;
             VkImage image;
             VkImageView depthView;
+
+            bool isTransient = false;
+        };
+
+        constexpr u32 TRANSIENT_UNUSED_PASS = std::numeric_limits<u32>::max();
+
+        struct TransientPlacement
+        {
+            VkMemoryRequirements memoryRequirements;
+
+            // Lifetime in the last frame, images that weren't used can share memory with anything
+            u32 firstPass = TRANSIENT_UNUSED_PASS;
+            u32 lastPass = TRANSIENT_UNUSED_PASS;
+
+            u32 heapIndex = 0;
+            bool isBound = false;
+        };
+
+        struct TransientImage
+        {
+            u64 descHash;
+            ImageID id;
+            bool inUse;
+
+            TransientPlacement placement;
+        };
+
+        struct TransientDepthImage
+        {
+            u64 descHash;
+            DepthImageID id;
+            bool inUse;
+
+            TransientPlacement placement;
+        };
+
+        // Every image placed in a heap is bound at offset 0, so the heap is as big as the biggest of them
+        struct TransientHeap
+        {
+            VkMemoryRequirements memoryRequirements;
+            VmaAllocation allocation = VK_NULL_HANDLE;
         };
 
         struct ImageHandlerVKData : IImageHandlerVKData
         {
             std::vector<Image> images;
             std::vector<DepthImage> depthImages;
+
+            std::vector<TransientImage> transientImages;
+            std::vector<TransientDepthImage> transientDepthImages;
+            std::vector<TransientHeap> transientHeaps;
+
+            u64 transientPlacementHash = 0;
+            size_t transientBytesSaved = 0;
         };
 
         void ImageHandlerVK::Init(RenderDeviceVK* device)
@@ -76,7 +129,7 @@ namespace Renderer
             // Recreate color images
             for (auto& image : data.images)
             {
-                if (image.desc.dimensionType == ImageDimensionType::DIMENSION_SCALE)
+                if (image.desc.dimensionType == ImageDimensionType::DIMENSION_SCALE && !image.isTransient)
                 {
                     // Destroy old image
                     vkDestroyImageView(_device->_device, image.colorView, nullptr);
@@ -97,7 +150,7 @@ namespace Renderer
             // Recreate depth images
             for (auto& image : data.depthImages)
             {
-                if (image.desc.dimensionType == ImageDimensionType::DIMENSION_SCALE)
+                if (image.desc.dimensionType == ImageDimensionType::DIMENSION_SCALE && !image.isTransient)
                 {
                     // Destroy old image
                     vkDestroyImageView(_device->_device, image.depthView, nullptr);
@@ -107,6 +160,9 @@ namespace Renderer
                     CreateImage(image);
                 }
             }
+
+            // Transient images change size too, so they need new memory requirements and heaps, the lifetimes from the last frame are still good
+            UpdateTransientPlacement(true);
         }
 
         ImageID ImageHandlerVK::CreateImage(const ImageDesc& desc)
@@ -190,6 +246,378 @@ namespace Renderer
             return DepthImageID(static_cast<DepthImageID::type>(nextHandle));
         }
 
+        ImageID ImageHandlerVK::AcquireTransientImage(const ImageDesc& desc)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            u64 descHash = GetDescHash(desc);
+            for (TransientImage& transientImage : data.transientImages)
+            {
+                if (!transientImage.inUse && transientImage.descHash == descHash)
+                {
+                    transientImage.inUse = true;
+                    return transientImage.id;
+                }
+            }
+
+            size_t nextHandle = data.images.size();
+            assert(nextHandle < ImageID::MaxValue());
+
+            // Nothing free matches this desc, so the pool grows, the image gets its memory once the RenderGraph places it
+            Image image;
+            image.desc = desc;
+            image.isTransient = true;
+
+            TransientImage& transientImage = data.transientImages.emplace_back();
+            transientImage.descHash = descHash;
+            transientImage.id = ImageID(static_cast<ImageID::type>(nextHandle));
+            transientImage.inUse = true;
+            CreateTransientImage(image, transientImage.placement);
+
+            data.images.push_back(image);
+
+            return transientImage.id;
+        }
+
+        DepthImageID ImageHandlerVK::AcquireTransientDepthImage(const DepthImageDesc& desc)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            u64 descHash = GetDescHash(desc);
+            for (TransientDepthImage& transientImage : data.transientDepthImages)
+            {
+                if (!transientImage.inUse && transientImage.descHash == descHash)
+                {
+                    transientImage.inUse = true;
+                    return transientImage.id;
+                }
+            }
+
+            size_t nextHandle = data.depthImages.size();
+            assert(nextHandle < DepthImageID::MaxValue());
+
+            // Nothing free matches this desc, so the pool grows, the image gets its memory once the RenderGraph places it
+            DepthImage image;
+            image.desc = desc;
+            image.isTransient = true;
+
+            TransientDepthImage& transientImage = data.transientDepthImages.emplace_back();
+            transientImage.descHash = descHash;
+            transientImage.id = DepthImageID(static_cast<DepthImageID::type>(nextHandle));
+            transientImage.inUse = true;
+            CreateTransientImage(image, transientImage.placement);
+
+            data.depthImages.push_back(image);
+
+            return transientImage.id;
+        }
+
+        void ImageHandlerVK::ResetTransientImages()
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            for (TransientImage& transientImage : data.transientImages)
+            {
+                transientImage.inUse = false;
+            }
+
+            for (TransientDepthImage& transientImage : data.transientDepthImages)
+            {
+                transientImage.inUse = false;
+            }
+        }
+
+        bool ImageHandlerVK::PlaceTransientImages(const TransientImageLifetime* lifetimes, u32 numLifetimes)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            for (TransientImage& transientImage : data.transientImages)
+            {
+                transientImage.placement.firstPass = TRANSIENT_UNUSED_PASS;
+                transientImage.placement.lastPass = TRANSIENT_UNUSED_PASS;
+            }
+
+            for (TransientDepthImage& transientImage : data.transientDepthImages)
+            {
+                transientImage.placement.firstPass = TRANSIENT_UNUSED_PASS;
+                transientImage.placement.lastPass = TRANSIENT_UNUSED_PASS;
+            }
+
+            for (u32 i = 0; i < numLifetimes; i++)
+            {
+                const TransientImageLifetime& lifetime = lifetimes[i];
+                TransientPlacement* placement = nullptr;
+
+                if (lifetime.image != ImageID::Invalid())
+                {
+                    auto itr = std::find_if(data.transientImages.begin(), data.transientImages.end(), [&](const TransientImage& transientImage) { return transientImage.id == lifetime.image; });
+                    if (itr != data.transientImages.end())
+                    {
+                        placement = &itr->placement;
+                    }
+                }
+                else
+                {
+                    auto itr = std::find_if(data.transientDepthImages.begin(), data.transientDepthImages.end(), [&](const TransientDepthImage& transientImage) { return transientImage.id == lifetime.depthImage; });
+                    if (itr != data.transientDepthImages.end())
+                    {
+                        placement = &itr->placement;
+                    }
+                }
+
+                if (placement == nullptr)
+                {
+                    DebugHandler::PrintFatal("Tried to place an image that was not acquired as a transient image");
+                }
+
+                placement->firstPass = lifetime.firstPass;
+                placement->lastPass = lifetime.lastPass;
+            }
+
+            return UpdateTransientPlacement(false);
+        }
+
+        size_t ImageHandlerVK::GetTransientBytesSaved()
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            return data.transientBytesSaved;
+        }
+
+        bool ImageHandlerVK::UpdateTransientPlacement(bool forceRebuild)
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            if (data.transientImages.size() == 0 && data.transientDepthImages.size() == 0)
+                return false;
+
+            if (forceRebuild)
+            {
+                // The memory requirements are about to change, so get rid of the old images before planning
+                DestroyTransientImages();
+            }
+
+            std::vector<TransientPlacement*> placements;
+            placements.reserve(data.transientImages.size() + data.transientDepthImages.size());
+
+            for (TransientImage& transientImage : data.transientImages)
+            {
+                placements.push_back(&transientImage.placement);
+            }
+
+            for (TransientDepthImage& transientImage : data.transientDepthImages)
+            {
+                placements.push_back(&transientImage.placement);
+            }
+
+            // First fit with the biggest images first, two images can share a heap if their lifetimes don't overlap and they agree on a memory type
+            std::vector<TransientPlacement*> sortedPlacements = placements;
+            std::stable_sort(sortedPlacements.begin(), sortedPlacements.end(), [](const TransientPlacement* a, const TransientPlacement* b)
+            {
+                return a->memoryRequirements.size > b->memoryRequirements.size;
+            });
+
+            auto overlaps = [](const TransientPlacement* a, const TransientPlacement* b)
+            {
+                if (a->firstPass == TRANSIENT_UNUSED_PASS || b->firstPass == TRANSIENT_UNUSED_PASS)
+                    return false;
+
+                return a->firstPass <= b->lastPass && b->firstPass <= a->lastPass;
+            };
+
+            std::vector<TransientHeap> heaps;
+            std::vector<std::vector<TransientPlacement*>> heapPlacements;
+            size_t unaliasedSize = 0;
+
+            for (TransientPlacement* placement : sortedPlacements)
+            {
+                const VkMemoryRequirements& requirements = placement->memoryRequirements;
+                unaliasedSize += requirements.size;
+
+                u32 heapIndex = 0;
+                for (; heapIndex < heaps.size(); heapIndex++)
+                {
+                    if ((heaps[heapIndex].memoryRequirements.memoryTypeBits & requirements.memoryTypeBits) == 0)
+                        continue;
+
+                    bool isFree = std::none_of(heapPlacements[heapIndex].begin(), heapPlacements[heapIndex].end(), [&](const TransientPlacement* other) { return overlaps(placement, other); });
+                    if (isFree)
+                        break;
+                }
+
+                if (heapIndex == heaps.size())
+                {
+                    TransientHeap& heap = heaps.emplace_back();
+                    heap.memoryRequirements = requirements;
+                    heapPlacements.emplace_back();
+                }
+                else
+                {
+                    VkMemoryRequirements& heapRequirements = heaps[heapIndex].memoryRequirements;
+                    heapRequirements.size = std::max(heapRequirements.size, requirements.size);
+                    heapRequirements.alignment = std::max(heapRequirements.alignment, requirements.alignment);
+                    heapRequirements.memoryTypeBits &= requirements.memoryTypeBits;
+                }
+
+                heapPlacements[heapIndex].push_back(placement);
+                placement->heapIndex = heapIndex;
+            }
+
+            // As long as every image stays in the same heap there is nothing to do, which is the case for almost every frame
+            u64 placementHash = heaps.size();
+            for (TransientPlacement* placement : placements)
+            {
+                placementHash = XXHash64::hash(&placement->heapIndex, sizeof(u32), placementHash);
+            }
+
+            bool isBound = std::all_of(placements.begin(), placements.end(), [](const TransientPlacement* placement) { return placement->isBound; });
+            if (isBound && placementHash == data.transientPlacementHash)
+                return false;
+
+            if (!forceRebuild)
+            {
+                // Images can't be rebound, so anything already placed has to be recreated, this only happens when the set of transient images or their lifetimes change
+                vkDeviceWaitIdle(_device->_device);
+                DestroyTransientImages();
+            }
+
+            size_t aliasedSize = 0;
+            for (TransientHeap& heap : heaps)
+            {
+                VmaAllocationCreateInfo allocInfo = {};
+                allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+                if (vmaAllocateMemory(_device->_allocator, &heap.memoryRequirements, &allocInfo, &heap.allocation, nullptr) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Failed to allocate transient image heap!");
+                }
+
+                aliasedSize += heap.memoryRequirements.size;
+            }
+
+            for (TransientImage& transientImage : data.transientImages)
+            {
+                Image& image = data.images[static_cast<ImageID::type>(transientImage.id)];
+                TransientPlacement& placement = transientImage.placement;
+
+                if (vmaBindImageMemory(_device->_allocator, heaps[placement.heapIndex].allocation, image.image) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Failed to bind transient image memory!");
+                }
+
+                CreateImageViews(image, FormatConverterVK::ToVkFormat(image.desc.format));
+                placement.isBound = true;
+            }
+
+            for (TransientDepthImage& transientImage : data.transientDepthImages)
+            {
+                DepthImage& image = data.depthImages[static_cast<DepthImageID::type>(transientImage.id)];
+                TransientPlacement& placement = transientImage.placement;
+
+                if (vmaBindImageMemory(_device->_allocator, heaps[placement.heapIndex].allocation, image.image) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Failed to bind transient image memory!");
+                }
+
+                CreateImageViews(image);
+                placement.isBound = true;
+            }
+
+            data.transientHeaps = std::move(heaps);
+            data.transientPlacementHash = placementHash;
+            data.transientBytesSaved = unaliasedSize - aliasedSize;
+
+            return true;
+        }
+
+        void ImageHandlerVK::CreateTransientImage(Image& image, TransientPlacement& placement)
+        {
+            VkFormat format;
+            CreateImage(image, format);
+
+            vkGetImageMemoryRequirements(_device->_device, image.image, &placement.memoryRequirements);
+            placement.isBound = false;
+        }
+
+        void ImageHandlerVK::CreateTransientImage(DepthImage& image, TransientPlacement& placement)
+        {
+            CreateImage(image);
+
+            vkGetImageMemoryRequirements(_device->_device, image.image, &placement.memoryRequirements);
+            placement.isBound = false;
+        }
+
+        void ImageHandlerVK::DestroyTransientImages()
+        {
+            ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
+
+            // The images come back unbound with fresh memory requirements, ready to be placed again
+            for (TransientImage& transientImage : data.transientImages)
+            {
+                Image& image = data.images[static_cast<ImageID::type>(transientImage.id)];
+
+                if (transientImage.placement.isBound)
+                {
+                    vkDestroyImageView(_device->_device, image.colorView, nullptr);
+                    for (VkImageView mipView : image.mipViews)
+                    {
+                        vkDestroyImageView(_device->_device, mipView, nullptr);
+                    }
+                    image.mipViews.clear();
+                }
+
+                vkDestroyImage(_device->_device, image.image, nullptr);
+                CreateTransientImage(image, transientImage.placement);
+            }
+
+            for (TransientDepthImage& transientImage : data.transientDepthImages)
+            {
+                DepthImage& image = data.depthImages[static_cast<DepthImageID::type>(transientImage.id)];
+
+                if (transientImage.placement.isBound)
+                {
+                    vkDestroyImageView(_device->_device, image.depthView, nullptr);
+                }
+
+                vkDestroyImage(_device->_device, image.image, nullptr);
+                CreateTransientImage(image, transientImage.placement);
+            }
+
+            for (TransientHeap& heap : data.transientHeaps)
+            {
+                vmaFreeMemory(_device->_allocator, heap.allocation);
+            }
+
+            data.transientHeaps.clear();
+            data.transientPlacementHash = 0;
+        }
+
+        u64 ImageHandlerVK::GetDescHash(const ImageDesc& desc)
+        {
+            // The debugName is deliberately left out, two passes asking for the same kind of image may share it
+            u64 hash = XXHash64::hash(&desc.dimensions, sizeof(desc.dimensions), 0);
+            hash = XXHash64::hash(&desc.dimensionType, sizeof(desc.dimensionType), hash);
+            hash = XXHash64::hash(&desc.depth, sizeof(desc.depth), hash);
+            hash = XXHash64::hash(&desc.mipLevels, sizeof(desc.mipLevels), hash);
+            hash = XXHash64::hash(&desc.format, sizeof(desc.format), hash);
+            hash = XXHash64::hash(&desc.sampleCount, sizeof(desc.sampleCount), hash);
+            hash = XXHash64::hash(&desc.clearColor, sizeof(desc.clearColor), hash);
+
+            return hash;
+        }
+
+        u64 ImageHandlerVK::GetDescHash(const DepthImageDesc& desc)
+        {
+            u64 hash = XXHash64::hash(&desc.dimensions, sizeof(desc.dimensions), 0);
+            hash = XXHash64::hash(&desc.dimensionType, sizeof(desc.dimensionType), hash);
+            hash = XXHash64::hash(&desc.format, sizeof(desc.format), hash);
+            hash = XXHash64::hash(&desc.sampleCount, sizeof(desc.sampleCount), hash);
+            hash = XXHash64::hash(&desc.depthClearValue, sizeof(desc.depthClearValue), hash);
+            hash = XXHash64::hash(&desc.stencilClearValue, sizeof(desc.stencilClearValue), hash);
+
+            return hash;
+        }
+
         const ImageDesc& ImageHandlerVK::GetImageDesc(const ImageID id)
         {
             ImageHandlerVKData& data = static_cast<ImageHandlerVKData&>(*_data);
@@ -395,6 +823,18 @@ namespace Renderer
             imageInfo.pQueueFamilyIndices = nullptr;
             imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
+            if (image.isTransient)
+            {
+                // The memory gets bound when the image is placed in a transient heap
+                if (vkCreateImage(_device->_device, &imageInfo, nullptr, &image.image) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Failed to create image!");
+                }
+
+                image.allocation = VK_NULL_HANDLE;
+                return;
+            }
+
             VmaAllocationCreateInfo allocInfo = {};
             allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
@@ -443,6 +883,18 @@ namespace Renderer
             imageInfo.pQueueFamilyIndices = nullptr;
             imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
+            if (image.isTransient)
+            {
+                // The memory gets bound when the image is placed in a transient heap, views can't be created before that
+                if (vkCreateImage(_device->_device, &imageInfo, nullptr, &image.image) != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("Failed to create image!");
+                }
+
+                image.allocation = VK_NULL_HANDLE;
+                return;
+            }
+
             VmaAllocationCreateInfo allocInfo = {};
             allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
@@ -451,13 +903,21 @@ namespace Renderer
                 DebugHandler::PrintFatal("Failed to create image!");
             }
 
+            CreateImageViews(image);
+
+            // Transition image from VK_IMAGE_LAYOUT_UNDEFINED to VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+            _device->TransitionImageLayout(image.image, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, 1, 1);
+        }
+
+        void ImageHandlerVK::CreateImageViews(DepthImage& image)
+        {
             // Create Depth View
             VkImageViewCreateInfo depthViewInfo = {};
             depthViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
             depthViewInfo.image = image.image;
             depthViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
 
-            depthViewInfo.format = imageInfo.format;
+            depthViewInfo.format = FormatConverterVK::ToVkFormat(image.desc.format);
             depthViewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
             depthViewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
             depthViewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
@@ -474,9 +934,6 @@ namespace Renderer
             }
 
             DebugMarkerUtilVK::SetObjectName(_device->_device, (u64)image.depthView, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_VIEW_EXT, image.desc.debugName.c_str());
-
-            // Transition image from VK_IMAGE_LAYOUT_UNDEFINED to VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
-            _device->TransitionImageLayout(image.image, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, 1, 1);
         }
 
         void ImageHandlerVK::CreateImageViews(Image& image, VkFormat format)
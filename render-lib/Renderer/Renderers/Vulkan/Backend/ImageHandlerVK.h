@@ -8,11 +8,14 @@
 
 namespace Renderer
 {
+    struct TransientImageLifetime;
+
     namespace Backend
     {
         class RenderDeviceVK;
         struct Image;
         struct DepthImage;
+        struct TransientPlacement;
 
         struct IImageHandlerVKData {};
 
@@ -28,6 +31,15 @@ namespace Renderer
 
             DepthImageID CreateDepthImage(const DepthImageDesc& desc);
 
+            // Transient images are pooled by desc, an image acquired this frame is not handed out again until ResetTransientImages
+            ImageID AcquireTransientImage(const ImageDesc& desc);
+            DepthImageID AcquireTransientDepthImage(const DepthImageDesc& desc);
+            void ResetTransientImages();
+
+            // Returns true if the transient images had to be recreated to fit the new placement
+            bool PlaceTransientImages(const TransientImageLifetime* lifetimes, u32 numLifetimes);
+            size_t GetTransientBytesSaved();
+
             const ImageDesc& GetImageDesc(const ImageID id);
             const DepthImageDesc& GetDepthImageDesc(const DepthImageID id);
 
@@ -50,6 +62,15 @@ namespace Renderer
             void CreateImage(DepthImage& image);
 
             void CreateImageViews(Image& image, VkFormat format);
+            void CreateImageViews(DepthImage& image);
+
+            u64 GetDescHash(const ImageDesc& desc);
+            u64 GetDescHash(const DepthImageDesc& desc);
+
+            void CreateTransientImage(Image& image, TransientPlacement& placement);
+            void CreateTransientImage(DepthImage& image, TransientPlacement& placement);
+            void DestroyTransientImages();
+            bool UpdateTransientPlacement(bool forceRebuild);
 
         private:
             RenderDeviceVK* _device;
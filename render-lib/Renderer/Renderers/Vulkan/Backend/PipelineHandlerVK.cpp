@@ -2,7 +2,11 @@
 
 #include <Utils/DebugHandler.h>
 #include <Utils/XXHash64.h>
+#include <Utils/Timer.h>
 #include <vulkan/vulkan.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 
 #include "FormatConverterVK.h"
 #include "RenderDeviceVK.h"
@@ -15,6 +19,46 @@ namespace Renderer
 {
     namespace Backend
     {
+        const std::filesystem::path PIPELINE_CACHE_PATH = "Data/shaders/_pipelines.cache";
+
+        struct PipelineCacheHeader
+        {
+            u32 token = 1313882952; // UTF8 -> Binary -> Decimal for "npch"
+            u32 version = 2;
+
+            // Cache data is only valid for the exact GPU and driver that produced it
+            u32 vendorID = 0;
+            u32 deviceID = 0;
+            u32 driverVersion = 0;
+            u8 pipelineCacheUUID[VK_UUID_SIZE] = {};
+
+            u32 numComputeShaders = 0;
+            u32 numGraphicsPipelines = 0;
+            u32 statesSize = sizeof(GraphicsPipelineDesc::States); // The states are stored as raw bytes, so any change to them invalidates the file
+            u64 dataSize = 0;
+        };
+
+        // A pipeline only needs a renderpass with the same attachment formats and sample counts to be compatible with it
+        struct RenderPassFormats
+        {
+            u32 numRenderTargets = 0;
+            VkFormat renderTargetFormats[MAX_RENDER_TARGETS] = {};
+            VkSampleCountFlagBits renderTargetSampleCounts[MAX_RENDER_TARGETS] = {};
+            VkBool32 renderTargetIsSwapChain[MAX_RENDER_TARGETS] = {};
+
+            VkFormat depthStencilFormat = VK_FORMAT_UNDEFINED;
+            VkSampleCountFlagBits depthStencilSampleCount = VK_SAMPLE_COUNT_1_BIT;
+        };
+
+        struct KnownGraphicsPipeline
+        {
+            VertexShaderDesc vertexShader; // Empty path if the pipeline has no vertex shader
+            PixelShaderDesc pixelShader; // Empty path if the pipeline has no pixel shader
+
+            GraphicsPipelineDesc::States states; // The shader IDs in here are cleared since they are only valid for the run that created them
+            RenderPassFormats formats;
+        };
+
         struct GraphicsPipelineCacheDesc
         {
             GraphicsPipelineDesc::States states;
@@ -69,14 +113,326 @@ namespace Renderer
         {
             std::vector<GraphicsPipeline> graphicsPipelines;
             std::vector<ComputePipeline> computePipelines;
+
+            VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+            std::vector<ComputeShaderDesc> knownComputeShaders; // Every compute shader we have built a pipeline for, on this run or a previous one
+            std::vector<KnownGraphicsPipeline> knownGraphicsPipelines; // Same thing for graphics pipelines, together with the formats of the rendertargets they were built for
         };
 
+        template <typename T>
+        static bool IsSameShader(const T& a, const T& b)
+        {
+            if (a.path != b.path || a.permutationFields.size() != b.permutationFields.size())
+                return false;
+
+            for (size_t i = 0; i < a.permutationFields.size(); i++)
+            {
+                if (a.permutationFields[i].key != b.permutationFields[i].key || a.permutationFields[i].value != b.permutationFields[i].value)
+                    return false;
+            }
+
+            return true;
+        }
+
+        static bool IsSamePipeline(const KnownGraphicsPipeline& a, const KnownGraphicsPipeline& b)
+        {
+            return memcmp(&a.states, &b.states, sizeof(a.states)) == 0 &&
+                   memcmp(&a.formats, &b.formats, sizeof(a.formats)) == 0 &&
+                   IsSameShader(a.vertexShader, b.vertexShader) &&
+                   IsSameShader(a.pixelShader, b.pixelShader);
+        }
+
+        // The manifest might still list shaders that have since been removed
+        static bool ShaderSourceExists(const std::string& path)
+        {
+            return std::filesystem::exists(std::filesystem::path(SHADER_SOURCE_DIR) / path);
+        }
+
+        static void WriteString(std::ofstream& stream, const std::string& string)
+        {
+            u32 length = static_cast<u32>(string.length());
+            stream.write(reinterpret_cast<const char*>(&length), sizeof(u32));
+            stream.write(string.data(), length);
+        }
+
+        static bool ReadString(std::ifstream& stream, std::string& string)
+        {
+            u32 length = 0;
+            if (!stream.read(reinterpret_cast<char*>(&length), sizeof(u32)))
+                return false;
+
+            string.resize(length);
+            return static_cast<bool>(stream.read(string.data(), length));
+        }
+
+        template <typename T>
+        static void WriteShaderDesc(std::ofstream& stream, const T& shaderDesc)
+        {
+            WriteString(stream, shaderDesc.path);
+
+            u32 numPermutationFields = static_cast<u32>(shaderDesc.permutationFields.size());
+            stream.write(reinterpret_cast<const char*>(&numPermutationFields), sizeof(u32));
+
+            for (const PermutationField& permutationField : shaderDesc.permutationFields)
+            {
+                WriteString(stream, permutationField.key);
+                WriteString(stream, permutationField.value);
+            }
+        }
+
+        template <typename T>
+        static bool ReadShaderDesc(std::ifstream& stream, T& shaderDesc)
+        {
+            u32 numPermutationFields = 0;
+            bool isValid = ReadString(stream, shaderDesc.path) && stream.read(reinterpret_cast<char*>(&numPermutationFields), sizeof(u32));
+
+            for (u32 i = 0; isValid && i < numPermutationFields; i++)
+            {
+                PermutationField& permutationField = shaderDesc.permutationFields.emplace_back();
+                isValid = ReadString(stream, permutationField.key) && ReadString(stream, permutationField.value);
+            }
+
+            return isValid;
+        }
+
         void PipelineHandlerVK::Init(RenderDeviceVK* device, ShaderHandlerVK* shaderHandler, ImageHandlerVK* imageHandler)
         {
             _device = device;
             _shaderHandler = shaderHandler;
             _imageHandler = imageHandler;
             _data = new PipelineHandlerVKData();
+
+            LoadPipelineCache();
+        }
+
+        void PipelineHandlerVK::Deinit()
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+
+            vkDestroyPipelineCache(_device->_device, data.pipelineCache, nullptr);
+            data.pipelineCache = VK_NULL_HANDLE;
+        }
+
+        void PipelineHandlerVK::WarmupPipelines()
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+
+            Timer timer;
+
+            // CreatePipeline appends to knownComputeShaders, so iterate a copy
+            const std::vector<ComputeShaderDesc> knownComputeShaders = data.knownComputeShaders;
+
+            u32 numComputeWarmedUp = 0;
+            for (const ComputeShaderDesc& shaderDesc : knownComputeShaders)
+            {
+                if (!ShaderSourceExists(shaderDesc.path))
+                    continue;
+
+                ComputePipelineDesc pipelineDesc;
+                pipelineDesc.computeShader = _shaderHandler->LoadShader(shaderDesc);
+
+                CreatePipeline(pipelineDesc);
+                numComputeWarmedUp++;
+            }
+
+            // Graphics pipelines need the rendertargets of the pass that uses them, which don't exist yet during loading
+            // So we build them against a temporary renderpass with the same formats and throw them away again, the compiled result stays in the VkPipelineCache
+            u32 numGraphicsWarmedUp = 0;
+            for (const KnownGraphicsPipeline& knownPipeline : data.knownGraphicsPipelines)
+            {
+                bool hasVertexShader = !knownPipeline.vertexShader.path.empty();
+                bool hasPixelShader = !knownPipeline.pixelShader.path.empty();
+
+                if ((hasVertexShader && !ShaderSourceExists(knownPipeline.vertexShader.path)) || (hasPixelShader && !ShaderSourceExists(knownPipeline.pixelShader.path)))
+                    continue;
+
+                GraphicsPipeline pipeline;
+                pipeline.desc.states = knownPipeline.states;
+                pipeline.numRenderTargets = knownPipeline.formats.numRenderTargets;
+
+                if (hasVertexShader)
+                {
+                    pipeline.desc.states.vertexShader = _shaderHandler->LoadShader(knownPipeline.vertexShader);
+                }
+                if (hasPixelShader)
+                {
+                    pipeline.desc.states.pixelShader = _shaderHandler->LoadShader(knownPipeline.pixelShader);
+                }
+
+                pipeline.renderPass = CreateRenderPass(knownPipeline.formats);
+                CreateVkPipeline(pipeline);
+
+                vkDestroyPipeline(_device->_device, pipeline.pipeline, nullptr);
+                vkDestroyPipelineLayout(_device->_device, pipeline.pipelineLayout, nullptr);
+                for (VkDescriptorSetLayout& layout : pipeline.descriptorSetLayouts)
+                {
+                    vkDestroyDescriptorSetLayout(_device->_device, layout, nullptr);
+                }
+                vkDestroyRenderPass(_device->_device, pipeline.renderPass, nullptr);
+
+                numGraphicsWarmedUp++;
+            }
+
+            DebugHandler::PrintSuccess("Warmed up %u compute and %u graphics pipelines in %.2fms", numComputeWarmedUp, numGraphicsWarmedUp, timer.GetLifeTime() * 1000.0f);
+        }
+
+        void PipelineHandlerVK::SavePipelineCache()
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+
+            if (data.pipelineCache == VK_NULL_HANDLE)
+                return;
+
+            size_t dataSize = 0;
+            if (vkGetPipelineCacheData(_device->_device, data.pipelineCache, &dataSize, nullptr) != VK_SUCCESS)
+            {
+                DebugHandler::PrintError("Failed to get pipelinecache size!");
+                return;
+            }
+
+            std::vector<u8> cacheData(dataSize);
+            if (vkGetPipelineCacheData(_device->_device, data.pipelineCache, &dataSize, cacheData.data()) != VK_SUCCESS)
+            {
+                DebugHandler::PrintError("Failed to get pipelinecache data!");
+                return;
+            }
+
+            VkPhysicalDeviceProperties deviceProperties;
+            vkGetPhysicalDeviceProperties(_device->_physicalDevice, &deviceProperties);
+
+            PipelineCacheHeader header;
+            header.vendorID = deviceProperties.vendorID;
+            header.deviceID = deviceProperties.deviceID;
+            header.driverVersion = deviceProperties.driverVersion;
+            memcpy(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+            header.numComputeShaders = static_cast<u32>(data.knownComputeShaders.size());
+            header.numGraphicsPipelines = static_cast<u32>(data.knownGraphicsPipelines.size());
+            header.dataSize = dataSize;
+
+            std::filesystem::create_directories(PIPELINE_CACHE_PATH.parent_path());
+
+            std::ofstream file(PIPELINE_CACHE_PATH, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                DebugHandler::PrintError("Failed to open pipelinecache for writing: %s", PIPELINE_CACHE_PATH.string().c_str());
+                return;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            for (const ComputeShaderDesc& shaderDesc : data.knownComputeShaders)
+            {
+                WriteShaderDesc(file, shaderDesc);
+            }
+
+            for (const KnownGraphicsPipeline& knownPipeline : data.knownGraphicsPipelines)
+            {
+                WriteShaderDesc(file, knownPipeline.vertexShader);
+                WriteShaderDesc(file, knownPipeline.pixelShader);
+                file.write(reinterpret_cast<const char*>(&knownPipeline.states), sizeof(knownPipeline.states));
+                file.write(reinterpret_cast<const char*>(&knownPipeline.formats), sizeof(knownPipeline.formats));
+            }
+
+            file.write(reinterpret_cast<const char*>(cacheData.data()), dataSize);
+
+            DebugHandler::PrintSuccess("Saved pipelinecache to: %s", PIPELINE_CACHE_PATH.string().c_str());
+        }
+
+        void PipelineHandlerVK::LoadPipelineCache()
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+
+            std::ifstream file(PIPELINE_CACHE_PATH, std::ios::binary);
+            if (!file.is_open())
+            {
+                DebugHandler::Print("Creating pipelinecache at: %s", PIPELINE_CACHE_PATH.string().c_str());
+                CreateVkPipelineCache(nullptr, 0);
+                return;
+            }
+
+            const PipelineCacheHeader expectedHeader;
+
+            PipelineCacheHeader header;
+            if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.token != expectedHeader.token || header.version != expectedHeader.version || header.statesSize != expectedHeader.statesSize)
+            {
+                DebugHandler::PrintWarning("Discarding invalid pipelinecache: %s", PIPELINE_CACHE_PATH.string().c_str());
+                CreateVkPipelineCache(nullptr, 0);
+                return;
+            }
+
+            bool isValid = true;
+            for (u32 i = 0; isValid && i < header.numComputeShaders; i++)
+            {
+                ComputeShaderDesc& shaderDesc = data.knownComputeShaders.emplace_back();
+                isValid = ReadShaderDesc(file, shaderDesc);
+            }
+
+            for (u32 i = 0; isValid && i < header.numGraphicsPipelines; i++)
+            {
+                KnownGraphicsPipeline& knownPipeline = data.knownGraphicsPipelines.emplace_back();
+                isValid = ReadShaderDesc(file, knownPipeline.vertexShader) &&
+                          ReadShaderDesc(file, knownPipeline.pixelShader) &&
+                          file.read(reinterpret_cast<char*>(&knownPipeline.states), sizeof(knownPipeline.states)) &&
+                          file.read(reinterpret_cast<char*>(&knownPipeline.formats), sizeof(knownPipeline.formats));
+            }
+
+            if (!isValid)
+            {
+                DebugHandler::PrintWarning("Discarding invalid pipelinecache: %s", PIPELINE_CACHE_PATH.string().c_str());
+                data.knownComputeShaders.clear();
+                data.knownGraphicsPipelines.clear();
+                CreateVkPipelineCache(nullptr, 0);
+                return;
+            }
+
+            // The list of known shaders is still useful for warming up, but the compiled data is tied to the GPU and driver it came from
+            VkPhysicalDeviceProperties deviceProperties;
+            vkGetPhysicalDeviceProperties(_device->_physicalDevice, &deviceProperties);
+
+            bool isSameDevice = header.vendorID == deviceProperties.vendorID &&
+                                header.deviceID == deviceProperties.deviceID &&
+                                header.driverVersion == deviceProperties.driverVersion &&
+                                memcmp(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+            if (!isSameDevice)
+            {
+                DebugHandler::Print("Discarding pipelinecache, it was created for a different GPU or driver");
+                CreateVkPipelineCache(nullptr, 0);
+                return;
+            }
+
+            std::vector<u8> cacheData(header.dataSize);
+            if (!file.read(reinterpret_cast<char*>(cacheData.data()), header.dataSize))
+            {
+                DebugHandler::PrintWarning("Discarding invalid pipelinecache: %s", PIPELINE_CACHE_PATH.string().c_str());
+                CreateVkPipelineCache(nullptr, 0);
+                return;
+            }
+
+            CreateVkPipelineCache(cacheData.data(), cacheData.size());
+            DebugHandler::PrintSuccess("Loaded pipelinecache from: %s", PIPELINE_CACHE_PATH.string().c_str());
+        }
+
+        void PipelineHandlerVK::CreateVkPipelineCache(const void* initialData, size_t initialDataSize)
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+
+            VkPipelineCacheCreateInfo createInfo = { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+            createInfo.initialDataSize = initialDataSize;
+            createInfo.pInitialData = initialData;
+
+            if (vkCreatePipelineCache(_device->_device, &createInfo, nullptr, &data.pipelineCache) == VK_SUCCESS)
+                return;
+
+            // The driver is allowed to refuse old data, in that case we just start over with an empty cache
+            if (initialData != nullptr)
+            {
+                DebugHandler::PrintWarning("Driver rejected the pipelinecache, starting with an empty one");
+                CreateVkPipelineCache(nullptr, 0);
+                return;
+            }
+
+            DebugHandler::PrintFatal("Failed to create pipeline cache!");
         }
 
         void PipelineHandlerVK::DiscardPipelines()
@@ -174,23 +530,84 @@ namespace Renderer
             pipeline.numRenderTargets = numAttachments;
 
             // -- Create Render Pass --
-            std::vector<VkAttachmentDescription> attachments(numAttachments);
-            std::vector< VkAttachmentReference> colorAttachmentRefs(numAttachments);
-            for (int i = 0; i < numAttachments; i++)
+            RenderPassFormats formats;
+            formats.numRenderTargets = numAttachments;
+
+            for (u32 i = 0; i < numAttachments; i++)
             {
                 ImageID imageID = desc.MutableResourceToImageID(desc.renderTargets[i]);
-
                 const ImageDesc& imageDesc = _imageHandler->GetImageDesc(imageID);
-                bool isSwapchain = _imageHandler->IsSwapChainImage(imageID);
 
-                attachments[i].format = FormatConverterVK::ToVkFormat(imageDesc.format);
-                attachments[i].samples = FormatConverterVK::ToVkSampleCount(imageDesc.sampleCount);
+                formats.renderTargetFormats[i] = FormatConverterVK::ToVkFormat(imageDesc.format);
+                formats.renderTargetSampleCounts[i] = FormatConverterVK::ToVkSampleCount(imageDesc.sampleCount);
+                formats.renderTargetIsSwapChain[i] = _imageHandler->IsSwapChainImage(imageID);
+            }
+
+            if (desc.depthStencil != RenderPassMutableResource::Invalid())
+            {
+                DepthImageID depthImageID = desc.MutableResourceToDepthImageID(desc.depthStencil);
+                const DepthImageDesc& imageDesc = _imageHandler->GetDepthImageDesc(depthImageID);
+
+                formats.depthStencilFormat = FormatConverterVK::ToVkFormat(imageDesc.format);
+                formats.depthStencilSampleCount = FormatConverterVK::ToVkSampleCount(imageDesc.sampleCount);
+            }
+
+            pipeline.renderPass = CreateRenderPass(formats);
+
+            // -- Create Framebuffer --
+            CreateFramebuffer(pipeline);
+
+            // -- Create Pipeline --
+            CreateVkPipeline(pipeline);
+
+            GraphicsPipelineID pipelineID = GraphicsPipelineID(static_cast<gIDType>(nextID));
+            pipeline.descriptorSetBuilder = new DescriptorSetBuilderVK(pipelineID, this, _shaderHandler, _device->_descriptorMegaPool);
+
+            data.graphicsPipelines.push_back(pipeline);
+
+            pipeline.descriptorSetBuilder->InitReflectData(); // Needs to happen after push_back
+
+            // Remember the shaders and rendertarget formats so WarmupPipelines can build this pipeline during loading next time
+            KnownGraphicsPipeline knownPipeline;
+            knownPipeline.states = desc.states;
+            knownPipeline.states.vertexShader = VertexShaderID::Invalid();
+            knownPipeline.states.pixelShader = PixelShaderID::Invalid();
+            knownPipeline.formats = formats;
+
+            if (desc.states.vertexShader != VertexShaderID::Invalid())
+            {
+                knownPipeline.vertexShader = _shaderHandler->GetDescriptor(desc.states.vertexShader);
+            }
+            if (desc.states.pixelShader != PixelShaderID::Invalid())
+            {
+                knownPipeline.pixelShader = _shaderHandler->GetDescriptor(desc.states.pixelShader);
+            }
+
+            auto itr = std::find_if(data.knownGraphicsPipelines.begin(), data.knownGraphicsPipelines.end(), [&knownPipeline](const KnownGraphicsPipeline& other) { return IsSamePipeline(knownPipeline, other); });
+            if (itr == data.knownGraphicsPipelines.end())
+            {
+                data.knownGraphicsPipelines.push_back(knownPipeline);
+            }
+
+            return pipelineID;
+        }
+
+        VkRenderPass PipelineHandlerVK::CreateRenderPass(const RenderPassFormats& formats)
+        {
+            u32 numAttachments = formats.numRenderTargets;
+
+            std::vector<VkAttachmentDescription> attachments(numAttachments);
+            std::vector< VkAttachmentReference> colorAttachmentRefs(numAttachments);
+            for (u32 i = 0; i < numAttachments; i++)
+            {
+                attachments[i].format = formats.renderTargetFormats[i];
+                attachments[i].samples = formats.renderTargetSampleCounts[i];
                 attachments[i].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
                 attachments[i].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
                 attachments[i].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
                 attachments[i].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 
-                if (isSwapchain)
+                if (formats.renderTargetIsSwapChain[i])
                 {
                     attachments[i].initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
                     attachments[i].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
@@ -213,17 +630,14 @@ namespace Renderer
             VkAttachmentReference depthDescriptionRef = {};
 
             // If we have a depthstencil, add an attachment for that
-            if (desc.depthStencil != RenderPassMutableResource::Invalid())
+            if (formats.depthStencilFormat != VK_FORMAT_UNDEFINED)
             {
-                DepthImageID depthImageID = desc.MutableResourceToDepthImageID(desc.depthStencil);
-                const DepthImageDesc& imageDesc = _imageHandler->GetDepthImageDesc(depthImageID);
-
                 u32 attachmentSlot = numAttachments++;
                 
                 VkAttachmentDescription& depthDescription = attachments.emplace_back();
                 depthDescription = {};
-                depthDescription.format = FormatConverterVK::ToVkFormat(imageDesc.format);
-                depthDescription.samples = FormatConverterVK::ToVkSampleCount(imageDesc.sampleCount);
+                depthDescription.format = formats.depthStencilFormat;
+                depthDescription.samples = formats.depthStencilSampleCount;
                 depthDescription.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
                 depthDescription.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
                 depthDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
@@ -257,26 +671,32 @@ namespace Renderer
             renderPassInfo.dependencyCount = 1;
             renderPassInfo.pDependencies = &dependency;
 
-            if (vkCreateRenderPass(_device->_device, &renderPassInfo, nullptr, &pipeline.renderPass) != VK_SUCCESS)
+            VkRenderPass renderPass;
+            if (vkCreateRenderPass(_device->_device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
             {
                 DebugHandler::PrintFatal("Failed to create render pass!");
             }
 
-            // -- Create Framebuffer --
-            CreateFramebuffer(pipeline);
+            return renderPass;
+        }
+
+        void PipelineHandlerVK::CreateVkPipeline(GraphicsPipeline& pipeline)
+        {
+            PipelineHandlerVKData& data = static_cast<PipelineHandlerVKData&>(*_data);
+            const GraphicsPipelineDesc::States& states = pipeline.desc.states;
 
             // -- Get Reflection data from shader --
             std::vector<BindInfo> bindInfos;
             std::vector<BindInfoPushConstant> bindInfoPushConstants;
-            if (desc.states.vertexShader != VertexShaderID::Invalid())
+            if (states.vertexShader != VertexShaderID::Invalid())
             {
-                const BindReflection& bindReflection = _shaderHandler->GetBindReflection(desc.states.vertexShader);
+                const BindReflection& bindReflection = _shaderHandler->GetBindReflection(states.vertexShader);
                 bindInfos.insert(bindInfos.end(), bindReflection.dataBindings.begin(), bindReflection.dataBindings.end());
                 bindInfoPushConstants.insert(bindInfoPushConstants.end(), bindReflection.pushConstants.begin(), bindReflection.pushConstants.end());
             }
-            if (desc.states.pixelShader != PixelShaderID::Invalid())
+            if (states.pixelShader != PixelShaderID::Invalid())
             {
-                const BindReflection& bindReflection = _shaderHandler->GetBindReflection(desc.states.pixelShader);
+                const BindReflection& bindReflection = _shaderHandler->GetBindReflection(states.pixelShader);
 
                 // Loop over all new databindings
                 for (const BindInfo& dataBinding : bindReflection.dataBindings)
@@ -356,24 +776,24 @@ namespace Renderer
             }
 
             std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
-            if (desc.states.vertexShader != VertexShaderID::Invalid())
+            if (states.vertexShader != VertexShaderID::Invalid())
             {
                 VkPipelineShaderStageCreateInfo vertShaderStageInfo = {};
                 vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
                 vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
 
-                vertShaderStageInfo.module = _shaderHandler->GetShaderModule(desc.states.vertexShader);
+                vertShaderStageInfo.module = _shaderHandler->GetShaderModule(states.vertexShader);
                 vertShaderStageInfo.pName = "main";
 
                 shaderStages.push_back(vertShaderStageInfo);
             }
-            if (desc.states.pixelShader != PixelShaderID::Invalid())
+            if (states.pixelShader != PixelShaderID::Invalid())
             {
                 VkPipelineShaderStageCreateInfo fragShaderStageInfo = {};
                 fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
                 fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
 
-                fragShaderStageInfo.module = _shaderHandler->GetShaderModule(desc.states.pixelShader);
+                fragShaderStageInfo.module = _shaderHandler->GetShaderModule(states.pixelShader);
                 fragShaderStageInfo.pName = "main";
 
                 shaderStages.push_back(fragShaderStageInfo);
@@ -386,7 +806,7 @@ namespace Renderer
             u8 numInstanceAttributes = 0;
             u32 instanceStride = 0;
 
-            for (auto& inputLayout : desc.states.inputLayouts)
+            for (auto& inputLayout : states.inputLayouts)
             {
                 if (!inputLayout.enabled)
                     break;
@@ -436,7 +856,7 @@ namespace Renderer
             u8 attributeCounts[2] = { 0 };
             u32 attributeOffsets[2] = { 0 };
 
-            for (auto& inputLayout : desc.states.inputLayouts)
+            for (auto& inputLayout : states.inputLayouts)
             {
                 if (!inputLayout.enabled)
                     break;
@@ -468,7 +888,7 @@ namespace Renderer
 
             VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
             inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-            inputAssembly.topology = FormatConverterVK::ToVkPrimitiveTopology(desc.states.primitiveTopology);
+            inputAssembly.topology = FormatConverterVK::ToVkPrimitiveTopology(states.primitiveTopology);
             inputAssembly.primitiveRestartEnable = VK_FALSE;
 
             // -- Set viewport and scissor rect --
@@ -484,20 +904,20 @@ namespace Renderer
             rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
             rasterizer.depthClampEnable = VK_FALSE;
             rasterizer.rasterizerDiscardEnable = VK_FALSE;
-            rasterizer.polygonMode = FormatConverterVK::ToVkPolygonMode(desc.states.rasterizerState.fillMode);
+            rasterizer.polygonMode = FormatConverterVK::ToVkPolygonMode(states.rasterizerState.fillMode);
             rasterizer.lineWidth = 1.0f;
-            rasterizer.cullMode = FormatConverterVK::ToVkCullModeFlags(desc.states.rasterizerState.cullMode);
-            rasterizer.frontFace = FormatConverterVK::ToVkFrontFace(desc.states.rasterizerState.frontFaceMode);
-            rasterizer.depthBiasEnable = desc.states.rasterizerState.depthBiasEnabled;
-            rasterizer.depthBiasConstantFactor = static_cast<f32>(desc.states.rasterizerState.depthBias);
-            rasterizer.depthBiasClamp = desc.states.rasterizerState.depthBiasClamp;
-            rasterizer.depthBiasSlopeFactor = desc.states.rasterizerState.depthBiasSlopeFactor;
+            rasterizer.cullMode = FormatConverterVK::ToVkCullModeFlags(states.rasterizerState.cullMode);
+            rasterizer.frontFace = FormatConverterVK::ToVkFrontFace(states.rasterizerState.frontFaceMode);
+            rasterizer.depthBiasEnable = states.rasterizerState.depthBiasEnabled;
+            rasterizer.depthBiasConstantFactor = static_cast<f32>(states.rasterizerState.depthBias);
+            rasterizer.depthBiasClamp = states.rasterizerState.depthBiasClamp;
+            rasterizer.depthBiasSlopeFactor = states.rasterizerState.depthBiasSlopeFactor;
 
             // -- Multisampling --
             VkPipelineMultisampleStateCreateInfo multisampling = {};
             multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
             multisampling.sampleShadingEnable = VK_FALSE;
-            multisampling.rasterizationSamples = FormatConverterVK::ToVkSampleCount(desc.states.rasterizerState.sampleCount);
+            multisampling.rasterizationSamples = FormatConverterVK::ToVkSampleCount(states.rasterizerState.sampleCount);
             multisampling.minSampleShading = 1.0f; // Optional
             multisampling.pSampleMask = nullptr; // Optional
             multisampling.alphaToCoverageEnable = VK_FALSE; // Optional
@@ -506,28 +926,28 @@ namespace Renderer
             // -- DepthStencil --
             VkPipelineDepthStencilStateCreateInfo depthStencil = {};
             depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-            depthStencil.depthTestEnable = desc.states.depthStencilState.depthEnable;
-            depthStencil.depthWriteEnable = desc.states.depthStencilState.depthWriteEnable;
-            depthStencil.depthCompareOp = FormatConverterVK::ToVkCompareOp(desc.states.depthStencilState.depthFunc);
-            //depthStencil.depthBoundsTestEnable = desc.states.depthStencilState;
+            depthStencil.depthTestEnable = states.depthStencilState.depthEnable;
+            depthStencil.depthWriteEnable = states.depthStencilState.depthWriteEnable;
+            depthStencil.depthCompareOp = FormatConverterVK::ToVkCompareOp(states.depthStencilState.depthFunc);
+            //depthStencil.depthBoundsTestEnable = states.depthStencilState;
             //depthStencil.minDepthBounds = 0.0f;
             //depthStencil.maxDepthBounds = 1.0f;
-            depthStencil.stencilTestEnable = desc.states.depthStencilState.stencilEnable;
+            depthStencil.stencilTestEnable = states.depthStencilState.stencilEnable;
 
             depthStencil.front = {};
-            depthStencil.front.failOp = FormatConverterVK::ToVkStencilOp(desc.states.depthStencilState.frontFace.stencilFailOp);
-            depthStencil.front.passOp = FormatConverterVK::ToVkStencilOp(desc.states.depthStencilState.frontFace.stencilPassOp);
-            depthStencil.front.depthFailOp = FormatConverterVK::ToVkStencilOp(desc.states.depthStencilState.frontFace.stencilDepthFailOp);
-            depthStencil.front.compareOp = FormatConverterVK::ToVkCompareOp(desc.states.depthStencilState.frontFace.stencilFunc);
+            depthStencil.front.failOp = FormatConverterVK::ToVkStencilOp(states.depthStencilState.frontFace.stencilFailOp);
+            depthStencil.front.passOp = FormatConverterVK::ToVkStencilOp(states.depthStencilState.frontFace.stencilPassOp);
+            depthStencil.front.depthFailOp = FormatConverterVK::ToVkStencilOp(states.depthStencilState.frontFace.stencilDepthFailOp);
+            depthStencil.front.compareOp = FormatConverterVK::ToVkCompareOp(states.depthStencilState.frontFace.stencilFunc);
             //depthStencil.front.compareMask;
             //depthStencil.front.writeMask;
             //depthStencil.front.reference;
 
             depthStencil.back = {};
-            depthStencil.back.failOp = FormatConverterVK::ToVkStencilOp(desc.states.depthStencilState.backFace.stencilFailOp);
-            depthStencil.back.passOp = FormatConverterVK::ToVkStencilOp(desc.states.depthStencilState.backFace.stencilPassOp);
-            depthStencil.back.depthFailOp = FormatConverterVK::ToVkStencilOp(desc.states.depthStencilState.backFace.stencilDepthFailOp);
-            depthStencil.back.compareOp = FormatConverterVK::ToVkCompareOp(desc.states.depthStencilState.backFace.stencilFunc);
+            depthStencil.back.failOp = FormatConverterVK::ToVkStencilOp(states.depthStencilState.backFace.stencilFailOp);
+            depthStencil.back.passOp = FormatConverterVK::ToVkStencilOp(states.depthStencilState.backFace.stencilPassOp);
+            depthStencil.back.depthFailOp = FormatConverterVK::ToVkStencilOp(states.depthStencilState.backFace.stencilDepthFailOp);
+            depthStencil.back.compareOp = FormatConverterVK::ToVkCompareOp(states.depthStencilState.backFace.stencilFunc);
             //depthStencil.back.compareMask;
             //depthStencil.back.writeMask;
             //depthStencil.back.reference;
@@ -537,20 +957,20 @@ namespace Renderer
             
             for (u32 i = 0; i < pipeline.numRenderTargets; i++)
             {
-                colorBlendAttachments[i].blendEnable = desc.states.blendState.renderTargets[i].blendEnable;
-                colorBlendAttachments[i].srcColorBlendFactor = FormatConverterVK::ToVkBlendFactor(desc.states.blendState.renderTargets[i].srcBlend);
-                colorBlendAttachments[i].dstColorBlendFactor = FormatConverterVK::ToVkBlendFactor(desc.states.blendState.renderTargets[i].destBlend);
-                colorBlendAttachments[i].colorBlendOp = FormatConverterVK::ToVkBlendOp(desc.states.blendState.renderTargets[i].blendOp);
-                colorBlendAttachments[i].srcAlphaBlendFactor = FormatConverterVK::ToVkBlendFactor(desc.states.blendState.renderTargets[i].srcBlendAlpha);
-                colorBlendAttachments[i].dstAlphaBlendFactor = FormatConverterVK::ToVkBlendFactor(desc.states.blendState.renderTargets[i].destBlendAlpha);
-                colorBlendAttachments[i].alphaBlendOp = FormatConverterVK::ToVkBlendOp(desc.states.blendState.renderTargets[i].blendOpAlpha);
-                colorBlendAttachments[i].colorWriteMask = FormatConverterVK::ToVkColorComponentFlags(desc.states.blendState.renderTargets[i].renderTargetWriteMask);
+                colorBlendAttachments[i].blendEnable = states.blendState.renderTargets[i].blendEnable;
+                colorBlendAttachments[i].srcColorBlendFactor = FormatConverterVK::ToVkBlendFactor(states.blendState.renderTargets[i].srcBlend);
+                colorBlendAttachments[i].dstColorBlendFactor = FormatConverterVK::ToVkBlendFactor(states.blendState.renderTargets[i].destBlend);
+                colorBlendAttachments[i].colorBlendOp = FormatConverterVK::ToVkBlendOp(states.blendState.renderTargets[i].blendOp);
+                colorBlendAttachments[i].srcAlphaBlendFactor = FormatConverterVK::ToVkBlendFactor(states.blendState.renderTargets[i].srcBlendAlpha);
+                colorBlendAttachments[i].dstAlphaBlendFactor = FormatConverterVK::ToVkBlendFactor(states.blendState.renderTargets[i].destBlendAlpha);
+                colorBlendAttachments[i].alphaBlendOp = FormatConverterVK::ToVkBlendOp(states.blendState.renderTargets[i].blendOpAlpha);
+                colorBlendAttachments[i].colorWriteMask = FormatConverterVK::ToVkColorComponentFlags(states.blendState.renderTargets[i].renderTargetWriteMask);
             }
 
             VkPipelineColorBlendStateCreateInfo colorBlending = {};
             colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-            colorBlending.logicOpEnable = desc.states.blendState.renderTargets[0].logicOpEnable;
-            colorBlending.logicOp = FormatConverterVK::ToVkLogicOp(desc.states.blendState.renderTargets[0].logicOp);
+            colorBlending.logicOpEnable = states.blendState.renderTargets[0].logicOpEnable;
+            colorBlending.logicOp = FormatConverterVK::ToVkLogicOp(states.blendState.renderTargets[0].logicOp);
             colorBlending.attachmentCount = pipeline.numRenderTargets;
             colorBlending.pAttachments = colorBlendAttachments.data();
             colorBlending.blendConstants[0] = 0.0f; // TODO: Blend constants
@@ -600,19 +1020,10 @@ namespace Renderer
             pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
             pipelineInfo.basePipelineIndex = -1; // Optional
 
-            if (vkCreateGraphicsPipelines(_device->_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
+            if (vkCreateGraphicsPipelines(_device->_device, data.pipelineCache, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
             {
                 DebugHandler::PrintFatal("Failed to create graphics pipeline!");
             }
-
-            GraphicsPipelineID pipelineID = GraphicsPipelineID(static_cast<gIDType>(nextID));
-            pipeline.descriptorSetBuilder = new DescriptorSetBuilderVK(pipelineID, this, _shaderHandler, _device->_descriptorMegaPool);
-
-            data.graphicsPipelines.push_back(pipeline);
-
-            pipeline.descriptorSetBuilder->InitReflectData(); // Needs to happen after push_back
-
-            return pipelineID;
         }
 
         ComputePipelineID PipelineHandlerVK::CreatePipeline(const ComputePipelineDesc& desc)
@@ -695,7 +1106,7 @@ namespace Renderer
             pipelineInfo.stage = shaderStage;
             pipelineInfo.layout = pipeline.pipelineLayout;
 
-            if (vkCreateComputePipelines(_device->_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
+            if (vkCreateComputePipelines(_device->_device, data.pipelineCache, 1, &pipelineInfo, nullptr, &pipeline.pipeline) != VK_SUCCESS)
             {
                 DebugHandler::PrintFatal("Failed to create compute pipeline!");
             }
@@ -707,6 +1118,14 @@ namespace Renderer
 
             pipeline.descriptorSetBuilder->InitReflectData(); // Needs to happen after push_back
 
+            // Remember the shader so WarmupPipelines can build this pipeline during loading next time
+            ComputeShaderDesc shaderDesc = _shaderHandler->GetDescriptor(desc.computeShader);
+            auto itr = std::find_if(data.knownComputeShaders.begin(), data.knownComputeShaders.end(), [&shaderDesc](const ComputeShaderDesc& knownShaderDesc) { return IsSameShader(shaderDesc, knownShaderDesc); });
+            if (itr == data.knownComputeShaders.end())
+            {
+                data.knownComputeShaders.push_back(shaderDesc);
+            }
+
             return pipelineID;
         }
 
@@ -15,6 +15,7 @@ namespace Renderer
         class ImageHandlerVK;
         class DescriptorSetBuilderVK;
         struct GraphicsPipeline;
+        struct RenderPassFormats;
 
         struct DescriptorSetLayoutData
         {
@@ -30,8 +31,13 @@ namespace Renderer
             using cIDType = type_safe::underlying_type<ComputePipelineID>;
         public:
             void Init(RenderDeviceVK* device, ShaderHandlerVK* shaderHandler, ImageHandlerVK* imageHandler);
+            void Deinit();
             void DiscardPipelines();
 
+            // Pipelines get compiled lazily the first time a pass asks for them, these let us pay that cost up front instead
+            void WarmupPipelines();
+            void SavePipelineCache();
+
             void OnWindowResize();
 
             GraphicsPipelineID CreatePipeline(const GraphicsPipelineDesc& desc);
@@ -62,12 +68,18 @@ namespace Renderer
             DescriptorSetBuilderVK* GetDescriptorSetBuilder(ComputePipelineID id);
 
         private:
+            void LoadPipelineCache();
+            void CreateVkPipelineCache(const void* initialData, size_t initialDataSize);
+
             u64 CalculateCacheDescHash(const GraphicsPipelineDesc& desc);
             u64 CalculateCacheDescHash(const ComputePipelineDesc& desc);
             bool TryFindExistingGPipeline(u64 descHash, size_t& id);
             bool TryFindExistingCPipeline(u64 descHash, size_t& id);
             DescriptorSetLayoutData& GetDescriptorSet(i32 setNumber, std::vector<DescriptorSetLayoutData>& sets);
             
+            VkRenderPass CreateRenderPass(const RenderPassFormats& formats);
+            // Creates the descriptor set layouts, pipeline layout and VkPipeline for pipeline.desc.states, pipeline.renderPass needs to exist already
+            void CreateVkPipeline(GraphicsPipeline& pipeline);
             void CreateFramebuffer(GraphicsPipeline& pipeline);
 
         private:
@@ -387,6 +387,7 @@ namespace Renderer
         void RenderDeviceVK::CreateLogicalDevice()
         {
             QueueFamilyIndices indices = FindQueueFamilies(_physicalDevice);
+            _queueFamilyIndices = indices;
 
             std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
             std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.transferFamily.value(), indices.presentFamily.value() };
@@ -737,9 +738,14 @@ namespace Renderer
                     indices.graphicsFamily = i;
                 }
 
+                // Prefer a family without graphics support, those map to the DMA engines so uploads don't compete with our draws
                 if (queueFamily.queueCount > 0 && (queueFamily.queueFlags & transferQueueFlags) == transferQueueFlags)
                 {
-                    indices.transferFamily = i;
+                    bool isDedicated = (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0;
+                    if (!indices.transferFamily.has_value() || isDedicated)
+                    {
+                        indices.transferFamily = i;
+                    }
                 }
                 
                 VkWin32SurfaceCreateInfoKHR surfaceCreateInfo = { VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR };
@@ -754,7 +760,8 @@ namespace Renderer
 
                 vkDestroySurfaceKHR(_instance, surface, nullptr);
 
-                if (indices.IsComplete())
+                bool hasDedicatedTransferFamily = indices.transferFamily.has_value() && indices.transferFamily != indices.graphicsFamily;
+                if (indices.IsComplete() && hasDedicatedTransferFamily)
                 {
                     break;
                 }
@@ -1284,19 +1291,6 @@ namespace Renderer
             vkFreeCommandBuffers(_device, _graphicsCommandPool, 1, &commandBuffer);
         }
 
-        void RenderDeviceVK::CopyBuffer(VkBuffer dstBuffer, u64 dstOffset, VkBuffer srcBuffer, u64 srcOffset, u64 range)
-        {
-            VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
-
-            VkBufferCopy copyRegion = {};
-            copyRegion.srcOffset = srcOffset;
-            copyRegion.dstOffset = dstOffset;
-            copyRegion.size = range;
-            vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-            EndSingleTimeCommands(commandBuffer);
-        }
-
         void RenderDeviceVK::CopyBufferToImage(VkBuffer srcBuffer, VkImage dstImage, VkFormat format, u32 width, u32 height, u32 numLayers, u32 numMipLevels)
         {
             VkCommandBuffer commandBuffer = BeginSingleTimeCommands();
@@ -85,7 +85,6 @@ namespace Renderer
             VkCommandBuffer BeginSingleTimeCommands();
             void EndSingleTimeCommands(VkCommandBuffer commandBuffer);
 
-            void CopyBuffer(VkBuffer dstBuffer, u64 dstOffset, VkBuffer srcBuffer, u64 srcOffset, u64 range);
             void CopyBufferToImage(VkBuffer srcBuffer, VkImage dstImage, VkFormat format, u32 width, u32 height, u32 numLayers, u32 numMipLevels);
             void CopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, size_t srcOffset, VkImage dstImage, VkFormat format, u32 width, u32 height, u32 numLayers, u32 numMipLevels);
             void TransitionImageLayout(VkImage image, VkImageAspectFlags aspects, VkImageLayout oldLayout, VkImageLayout newLayout, u32 numLayers, u32 numMipLevels);
@@ -93,6 +92,9 @@ namespace Renderer
 
             uvec2 GetMainWindowSize() { return _mainWindowSize; }
 
+            // Resources shared between these two families either need CONCURRENT sharing or queue family ownership transfers
+            bool HasDedicatedTransferQueue() { return _queueFamilyIndices.graphicsFamily != _queueFamilyIndices.transferFamily; }
+
             static PFN_vkCmdDrawIndexedIndirectCountKHR fnVkCmdDrawIndexedIndirectCountKHR;
         private:
             uvec2 _mainWindowSize;
@@ -110,6 +112,7 @@ namespace Renderer
             VkCommandPool _graphicsCommandPool = VK_NULL_HANDLE;
             VkCommandPool _transferCommandPool = VK_NULL_HANDLE;
 
+            QueueFamilyIndices _queueFamilyIndices;
             VkQueue _graphicsQueue = VK_NULL_HANDLE;
             VkQueue _transferQueue = VK_NULL_HANDLE;
             VkQueue _presentQueue = VK_NULL_HANDLE;
@@ -83,6 +83,37 @@ namespace Renderer
                 return _computeShaders[static_cast<psIDType>(id)].bindReflection;
             }
 
+            VertexShaderDesc GetDescriptor(const VertexShaderID id)
+            {
+                const Shader& shader = _vertexShaders[static_cast<vsIDType>(id)];
+
+                VertexShaderDesc desc;
+                desc.path = shader.sourcePath;
+                desc.permutationFields = shader.permutationFields;
+
+                return desc;
+            }
+            PixelShaderDesc GetDescriptor(const PixelShaderID id)
+            {
+                const Shader& shader = _pixelShaders[static_cast<psIDType>(id)];
+
+                PixelShaderDesc desc;
+                desc.path = shader.sourcePath;
+                desc.permutationFields = shader.permutationFields;
+
+                return desc;
+            }
+            ComputeShaderDesc GetDescriptor(const ComputeShaderID id)
+            {
+                const Shader& shader = _computeShaders[static_cast<csIDType>(id)];
+
+                ComputeShaderDesc desc;
+                desc.path = shader.sourcePath;
+                desc.permutationFields = shader.permutationFields;
+
+                return desc;
+            }
+
         private:
             struct Shader
             {
@@ -131,6 +162,7 @@ namespace Renderer
                 Shader& shader = shaders.back();
                 ReadFile(shaderBinPath, shader.spirv);
                 shader.path = permutationPath;
+                shader.sourcePath = shaderPath;
                 shader.module = CreateShaderModule(shader.spirv);
                 shader.permutationFields = permutationFields;
 
@@ -9,7 +9,12 @@
 #include <gli/gli.hpp>
 #include <vector>
 #include <queue>
+#include <algorithm>
 #include <filesystem>
+#include <shared_mutex>
+#include <thread>
+#include <condition_variable>
+#include <robin_hood.h>
 
 #include "vk_mem_alloc.h"
 #include "RenderDeviceVK.h"
@@ -45,12 +50,23 @@ namespace Renderer
             size_t fileSize;
 
             VmaAllocation allocation;
-            VkImage image;
-            VkImageView imageView;
+            VkImage image = VK_NULL_HANDLE;
+            VkImageView imageView = VK_NULL_HANDLE;
 
             std::string debugName = "";
 
             bool layoutUndefined = true;
+
+            std::atomic<bool> isPending = false; // Still decoding or uploading, GetImageView returns the debug texture until the copy has been submitted
+            std::atomic<u32> refCount = 0; // One per LoadTexture call, array slots own the reference of the load that filled them. Only dropped under the unique textureHashMutex lock
+            std::mutex loadMutex; // Guards creating the image on a decode worker against UnloadTexture destroying it
+        };
+
+        struct TextureDecodeJob
+        {
+            Texture* texture;
+            TextureID textureID;
+            std::string path;
         };
 
         struct TextureArray
@@ -58,6 +74,8 @@ namespace Renderer
             u32 size;
             SafeVector<TextureID>* textures = nullptr;
             SafeVector<u64>* textureHashes = nullptr;
+            robin_hood::unordered_map<u64, u32> hashToArrayIndex; // Only modified while holding the textureArrays WriteLock, so lookups just need the ReadLock
+            std::vector<u32> freeArrayIndices; // Slots handed back by FreeArrayIndex, reused before we grow the array
         };
 
         struct TextureHandlerVKData : ITextureHandlerVKData
@@ -65,15 +83,49 @@ namespace Renderer
             SafeVector<Texture*> textures;
             std::queue<Texture*> freeTextureQueue;
 
+            std::shared_mutex textureHashMutex;
+            robin_hood::unordered_map<u64, TextureID::type> textureHashToID; // Only contains loaded textures, never data textures
+
             SafeVector<TextureArray> textureArrays;
+
+            std::vector<std::thread> decodeThreads;
+            std::mutex decodeMutex;
+            std::condition_variable decodeCondition;
+            std::queue<TextureDecodeJob> decodeJobs;
+            bool stopDecoding = false;
         };
 
+        TextureHandlerVK::~TextureHandlerVK()
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            {
+                std::scoped_lock lock(data.decodeMutex);
+                data.stopDecoding = true;
+            }
+            data.decodeCondition.notify_all();
+
+            for (std::thread& thread : data.decodeThreads)
+            {
+                thread.join();
+            }
+        }
+
         void TextureHandlerVK::Init(RenderDeviceVK* device, BufferHandlerVK* bufferHandler, UploadBufferHandlerVK* uploadBufferHandler)
         {
             _data = new TextureHandlerVKData();
             _device = device;
             _bufferHandler = bufferHandler;
             _uploadBufferHandler = uploadBufferHandler;
+
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            // Leave room for the game thread and the loaders that are feeding us
+            u32 numDecodeThreads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+            for (u32 i = 0; i < numDecodeThreads; i++)
+            {
+                data.decodeThreads.emplace_back(&TextureHandlerVK::DecodeWorker, this);
+            }
         }
 
         void TextureHandlerVK::InitDebugTexture()
@@ -120,51 +172,69 @@ namespace Renderer
             TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
 
             // Check the cache, we only want to do this for LOADED textures though, never CREATED data textures
-            size_t nextID;
+            TextureID textureID;
             u64 cacheDescHash = CalculateDescHash(desc);
-            if (TryFindExistingTexture(cacheDescHash, nextID))
+            if (TryAcquireExistingTexture(cacheDescHash, textureID))
             {
-                TextureID::type id = static_cast<TextureID::type>(nextID);
+                return textureID; // We already loaded this texture
+            }
 
-                const Texture* texture = nullptr;
+            // TODO: Check the clearlist before allocating a new one
 
-                data.textures.ReadLock(
-                    [&](const std::vector<Texture*>& textures)
-                    {
-                        texture = textures[id];
-                    });
+            Texture* texture = nullptr;
+            {
+                std::unique_lock lock(data.textureHashMutex);
 
-                if (texture->loaded)
+                // Another thread might have started loading the same texture after our lookup
+                auto itr = data.textureHashToID.find(cacheDescHash);
+                if (itr != data.textureHashToID.end())
                 {
-                    return TextureID(id); // We already loaded this texture
+                    data.textures.ReadGet(itr->second)->refCount++;
+                    return TextureID(itr->second);
                 }
-            }
 
-            // TODO: Check the clearlist before allocating a new one
+                // Other threads get this id from textureHashToID as soon as we unlock, long before LoadFile has created the image.
+                // Until the upload has been submitted the texture is backed by the debug texture, synchronous loads included
+                texture = new Texture();
+                texture->layers = 1;
+                texture->isPending = true;
+                texture->refCount = 1;
 
-            TextureID textureID;
-            Texture* texture = new Texture();
+                data.textures.WriteLock(
+                    [&](std::vector<Texture*>& textures)
+                    {
+                        size_t nextHandle = textures.size();
 
-            data.textures.WriteLock(
-                [&](std::vector<Texture*>& textures)
-                {
-                    size_t nextHandle = textures.size();
+                        // Make sure we haven't exceeded the limit of the ImageID type, if this hits you need to change type of ImageID to something bigger
+                        if (nextHandle >= TextureID::MaxValue())
+                        {
+                            DebugHandler::PrintFatal("We exceeded the limit of the TextureID type!");
+                        }
 
-                    // Make sure we haven't exceeded the limit of the ImageID type, if this hits you need to change type of ImageID to something bigger
-                    if (nextHandle >= TextureID::MaxValue())
-                    {
-                        DebugHandler::PrintFatal("We exceeded the limit of the TextureID type!");
-                    }
+                        textures.push_back(texture);
+                        textureID = TextureID(static_cast<TextureID::type>(nextHandle));
+                    });
 
-                    textures.push_back(texture);
-                    textureID = TextureID(static_cast<TextureID::type>(nextHandle));
-                });
+                texture->hash = cacheDescHash;
+                data.textureHashToID[cacheDescHash] = static_cast<TextureID::type>(textureID);
+            }
 
-            texture->hash = cacheDescHash;
             texture->debugName = desc.path;
 
             texture->textureIndex = static_cast<TextureID::type>(textureID);
-            LoadFile(desc.path, *texture, textureID);
+
+            if (desc.loadSynchronously)
+            {
+                LoadFile(desc.path, *texture, textureID);
+            }
+            else
+            {
+                {
+                    std::scoped_lock lock(data.decodeMutex);
+                    data.decodeJobs.push({ texture, textureID, desc.path });
+                }
+                data.decodeCondition.notify_one();
+            }
 
             return textureID;
         }
@@ -199,6 +269,7 @@ namespace Renderer
                 DebugHandler::PrintFatal("Tried to load into a TextureArrayID which doesn't exist! (%u)", id);
             }
 
+            // The reference LoadTexture takes is owned by the array slot, the texture is shared with every other array holding the same desc
             textureID = LoadTexture(desc);
 
             {
@@ -207,9 +278,32 @@ namespace Renderer
                     [&](std::vector<TextureArray>& textureArrays)
                     {
                         TextureArray& textureArray = textureArrays[static_cast<TextureArrayID::type>(textureArrayID)];
-                        arrayIndex = static_cast<u32>(textureArray.textures->Size());
-                        textureArray.textures->PushBack(textureID);
-                        textureArray.textureHashes->PushBack(descHash);
+
+                        // Another thread might have added the same texture to this array after our lookup, its slot already holds a reference
+                        auto itr = textureArray.hashToArrayIndex.find(descHash);
+                        if (itr != textureArray.hashToArrayIndex.end())
+                        {
+                            arrayIndex = itr->second;
+                            ReleaseTextureReference(textureID);
+                            return;
+                        }
+
+                        if (!textureArray.freeArrayIndices.empty())
+                        {
+                            arrayIndex = textureArray.freeArrayIndices.back();
+                            textureArray.freeArrayIndices.pop_back();
+
+                            textureArray.textures->WriteLock([&](std::vector<TextureID>& textures) { textures[arrayIndex] = textureID; });
+                            textureArray.textureHashes->WriteLock([&](std::vector<u64>& textureHashes) { textureHashes[arrayIndex] = descHash; });
+                        }
+                        else
+                        {
+                            arrayIndex = static_cast<u32>(textureArray.textures->Size());
+                            textureArray.textures->PushBack(textureID);
+                            textureArray.textureHashes->PushBack(descHash);
+                        }
+
+                        textureArray.hashToArrayIndex[descHash] = arrayIndex;
                     });
             }
             
@@ -220,6 +314,9 @@ namespace Renderer
         {
             TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
 
+            // Same lock order as LoadTexture, hash mutex before the textures lock
+            std::unique_lock lock(data.textureHashMutex);
+
             data.textures.WriteLock(
                 [&](std::vector<Texture*>& textures)
                 {
@@ -230,12 +327,25 @@ namespace Renderer
                         return;
                     }
 
-                    texture->loaded = false;
+                    auto itr = data.textureHashToID.find(texture->hash);
+                    if (itr != data.textureHashToID.end() && itr->second == static_cast<TextureID::type>(textureID))
+                    {
+                        data.textureHashToID.erase(itr);
+                    }
                     texture->hash = 0;
 
-                    vmaFreeMemory(_device->_allocator, texture->allocation);
-                    vkDestroyImage(_device->_device, texture->image, nullptr);
-                    vkDestroyImageView(_device->_device, texture->imageView, nullptr);
+                    {
+                        // If a decode worker hasn't created the image yet it will see loaded is false and skip it
+                        std::scoped_lock lock(texture->loadMutex);
+                        texture->loaded = false;
+
+                        if (texture->image != VK_NULL_HANDLE)
+                        {
+                            vmaFreeMemory(_device->_allocator, texture->allocation);
+                            vkDestroyImage(_device->_device, texture->image, nullptr);
+                            vkDestroyImageView(_device->_device, texture->imageView, nullptr);
+                        }
+                    }
 
                     data.freeTextureQueue.push(texture);
                 });
@@ -255,12 +365,108 @@ namespace Renderer
                         {
                             for (u32 i = unloadStartIndex; i < textures.size(); i++)
                             {
-                                UnloadTexture(textures[i]);
+                                // Slots released by ReleaseTextureInArray point at our debug textures, those should never be unloaded
+                                if (textures[i] == _debugTexture || textures[i] == _debugOnionTexture)
+                                    continue;
+
+                                // Other arrays might still sample the same texture
+                                if (ReleaseTextureReference(textures[i]))
+                                {
+                                    UnloadTexture(textures[i]);
+                                }
+                            }
+                        });
+
+                    textureArray.textureHashes->ReadLock(
+                        [&](const std::vector<u64>& textureHashes)
+                        {
+                            for (u32 i = unloadStartIndex; i < textureHashes.size(); i++)
+                            {
+                                textureArray.hashToArrayIndex.erase(textureHashes[i]);
                             }
                         });
 
                     textureArray.textureHashes->Resize(unloadStartIndex);
                     textureArray.textures->Resize(unloadStartIndex);
+
+                    // Free slots past the new end no longer exist
+                    std::vector<u32>& freeArrayIndices = textureArray.freeArrayIndices;
+                    freeArrayIndices.erase(std::remove_if(freeArrayIndices.begin(), freeArrayIndices.end(), [unloadStartIndex](u32 index) { return index >= unloadStartIndex; }), freeArrayIndices.end());
+                });
+        }
+
+        bool TextureHandlerVK::ReleaseTextureInArray(const TextureArrayID textureArrayID, u32 arrayIndex, TextureID& textureToUnload)
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+            TextureArrayID::type id = static_cast<TextureArrayID::type>(textureArrayID);
+
+            if (data.textureArrays.Size() <= id)
+            {
+                DebugHandler::PrintFatal("Tried to access invalid TextureArrayID: %u", id);
+            }
+
+            bool released = false;
+            textureToUnload = TextureID::Invalid();
+            data.textureArrays.WriteLock(
+                [&](std::vector<TextureArray>& textureArrays)
+                {
+                    TextureArray& textureArray = textureArrays[id];
+
+                    if (arrayIndex >= textureArray.textures->Size())
+                    {
+                        DebugHandler::PrintFatal("Tried to unload invalid index %u in TextureArrayID: %u", arrayIndex, id);
+                    }
+
+                    TextureID oldTextureID = textureArray.textures->ReadGet(arrayIndex);
+                    if (oldTextureID == _debugTexture || oldTextureID == _debugOnionTexture)
+                        return; // Already released
+
+                    // The slot keeps pointing at a valid image until it gets reused, so descriptors built from this array stay valid
+                    TextureID placeholderID = IsOnionTexture(oldTextureID) ? _debugOnionTexture : _debugTexture;
+                    textureArray.textures->WriteLock([&](std::vector<TextureID>& textures) { textures[arrayIndex] = placeholderID; });
+
+                    // Forget the hash right away, loading the same texture again before the slot is freed has to get a new slot
+                    textureArray.textureHashes->WriteLock(
+                        [&](std::vector<u64>& textureHashes)
+                        {
+                            textureArray.hashToArrayIndex.erase(textureHashes[arrayIndex]);
+                            textureHashes[arrayIndex] = 0;
+                        });
+
+                    // Other arrays might still sample the same texture, it only goes away with its last reference
+                    if (ReleaseTextureReference(oldTextureID))
+                    {
+                        textureToUnload = oldTextureID;
+                    }
+                    released = true;
+                });
+
+            return released;
+        }
+
+        void TextureHandlerVK::FreeArrayIndex(const TextureArrayID textureArrayID, u32 arrayIndex)
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+            TextureArrayID::type id = static_cast<TextureArrayID::type>(textureArrayID);
+
+            data.textureArrays.WriteLock(
+                [&](std::vector<TextureArray>& textureArrays)
+                {
+                    TextureArray& textureArray = textureArrays[id];
+
+                    // UnloadTexturesInArray might have truncated (and refilled) the array since the slot was released
+                    if (arrayIndex >= textureArray.textures->Size())
+                        return;
+
+                    TextureID textureID = textureArray.textures->ReadGet(arrayIndex);
+                    if (textureID != _debugTexture && textureID != _debugOnionTexture)
+                        return;
+
+                    std::vector<u32>& freeArrayIndices = textureArray.freeArrayIndices;
+                    if (std::find(freeArrayIndices.begin(), freeArrayIndices.end(), arrayIndex) == freeArrayIndices.end())
+                    {
+                        freeArrayIndices.push_back(arrayIndex);
+                    }
                 });
         }
 
@@ -303,6 +509,7 @@ namespace Renderer
 
             size_t nextHandle;
             Texture* texture = new Texture();
+            texture->refCount = 1; // Data textures are never shared, this is the reference of the array slot (if any) that holds it
 
             data.textures.WriteLock([&](std::vector<Texture*>& textures)
                 {
@@ -363,6 +570,32 @@ namespace Renderer
             return textureID;
         }
 
+        bool TextureHandlerVK::UpdateDataTexture(TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* pixels, u32 pixelsRowLength)
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+            TextureID::type id = static_cast<TextureID::type>(textureID);
+
+            // Lets make sure this id exists
+            if (data.textures.Size() <= id)
+            {
+                DebugHandler::PrintFatal("Tried to access invalid TextureID: %u", id);
+            }
+
+            const Texture* texture = data.textures.ReadGet(id);
+            if (x + width > static_cast<u32>(texture->width) || y + height > static_cast<u32>(texture->height))
+            {
+                DebugHandler::PrintFatal("Tried to update a %ux%u rect at (%u, %u) outside of DataTexture %s", width, height, x, y, texture->debugName.c_str());
+            }
+
+            if (FormatIsCompressed(texture->format))
+            {
+                DebugHandler::PrintFatal("Tried to update a rect of compressed DataTexture %s", texture->debugName.c_str());
+            }
+
+            u32 texelSize = static_cast<u32>(FormatTexelSize(texture->format));
+            return _uploadBufferHandler->UploadTextureRegion(textureID, x, y, width, height, texelSize, static_cast<const u8*>(pixels), static_cast<size_t>(pixelsRowLength) * texelSize);
+        }
+
         void TextureHandlerVK::CopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, size_t srcOffset, TextureID dstTextureID)
         {
             TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
@@ -383,19 +616,182 @@ namespace Renderer
                     if (!texture.loaded)
                         return;
 
-                    // Transition to TRANSFER_DST_OPTIMAL
-                    VkImageLayout beforeLayout = (texture.layoutUndefined) ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                    _device->TransitionImageLayout(commandBuffer, texture.image, VK_IMAGE_ASPECT_COLOR_BIT, beforeLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, texture.layers, texture.mipLevels);
+                    // Transition to TRANSFER_DST_OPTIMAL, we overwrite every mip and layer so the old contents can be discarded.
+                    // This also means the transfer queue doesn't have to acquire ownership from the graphics queue first
+                    _device->TransitionImageLayout(commandBuffer, texture.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, texture.layers, texture.mipLevels);
 
                     // Do the copy
                     _device->CopyBufferToImage(commandBuffer, srcBuffer, srcOffset, texture.image, texture.format, static_cast<u32>(texture.width), static_cast<u32>(texture.height), texture.layers, texture.mipLevels);
 
-                    // Transition back to SHADER_READ_ONLY_OPTIMAL
-                    _device->TransitionImageLayout(commandBuffer, texture.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, texture.layers, texture.mipLevels);
+                    if (_device->HasDedicatedTransferQueue())
+                    {
+                        // Release the image to the graphics queue, AcquireUploadedTextures records the matching acquire
+                        VkImageMemoryBarrier releaseBarrier = GetOwnershipTransferBarrier(texture);
+                        releaseBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+                        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &releaseBarrier);
+                    }
+                    else
+                    {
+                        // Transition back to SHADER_READ_ONLY_OPTIMAL
+                        _device->TransitionImageLayout(commandBuffer, texture.image, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, texture.layers, texture.mipLevels);
+                    }
                     texture.layoutUndefined = false;
                 });
         }
 
+        void TextureHandlerVK::CopyBufferToImageRegions(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, const std::vector<TextureRegionCopy>& copies)
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            struct ImageRegions
+            {
+                VkImage image;
+                std::vector<VkBufferImageCopy> regions;
+            };
+
+            // One transition and one copy call per texture, no matter how many rects it got
+            std::vector<ImageRegions> images;
+            std::vector<VkImageMemoryBarrier> barriers;
+            robin_hood::unordered_map<TextureID::type, size_t> idToImage;
+
+            data.textures.WriteLock(
+                [&](std::vector<Texture*>& textures)
+                {
+                    for (const TextureRegionCopy& copy : copies)
+                    {
+                        TextureID::type id = static_cast<TextureID::type>(copy.texture);
+                        Texture& texture = *textures[id];
+
+                        // If the texture has been unloaded, just skip it
+                        if (!texture.loaded)
+                            continue;
+
+                        auto result = idToImage.emplace(id, images.size());
+                        if (result.second)
+                        {
+                            images.push_back({ texture.image, {} });
+
+                            // Unlike full uploads the old contents have to survive the transition, unless there never were any
+                            VkImageMemoryBarrier& barrier = barriers.emplace_back();
+                            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+                            barrier.oldLayout = texture.layoutUndefined ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                            barrier.image = texture.image;
+                            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                            barrier.subresourceRange.baseMipLevel = 0;
+                            barrier.subresourceRange.levelCount = texture.mipLevels;
+                            barrier.subresourceRange.baseArrayLayer = 0;
+                            barrier.subresourceRange.layerCount = texture.layers;
+
+                            texture.layoutUndefined = false;
+                        }
+
+                        VkBufferImageCopy& region = images[result.first->second].regions.emplace_back();
+                        region.bufferOffset = copy.srcOffset;
+                        region.bufferRowLength = 0;
+                        region.bufferImageHeight = 0;
+                        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                        region.imageSubresource.mipLevel = 0;
+                        region.imageSubresource.baseArrayLayer = 0;
+                        region.imageSubresource.layerCount = 1;
+                        region.imageOffset = { static_cast<i32>(copy.x), static_cast<i32>(copy.y), 0 };
+                        region.imageExtent = { copy.width, copy.height, 1 };
+                    }
+                });
+
+            if (images.empty())
+                return;
+
+            // Earlier frames might still be sampling the textures
+            VkPipelineStageFlags shaderStageMask = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            vkCmdPipelineBarrier(commandBuffer, shaderStageMask, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, static_cast<u32>(barriers.size()), barriers.data());
+
+            for (const ImageRegions& imageRegions : images)
+            {
+                vkCmdCopyBufferToImage(commandBuffer, srcBuffer, imageRegions.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<u32>(imageRegions.regions.size()), imageRegions.regions.data());
+            }
+
+            for (VkImageMemoryBarrier& barrier : barriers)
+            {
+                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+                barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            }
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, shaderStageMask, 0, 0, nullptr, 0, nullptr, static_cast<u32>(barriers.size()), barriers.data());
+        }
+
+        void TextureHandlerVK::AcquireUploadedTextures(VkCommandBuffer commandBuffer, const std::vector<TextureID>& textureIDs)
+        {
+            if (!_device->HasDedicatedTransferQueue() || textureIDs.empty())
+                return;
+
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            std::vector<VkImageMemoryBarrier> acquireBarriers;
+            acquireBarriers.reserve(textureIDs.size());
+
+            data.textures.ReadLock(
+                [&](const std::vector<Texture*>& textures)
+                {
+                    for (TextureID textureID : textureIDs)
+                    {
+                        const Texture& texture = *textures[static_cast<TextureID::type>(textureID)];
+
+                        // The copy was skipped if it got unloaded in the meantime
+                        if (!texture.loaded)
+                            continue;
+
+                        VkImageMemoryBarrier& acquireBarrier = acquireBarriers.emplace_back(GetOwnershipTransferBarrier(texture));
+                        acquireBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+                    }
+                });
+
+            if (acquireBarriers.empty())
+                return;
+
+            VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            // Chains off the transfer stage wait on transferFinishedSemaphore in UploadBufferHandlerVK::ExecuteUploadTasks
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStageMask, 0, 0, nullptr, 0, nullptr, static_cast<u32>(acquireBarriers.size()), acquireBarriers.data());
+        }
+
+        VkImageMemoryBarrier TextureHandlerVK::GetOwnershipTransferBarrier(const Texture& texture)
+        {
+            // The release and acquire halves have to match exactly, only the access masks differ
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.srcQueueFamilyIndex = _device->_queueFamilyIndices.transferFamily.value();
+            barrier.dstQueueFamilyIndex = _device->_queueFamilyIndices.graphicsFamily.value();
+            barrier.image = texture.image;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = texture.mipLevels;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = texture.layers;
+
+            return barrier;
+        }
+
+        void TextureHandlerVK::MarkTexturesUploaded(const std::vector<TextureID>& textureIDs)
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            data.textures.ReadLock(
+                [&](const std::vector<Texture*>& textures)
+                {
+                    for (TextureID textureID : textureIDs)
+                    {
+                        textures[static_cast<TextureID::type>(textureID)]->isPending = false;
+                    }
+                });
+        }
+
         void TextureHandlerVK::TransitionImageLayout(VkCommandBuffer commandBuffer, TextureID textureID, VkImageAspectFlags aspects, VkImageLayout oldLayout, VkImageLayout newLayout)
         {
             TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
@@ -435,7 +831,11 @@ namespace Renderer
                 DebugHandler::PrintFatal("Tried to access invalid TextureID: %u", id);
             }
 
-            return data.textures.ReadGet(id)->layers != 1;
+            const Texture* texture = data.textures.ReadGet(id);
+            if (texture->isPending)
+                return false; // Pending textures are backed by the 2D debug texture
+
+            return texture->layers != 1;
         }
 
         VkImageView TextureHandlerVK::GetImageView(const TextureID textureID)
@@ -449,7 +849,11 @@ namespace Renderer
                 DebugHandler::PrintFatal("Tried to access invalid TextureID: %u", id);
             }
 
-            return data.textures.ReadGet(id)->imageView;
+            const Texture* texture = data.textures.ReadGet(id);
+            if (texture->isPending)
+                return GetImageView(_debugTexture);
+
+            return texture->imageView;
         }
 
         VkImageView TextureHandlerVK::GetDebugTextureImageView()
@@ -482,27 +886,41 @@ namespace Renderer
             return hash;
         }
 
-        bool TextureHandlerVK::TryFindExistingTexture(u64 descHash, size_t& id)
+        bool TextureHandlerVK::TryAcquireExistingTexture(u64 descHash, TextureID& textureID)
         {
             TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
-            id = 0;
+            std::shared_lock lock(data.textureHashMutex);
 
-            bool foundTexture = false;
-            data.textures.ReadLock(
-                [&](const std::vector<Texture*>& textures)
-                {
-                    for (auto* texture : textures)
-                    {
-                        if (descHash == texture->hash)
-                        {
-                            foundTexture = true;
-                            return;
-                        }
-                        id++;
-                    }
-                });
+            auto itr = data.textureHashToID.find(descHash);
+            if (itr == data.textureHashToID.end())
+                return false;
 
-            return foundTexture;
+            // The last reference can only be dropped under the unique lock, so the texture can't go away between the find and the increment
+            data.textures.ReadGet(itr->second)->refCount++;
+
+            textureID = TextureID(itr->second);
+            return true;
+        }
+
+        bool TextureHandlerVK::ReleaseTextureReference(const TextureID textureID)
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+            TextureID::type id = static_cast<TextureID::type>(textureID);
+
+            std::unique_lock lock(data.textureHashMutex);
+
+            Texture* texture = data.textures.ReadGet(id);
+            if (texture->refCount > 0 && --texture->refCount > 0)
+                return false;
+
+            // Forget the hash right away, the image is only destroyed once the frames in flight are done with it so loading it again has to create a new one
+            auto itr = data.textureHashToID.find(texture->hash);
+            if (itr != data.textureHashToID.end() && itr->second == id)
+            {
+                data.textureHashToID.erase(itr);
+            }
+
+            return true;
         }
 
         bool TextureHandlerVK::TryFindExistingTextureInArray(TextureArrayID textureArrayID, u64 descHash, size_t& arrayIndex, TextureID& textureID)
@@ -515,19 +933,17 @@ namespace Renderer
             }
 
             bool foundTexture = false;
-            data.textureArrays.WriteLock(
-                [&](std::vector<TextureArray>& textureArrays)
+            data.textureArrays.ReadLock(
+                [&](const std::vector<TextureArray>& textureArrays)
                 {
-                    TextureArray& array = textureArrays[id];
+                    const TextureArray& array = textureArrays[id];
 
-                    for (arrayIndex = 0; arrayIndex < array.textureHashes->Size(); arrayIndex++)
+                    auto itr = array.hashToArrayIndex.find(descHash);
+                    if (itr != array.hashToArrayIndex.end())
                     {
-                        if (descHash == array.textureHashes->ReadGet(arrayIndex))
-                        {
-                            textureID = array.textures->ReadGet(arrayIndex);
-                            foundTexture = true;
-                            return;
-                        }
+                        arrayIndex = itr->second;
+                        textureID = array.textures->ReadGet(arrayIndex);
+                        foundTexture = true;
                     }
                 });
 
@@ -541,6 +957,7 @@ namespace Renderer
             int channels;
 
             void* pixels = stbi_load(filename.c_str(), &texture.width, &texture.height, &channels, STBI_rgb_alpha);
+            bool loadedWithStbi = pixels != nullptr;
 
             gli::texture gliTexture;
 
@@ -578,14 +995,56 @@ namespace Renderer
 
             {
                 ZoneScopedN("CreateTexture");
-                // Create texture
-                CreateTexture(texture);
 
-                // Create upload buffer
-                auto uploadBuffer = _uploadBufferHandler->CreateUploadBuffer(textureID, 0, texture.fileSize);
+                bool isLoaded;
+                {
+                    // The texture might have been unloaded while we were decoding it
+                    std::scoped_lock lock(texture.loadMutex);
+                    isLoaded = texture.loaded;
+
+                    if (isLoaded)
+                    {
+                        // Create texture
+                        CreateTexture(texture);
+                    }
+                }
+
+                if (isLoaded)
+                {
+                    // Create upload buffer
+                    auto uploadBuffer = _uploadBufferHandler->CreateUploadBuffer(textureID, 0, texture.fileSize);
+
+                    // Copy data to upload buffer
+                    memcpy(uploadBuffer->mappedMemory, pixels, texture.fileSize);
+                }
+            }
+
+            if (loadedWithStbi)
+            {
+                stbi_image_free(pixels);
+            }
+        }
+
+        void TextureHandlerVK::DecodeWorker()
+        {
+            TextureHandlerVKData& data = static_cast<TextureHandlerVKData&>(*_data);
+
+            while (true)
+            {
+                TextureDecodeJob job;
+                {
+                    std::unique_lock lock(data.decodeMutex);
+                    data.decodeCondition.wait(lock, [&]() { return data.stopDecoding || !data.decodeJobs.empty(); });
+
+                    if (data.stopDecoding)
+                        return;
+
+                    job = std::move(data.decodeJobs.front());
+                    data.decodeJobs.pop();
+                }
 
-                // Copy data to upload buffer
-                memcpy(uploadBuffer->mappedMemory, pixels, texture.fileSize);
+                ZoneScopedN("DecodeTexture");
+                LoadFile(job.path, *job.texture, job.textureID);
             }
         }
 
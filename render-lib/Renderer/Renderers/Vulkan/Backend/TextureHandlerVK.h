@@ -1,6 +1,7 @@
 #pragma once
 #include <NovusTypes.h>
 #include <vulkan/vulkan_core.h>
+#include <vector>
 
 #include "../../../Descriptors/TextureDesc.h"
 #include "../../../Descriptors/TextureArrayDesc.h"
@@ -19,25 +20,51 @@ namespace Renderer
 
         struct ITextureHandlerVKData {};
 
+        // A rect of mip 0 and layer 0, srcOffset points at its first texel and the rows are tightly packed
+        struct TextureRegionCopy
+        {
+            TextureID texture;
+            size_t srcOffset;
+            u32 x;
+            u32 y;
+            u32 width;
+            u32 height;
+        };
+
         class TextureHandlerVK
         {
         public:
+            ~TextureHandlerVK();
+
             void Init(RenderDeviceVK* device, BufferHandlerVK* bufferHandler, UploadBufferHandlerVK* uploadBufferHandler);
 
             void InitDebugTexture();
 
+            // Every call takes a reference on the texture, textures loaded with the same desc are shared between all arrays
             TextureID LoadTexture(const TextureDesc& desc);
             TextureID LoadTextureIntoArray(const TextureDesc& desc, TextureArrayID textureArrayID, u32& arrayIndex);
 
             void UnloadTexture(const TextureID textureID);
             void UnloadTexturesInArray(const TextureArrayID textureArrayID, u32 unloadStartIndex);
+            // Points the slot at a placeholder, forgets its hash and drops the slot's reference, but keeps the slot reserved until FreeArrayIndex
+            // Returns false if the slot was already released. textureToUnload is the texture if that was its last reference (Invalid otherwise), the caller is responsible for unloading it
+            bool ReleaseTextureInArray(const TextureArrayID textureArrayID, u32 arrayIndex, TextureID& textureToUnload);
+            // Lets later loads reuse a slot released by ReleaseTextureInArray
+            void FreeArrayIndex(const TextureArrayID textureArrayID, u32 arrayIndex);
 
             TextureArrayID CreateTextureArray(const TextureArrayDesc& desc);
 
             TextureID CreateDataTexture(const DataTextureDesc& desc);
             TextureID CreateDataTextureIntoArray(const DataTextureDesc& desc, TextureArrayID textureArrayID, u32& arrayIndex);
+            bool UpdateDataTexture(TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* pixels, u32 pixelsRowLength);
 
             void CopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, size_t srcOffset, TextureID dstTextureID);
+            // Graphics queue only, the textures keep everything outside the rects so they can't be handed over to the transfer queue like full uploads
+            void CopyBufferToImageRegions(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, const std::vector<TextureRegionCopy>& copies);
+            // Records the graphics queue half of the ownership transfer for textures copied on the transfer queue
+            void AcquireUploadedTextures(VkCommandBuffer commandBuffer, const std::vector<TextureID>& textureIDs);
+            // Called once the graphics queue has taken ownership of the copies, the render graph waits on that submit before it samples them
+            void MarkTexturesUploaded(const std::vector<TextureID>& textureIDs);
             void TransitionImageLayout(VkCommandBuffer commandBuffer, TextureID textureID, VkImageAspectFlags aspects, VkImageLayout oldLayout, VkImageLayout newLayout);
 
             const SafeVector<TextureID>& GetTextureIDsInArray(const TextureArrayID textureID);
@@ -52,10 +79,14 @@ namespace Renderer
 
         private:
             u64 CalculateDescHash(const TextureDesc& desc);
-            bool TryFindExistingTexture(u64 descHash, size_t& id);
+            bool TryAcquireExistingTexture(u64 descHash, TextureID& textureID);
+            // Returns true if that was the last reference, the texture is then no longer found by LoadTexture
+            bool ReleaseTextureReference(const TextureID textureID);
             bool TryFindExistingTextureInArray(TextureArrayID textureArrayID, u64 descHash, size_t& arrayIndex, TextureID& textureID);
 
             void LoadFile(const std::string& filename, Texture& texture, TextureID textureID);
+            void DecodeWorker();
+            VkImageMemoryBarrier GetOwnershipTransferBarrier(const Texture& texture);
             void CreateTexture(Texture& texture);
 
         private:
@@ -6,9 +6,9 @@
 #include "RenderDeviceVK.h"
 
 #include <tracy/Tracy.hpp>
-#include <tracy/TracyVulkan.hpp>
 #include <Utils/ConcurrentQueue.h>
 #include <Utils/SafeVector.h>
+#include <cassert>
 
 namespace Renderer
 {
@@ -20,6 +20,17 @@ namespace Renderer
             size_t targetOffset;
             size_t stagingBufferOffset;
             size_t copySize;
+            u64 submissionIndex;
+        };
+
+        struct BufferToBufferCopyTask
+        {
+            BufferID dstBuffer;
+            u64 dstOffset;
+            BufferID srcBuffer;
+            u64 srcOffset;
+            u64 range;
+            u64 submissionIndex;
         };
 
         struct UploadToTextureTask
@@ -49,15 +60,66 @@ namespace Renderer
             VkFence fence;
         };
 
+        // Rect updates of textures the graphics queue already owns. They are only recorded by ExecuteUploadTasks,
+        // so they get their own staging memory that a full StagingBuffer being submitted early can't recycle under them
+        struct RegionStagingBuffer
+        {
+            BufferID buffer = BufferID::Invalid();
+            void* mappedMemory = nullptr;
+            Memory::StackAllocator allocator;
+
+            std::vector<TextureRegionCopy> copies;
+
+            bool isSubmitted = false;
+            VkFence fence;
+        };
+
+        struct BufferRangeToAcquire
+        {
+            BufferID buffer;
+            u64 offset;
+            u64 size;
+        };
+
+#if _DEBUG
+        struct RecordedUpload
+        {
+            BufferID buffer;
+            u64 offset;
+            u64 size;
+            u64 submissionIndex;
+        };
+#endif
+
         struct UploadBufferHandlerVKData : IUploadBufferHandlerVKData
         {
             FrameResource<StagingBuffer, 3> stagingBuffers;
             std::atomic<u32> selectedStagingBuffer = 0;
 
             bool isDirty = true;
+            bool isUploadSignaled = false; // Set when this frame's ExecuteUploadTasks signaled uploadFinishedSemaphore, it has to be waited on exactly once
+            SemaphoreID transferFinishedSemaphore;
             SemaphoreID uploadFinishedSemaphore;
 
+            // Copies between buffers run on the graphics queue since the other frame in flight might still be using the source or destination
+            moodycamel::ConcurrentQueue<BufferToBufferCopyTask> bufferCopyTasks;
+            std::atomic<u64> nextSubmissionIndex = 0; // Orders buffer uploads against copies, see ExecuteBufferCopies
+
+#if _DEBUG
+            std::mutex recordedUploadsMutex;
+            std::vector<RecordedUpload> recordedUploads; // Staging copies recorded since the last ExecuteBufferCopies
+#endif
+
+            // Released by the transfer queue in early submits, acquired by the next ExecuteUploadTasks
+            std::mutex acquireMutex;
+            std::vector<TextureID> texturesToAcquire;
+            std::vector<BufferRangeToAcquire> bufferRangesToAcquire;
+
             std::mutex submitMutex;
+
+            FrameResource<RegionStagingBuffer, 2> regionStagingBuffers;
+            u32 selectedRegionStagingBuffer = 0;
+            std::mutex regionMutex;
         };
 
         void UploadBufferHandlerVK::Init(RenderDeviceVK* device, BufferHandlerVK* bufferHandler, TextureHandlerVK* textureHandler, SemaphoreHandlerVK* semaphoreHandler, CommandListHandlerVK* commandListHandler)
@@ -99,28 +161,56 @@ namespace Renderer
                 vkCreateFence(_device->_device, &fenceInfo, nullptr, &stagingBuffer.fence);
             }
 
+            for (u32 i = 0; i < data->regionStagingBuffers.Num; i++)
+            {
+                RegionStagingBuffer& stagingBuffer = data->regionStagingBuffers.Get(i);
+
+                BufferDesc bufferDesc;
+                bufferDesc.name = "RegionStagingBuffer" + std::to_string(i);
+                bufferDesc.size = REGION_BUFFER_SIZE;
+                bufferDesc.usage = Renderer::BufferUsage::TRANSFER_SOURCE;
+                bufferDesc.cpuAccess = Renderer::BufferCPUAccess::WriteOnly;
+
+                stagingBuffer.buffer = _bufferHandler->CreateBuffer(bufferDesc);
+                stagingBuffer.allocator.Init(REGION_BUFFER_SIZE, "RegionStagingBuffer", true, false);
+
+                VkResult result = vmaMapMemory(_device->_allocator, _bufferHandler->GetBufferAllocation(stagingBuffer.buffer), &stagingBuffer.mappedMemory);
+                if (result != VK_SUCCESS)
+                {
+                    DebugHandler::PrintFatal("vmaMapMemory failed!\n");
+                }
+
+                VkFenceCreateInfo fenceInfo = {};
+                fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+                vkCreateFence(_device->_device, &fenceInfo, nullptr, &stagingBuffer.fence);
+            }
+
+            data->transferFinishedSemaphore = _semaphoreHandler->CreateNSemaphore();
             data->uploadFinishedSemaphore = _semaphoreHandler->CreateNSemaphore();
         }
 
         void UploadBufferHandlerVK::ExecuteUploadTasks()
         {
             UploadBufferHandlerVKData* data = static_cast<UploadBufferHandlerVKData*>(_data);
+            data->isUploadSignaled = false;
 
-            if (!data->isDirty)
+            // Textures and buffer ranges from staging buffers that got submitted early still need to be acquired on the graphics queue
+            std::vector<TextureID> texturesToAcquire;
+            std::vector<BufferRangeToAcquire> bufferRangesToAcquire;
+            {
+                std::scoped_lock lock(data->acquireMutex);
+                texturesToAcquire.swap(data->texturesToAcquire);
+                bufferRangesToAcquire.swap(data->bufferRangesToAcquire);
+            }
+
+            if (!data->isDirty && texturesToAcquire.empty() && bufferRangesToAcquire.empty())
                 return;
 
             ZoneScoped;
 
-            CommandListID commandListID = _commandListHandler->BeginCommandList(QueueType::Graphics);
-
-            VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
-
-#if TRACY_ENABLE
-            TracySourceLocation(ExecuteUpload, "ExecuteUpload", tracy::Color::Yellow2);
-            tracy::VkCtxManualScope tracyScope(_device->_tracyContext, &ExecuteUpload, true);
-            tracyScope.Start(commandBuffer);
-#endif
-
+            // Early submits are waited for on the CPU, only staging buffers recorded here need the transfer list and its semaphore
+            bool hasTransferWork = false;
             for (u32 i = 0; i < data->stagingBuffers.Num; i++)
             {
                 StagingBuffer& stagingBuffer = data->stagingBuffers.Get(i);
@@ -129,19 +219,54 @@ namespace Renderer
                 {
                     WaitForStagingBuffer(stagingBuffer);
                 }
-                else
+                else if (stagingBuffer.uploadToBufferTasks.size_approx() > 0 || stagingBuffer.uploadToTextureTasks.size_approx() > 0)
                 {
-                    ExecuteStagingBuffer(commandBuffer, stagingBuffer);
+                    hasTransferWork = true;
                 }
             }
 
-#if TRACY_ENABLE
-            tracyScope.End();
-#endif
+            VkSemaphore transferFinishedSemaphore = _semaphoreHandler->GetVkSemaphore(data->transferFinishedSemaphore);
+            if (hasTransferWork)
+            {
+                // Staging copies go on the transfer queue so big streaming uploads don't sit in front of the frame's draws
+                CommandListID transferCommandListID = _commandListHandler->BeginCommandList(QueueType::Transfer);
+                VkCommandBuffer transferCommandBuffer = _commandListHandler->GetCommandBuffer(transferCommandListID);
+
+                for (u32 i = 0; i < data->stagingBuffers.Num; i++)
+                {
+                    StagingBuffer& stagingBuffer = data->stagingBuffers.Get(i);
+
+                    if (!stagingBuffer.isSubmitted)
+                    {
+                        ExecuteStagingBuffer(transferCommandBuffer, stagingBuffer, texturesToAcquire, bufferRangesToAcquire);
+                    }
+                }
+
+                _commandListHandler->AddSignalSemaphore(transferCommandListID, transferFinishedSemaphore);
+                _commandListHandler->EndCommandList(transferCommandListID, VK_NULL_HANDLE);
+            }
+
+            // The render graph waits for this list before it reads anything we uploaded
+            CommandListID graphicsCommandListID = _commandListHandler->BeginCommandList(QueueType::Graphics);
+            VkCommandBuffer graphicsCommandBuffer = _commandListHandler->GetCommandBuffer(graphicsCommandListID);
+
+            // Take ownership of what the transfer queue wrote, the acquire barriers chain off the transfer stage we wait on below
+            AcquireUploadedBuffers(graphicsCommandBuffer, bufferRangesToAcquire);
+            _textureHandler->AcquireUploadedTextures(graphicsCommandBuffer, texturesToAcquire);
+            ExecuteBufferCopies(graphicsCommandBuffer);
+            VkFence regionFence = ExecuteTextureRegionCopies(graphicsCommandBuffer);
+
+            if (hasTransferWork)
+            {
+                // Nothing in this list touches the uploads before the transfer stage, the acquire barriers carry the dependency on to the render graph
+                _commandListHandler->AddWaitSemaphore(graphicsCommandListID, transferFinishedSemaphore, VK_PIPELINE_STAGE_TRANSFER_BIT);
+            }
+
+            VkSemaphore uploadFinishedSemaphore = _semaphoreHandler->GetVkSemaphore(data->uploadFinishedSemaphore);
+            _commandListHandler->AddSignalSemaphore(graphicsCommandListID, uploadFinishedSemaphore);
+            _commandListHandler->EndCommandList(graphicsCommandListID, regionFence);
 
-            VkSemaphore semaphore = _semaphoreHandler->GetVkSemaphore(data->uploadFinishedSemaphore);
-            _commandListHandler->AddSignalSemaphore(commandListID, semaphore);
-            _commandListHandler->EndCommandList(commandListID, VK_NULL_HANDLE);
+            _textureHandler->MarkTexturesUploaded(texturesToAcquire);
 
             // Reset staging buffer allocators and uploadToBufferTasks
             for (u32 i = 0; i < data->stagingBuffers.Num; i++)
@@ -153,6 +278,7 @@ namespace Renderer
             }
 
             data->isDirty = false;
+            data->isUploadSignaled = true;
         }
 
         std::shared_ptr<UploadBuffer> UploadBufferHandlerVK::CreateUploadBuffer(BufferID targetBuffer, size_t targetOffset, size_t size)
@@ -174,6 +300,7 @@ namespace Renderer
             task.targetOffset = targetOffset;
             task.stagingBufferOffset = offset;
             task.copySize = size;
+            task.submissionIndex = data->nextSubmissionIndex++;
 
             StagingBuffer& stagingBuffer = data->stagingBuffers.Get(static_cast<StagingBufferID::type>(stagingBufferID));
             stagingBuffer.uploadToBufferTasks.enqueue(task);
@@ -263,6 +390,51 @@ namespace Renderer
             return uploadBuffer;
         }
 
+        void UploadBufferHandlerVK::CopyBuffer(BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range)
+        {
+            UploadBufferHandlerVKData* data = static_cast<UploadBufferHandlerVKData*>(_data);
+
+            BufferToBufferCopyTask task;
+            task.dstBuffer = dstBuffer;
+            task.dstOffset = dstOffset;
+            task.srcBuffer = srcBuffer;
+            task.srcOffset = srcOffset;
+            task.range = range;
+            task.submissionIndex = data->nextSubmissionIndex++;
+            data->bufferCopyTasks.enqueue(task);
+
+            data->isDirty = true;
+        }
+
+        bool UploadBufferHandlerVK::UploadTextureRegion(TextureID targetTexture, u32 x, u32 y, u32 width, u32 height, u32 texelSize, const u8* pixels, size_t pixelsRowPitch)
+        {
+            UploadBufferHandlerVKData* data = static_cast<UploadBufferHandlerVKData*>(_data);
+
+            size_t rowSize = static_cast<size_t>(width) * texelSize;
+            size_t size = rowSize * height;
+
+            std::scoped_lock lock(data->regionMutex);
+            RegionStagingBuffer& stagingBuffer = data->regionStagingBuffers.Get(data->selectedRegionStagingBuffer);
+
+            // Submitted two ExecuteUploadTasks ago, so this practically never blocks
+            WaitForStagingBuffer(stagingBuffer);
+
+            size_t offset;
+            if (!stagingBuffer.allocator.TryAllocateOffset(size, 16, offset))
+                return false;
+
+            u8* dst = &static_cast<u8*>(stagingBuffer.mappedMemory)[offset];
+            for (u32 row = 0; row < height; row++)
+            {
+                memcpy(&dst[row * rowSize], &pixels[row * pixelsRowPitch], rowSize);
+            }
+
+            stagingBuffer.copies.push_back({ targetTexture, offset, x, y, width, height });
+
+            data->isDirty = true;
+            return true;
+        }
+
         SemaphoreID UploadBufferHandlerVK::GetUploadFinishedSemaphore()
         {
             UploadBufferHandlerVKData* data = static_cast<UploadBufferHandlerVKData*>(_data);
@@ -272,7 +444,7 @@ namespace Renderer
         bool UploadBufferHandlerVK::ShouldWaitForUpload()
         {
             UploadBufferHandlerVKData* data = static_cast<UploadBufferHandlerVKData*>(_data);
-            return data->isDirty;
+            return data->isUploadSignaled;
         }
 
         size_t UploadBufferHandlerVK::Allocate(size_t size, StagingBufferID& stagingBufferID, void*& mappedMemory)
@@ -346,9 +518,14 @@ namespace Renderer
             return offset;
         }
 
-        void UploadBufferHandlerVK::ExecuteStagingBuffer(VkCommandBuffer commandBuffer, StagingBuffer& stagingBuffer)
+        void UploadBufferHandlerVK::ExecuteStagingBuffer(VkCommandBuffer commandBuffer, StagingBuffer& stagingBuffer, std::vector<TextureID>& recordedTextures, std::vector<BufferRangeToAcquire>& recordedBufferRanges)
         {
+            size_t firstRecordedRange = recordedBufferRanges.size();
+
+#if _DEBUG
             UploadBufferHandlerVKData* data = static_cast<UploadBufferHandlerVKData*>(_data);
+            std::vector<RecordedUpload> recordedUploads;
+#endif
 
             {
                 UploadToBufferTask task;
@@ -362,7 +539,47 @@ namespace Renderer
                     copyRegion.srcOffset = task.stagingBufferOffset;
                     copyRegion.size = task.copySize;
                     vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
+
+#if _DEBUG
+                    recordedUploads.push_back({ task.targetBuffer, task.targetOffset, task.copySize, task.submissionIndex });
+#endif
+
+                    // GPUVector uploads its dirty ranges in order, so neighbouring copies can share one ownership transfer
+                    if (recordedBufferRanges.size() > firstRecordedRange)
+                    {
+                        BufferRangeToAcquire& previousRange = recordedBufferRanges.back();
+                        if (previousRange.buffer == task.targetBuffer && previousRange.offset + previousRange.size == task.targetOffset)
+                        {
+                            previousRange.size += task.copySize;
+                            continue;
+                        }
+                    }
+
+                    recordedBufferRanges.push_back({ task.targetBuffer, task.targetOffset, task.copySize });
+                }
+            }
+
+#if _DEBUG
+            if (!recordedUploads.empty())
+            {
+                std::scoped_lock lock(data->recordedUploadsMutex);
+                data->recordedUploads.insert(data->recordedUploads.end(), recordedUploads.begin(), recordedUploads.end());
+            }
+#endif
+
+            // Release only the ranges we wrote to the graphics queue, AcquireUploadedBuffers records the matching acquire
+            if (_device->HasDedicatedTransferQueue() && recordedBufferRanges.size() > firstRecordedRange)
+            {
+                std::vector<VkBufferMemoryBarrier> releaseBarriers;
+                releaseBarriers.reserve(recordedBufferRanges.size() - firstRecordedRange);
+
+                for (size_t i = firstRecordedRange; i < recordedBufferRanges.size(); i++)
+                {
+                    VkBufferMemoryBarrier& releaseBarrier = releaseBarriers.emplace_back(GetOwnershipTransferBarrier(recordedBufferRanges[i]));
+                    releaseBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
                 }
+
+                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, static_cast<u32>(releaseBarriers.size()), releaseBarriers.data(), 0, nullptr);
             }
 
             {
@@ -372,6 +589,7 @@ namespace Renderer
                     VkBuffer srcBuffer = _bufferHandler->GetBuffer(stagingBuffer.buffer);
 
                     _textureHandler->CopyBufferToImage(commandBuffer, srcBuffer, task.stagingBufferOffset, task.targetTexture);
+                    recordedTextures.push_back(task.targetTexture);
                 }
             }
 
@@ -380,23 +598,163 @@ namespace Renderer
 
         void UploadBufferHandlerVK::ExecuteStagingBuffer(StagingBuffer& stagingBuffer)
         {
+            ZoneScoped;
+
             // First thread to reach here should submit it
-            CommandListID commandListID = _commandListHandler->BeginCommandList(QueueType::Graphics);
+            CommandListID commandListID = _commandListHandler->BeginCommandList(QueueType::Transfer);
             VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
 
-#if TRACY_ENABLE
-            TracySourceLocation(RingBufferUpload, "RingBufferUpload", tracy::Color::Yellow2);
-            tracy::VkCtxManualScope tracyScope(_device->_tracyContext, &RingBufferUpload, true);
-            tracyScope.Start(commandBuffer);
-#endif
+            std::vector<TextureID> recordedTextures;
+            std::vector<BufferRangeToAcquire> recordedBufferRanges;
+            ExecuteStagingBuffer(commandBuffer, stagingBuffer, recordedTextures, recordedBufferRanges);
+
+            _commandListHandler->EndCommandList(commandListID, stagingBuffer.fence);
 
-            ExecuteStagingBuffer(commandBuffer, stagingBuffer);
+            // Only hand these over once the copies are submitted, ExecuteUploadTasks waits on the fence before acquiring them
+            if (!recordedTextures.empty() || !recordedBufferRanges.empty())
+            {
+                UploadBufferHandlerVKData* data = static_cast<UploadBufferHandlerVKData*>(_data);
 
-#if TRACY_ENABLE
-            tracyScope.End();
+                std::scoped_lock lock(data->acquireMutex);
+                data->texturesToAcquire.insert(data->texturesToAcquire.end(), recordedTextures.begin(), recordedTextures.end());
+                data->bufferRangesToAcquire.insert(data->bufferRangesToAcquire.end(), recordedBufferRanges.begin(), recordedBufferRanges.end());
+            }
+        }
+
+        void UploadBufferHandlerVK::ExecuteBufferCopies(VkCommandBuffer commandBuffer)
+        {
+            UploadBufferHandlerVKData* data = static_cast<UploadBufferHandlerVKData*>(_data);
+
+            std::vector<BufferToBufferCopyTask> tasks;
+            BufferToBufferCopyTask task;
+            while (data->bufferCopyTasks.try_dequeue(task))
+            {
+                tasks.push_back(task);
+            }
+
+#if _DEBUG
+            std::vector<RecordedUpload> recordedUploads;
+            {
+                std::scoped_lock lock(data->recordedUploadsMutex);
+                recordedUploads.swap(data->recordedUploads);
+            }
+
+            // Copies are recorded after every staging copy of the batch, a copy queued before an upload into the same range would overwrite the newer data
+            for (const BufferToBufferCopyTask& copyTask : tasks)
+            {
+                for (const RecordedUpload& upload : recordedUploads)
+                {
+                    bool overlaps = upload.buffer == copyTask.dstBuffer && upload.offset < copyTask.dstOffset + copyTask.range && copyTask.dstOffset < upload.offset + upload.size;
+                    assert(!overlaps || upload.submissionIndex < copyTask.submissionIndex); // See Renderer::CopyBuffer, upload from the CPU copy instead of copying into a range you also upload to this frame
+                }
+            }
 #endif
 
-            _commandListHandler->EndCommandList(commandListID, stagingBuffer.fence);
+            if (tasks.empty())
+                return;
+
+            // Earlier frames on the graphics queue might still be writing to a source or reading from a destination, only wait on the ranges we copy
+            std::vector<VkBufferMemoryBarrier> barriers;
+            barriers.reserve(tasks.size() * 2);
+
+            for (const BufferToBufferCopyTask& copyTask : tasks)
+            {
+                VkBufferMemoryBarrier& srcBarrier = barriers.emplace_back();
+                srcBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+                srcBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+                srcBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+                srcBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                srcBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                srcBarrier.buffer = _bufferHandler->GetBuffer(copyTask.srcBuffer);
+                srcBarrier.offset = copyTask.srcOffset;
+                srcBarrier.size = copyTask.range;
+
+                VkBufferMemoryBarrier& dstBarrier = barriers.emplace_back(srcBarrier);
+                dstBarrier.srcAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+                dstBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                dstBarrier.buffer = _bufferHandler->GetBuffer(copyTask.dstBuffer);
+                dstBarrier.offset = copyTask.dstOffset;
+            }
+
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, static_cast<u32>(barriers.size()), barriers.data(), 0, nullptr);
+
+            for (const BufferToBufferCopyTask& copyTask : tasks)
+            {
+                VkBufferCopy copyRegion = {};
+                copyRegion.srcOffset = copyTask.srcOffset;
+                copyRegion.dstOffset = copyTask.dstOffset;
+                copyRegion.size = copyTask.range;
+                vkCmdCopyBuffer(commandBuffer, _bufferHandler->GetBuffer(copyTask.srcBuffer), _bufferHandler->GetBuffer(copyTask.dstBuffer), 1, &copyRegion);
+            }
+        }
+
+        VkFence UploadBufferHandlerVK::ExecuteTextureRegionCopies(VkCommandBuffer commandBuffer)
+        {
+            UploadBufferHandlerVKData* data = static_cast<UploadBufferHandlerVKData*>(_data);
+
+            std::scoped_lock lock(data->regionMutex);
+            RegionStagingBuffer& stagingBuffer = data->regionStagingBuffers.Get(data->selectedRegionStagingBuffer);
+
+            if (stagingBuffer.copies.empty())
+                return VK_NULL_HANDLE;
+
+            // Recorded after AcquireUploadedTextures, a texture created in the same batch is already ours by now
+            _textureHandler->CopyBufferToImageRegions(commandBuffer, _bufferHandler->GetBuffer(stagingBuffer.buffer), stagingBuffer.copies);
+
+            stagingBuffer.copies.clear();
+            stagingBuffer.isSubmitted = true;
+
+            // Updates made while this one is in flight go into the other buffer
+            data->selectedRegionStagingBuffer = (data->selectedRegionStagingBuffer + 1) % data->regionStagingBuffers.Num;
+
+            return stagingBuffer.fence;
+        }
+
+        void UploadBufferHandlerVK::AcquireUploadedBuffers(VkCommandBuffer commandBuffer, const std::vector<BufferRangeToAcquire>& bufferRanges)
+        {
+            if (bufferRanges.empty())
+                return;
+
+            // Anything from draw indirect to a later buffer copy can be the first to read an upload
+            VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+            VkAccessFlags dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+            if (!_device->HasDedicatedTransferQueue())
+            {
+                // Same queue family, there is no ownership to transfer so we only need to make the copies visible
+                VkMemoryBarrier memoryBarrier = {};
+                memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                memoryBarrier.dstAccessMask = dstAccessMask;
+
+                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStageMask, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+                return;
+            }
+
+            std::vector<VkBufferMemoryBarrier> acquireBarriers;
+            acquireBarriers.reserve(bufferRanges.size());
+
+            for (const BufferRangeToAcquire& bufferRange : bufferRanges)
+            {
+                VkBufferMemoryBarrier& acquireBarrier = acquireBarriers.emplace_back(GetOwnershipTransferBarrier(bufferRange));
+                acquireBarrier.dstAccessMask = dstAccessMask;
+            }
+
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStageMask, 0, 0, nullptr, static_cast<u32>(acquireBarriers.size()), acquireBarriers.data(), 0, nullptr);
+        }
+
+        VkBufferMemoryBarrier UploadBufferHandlerVK::GetOwnershipTransferBarrier(const BufferRangeToAcquire& bufferRange)
+        {
+            // The release and acquire halves have to match exactly, only the access masks differ
+            VkBufferMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcQueueFamilyIndex = _device->_queueFamilyIndices.transferFamily.value();
+            barrier.dstQueueFamilyIndex = _device->_queueFamilyIndices.graphicsFamily.value();
+            barrier.buffer = _bufferHandler->GetBuffer(bufferRange.buffer);
+            barrier.offset = bufferRange.offset;
+            barrier.size = bufferRange.size;
+
+            return barrier;
         }
 
         void UploadBufferHandlerVK::WaitForStagingBuffer(StagingBuffer& stagingBuffer)
@@ -418,5 +776,24 @@ namespace Renderer
             // Reset staging buffer
             stagingBuffer.allocator.Reset();
         }
+
+        void UploadBufferHandlerVK::WaitForStagingBuffer(RegionStagingBuffer& stagingBuffer)
+        {
+            if (!stagingBuffer.isSubmitted)
+                return;
+
+            u64 timeout = 5000000000; // 5 seconds in nanoseconds
+            VkResult result = vkWaitForFences(_device->_device, 1, &stagingBuffer.fence, true, timeout);
+
+            if (result == VK_TIMEOUT)
+            {
+                DebugHandler::PrintFatal("Waiting for region staging buffer fence took longer than 5 seconds, something is wrong!");
+            }
+
+            vkResetFences(_device->_device, 1, &stagingBuffer.fence);
+            stagingBuffer.isSubmitted = false;
+
+            stagingBuffer.allocator.Reset();
+        }
     }
 }
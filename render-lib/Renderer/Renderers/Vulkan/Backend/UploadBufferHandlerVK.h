@@ -1,6 +1,7 @@
 #pragma once
 #include <NovusTypes.h>
 #include <Memory/StackAllocator.h>
+#include <vector>
 
 #include "../../../Descriptors/UploadBuffer.h"
 #include "../../../Descriptors/TextureDesc.h"
@@ -8,6 +9,9 @@
 
 struct VkCommandBuffer_T;
 typedef VkCommandBuffer_T* VkCommandBuffer;
+struct VkFence_T;
+typedef VkFence_T* VkFence;
+struct VkBufferMemoryBarrier;
 
 namespace Renderer
 {
@@ -20,6 +24,8 @@ namespace Renderer
         class CommandListHandlerVK;
 
         struct StagingBuffer;
+        struct RegionStagingBuffer;
+        struct BufferRangeToAcquire;
 
         struct IUploadBufferHandlerVKData {};
 
@@ -32,16 +38,31 @@ namespace Renderer
             [[nodiscard]] std::shared_ptr<UploadBuffer> CreateUploadBuffer(BufferID targetBuffer, size_t targetOffset, size_t size);
             [[nodiscard]] std::shared_ptr<UploadBuffer> CreateUploadBuffer(TextureID targetTexture, size_t targetOffset, size_t size);
 
+            // Queues a GPU side copy, it gets recorded at the start of the next frame and the render graph waits for it through GetUploadFinishedSemaphore
+            // Recorded after all of the batch's staging copies, debug builds assert if an upload queued after the copy writes into its destination
+            void CopyBuffer(BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range);
+
+            // Copies the rect into staging memory that only ExecuteUploadTasks records, returns false if there's no room left until then
+            bool UploadTextureRegion(TextureID targetTexture, u32 x, u32 y, u32 width, u32 height, u32 texelSize, const u8* pixels, size_t pixelsRowPitch);
+
             SemaphoreID GetUploadFinishedSemaphore();
             bool ShouldWaitForUpload();
         private:
             size_t Allocate(size_t size, StagingBufferID& stagingBufferID, void*& mappedMemory);
-            void ExecuteStagingBuffer(VkCommandBuffer commandBuffer, StagingBuffer& stagingBuffer);
+            void ExecuteStagingBuffer(VkCommandBuffer commandBuffer, StagingBuffer& stagingBuffer, std::vector<TextureID>& recordedTextures, std::vector<BufferRangeToAcquire>& recordedBufferRanges);
             void ExecuteStagingBuffer(StagingBuffer& stagingBuffer);
+            void ExecuteBufferCopies(VkCommandBuffer commandBuffer);
+            // Returns the fence the graphics upload list has to signal if any rects were recorded
+            VkFence ExecuteTextureRegionCopies(VkCommandBuffer commandBuffer);
+            // Records the graphics queue half of the ownership transfer for buffer ranges copied on the transfer queue
+            void AcquireUploadedBuffers(VkCommandBuffer commandBuffer, const std::vector<BufferRangeToAcquire>& bufferRanges);
+            VkBufferMemoryBarrier GetOwnershipTransferBarrier(const BufferRangeToAcquire& bufferRange);
             void WaitForStagingBuffer(StagingBuffer& stagingBuffer);
+            void WaitForStagingBuffer(RegionStagingBuffer& stagingBuffer);
 
         private:
             static const size_t BUFFER_SIZE = 32 * 1024 * 1024; // 32 MB
+            static const size_t REGION_BUFFER_SIZE = 4 * 1024 * 1024; // 4 MB
 
             RenderDeviceVK* _device;
             BufferHandlerVK* _bufferHandler;
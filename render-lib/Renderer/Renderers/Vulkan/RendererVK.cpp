@@ -65,6 +65,8 @@ namespace Renderer
     {
         _device->FlushGPU(); // Make sure it has finished rendering
 
+        _pipelineHandler->Deinit();
+
         delete(_device);
         delete(_bufferHandler);
         delete(_imageHandler);
@@ -83,26 +85,40 @@ namespace Renderer
 
         _shaderHandler->ReloadShaders(forceRecompileAll);
         _pipelineHandler->DiscardPipelines();
+        _device->_descriptorMegaPool->ResetCache();
 
         CreateDummyPipeline();
     }
 
+    void RendererVK::WarmupPipelines()
+    {
+        ZoneScoped;
+        _pipelineHandler->WarmupPipelines();
+    }
+
+    void RendererVK::SavePipelineCache()
+    {
+        _pipelineHandler->SavePipelineCache();
+    }
+
     BufferID RendererVK::CreateBuffer(BufferDesc& desc)
     {
         if (desc.size == 0)
             desc.size = 1;
 
+        std::scoped_lock lock(_resourceMutex);
         return _bufferHandler->CreateBuffer(desc);
     }
 
     BufferID RendererVK::CreateTemporaryBuffer(BufferDesc& desc, u32 framesLifetime)
     {
+        std::scoped_lock lock(_resourceMutex);
         return _bufferHandler->CreateTemporaryBuffer(desc, framesLifetime);
     }
 
     void RendererVK::QueueDestroyBuffer(BufferID buffer)
     {
-        std::scoped_lock(_destroyListMutex);
+        std::scoped_lock lock(_destroyListMutex);
         _destroyLists[_destroyListIndex].buffers.push_back(buffer);
     }
 
@@ -116,8 +132,29 @@ namespace Renderer
         return _imageHandler->CreateDepthImage(desc);
     }
 
+    ImageID RendererVK::AcquireTransientImage(const ImageDesc& desc)
+    {
+        return _imageHandler->AcquireTransientImage(desc);
+    }
+
+    DepthImageID RendererVK::AcquireTransientDepthImage(const DepthImageDesc& desc)
+    {
+        return _imageHandler->AcquireTransientDepthImage(desc);
+    }
+
+    void RendererVK::PlaceTransientImages(const TransientImageLifetime* lifetimes, u32 numLifetimes)
+    {
+        if (_imageHandler->PlaceTransientImages(lifetimes, numLifetimes))
+        {
+            // The transient images got recreated, so framebuffers and cached descriptor sets point at destroyed views
+            _pipelineHandler->OnWindowResize();
+            _device->_descriptorMegaPool->InvalidateCache();
+        }
+    }
+
     SamplerID RendererVK::CreateSampler(SamplerDesc& desc)
     {
+        std::scoped_lock lock(_resourceMutex);
         return _samplerHandler->CreateSampler(desc);
     }
 
@@ -128,11 +165,13 @@ namespace Renderer
 
     GraphicsPipelineID RendererVK::CreatePipeline(GraphicsPipelineDesc& desc)
     {
+        std::scoped_lock lock(_resourceMutex);
         return _pipelineHandler->CreatePipeline(desc);
     }
 
     ComputePipelineID RendererVK::CreatePipeline(ComputePipelineDesc& desc)
     {
+        std::scoped_lock lock(_resourceMutex);
         return _pipelineHandler->CreatePipeline(desc);
     }
 
@@ -151,6 +190,11 @@ namespace Renderer
         return _textureHandler->CreateDataTextureIntoArray(desc, textureArray, arrayIndex);
     }
 
+    bool RendererVK::UpdateDataTexture(TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* pixels, u32 pixelsRowLength)
+    {
+        return _textureHandler->UpdateDataTexture(textureID, x, y, width, height, pixels, pixelsRowLength);
+    }
+
     TextureID RendererVK::LoadTexture(TextureDesc& desc)
     {
         return _textureHandler->LoadTexture(desc);
@@ -163,16 +207,19 @@ namespace Renderer
 
     VertexShaderID RendererVK::LoadShader(VertexShaderDesc& desc)
     {
+        std::scoped_lock lock(_resourceMutex);
         return _shaderHandler->LoadShader(desc);
     }
 
     PixelShaderID RendererVK::LoadShader(PixelShaderDesc& desc)
     {
+        std::scoped_lock lock(_resourceMutex);
         return _shaderHandler->LoadShader(desc);
     }
 
     ComputeShaderID RendererVK::LoadShader(ComputeShaderDesc& desc)
     {
+        std::scoped_lock lock(_resourceMutex);
         return _shaderHandler->LoadShader(desc);
     }
 
@@ -181,6 +228,7 @@ namespace Renderer
         _device->FlushGPU(); // Make sure we have finished rendering
 
         _textureHandler->UnloadTexture(textureID);
+        _device->_descriptorMegaPool->InvalidateCache();
     }
 
     void RendererVK::UnloadTexturesInArray(TextureArrayID textureArrayID, u32 unloadStartIndex)
@@ -188,6 +236,36 @@ namespace Renderer
         _device->FlushGPU(); // Make sure we have finished rendering
 
         _textureHandler->UnloadTexturesInArray(textureArrayID, unloadStartIndex);
+        _device->_descriptorMegaPool->InvalidateCache();
+    }
+
+    void RendererVK::UnloadTexturesInArray(TextureArrayID textureArrayID, const std::vector<u32>& arrayIndices)
+    {
+        if (arrayIndices.empty())
+            return;
+
+        // Frames in flight can still sample these, so the textures are unloaded and their slots reused once those frames have retired
+        {
+            std::scoped_lock lock(_destroyListMutex);
+            ObjectDestroyList& destroyList = _destroyLists[_destroyListIndex];
+
+            for (u32 arrayIndex : arrayIndices)
+            {
+                TextureID textureID;
+                if (!_textureHandler->ReleaseTextureInArray(textureArrayID, arrayIndex, textureID))
+                    continue;
+
+                // Textures still held by another array stay loaded, only the slot is freed
+                if (textureID != TextureID::Invalid())
+                {
+                    destroyList.textures.push_back(textureID);
+                }
+                destroyList.textureArrayIndices.push_back({ textureArrayID, arrayIndex });
+            }
+        }
+
+        // New descriptor sets pick up the placeholders, the old ones keep the images alive until the destroy list comes around
+        _device->_descriptorMegaPool->InvalidateCache();
     }
 
     static VmaBudget sBudgets[16] = { 0 };
@@ -219,6 +297,8 @@ namespace Renderer
         _commandListHandler->ResetCommandBuffers();
         _uploadBufferHandler->ExecuteUploadTasks();
         _bufferHandler->OnFrameStart();
+        _imageHandler->ResetTransientImages();
+        _constantRing.BeginFrame(frameIndex);
 
         vmaSetCurrentFrameIndex(_device->_allocator, frameIndex);
         vmaGetBudget(_device->_allocator, sBudgets);
@@ -622,9 +702,30 @@ namespace Renderer
         return false;
     }
 
+    struct ImageInfosArrays
+    {
+        void Reset() { numUsed = 0; }
+
+        std::vector<VkDescriptorImageInfo>& GetNext()
+        {
+            if (numUsed == arrays.size())
+            {
+                arrays.emplace_back();
+            }
+
+            std::vector<VkDescriptorImageInfo>& imageInfos = arrays[numUsed++];
+            imageInfos.clear();
+
+            return imageInfos;
+        }
+
+        std::vector<std::vector<VkDescriptorImageInfo>> arrays;
+        size_t numUsed = 0;
+    };
+
     void RendererVK::BindDescriptor(Backend::DescriptorSetBuilderVK* builder, void* imageInfosArraysVoid, Descriptor& descriptor)
     {
-        std::vector<std::vector<VkDescriptorImageInfo>>& imageInfosArrays = *static_cast<std::vector<std::vector<VkDescriptorImageInfo>>*>(imageInfosArraysVoid);
+        ImageInfosArrays& imageInfosArrays = *static_cast<ImageInfosArrays*>(imageInfosArraysVoid);
 
         if (descriptor.descriptorType == DescriptorType::DESCRIPTOR_TYPE_SAMPLER)
         {
@@ -644,7 +745,7 @@ namespace Renderer
         else if (descriptor.descriptorType == DescriptorType::DESCRIPTOR_TYPE_TEXTURE_ARRAY)
         {
             const SafeVector<TextureID>& textureIDs = _textureHandler->GetTextureIDsInArray(descriptor.textureArrayID);
-            std::vector<VkDescriptorImageInfo>& imageInfos = imageInfosArrays.emplace_back();
+            std::vector<VkDescriptorImageInfo>& imageInfos = imageInfosArrays.GetNext();
 
             u32 textureArraySize = _textureHandler->GetTextureArraySize(descriptor.textureArrayID);
             imageInfos.reserve(textureArraySize);
@@ -669,7 +770,7 @@ namespace Renderer
                 });
 
             // from numTextures to textureArraySize, add debug texture
-            VkDescriptorImageInfo imageInfoDebugTexture;
+            VkDescriptorImageInfo imageInfoDebugTexture = {}; // Zeroed so the padding doesn't throw off the descriptor set cache hashing
             imageInfoDebugTexture.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
             if (texturesAreOnionTextures)
@@ -718,7 +819,8 @@ namespace Renderer
         {
             VkDescriptorBufferInfo bufferInfo = {};
             bufferInfo.buffer = _bufferHandler->GetBuffer(descriptor.bufferID);
-            bufferInfo.range = _bufferHandler->GetBufferSize(descriptor.bufferID);
+            bufferInfo.offset = descriptor.bufferOffset;
+            bufferInfo.range = descriptor.bufferRange > 0 ? descriptor.bufferRange : _bufferHandler->GetBufferSize(descriptor.bufferID) - descriptor.bufferOffset;
 
             builder->BindBuffer(descriptor.nameHash, bufferInfo);
         }
@@ -729,6 +831,7 @@ namespace Renderer
         _device->RecreateSwapChain(_imageHandler, _semaphoreHandler, swapChain);
         _pipelineHandler->OnWindowResize();
         _imageHandler->OnWindowResize();
+        _device->_descriptorMegaPool->InvalidateCache();
     }
 
     void RendererVK::CreateDummyPipeline()
@@ -750,7 +853,19 @@ namespace Renderer
             _bufferHandler->DestroyBuffer(buffer);
         }
 
+        for (const TextureID texture : destroyList.textures)
+        {
+            _textureHandler->UnloadTexture(texture);
+        }
+
+        for (const std::pair<TextureArrayID, u32>& textureArrayIndex : destroyList.textureArrayIndices)
+        {
+            _textureHandler->FreeArrayIndex(textureArrayIndex.first, textureArrayIndex.second);
+        }
+
         destroyList.buffers.clear();
+        destroyList.textures.clear();
+        destroyList.textureArrayIndices.clear();
     }
 
     void RendererVK::BindDescriptorSet(CommandListID commandListID, DescriptorSetSlot slot, Descriptor* descriptors, u32 numDescriptors)
@@ -761,10 +876,12 @@ namespace Renderer
         GraphicsPipelineID graphicsPipelineID = _commandListHandler->GetBoundGraphicsPipeline(commandListID);
         ComputePipelineID computePipelineID = _commandListHandler->GetBoundComputePipeline(commandListID);
 
+        // These need to live until builder->BuildDescriptor(), we keep them around between binds so texture arrays don't allocate every time
+        thread_local ImageInfosArrays imageInfosArrays;
+
         if (graphicsPipelineID != GraphicsPipelineID::Invalid())
         {
-            std::vector<std::vector<VkDescriptorImageInfo>> imageInfosArrays; // These need to live until builder->BuildDescriptor()
-            imageInfosArrays.reserve(8);
+            imageInfosArrays.Reset();
 
             Backend::DescriptorSetBuilderVK* builder = _pipelineHandler->GetDescriptorSetBuilder(graphicsPipelineID);
 
@@ -775,7 +892,7 @@ namespace Renderer
                 BindDescriptor(builder, &imageInfosArrays, descriptor);
             }
 
-            VkDescriptorSet descriptorSet = builder->BuildDescriptor(static_cast<i32>(slot), Backend::DescriptorLifetime::PerFrame);
+            VkDescriptorSet descriptorSet = builder->BuildDescriptor(static_cast<i32>(slot), Backend::DescriptorLifetime::Cached);
 
             VkPipelineLayout pipelineLayout = _pipelineHandler->GetPipelineLayout(graphicsPipelineID);
 
@@ -784,8 +901,7 @@ namespace Renderer
         } 
         else if (computePipelineID != ComputePipelineID::Invalid())
         {
-            std::vector<std::vector<VkDescriptorImageInfo>> imageInfosArrays; // These need to live until builder->BuildDescriptor()
-            imageInfosArrays.reserve(8);
+            imageInfosArrays.Reset();
 
             Backend::DescriptorSetBuilderVK* builder = _pipelineHandler->GetDescriptorSetBuilder(computePipelineID);
 
@@ -796,7 +912,7 @@ namespace Renderer
                 BindDescriptor(builder, &imageInfosArrays, descriptor);
             }
 
-            VkDescriptorSet descriptorSet = builder->BuildDescriptor(static_cast<i32>(slot), Backend::DescriptorLifetime::PerFrame);
+            VkDescriptorSet descriptorSet = builder->BuildDescriptor(static_cast<i32>(slot), Backend::DescriptorLifetime::Cached);
 
             VkPipelineLayout pipelineLayout = _pipelineHandler->GetPipelineLayout(computePipelineID);
 
@@ -868,6 +984,14 @@ namespace Renderer
     void RendererVK::AddWaitSemaphore(CommandListID commandListID, SemaphoreID semaphoreID)
     {
         VkSemaphore semaphore = _semaphoreHandler->GetVkSemaphore(semaphoreID);
+
+        // Uploaded data gets read by compute and vertex work long before we output any color
+        if (semaphoreID == _uploadBufferHandler->GetUploadFinishedSemaphore())
+        {
+            _commandListHandler->AddWaitSemaphore(commandListID, semaphore, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+            return;
+        }
+
         _commandListHandler->AddWaitSemaphore(commandListID, semaphore);
     }
 
@@ -1006,25 +1130,155 @@ namespace Renderer
         vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
     }
 
-    void RendererVK::ImageBarrier(CommandListID commandListID, ImageID image)
+    void RendererVK::GetBarrierMasks(u8 stages, bool isDepth, u32& stageMask, u32& accessMask)
+    {
+        stageMask = 0;
+        accessMask = 0;
+
+        if (stages & PIPELINE_STAGE_VERTEX_SHADER)
+        {
+            stageMask |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+            accessMask |= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        }
+
+        if (stages & PIPELINE_STAGE_PIXEL_SHADER)
+        {
+            stageMask |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            accessMask |= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        }
+
+        if (stages & PIPELINE_STAGE_COMPUTE_SHADER)
+        {
+            stageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            accessMask |= VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        }
+
+        if (stages & PIPELINE_STAGE_RENDERTARGET)
+        {
+            if (isDepth)
+            {
+                stageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+                accessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            }
+            else
+            {
+                stageMask |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                accessMask |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            }
+        }
+
+        if (stages & PIPELINE_STAGE_TRANSFER)
+        {
+            stageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+            accessMask |= VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        }
+    }
+
+    void RendererVK::ImageBarrier(CommandListID commandListID, ImageID image, u8 srcStages, u8 dstStages)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
         const VkImage& vkImage = _imageHandler->GetImage(image);
         const ImageDesc& imageDesc = _imageHandler->GetImageDesc(image);
 
-        _device->TransitionImageLayout(commandBuffer, vkImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, imageDesc.depth, imageDesc.mipLevels);
+        if (srcStages == PIPELINE_STAGE_NONE && dstStages == PIPELINE_STAGE_NONE)
+        {
+            _device->TransitionImageLayout(commandBuffer, vkImage, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, imageDesc.depth, imageDesc.mipLevels);
+            return;
+        }
+
+        // Color images live in GENERAL, so this only has to make the previous stages writes visible to the next stages
+        VkImageMemoryBarrier imageBarrier = {};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        imageBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = vkImage;
+        imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageBarrier.subresourceRange.levelCount = imageDesc.mipLevels;
+        imageBarrier.subresourceRange.layerCount = imageDesc.depth;
+
+        VkPipelineStageFlags srcStageMask;
+        VkPipelineStageFlags dstStageMask;
+        GetBarrierMasks(srcStages, false, srcStageMask, imageBarrier.srcAccessMask);
+        GetBarrierMasks(dstStages, false, dstStageMask, imageBarrier.dstAccessMask);
+
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
     }
 
-    void RendererVK::DepthImageBarrier(CommandListID commandListID, DepthImageID image)
+    void RendererVK::DepthImageBarrier(CommandListID commandListID, DepthImageID image, u8 srcStages, u8 dstStages)
     {
         VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
         const VkImage& vkImage = _imageHandler->GetImage(image);
-        const DepthImageDesc& imageDesc = _imageHandler->GetDepthImageDesc(image);
 
         u32 imageAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
         // TODO: If we add stencil support we need to selectively add VK_IMAGE_ASPECT_STENCIL_BIT to imageAspect if the depthStencil has a stencil
 
-        _device->TransitionImageLayout(commandBuffer, vkImage, imageAspect, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, 1, 1);
+        if (srcStages == PIPELINE_STAGE_NONE && dstStages == PIPELINE_STAGE_NONE)
+        {
+            _device->TransitionImageLayout(commandBuffer, vkImage, imageAspect, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, 1, 1);
+            return;
+        }
+
+        VkImageMemoryBarrier imageBarrier = {};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        imageBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = vkImage;
+        imageBarrier.subresourceRange.aspectMask = imageAspect;
+        imageBarrier.subresourceRange.levelCount = 1;
+        imageBarrier.subresourceRange.layerCount = 1;
+
+        VkPipelineStageFlags srcStageMask;
+        VkPipelineStageFlags dstStageMask;
+        GetBarrierMasks(srcStages, true, srcStageMask, imageBarrier.srcAccessMask);
+        GetBarrierMasks(dstStages, true, dstStageMask, imageBarrier.dstAccessMask);
+
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+    }
+
+    void RendererVK::DiscardImage(CommandListID commandListID, ImageID image)
+    {
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+        const ImageDesc& imageDesc = _imageHandler->GetImageDesc(image);
+
+        // Whatever last used this memory might have been another image, so wait for all of its writes before we transition away from UNDEFINED
+        VkImageMemoryBarrier imageBarrier = {};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        imageBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        imageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = _imageHandler->GetImage(image);
+        imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageBarrier.subresourceRange.levelCount = imageDesc.mipLevels;
+        imageBarrier.subresourceRange.layerCount = imageDesc.depth;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+    }
+
+    void RendererVK::DiscardDepthImage(CommandListID commandListID, DepthImageID image)
+    {
+        VkCommandBuffer commandBuffer = _commandListHandler->GetCommandBuffer(commandListID);
+
+        VkImageMemoryBarrier imageBarrier = {};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        imageBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        imageBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = _imageHandler->GetImage(image);
+        imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        imageBarrier.subresourceRange.levelCount = 1;
+        imageBarrier.subresourceRange.layerCount = 1;
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
     }
 
     void RendererVK::PushConstant(CommandListID commandListID, void* data, u32 offset, u32 size)
@@ -1284,7 +1538,7 @@ namespace Renderer
 
             _destroyListIndex = (_destroyListIndex + 1) % _destroyLists.size();
 
-            std::scoped_lock(_destroyListMutex);
+            std::scoped_lock lock(_destroyListMutex);
             DestroyObjects(_destroyLists[_destroyListIndex]);
         }
     }
@@ -1311,12 +1565,7 @@ namespace Renderer
 
     void RendererVK::CopyBuffer(BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range)
     {
-        VkBuffer vkDstBuffer = _bufferHandler->GetBuffer(dstBuffer);
-        VkBuffer vkSrcBuffer = _bufferHandler->GetBuffer(srcBuffer);
-        _device->CopyBuffer(vkDstBuffer, dstOffset, vkSrcBuffer, srcOffset, range);
-
-        //std::scoped_lock(_destroyListMutex);
-        //DestroyObjects(_destroyLists[_destroyListIndex]);
+        _uploadBufferHandler->CopyBuffer(dstBuffer, dstOffset, srcBuffer, srcOffset, range);
     }
 
     void RendererVK::FillBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, u32 data)
@@ -1372,6 +1621,11 @@ namespace Renderer
         return budget;
     }
 
+    size_t RendererVK::GetTransientVRAMSaved()
+    {
+        return _imageHandler->GetTransientBytesSaved();
+    }
+
     void RendererVK::InitImgui()
     {
         _device->InitializeImguiVulkan();
@@ -1393,4 +1647,19 @@ namespace Renderer
     {
         return _imageHandler->GetNumDepthImages();
     }
+
+    u32 RendererVK::GetNumDescriptorSetCacheHits()
+    {
+        return _device->_descriptorMegaPool->GetCacheStats().numHits;
+    }
+
+    u32 RendererVK::GetNumDescriptorSetCacheMisses()
+    {
+        return _device->_descriptorMegaPool->GetCacheStats().numMisses;
+    }
+
+    u32 RendererVK::GetNumCachedDescriptorSets()
+    {
+        return _device->_descriptorMegaPool->GetCacheStats().numCachedSets;
+    }
 }
\ No newline at end of file
@@ -34,6 +34,8 @@ namespace Renderer
         void Deinit() override;
 
         void ReloadShaders(bool forceRecompileAll) override;
+        void WarmupPipelines() override;
+        void SavePipelineCache() override;
 
         // Creation
         [[nodiscard]] BufferID CreateBuffer(BufferDesc& desc) override;
@@ -43,6 +45,10 @@ namespace Renderer
         [[nodiscard]] ImageID CreateImage(ImageDesc& desc) override;
         [[nodiscard]] DepthImageID CreateDepthImage(DepthImageDesc& desc) override;
 
+        [[nodiscard]] ImageID AcquireTransientImage(const ImageDesc& desc) override;
+        [[nodiscard]] DepthImageID AcquireTransientDepthImage(const DepthImageDesc& desc) override;
+        void PlaceTransientImages(const TransientImageLifetime* lifetimes, u32 numLifetimes) override;
+
         [[nodiscard]] SamplerID CreateSampler(SamplerDesc& desc) override;
         [[nodiscard]] SemaphoreID CreateNSemaphore() override;
 
@@ -53,6 +59,7 @@ namespace Renderer
 
         [[nodiscard]] TextureID CreateDataTexture(DataTextureDesc& desc) override;
         [[nodiscard]] TextureID CreateDataTextureIntoArray(DataTextureDesc& desc, TextureArrayID textureArray, u32& arrayIndex) override;
+        [[nodiscard]] bool UpdateDataTexture(TextureID textureID, u32 x, u32 y, u32 width, u32 height, const void* pixels, u32 pixelsRowLength) override;
 
         // Loading
         [[nodiscard]] TextureID LoadTexture(TextureDesc& desc) override;
@@ -65,6 +72,7 @@ namespace Renderer
         // Unloading
         void UnloadTexture(TextureID textureID) override;
         void UnloadTexturesInArray(TextureArrayID textureArrayID, u32 unloadStartIndex) override;
+        void UnloadTexturesInArray(TextureArrayID textureArrayID, const std::vector<u32>& arrayIndices) override;
 
         // Command List Functions
         [[nodiscard]] CommandListID BeginCommandList() override;
@@ -98,8 +106,10 @@ namespace Renderer
         void CopyImage(CommandListID commandListID, ImageID dstImageID, uvec2 dstPos, u32 dstMipLevel, ImageID srcImageID, uvec2 srcPos, u32 srcMipLevel, uvec2 size) override;
         void CopyBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, BufferID srcBuffer, u64 srcOffset, u64 range) override;
         void PipelineBarrier(CommandListID commandListID, PipelineBarrierType type, BufferID buffer) override;
-        void ImageBarrier(CommandListID commandListID, ImageID image) override;
-        void DepthImageBarrier(CommandListID commandListID, DepthImageID image) override;
+        void ImageBarrier(CommandListID commandListID, ImageID image, u8 srcStages, u8 dstStages) override;
+        void DepthImageBarrier(CommandListID commandListID, DepthImageID image, u8 srcStages, u8 dstStages) override;
+        void DiscardImage(CommandListID commandListID, ImageID image) override;
+        void DiscardDepthImage(CommandListID commandListID, DepthImageID image) override;
         void PushConstant(CommandListID commandListID, void* data, u32 offset, u32 size) override;
         void FillBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, u32 data) override;
         void UpdateBuffer(CommandListID commandListID, BufferID dstBuffer, u64 dstOffset, u64 size, void* data) override;
@@ -129,10 +139,15 @@ namespace Renderer
 
         [[nodiscard]] size_t GetVRAMUsage() override;
         [[nodiscard]] size_t GetVRAMBudget() override;
+        [[nodiscard]] size_t GetTransientVRAMSaved() override;
 
         [[nodiscard]] u32 GetNumImages() override;
         [[nodiscard]] u32 GetNumDepthImages() override;
 
+        [[nodiscard]] u32 GetNumDescriptorSetCacheHits() override;
+        [[nodiscard]] u32 GetNumDescriptorSetCacheMisses() override;
+        [[nodiscard]] u32 GetNumCachedDescriptorSets() override;
+
         void InitImgui() override;
         void DrawImgui(CommandListID commandListID) override;
 
@@ -143,6 +158,9 @@ namespace Renderer
         void RecreateSwapChain(Backend::SwapChainVK* swapChain);
         void CreateDummyPipeline();
 
+        // Translates PipelineStage flags into Vulkan stage and access masks
+        void GetBarrierMasks(u8 stages, bool isDepth, u32& stageMask, u32& accessMask);
+
     private:
         Backend::RenderDeviceVK* _device = nullptr;
         Backend::BufferHandlerVK* _bufferHandler = nullptr;
@@ -163,9 +181,14 @@ namespace Renderer
 
         std::mutex _destroyListMutex;
 
+        // RenderGraph passes record on worker threads and lazily create shaders, pipelines and buffers while doing it
+        std::mutex _resourceMutex;
+
         struct ObjectDestroyList
         {
             std::vector<BufferID> buffers;
+            std::vector<TextureID> textures;
+            std::vector<std::pair<TextureArrayID, u32>> textureArrayIndices; // Released slots, only handed back to the array once nothing in flight can sample them
         };
 
         std::array<ObjectDestroyList, 4> _destroyLists;
@@ -6,17 +6,19 @@ struct PanelData
     uint4 borderInset;
     uint4 slicingOffset;
     float2 dimensions;
+    uint borderIndex;
 };
 
 [[vk::binding(0, PER_PASS)]] SamplerState _sampler;
-[[vk::binding(1, PER_DRAW)]] ConstantBuffer<PanelData> _panelData;
-[[vk::binding(2, PER_DRAW)]] Texture2D<float4> _texture;
-[[vk::binding(3, PER_DRAW)]] Texture2D<float4> _border;
+[[vk::binding(3, PER_PASS)]] StructuredBuffer<PanelData> _panelData;
+[[vk::binding(5, PER_PASS)]] Texture2D<float4> _textures[4096];
 
 struct VertexOutput
 {
     float4 position : SV_POSITION;
     float2 uv : TEXCOORD0;
+    nointerpolation uint dataIndex : TEXCOORD1;
+    nointerpolation uint textureIndex : TEXCOORD2;
 };
 
 float Map(float value, float originalMin, float originalMax, float newMin, float newMax)
@@ -38,10 +40,10 @@ float NineSliceAxis(float coord, float pixelBorderMin, float pixelBorderMax, flo
     return Map(coord, 1 - pixelBorderMax, 1, 1 - scaledPixelBorderMax, 1);
 }
 
-float4 GetBorderColor(float2 uv)
+float4 GetBorderColor(float2 uv, PanelData panelData)
 {
     float2 pixelTextureDimension; // Dimension of the actual texture, without any scaling
-    _border.GetDimensions(pixelTextureDimension.x, pixelTextureDimension.y);
+    _textures[NonUniformResourceIndex(panelData.borderIndex)].GetDimensions(pixelTextureDimension.x, pixelTextureDimension.y);
     
     // TODO: Maybe toggle BorderColor stuff through the constant buffer instead
     if (pixelTextureDimension.x == 1)
@@ -54,15 +56,15 @@ float4 GetBorderColor(float2 uv)
     
     float sliceWidthUV = 1.0f / 8.0f;
     
-    float topBorderSize = _panelData.borderSize.x;
-    float rightBorderSize = _panelData.borderSize.y;
-    float bottomBorderSize = _panelData.borderSize.z;
-    float leftBorderSize = _panelData.borderSize.w;
+    float topBorderSize = panelData.borderSize.x;
+    float rightBorderSize = panelData.borderSize.y;
+    float bottomBorderSize = panelData.borderSize.z;
+    float leftBorderSize = panelData.borderSize.w;
     
-    float topBorderUVOffset = topBorderSize / _panelData.dimensions.y;
-    float rightBorderUVOffset = rightBorderSize / _panelData.dimensions.x;
-    float bottomBorderUVOffset = bottomBorderSize / _panelData.dimensions.y;
-    float leftBorderUVOffset = leftBorderSize / _panelData.dimensions.x;
+    float topBorderUVOffset = topBorderSize / panelData.dimensions.y;
+    float rightBorderUVOffset = rightBorderSize / panelData.dimensions.x;
+    float bottomBorderUVOffset = bottomBorderSize / panelData.dimensions.y;
+    float leftBorderUVOffset = leftBorderSize / panelData.dimensions.x;
     
     float2 adjustedUV = uv;
     
@@ -139,44 +141,46 @@ float4 GetBorderColor(float2 uv)
     }
     
     
-    return _border.SampleLevel(_sampler, adjustedUV, 0);
+    return _textures[NonUniformResourceIndex(panelData.borderIndex)].SampleLevel(_sampler, adjustedUV, 0);
 }
 
-float4 GetColor(float2 uv)
+float4 GetColor(float2 uv, PanelData panelData, uint textureIndex)
 {
-    float2 pixel = uv * _panelData.dimensions;
+    float2 pixel = uv * panelData.dimensions;
     
-    float topBorderInset = _panelData.borderInset.x;
-    float rightBorderInset = _panelData.borderInset.y;
-    float bottomBorderInset = _panelData.borderInset.z;
-    float leftBorderInset = _panelData.borderInset.w;
+    float topBorderInset = panelData.borderInset.x;
+    float rightBorderInset = panelData.borderInset.y;
+    float bottomBorderInset = panelData.borderInset.z;
+    float leftBorderInset = panelData.borderInset.w;
     
     if (pixel.x < leftBorderInset)
         return float4(0,0,0,0);
     
-    if (pixel.x > _panelData.dimensions.x - rightBorderInset)
+    if (pixel.x > panelData.dimensions.x - rightBorderInset)
         return float4(0,0,0,0);
     
     if (pixel.y < topBorderInset)
         return float4(0,0,0,0);
     
-    if (pixel.y > _panelData.dimensions.y - bottomBorderInset)
+    if (pixel.y > panelData.dimensions.y - bottomBorderInset)
         return float4(0,0,0,0);
     
-    return _texture.SampleLevel(_sampler, uv, 0) * _panelData.color;
+    return _textures[NonUniformResourceIndex(textureIndex)].SampleLevel(_sampler, uv, 0) * panelData.color;
 }
 
 float4 main(VertexOutput input) : SV_Target
 {
+    PanelData panelData = _panelData[input.dataIndex];
+
     float2 pixelTextureDimension; // Dimension of the actual texture, without any scaling
-    _texture.GetDimensions(pixelTextureDimension.x, pixelTextureDimension.y);
+    _textures[NonUniformResourceIndex(input.textureIndex)].GetDimensions(pixelTextureDimension.x, pixelTextureDimension.y);
     
-    float2 scaledPixelTextureDimension = _panelData.dimensions; // Dimension of the scaled image in our engine
+    float2 scaledPixelTextureDimension = panelData.dimensions; // Dimension of the scaled image in our engine
     
-    float topSlicingOffset = _panelData.slicingOffset.x;
-    float rightSlicingOffset = _panelData.slicingOffset.y;
-    float bottomSlicingOffset = _panelData.slicingOffset.z;
-    float leftSlicingOffset = _panelData.slicingOffset.w;
+    float topSlicingOffset = panelData.slicingOffset.x;
+    float rightSlicingOffset = panelData.slicingOffset.y;
+    float bottomSlicingOffset = panelData.slicingOffset.z;
+    float leftSlicingOffset = panelData.slicingOffset.w;
     
     float horizontalPixelBorderMin = leftSlicingOffset / pixelTextureDimension.x;
     float horizontalPixelBorderMax = rightSlicingOffset / pixelTextureDimension.x;
@@ -195,8 +199,8 @@ float4 main(VertexOutput input) : SV_Target
         NineSliceAxis(input.uv.y, scaledVerticalPixelBorderMin, scaledVerticalPixelBorderMax, verticalPixelBorderMin, verticalPixelBorderMax)
     );
     
-    float4 borderColor = GetBorderColor(scaledUV);
-    float4 backgroundColor = GetColor(scaledUV);
+    float4 borderColor = GetBorderColor(scaledUV, panelData);
+    float4 backgroundColor = GetColor(scaledUV, panelData, input.textureIndex);
 
     float4 color = borderColor + backgroundColor;
     
@@ -8,31 +8,31 @@ struct TextData
 
 [[vk::binding(0, PER_PASS)]] SamplerState _sampler;
 
-[[vk::binding(1, PER_DRAW)]] ConstantBuffer<TextData> _textData;
-[[vk::binding(2, PER_DRAW)]] StructuredBuffer<uint> _textureIDs;
-[[vk::binding(3, PER_DRAW)]] Texture2D<float4> _textures[128];
+[[vk::binding(4, PER_PASS)]] StructuredBuffer<TextData> _textData;
+[[vk::binding(6, PER_PASS)]] Texture2D<float4> _fontTextures[32]; // One per font atlas page, needs to match FontAtlas::MAX_PAGES
 
 struct VertexOutput
 {
     float4 position : SV_POSITION;
     float2 uv : TEXCOORD0;
-    uint charIndex : TEXCOORD1;
+    nointerpolation uint dataIndex : TEXCOORD1;
+    nointerpolation uint textureIndex : TEXCOORD2;
 };
 
 float4 main(VertexOutput input) : SV_Target
 {
-    uint textureID = _textureIDs[input.charIndex];
+    TextData textData = _textData[input.dataIndex];
 
-    float distance = _textures[textureID].SampleLevel(_sampler, input.uv, 0).r;
+    float distance = _fontTextures[NonUniformResourceIndex(input.textureIndex)].SampleLevel(_sampler, input.uv, 0).r;
     float smoothWidth = fwidth(distance);
     float alpha = smoothstep(0.5 - smoothWidth, 0.5 + smoothWidth, distance);
-    float3 rgb = float3(alpha, alpha, alpha) * _textData.textColor.rgb;
+    float3 rgb = float3(alpha, alpha, alpha) * textData.textColor.rgb;
 
-    if (_textData.outlineWidth > 0.0)
+    if (textData.outlineWidth > 0.0)
     {
-        float w = 1.0 - _textData.outlineWidth;
+        float w = 1.0 - textData.outlineWidth;
         alpha = smoothstep(w - smoothWidth, w + smoothWidth, distance);
-        rgb += lerp(float3(alpha, alpha, alpha), _textData.outlineColor.rgb, alpha);
+        rgb += lerp(float3(alpha, alpha, alpha), textData.outlineColor.rgb, alpha);
     }
 
     return float4(rgb, alpha);
@@ -0,0 +1,47 @@
+
+struct Vertex
+{
+    float2 position;
+    float2 uv;
+};
+
+// One per quad, dataIndex points into _panelData or _textData depending on which pipeline is drawing
+struct Instance
+{
+    uint dataIndex;
+    uint textureIndex;
+};
+
+[[vk::binding(1, PER_PASS)]] StructuredBuffer<Vertex> _vertices;
+[[vk::binding(2, PER_PASS)]] StructuredBuffer<Instance> _instances;
+
+struct VertexInput
+{
+    uint vertexID : SV_VertexID;
+    uint instanceID : SV_InstanceID;
+};
+
+struct VertexOutput
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+    nointerpolation uint dataIndex : TEXCOORD1;
+    nointerpolation uint textureIndex : TEXCOORD2;
+};
+
+VertexOutput main(VertexInput input)
+{
+    VertexOutput output;
+
+    // Batches are drawn with their first quad as the first instance, so instanceID indexes every quad this frame
+    uint vertexOffset = input.instanceID * 4 + input.vertexID; // 4 vertices per quad
+    Vertex vertex = _vertices[vertexOffset];
+    Instance instance = _instances[input.instanceID];
+
+    output.position = float4((vertex.position * 2.0f) - 1.0f, 0.0f, 1.0f);
+    output.uv = vertex.uv;
+    output.dataIndex = instance.dataIndex;
+    output.textureIndex = instance.textureIndex;
+
+    return output;
+}
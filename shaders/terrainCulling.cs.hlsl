@@ -11,6 +11,7 @@ struct Constants
     float4 frustumPlanes[6];
     float4x4 viewmat;
     uint occlusionCull;
+    uint numInstances;
 };
 
 [[vk::push_constant]] Constants _constants;
@@ -87,12 +88,18 @@ bool IsAABBInsideFrustum(float4 frustum[6], AABB aabb)
 void main(uint3 dispatchThreadId : SV_DispatchThreadID)
 {
 	const uint instanceIndex = dispatchThreadId.x;
+    if (instanceIndex >= _constants.numInstances)
+    {
+        return;
+    }
+
 	CellInstance instance = _instances[instanceIndex];
 
     const uint cellID = instance.packedChunkCellID & 0xffff;
     const uint chunkID = instance.packedChunkCellID >> 16;
 
-    const float2 heightRange = ReadHeightRange(instanceIndex);
+    // Height ranges are stored per chunk slot, which is what instanceID points to
+    const float2 heightRange = ReadHeightRange(instance.instanceID);
     AABB aabb = GetCellAABB(chunkID, cellID, heightRange);
     
     if (!IsAABBInsideFrustum(_constants.frustumPlanes, aabb))